@@ -2,6 +2,7 @@
 // port-lint: source AbstractCoroutine.kt
 #include <string>
 #include <memory>
+#include <mutex>
 #include <functional>
 #include <any>
 #include <typeinfo>
@@ -101,16 +102,25 @@ namespace kotlinx::coroutines {
         std::shared_ptr<CoroutineContext> parent_context;
         std::shared_ptr<CoroutineContext> context;
 
+    private:
+        mutable std::once_flag own_context_once_;
+        mutable std::shared_ptr<FlatCoroutineContext> own_context_;
+
+    public:
+
         std::shared_ptr<CoroutineContext> get_coroutine_context() const override {
             // Return fully constructed context (parent + this)
             // This is safe to call after construction
             // Note: shared_from_this() returns shared_ptr<JobSupport>, we need to cast
             auto self_job = const_cast<AbstractCoroutine<T>*>(this)->JobSupport::shared_from_this();
 
-            // Cast self to Element
-            auto self_element = std::static_pointer_cast<CoroutineContext::Element>(self_job);
-
-            return std::make_shared<CombinedContext>(parent_context, self_element);
+            // Built once: the flat context borrows this coroutine as its Job element (owning it
+            // would be a cycle), and the returned pointer shares ownership of the coroutine.
+            std::call_once(own_context_once_, [&] {
+                own_context_ = FlatCoroutineContext::with_borrowed_element(
+                    *parent_context, *static_cast<CoroutineContext::Element*>(self_job.get()), self_job);
+            });
+            return std::shared_ptr<CoroutineContext>(self_job, own_context_.get());
         }
 
         // Continuation impl
@@ -202,14 +212,14 @@ namespace kotlinx::coroutines {
             }
 
             // Try to cast to CompletedExceptionally first
-            auto* ex = dynamic_cast<CompletedExceptionally*>(state);
+            auto* ex = as_completed_exceptionally(state);
             if (ex && ex->cause) {
                 on_cancelled(ex->cause, ex->handled);
                 return;
             }
 
             if (auto* completed = dynamic_cast<CompletedValue<T>*>(state)) {
-                on_completed(std::move(completed->value));
+                on_completed(completed->value); // the state keeps its value for get_completed()
                 return;
             }
 
@@ -222,7 +232,7 @@ namespace kotlinx::coroutines {
         }
 
 
-        //       → template<typename R> void start(CoroutineStart, R, std::function<T(R)>)
+        //       → template<typename R, typename Block> void start(CoroutineStart, R, Block&&)
 
         /**
      * @brief Returns a string representation of this coroutine for debugging.
@@ -240,9 +250,10 @@ namespace kotlinx::coroutines {
             return "\"" + name + "\":" + JobSupport::name_string();
         }
 
-        template <typename R>
-        void start(CoroutineStart start_strategy, R receiver, std::function<T(R)> block) {
-            invoke(start_strategy, block, receiver, std::dynamic_pointer_cast<Continuation<T>>(JobSupport::shared_from_this()));
+        // The block is forwarded as is, so builders pass lambdas without wrapping them in std::function.
+        template <typename R, typename Block>
+        void start(CoroutineStart start_strategy, R receiver, Block&& block) {
+            invoke(start_strategy, std::forward<Block>(block), receiver, std::dynamic_pointer_cast<Continuation<T>>(JobSupport::shared_from_this()));
         }
 
         // Helper for parent init
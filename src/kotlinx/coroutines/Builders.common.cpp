@@ -44,33 +44,4 @@ bool StandaloneCoroutine::handle_job_exception(std::exception_ptr exception) {
     return true;
 }
 
-// ---------------------------------------------------------------------------
-// LazyStandaloneCoroutine implementation
-// ---------------------------------------------------------------------------
-
-LazyStandaloneCoroutine::LazyStandaloneCoroutine(
-    std::shared_ptr<CoroutineContext> parentContext,
-    std::function<void(CoroutineScope*)> block_param
-) : StandaloneCoroutine(parentContext, false),
-    block(block_param) {}
-
-void LazyStandaloneCoroutine::on_start() {
-    /*
-     * TODO: STUB - Lazy coroutine startup not implemented
-     *
-     * Kotlin source: LazyStandaloneCoroutine.onStart() in Builders.common.kt
-     *
-     * What's missing:
-     * - Should call: continuation.startCoroutineCancellable(this)
-     * - startCoroutineCancellable() wraps the block in a CancellableContinuation
-     *   and dispatches it through the coroutine's dispatcher
-     * - Requires: CancellableContinuationImpl, DispatchedContinuation integration
-     *
-     * Current behavior: Does nothing - lazy coroutine never actually starts
-     * Correct behavior: Start the coroutine block with cancellation support
-     *
-     * Workaround: Use CoroutineStart::DEFAULT instead of LAZY for now
-     */
-}
-
 } // namespace kotlinx::coroutines
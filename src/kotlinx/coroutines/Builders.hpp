@@ -12,7 +12,9 @@
 #include <functional>
 #include <thread>
 #include <memory>
+#include <type_traits>
 #include "kotlinx/coroutines/dsl/Suspend.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 
 namespace kotlinx {
 namespace coroutines {
@@ -32,16 +34,34 @@ namespace coroutines {
         bool handle_job_exception(std::exception_ptr exception) override;
     };
 
+    /**
+     * Holds the block inline until the coroutine is started, so a lazy launch allocates only
+     * the coroutine itself.
+     */
+    template<typename Block>
     class LazyStandaloneCoroutine : public StandaloneCoroutine {
     private:
-        std::function<void(CoroutineScope*)> block;
+        Block block;
 
     public:
-        LazyStandaloneCoroutine(
-            std::shared_ptr<CoroutineContext> parent_context,
-            std::function<void(CoroutineScope*)> block_param
-        );
-        void on_start() override;
+        LazyStandaloneCoroutine(std::shared_ptr<CoroutineContext> parent_context, Block block_param)
+            : StandaloneCoroutine(std::move(parent_context), false),
+              block(std::move(block_param)) {}
+
+        /**
+         * Runs the block now that the coroutine is started, the way launch runs it for an eager
+         * start; the block is moved out first, so its captures go away once it is done.
+         *
+         * Kotlin: override fun onStart() { continuation.startCoroutineCancellable(this) }
+         */
+        void on_start() override {
+            Block started = std::move(block);
+            auto unit_block = [&started](CoroutineScope* s) -> Unit {
+                std::invoke(started, s);
+                return Unit();
+            };
+            start(CoroutineStart::DEFAULT, static_cast<CoroutineScope*>(this), unit_block);
+        }
     };
 
     /**
@@ -67,7 +87,7 @@ namespace coroutines {
         T get_completed() const override {
             auto* state = JobSupport::get_completed_internal();
             // Check for exception first
-            if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+            if (auto* ex = as_completed_exceptionally(state)) {
                 std::rethrow_exception(ex->cause);
             }
             // Extract value from CompletedValue wrapper
@@ -79,7 +99,7 @@ namespace coroutines {
 
         [[nodiscard]] std::exception_ptr get_completion_exception_or_null() const override {
             auto* state = JobSupport::get_state_for_await();
-            if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+            if (auto* ex = as_completed_exceptionally(state)) {
                 return ex->cause;
             }
             return nullptr;
@@ -96,7 +116,7 @@ namespace coroutines {
         T await_blocking() override {
             auto* state = AbstractCoroutine<T>::await_internal_blocking();
             // Check for exception first
-            if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+            if (auto* ex = as_completed_exceptionally(state)) {
                 std::rethrow_exception(ex->cause);
             }
             // Extract value from CompletedValue wrapper
@@ -135,84 +155,91 @@ namespace coroutines {
         return EmptyCoroutineContext::instance();
     }
 
+    // The builders take the block as a template parameter and hand it to start() unwrapped: a
+    // capturing lambda would otherwise cost a std::function allocation per launch.
+
     // Full launch with all parameters
-    inline std::shared_ptr<struct Job> launch(
+    template<typename Block>
+    std::shared_ptr<struct Job> launch(
         CoroutineScope* scope,
         std::shared_ptr<CoroutineContext> context,
         CoroutineStart start,
-        std::function<void(CoroutineScope*)> block
+        Block&& block
     ) {
         if (!context) context = empty_context();
-        auto new_context = scope->get_coroutine_context()->operator+(context); 
+        auto new_context = scope->get_coroutine_context()->operator+(context);
 
         std::shared_ptr<StandaloneCoroutine> coroutine;
         if (start == CoroutineStart::LAZY) {
-             coroutine = std::make_shared<LazyStandaloneCoroutine>(new_context, block);
-        } else {
-             coroutine = std::make_shared<StandaloneCoroutine>(new_context, true);
+             coroutine = internal::make_frame<LazyStandaloneCoroutine<std::decay_t<Block>>>(
+                 new_context, std::forward<Block>(block));
+             return coroutine;
         }
-        
-        // Wrap block to return Unit
-        std::function<Unit(CoroutineScope*)> wrapped_block = [block](CoroutineScope* s) -> Unit {
-            if (block) block(s);
+        coroutine = internal::make_frame<StandaloneCoroutine>(new_context, true);
+
+        // Adapt block to return Unit; start() runs it before returning, so a reference is enough
+        auto unit_block = [&block](CoroutineScope* s) -> Unit {
+            std::invoke(block, s);
             return Unit();
         };
 
-        coroutine->start(start, static_cast<CoroutineScope*>(coroutine.get()), wrapped_block);
+        coroutine->start(start, static_cast<CoroutineScope*>(coroutine.get()), unit_block);
         return coroutine;
     }
 
     // Overload: launch(scope, block) - no context, default start
-    inline std::shared_ptr<struct Job> launch(
+    template<typename Block>
+    std::shared_ptr<struct Job> launch(
         CoroutineScope* scope,
-        std::function<void(CoroutineScope*)> block
+        Block&& block
     ) {
-        return launch(scope, nullptr, CoroutineStart::DEFAULT, block);
+        return launch(scope, nullptr, CoroutineStart::DEFAULT, std::forward<Block>(block));
     }
 
     // Overload: launch(scope, context, block) - no start parameter
-    inline std::shared_ptr<struct Job> launch(
+    template<typename Block>
+    std::shared_ptr<struct Job> launch(
         CoroutineScope* scope,
         std::shared_ptr<CoroutineContext> context,
-        std::function<void(CoroutineScope*)> block
+        Block&& block
     ) {
-        return launch(scope, context, CoroutineStart::DEFAULT, block);
+        return launch(scope, std::move(context), CoroutineStart::DEFAULT, std::forward<Block>(block));
     }
 
-    template<typename T>
+    template<typename T, typename Block>
     std::shared_ptr<Deferred<T>> async(
         CoroutineScope* scope,
         std::shared_ptr<CoroutineContext> context,
         CoroutineStart start,
-        std::function<T(CoroutineScope*)> block
+        Block&& block
     ) {
         if (!context) context = empty_context();
         auto new_context = scope->get_coroutine_context()->operator+(context);
 
         std::shared_ptr<DeferredCoroutine<T>> coroutine;
-        coroutine = std::make_shared<DeferredCoroutine<T>>(new_context, true);
+        coroutine = internal::make_frame<DeferredCoroutine<T>>(new_context, true);
         // Cast to CoroutineScope* to match the block signature
-        coroutine->start(start, static_cast<CoroutineScope*>(coroutine.get()), block);
+        coroutine->start(start, static_cast<CoroutineScope*>(coroutine.get()), std::forward<Block>(block));
         return coroutine;
     }
 
     // Overload: async(scope, block) - no context, default start
-    template<typename T>
+    template<typename T, typename Block>
     std::shared_ptr<Deferred<T>> async(
         CoroutineScope* scope,
-        std::function<T(CoroutineScope*)> block
+        Block&& block
     ) {
-        return async<T>(scope, nullptr, CoroutineStart::DEFAULT, block);
+        return async<T>(scope, nullptr, CoroutineStart::DEFAULT, std::forward<Block>(block));
     }
 
     // Overload: async(scope, context, block) - no start
-    template<typename T>
+    template<typename T, typename Block>
     std::shared_ptr<Deferred<T>> async(
         CoroutineScope* scope,
         std::shared_ptr<CoroutineContext> context,
-        std::function<T(CoroutineScope*)> block
+        Block&& block
     ) {
-        return async<T>(scope, context, CoroutineStart::DEFAULT, block);
+        return async<T>(scope, std::move(context), CoroutineStart::DEFAULT, std::forward<Block>(block));
     }
 
     // Transliterated from Builders.common.kt: suspend fun <T> withContext(context: CoroutineContext, block: suspend CoroutineScope.() -> T): T
@@ -396,7 +423,7 @@ namespace coroutines {
          
          try {
              auto new_context = context->operator+(event_loop);
-             auto coroutine = std::make_shared<BlockingCoroutine<T>>(new_context, event_loop);
+             auto coroutine = internal::make_frame<BlockingCoroutine<T>>(new_context, event_loop);
              
              // Cast to CoroutineScope* to match block signature - R must be consistent
              coroutine->start(CoroutineStart::DEFAULT, static_cast<CoroutineScope*>(coroutine.get()), block);
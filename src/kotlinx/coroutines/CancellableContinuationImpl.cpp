@@ -2,7 +2,7 @@
  * @file CancellableContinuationImpl.cpp
  * @brief Implementation of CancellableContinuationImpl<void> methods.
  *
- * The void specialization's methods that depend on DispatchedContinuation live here.
+ * The void specialization's constructor and methods that depend on DispatchedContinuation live here.
  * This avoids circular includes: DispatchedContinuation.hpp includes CancellableContinuationImpl.hpp,
  * so we can't use DispatchedContinuation in the header. The .cpp includes both, solving the cycle.
  *
@@ -15,19 +15,31 @@
 namespace kotlinx {
 namespace coroutines {
 
+CancellableContinuationImpl<void>::CancellableContinuationImpl(std::shared_ptr<Continuation<void>> delegate_,
+                                                               int resume_mode_)
+    : DispatchedTask<void>(resume_mode_), delegate(delegate_),
+      dispatched_delegate_(dynamic_cast<internal::DispatchedContinuation<void>*>(delegate.get())) {
+    context_ = delegate->get_context();
+    state_.store(&Active::instance, std::memory_order_relaxed);
+    decision_and_index_.store(decision_and_index(UNDECIDED, NO_INDEX), std::memory_order_relaxed);
+}
+
 // Kotlin line 138
 bool CancellableContinuationImpl<void>::is_reusable() const {
     if (!is_reusable_mode(this->resume_mode)) return false;
-    auto dispatched = std::dynamic_pointer_cast<internal::DispatchedContinuation<void>>(delegate);
-    return dispatched && dispatched->is_reusable();
+    if (reusable_slot_ != nullptr) return true;
+    return dispatched_delegate_ && dispatched_delegate_->is_reusable();
 }
 
 // Kotlin lines 351-356
 void CancellableContinuationImpl<void>::release_claimed_reusable_continuation() {
-    auto dispatched = std::dynamic_pointer_cast<internal::DispatchedContinuation<void>>(delegate);
-    if (!dispatched) return;
+    if (reusable_slot_ != nullptr) {
+        reusable_slot_->release(shared_from_this());
+        return;
+    }
+    if (!dispatched_delegate_) return;
 
-    std::exception_ptr cancellation_cause = dispatched->try_release_claimed_continuation(this);
+    std::exception_ptr cancellation_cause = dispatched_delegate_->try_release_claimed_continuation(this);
     if (!cancellation_cause) return;
 
     detach_child();
@@ -37,9 +49,8 @@ void CancellableContinuationImpl<void>::release_claimed_reusable_continuation()
 // Kotlin lines 194-199
 bool CancellableContinuationImpl<void>::cancel_later(std::exception_ptr cause) {
     if (!is_reusable()) return false;
-    auto dispatched = std::dynamic_pointer_cast<internal::DispatchedContinuation<void>>(delegate);
-    if (!dispatched) return false;
-    return dispatched->postpone_cancellation(cause);
+    if (!dispatched_delegate_) return false;
+    return dispatched_delegate_->postpone_cancellation(cause);
 }
 
 } // namespace coroutines
@@ -16,6 +16,8 @@
 #include "kotlinx/coroutines/internal/Symbol.hpp"
 #include "kotlinx/coroutines/internal/DispatchedTask.hpp"
 #include "kotlinx/coroutines/internal/ConcurrentLinkedList.hpp"
+#include "kotlinx/coroutines/internal/ReusableContinuationSlot.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 #include <atomic>
 #include <cassert>
 #include <mutex>
@@ -61,6 +63,7 @@ static const void* RESUME_TOKEN = (void*)"RESUME_TOKEN";
 // State, NotCompleted, Active are defined in ContinuationState.hpp
 
 struct CancelHandler : public virtual NotCompleted {
+    CancelHandler() { kind = StateKind::CANCEL_HANDLER; }
     virtual void invoke(std::exception_ptr cause) = 0;
 };
 
@@ -90,7 +93,8 @@ struct CompletedCancellableContinuationState : public State {
         std::function<void(std::exception_ptr, T, std::shared_ptr<CoroutineContext>)> oc = nullptr,
         void* idempotent = nullptr,
         std::exception_ptr cause = nullptr
-    ) : result(r), cancel_handler(ch), on_cancellation(oc), idempotent_resume(idempotent), cancel_cause(cause) {}
+    ) : State(StateKind::COMPLETED_CONTINUATION), result(r), cancel_handler(ch), on_cancellation(oc),
+        idempotent_resume(idempotent), cancel_cause(cause) {}
 
     bool is_cancelled() const { return cancel_cause != nullptr; }
     
@@ -110,7 +114,8 @@ struct CompletedCancellableContinuationState<void> : public State {
         std::function<void(std::exception_ptr, std::shared_ptr<CoroutineContext>)> oc = nullptr,
         void* idempotent = nullptr,
         std::exception_ptr cause = nullptr
-    ) : cancel_handler(ch), on_cancellation(oc), idempotent_resume(idempotent), cancel_cause(cause) {}
+    ) : State(StateKind::COMPLETED_CONTINUATION), cancel_handler(ch), on_cancellation(oc),
+        idempotent_resume(idempotent), cancel_cause(cause) {}
 
     bool is_cancelled() const { return cancel_cause != nullptr; }
     std::string to_string() const override { return "CompletedCancellableContinuationState"; }
@@ -129,7 +134,8 @@ template <typename T>
 struct CompletedWithValue : public State {
     T result;
 
-    explicit CompletedWithValue(T r) : result(std::move(r)) {}
+    CompletedWithValue() : State(StateKind::COMPLETED_WITH_VALUE), result() {}
+    explicit CompletedWithValue(T r) : State(StateKind::COMPLETED_WITH_VALUE), result(std::move(r)) {}
 
     std::string to_string() const override { return "CompletedWithValue"; }
 };
@@ -137,15 +143,22 @@ struct CompletedWithValue : public State {
 // Void specialization - represents successful void completion without metadata
 template <>
 struct CompletedWithValue<void> : public State {
+    /** It carries nothing, so every continuation shares this one (like Active::instance). */
+    static CompletedWithValue<void> instance;
+    CompletedWithValue() : State(StateKind::COMPLETED_WITH_VALUE) {}
     std::string to_string() const override { return "CompletedWithValue<void>"; }
 };
+inline CompletedWithValue<void> CompletedWithValue<void>::instance;
 
 // Private class CancelledContinuation
 struct CancelledContinuation : public CompletedExceptionally, public State {
     bool handled;
     
+    // Kotlin: cause ?: CancellationException("Continuation $continuation was cancelled normally");
+    // the shared instance stands in for it, so a plain cancel() allocates no exception.
     explicit CancelledContinuation(std::exception_ptr cause, bool handled = false) 
-        : CompletedExceptionally(cause), handled(handled) {}
+        : CompletedExceptionally(cause ? std::move(cause) : job_cancelled_exception()),
+          State(StateKind::CANCELLED), handled(handled) {}
 
     // Helper to make it look like Kotlin's makeHandled() which is atomic in Kotlin but we simplify here
     // In Kotlin it uses atomic boolean updater.
@@ -167,10 +180,49 @@ struct CancelledContinuation : public CompletedExceptionally, public State {
 // Completed exceptionally (non-cancellation) as State
 struct CompletedExceptionState : public CompletedExceptionally, public State {
     explicit CompletedExceptionState(std::exception_ptr cause, bool handled = false)
-        : CompletedExceptionally(cause, handled) {}
+        : CompletedExceptionally(cause, handled), State(StateKind::COMPLETED_EXCEPTION) {}
     std::string to_string() const override { return "CompletedException"; }
 };
 
+// Tag checks for the states above (see StateKind). A continuation only ever holds completed
+// states of its own T, so the value states need no further check. CancelHandler and SegmentBase
+// derive from State through a virtual base: only those are cast dynamically, once the tag matched.
+
+inline CancelHandler* as_cancel_handler(State* state) {
+    if (state == nullptr || state->kind != StateKind::CANCEL_HANDLER) return nullptr;
+    return dynamic_cast<CancelHandler*>(state);
+}
+
+inline internal::SegmentBase* as_segment(State* state) {
+    if (state == nullptr || state->kind != StateKind::SEGMENT) return nullptr;
+    return dynamic_cast<internal::SegmentBase*>(state);
+}
+
+inline CancelledContinuation* as_cancelled(State* state) {
+    if (state == nullptr || state->kind != StateKind::CANCELLED) return nullptr;
+    return static_cast<CancelledContinuation*>(state);
+}
+
+/** Kotlin: `state is CompletedExceptionally` (a CancelledContinuation or a CompletedExceptionState). */
+inline CompletedExceptionally* as_completed_exceptionally(State* state) {
+    if (state == nullptr) return nullptr;
+    if (state->kind == StateKind::CANCELLED) return static_cast<CancelledContinuation*>(state);
+    if (state->kind == StateKind::COMPLETED_EXCEPTION) return static_cast<CompletedExceptionState*>(state);
+    return nullptr;
+}
+
+template <typename T>
+CompletedWithValue<T>* as_completed_with_value(State* state) {
+    if (state == nullptr || state->kind != StateKind::COMPLETED_WITH_VALUE) return nullptr;
+    return static_cast<CompletedWithValue<T>*>(state);
+}
+
+template <typename T>
+CompletedCancellableContinuationState<T>* as_completed_continuation(State* state) {
+    if (state == nullptr || state->kind != StateKind::COMPLETED_CONTINUATION) return nullptr;
+    return static_cast<CompletedCancellableContinuationState<T>*>(state);
+}
+
 /**
  * @brief Implementation of CancellableContinuation.
  *
@@ -185,6 +237,10 @@ private:
     static_assert(!std::is_void_v<T>, "Use void specialization");
     std::shared_ptr<Continuation<T>> delegate;
 
+    // Kotlin: delegate as DispatchedContinuation, worked out once here instead of on every
+    // dispatch, run and release; null when the delegate is not one.
+    internal::DispatchedContinuation<T>* dispatched_delegate_;
+
     // _decisionAndIndex - Kotlin line 69
     std::atomic<int> decision_and_index_;
 
@@ -204,23 +260,45 @@ private:
     // Context cache - Kotlin line 38: context = delegate.context
     std::shared_ptr<CoroutineContext> context_;
 
-    // For segment-based cancellation (channel operations)
-    void* segment_for_cancellation_ = nullptr;
+    // For segment-based cancellation (channel operations). Kotlin keeps the segment as the
+    // state; here it sits beside the state, retained until cancel() has called it or it is dropped.
+    std::atomic<internal::SegmentBase*> segment_for_cancellation_{nullptr};
+
+    // Where this continuation is parked between suspensions when its delegate is not a
+    // DispatchedContinuation; see dsl::suspend_cancellable_coroutine_reusable.
+    internal::ReusableContinuationSlot* reusable_slot_ = nullptr;
+
+    // Where get_result() puts a value instead of boxing it in a `new T`; see set_result_slot().
+    T* result_slot_ = nullptr;
+
+    // C++ only: the state of a plain resume with a value, which every resume of this
+    // continuation reuses instead of allocating one; taken by one resume at a time and given
+    // back when the state moves on. Only for a T that can be default-constructed and assigned.
+    static constexpr bool INLINE_VALUE = std::is_default_constructible_v<T> && std::is_move_assignable_v<T>;
+    struct NoInlineValue {};
+    [[no_unique_address]] std::conditional_t<INLINE_VALUE, CompletedWithValue<T>, NoInlineValue> inline_value_;
+    std::atomic<bool> inline_value_taken_{false};
 
 public:
     CancellableContinuationImpl(std::shared_ptr<Continuation<T>> delegate_, int resume_mode_)
-        : DispatchedTask<T>(resume_mode_), delegate(delegate_) {
+        : DispatchedTask<T>(resume_mode_), delegate(delegate_),
+          dispatched_delegate_(dynamic_cast<internal::DispatchedContinuation<T>*>(delegate.get())) {
         context_ = delegate->get_context();
         state_.store(&Active::instance, std::memory_order_relaxed);
         decision_and_index_.store(decision_and_index(UNDECIDED, NO_INDEX), std::memory_order_relaxed);
     }
 
     ~CancellableContinuationImpl() override {
-       // Cleanup if needed
+        drop_segment_for_cancellation();
     }
 
     std::shared_ptr<CoroutineContext> get_context() const override { return context_; }
     std::shared_ptr<Continuation<T>> get_delegate() override { return delegate; }
+    Continuation<T>* delegate_ptr() override { return delegate.get(); }
+    internal::DispatchedContinuation<T>* dispatched_delegate() override { return dispatched_delegate_; }
+
+    // Always created by std::make_shared, so this shares its control block
+    std::shared_ptr<SchedulerTask> shared_task() override { return this->shared_from_this(); }
 
     /**
      * Kotlin line 138:
@@ -228,8 +306,21 @@ public:
      */
     bool is_reusable() const {
         if (!is_reusable_mode(this->resume_mode)) return false;
-        auto dispatched = std::dynamic_pointer_cast<internal::DispatchedContinuation<T>>(delegate);
-        return dispatched && dispatched->is_reusable();
+        if (reusable_slot_ != nullptr) return true;
+        return dispatched_delegate_ && dispatched_delegate_->is_reusable();
+    }
+
+    /** Makes [slot] the place this continuation is released to after each suspension. */
+    void set_reusable_slot(internal::ReusableContinuationSlot* slot) {
+        reusable_slot_ = slot;
+    }
+
+    /**
+     * C++ only: makes get_result() assign a value to [slot], owned by the caller, and return
+     * [slot] instead of a `new T` the caller deletes. Null restores boxing.
+     */
+    void set_result_slot(T* slot) {
+        result_slot_ = slot;
     }
 
     /**
@@ -247,10 +338,10 @@ public:
         // val state = _state.value
         State* state = state_.load(std::memory_order_acquire);
         // assert { state !is NotCompleted }
-        assert(dynamic_cast<NotCompleted*>(state) == nullptr);
+        assert(!is_not_completed(state));
 
         // if (state is CompletedContinuation<*> && state.idempotentResume != null)
-        if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<T>*>(state)) {
+        if (auto* cc = as_completed_continuation<T>(state)) {
             if (cc->idempotent_resume != nullptr) {
                 // Cannot reuse continuation that was resumed with idempotent marker
                 detach_child();
@@ -262,6 +353,9 @@ public:
         decision_and_index_.store(decision_and_index(UNDECIDED, NO_INDEX), std::memory_order_release);
         // _state.value = Active
         state_.store(&Active::instance, std::memory_order_release);
+        inline_value_taken_.store(false, std::memory_order_release);
+        // Kotlin keeps the segment in the state it just overwrote
+        drop_segment_for_cancellation();
         return true;
     }
 
@@ -274,10 +368,13 @@ public:
      * }
      */
     void release_claimed_reusable_continuation() {
-        auto dispatched = std::dynamic_pointer_cast<internal::DispatchedContinuation<T>>(delegate);
-        if (!dispatched) return;
+        if (reusable_slot_ != nullptr) {
+            reusable_slot_->release(this->shared_from_this());
+            return;
+        }
+        if (!dispatched_delegate_) return;
 
-        std::exception_ptr cancellation_cause = dispatched->try_release_claimed_continuation(this);
+        std::exception_ptr cancellation_cause = dispatched_delegate_->try_release_claimed_continuation(this);
         if (!cancellation_cause) return;
 
         detach_child();
@@ -294,9 +391,8 @@ public:
      */
     bool cancel_later(std::exception_ptr cause) {
         if (!is_reusable()) return false;
-        auto dispatched = std::dynamic_pointer_cast<internal::DispatchedContinuation<T>>(delegate);
-        if (!dispatched) return false;
-        return dispatched->postpone_cancellation(cause);
+        if (!dispatched_delegate_) return false;
+        return dispatched_delegate_->postpone_cancellation(cause);
     }
 
     /*
@@ -326,7 +422,7 @@ public:
     */
 
     bool is_active() const override {
-        return dynamic_cast<NotCompleted*>(state_.load(std::memory_order_acquire)) != nullptr;
+        return is_not_completed(state_.load(std::memory_order_acquire));
     }
 
     bool is_completed() const override {
@@ -334,7 +430,7 @@ public:
     }
 
     bool is_cancelled() const override {
-        return dynamic_cast<CancelledContinuation*>(state_.load(std::memory_order_acquire)) != nullptr;
+        return as_cancelled(state_.load(std::memory_order_acquire)) != nullptr;
     }
     
     // initCancellability implementation
@@ -364,22 +460,22 @@ public:
         State* s = state_.load(std::memory_order_acquire);
 
         // CompletedWithValue<T> -> success with result (lightweight fast path)
-        if (auto* cwv = dynamic_cast<CompletedWithValue<T>*>(s)) {
+        if (auto* cwv = as_completed_with_value<T>(s)) {
             return Result<T>::success(cwv->result);
         }
 
         // CompletedCancellableContinuationState<T> -> success with result
-        if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<T>*>(s)) {
+        if (auto* cc = as_completed_continuation<T>(s)) {
             return Result<T>::success(cc->result);
         }
 
         // CancelledContinuation -> failure with cause
-        if (auto* cancelled = dynamic_cast<CancelledContinuation*>(s)) {
+        if (auto* cancelled = as_cancelled(s)) {
             return Result<T>::failure(cancelled->cause);
         }
 
         // CompletedExceptionally (non-cancellation) -> failure with cause
-        if (auto* ex = dynamic_cast<CompletedExceptionally*>(s)) {
+        if (auto* ex = as_completed_exceptionally(s)) {
             return Result<T>::failure(ex->cause);
         }
 
@@ -392,14 +488,14 @@ public:
     void cancel_completed_result(Result<T> taken_state, std::exception_ptr cause) override {
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
-            if (dynamic_cast<NotCompleted*>(state)) {
+            if (is_not_completed(state)) {
                 throw std::runtime_error("Not completed");
             }
-            if (dynamic_cast<CompletedExceptionally*>(state)) return; // already exceptional
+            if (as_completed_exceptionally(state)) return; // already exceptional
 
             // Handle CompletedWithValue - promote to CompletedCancellableContinuationState with cancelCause
             // Kotlin lines 181-187: else branch for raw values
-            if (auto* cwv = dynamic_cast<CompletedWithValue<T>*>(state)) {
+            if (auto* cwv = as_completed_with_value<T>(state)) {
                 auto* update = new CompletedCancellableContinuationState<T>(
                     cwv->result, nullptr, nullptr, nullptr, cause);
                 if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
@@ -411,7 +507,7 @@ public:
                 continue;
             }
 
-            if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<T>*>(state)) {
+            if (auto* cc = as_completed_continuation<T>(state)) {
                 if (cc->is_cancelled()) throw std::runtime_error("Must be called at most once");
                 auto* update = new CompletedCancellableContinuationState<T>(
                     cc->result, cc->cancel_handler, cc->on_cancellation, cc->idempotent_resume, cause);
@@ -434,14 +530,17 @@ public:
     
     // cancel - Kotlin lines 201-217
     bool cancel(std::exception_ptr cause = nullptr) override {
+        // The cancellation handler may drop the last outside reference, e.g. by taking this
+        // waiter out of a queue; stay alive until the resumption is dispatched
+        auto self = this->weak_from_this().lock();
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
             // line 203: if (state !is NotCompleted) return false
-            if (!dynamic_cast<NotCompleted*>(state)) return false;
+            if (!is_not_completed(state)) return false;
 
             // line 205: val update = CancelledContinuation(this, cause, handled = state is CancelHandler || state is Segment<*>)
-            bool is_cancel_handler = dynamic_cast<CancelHandler*>(state) != nullptr;
-            bool is_segment = dynamic_cast<internal::SegmentBase*>(state) != nullptr;
+            bool is_cancel_handler = as_cancel_handler(state) != nullptr;
+            bool is_segment = as_segment(state) != nullptr;
             bool handled = is_cancel_handler || is_segment;
             auto* update = new CancelledContinuation(cause, handled);
 
@@ -465,7 +564,9 @@ public:
             if (is_cancel_handler && handler_to_call) {
                 call_cancel_handler(handler_to_call, cause);
             } else if (is_segment) {
-                call_segment_on_cancellation(dynamic_cast<internal::SegmentBase*>(state), cause);
+                call_segment_on_cancellation(as_segment(state), cause);
+            } else {
+                run_segment_on_cancellation(cause);
             }
 
             // line 213: detachChildIfNonReusable()
@@ -478,6 +579,7 @@ public:
 
     // Kotlin lines 219-224
     void parent_cancelled(std::exception_ptr cause) {
+        auto self = this->weak_from_this().lock();
         if (cancel_later(cause)) return;
         cancel(cause);
         // Even if cancellation has failed, we should detach child to avoid potential leak
@@ -638,7 +740,7 @@ public:
         // val state = this.state
         State* state = state_.load(std::memory_order_acquire);
         // if (state is CompletedExceptionally) throw recoverStackTrace(state.cause, this)
-        if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+        if (auto* ex = as_completed_exceptionally(state)) {
             std::rethrow_exception(ex->cause);
         }
 
@@ -649,8 +751,7 @@ public:
         // if (resumeMode.isCancellableMode) { ... }
         if (is_cancellable_mode(this->resume_mode) && context_) {
             // val job = context[Job]
-            auto job_element = context_->get(Job::type_key);
-            auto job = std::dynamic_pointer_cast<Job>(job_element);
+            Job* job = context_->job_ptr();
             // if (job != null && !job.isActive)
             if (job && !job->is_active()) {
                 // val cause = job.getCancellationException()
@@ -673,25 +774,33 @@ public:
     // }
     void* get_successful_result(State* state) {
         // Check CompletedWithValue first (common fast path)
-        if (auto* cwv = dynamic_cast<CompletedWithValue<T>*>(state)) {
+        if (auto* cwv = as_completed_with_value<T>(state)) {
             if constexpr (std::is_void_v<T>) {
                 (void)cwv;
                 return nullptr;
             } else {
-                return new T(cwv->result); // allocate per ABI convention
+                return box_result(cwv->result);
             }
         }
 
-        if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<T>*>(state)) {
+        if (auto* cc = as_completed_continuation<T>(state)) {
             if constexpr (std::is_void_v<T>) {
                 (void)cc;
                 return nullptr;
             } else {
-                return new T(cc->result); // allocate per ABI convention
+                return box_result(cc->result);
             }
         }
         throw std::logic_error("Invalid state for result");
     }
+
+    // Per the ABI convention: a `new T`, unless the caller gave a result slot
+    template<typename V>
+    void* box_result(const V& value) {
+        if (result_slot_ == nullptr) return new T(value);
+        *result_slot_ = value;
+        return result_slot_;
+    }
     
     // installParentHandle - Kotlin lines 339-345
     std::shared_ptr<DisposableHandle> install_parent_handle() {
@@ -748,18 +857,18 @@ public:
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
 
-            if (auto* nc = dynamic_cast<NotCompleted*>(state)) {
-                State* update = resumed_state(nc, owned_state_, value, this->resume_mode, on_cancellation, idempotent);
+            if (is_not_completed(state)) {
+                State* update = resumed_state(state, owned_state_, value, this->resume_mode, on_cancellation, idempotent);
                 if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
                     detach_child_if_non_reusable();
                     return const_cast<void*>(RESUME_TOKEN);
                 }
-                delete update;
+                discard_resumed_state(update);
                 continue;
             }
 
             // Kotlin lines 542-549: idempotent resume check for CompletedCancellableContinuationState
-            if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<T>*>(state)) {
+            if (auto* cc = as_completed_continuation<T>(state)) {
                 if (idempotent != nullptr && cc->idempotent_resume == idempotent) {
                     // assert state.result == value
                     return const_cast<void*>(RESUME_TOKEN);
@@ -775,7 +884,7 @@ public:
     void* try_resume_with_exception(std::exception_ptr exception) override {
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
-            if (dynamic_cast<NotCompleted*>(state)) {
+            if (is_not_completed(state)) {
                 auto* update = new CompletedExceptionState(exception, false);
                 if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
                     return const_cast<void*>(RESUME_TOKEN);
@@ -783,7 +892,7 @@ public:
                 delete update;
                 continue;
             }
-            if (dynamic_cast<CancelledContinuation*>(state)) return nullptr;
+            if (as_cancelled(state)) return nullptr;
             return nullptr;
         }
     }
@@ -798,7 +907,7 @@ public:
     // resumedState - determines what to store as the new state
     // Kotlin lines 473-491
     State* resumed_state(
-        NotCompleted* state,
+        State* state,  // NotCompleted
         std::shared_ptr<State> owned_state,  // shared ownership of state for proper CancelHandler handling
         T proposed_update,
         int resume_mode,
@@ -809,12 +918,12 @@ public:
 
         // Cannot be cancelled in process, no metadata needed - use lightweight wrapper
         if (!is_cancellable_mode(resume_mode) && idempotent == nullptr) {
-            return new CompletedWithValue<T>(std::move(proposed_update));
+            return completed_with_value(std::move(proposed_update));
         }
 
         // Lines 486-489: onCancellation != null || state is CancelHandler || idempotent != null
         // -> CompletedCancellableContinuationState (need to track handlers/metadata)
-        auto* ch = dynamic_cast<CancelHandler*>(state);
+        auto* ch = as_cancel_handler(state);
         if (on_cancellation != nullptr || ch != nullptr || idempotent != nullptr) {
             // Use dynamic_pointer_cast from owned_state to properly share ownership
             auto ch_shared = ch ? std::dynamic_pointer_cast<CancelHandler>(owned_state) : nullptr;
@@ -826,7 +935,29 @@ public:
             );
         }
 
-        return new CompletedWithValue<T>(std::move(proposed_update));
+        return completed_with_value(std::move(proposed_update));
+    }
+
+    // The inline value state if no other resume holds it, else a new one
+    State* completed_with_value(T value) {
+        if constexpr (INLINE_VALUE) {
+            if (!inline_value_taken_.exchange(true, std::memory_order_acquire)) {
+                inline_value_.result = std::move(value);
+                return &inline_value_;
+            }
+        }
+        return new CompletedWithValue<T>(std::move(value));
+    }
+
+    // Drops a state from resumed_state() that did not become the state
+    void discard_resumed_state(State* update) {
+        if constexpr (INLINE_VALUE) {
+            if (update == &inline_value_) {
+                inline_value_taken_.store(false, std::memory_order_release);
+                return;
+            }
+        }
+        delete update;
     }
 
     // resumeImpl - Kotlin lines 493-523
@@ -835,10 +966,10 @@ public:
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
 
-            if (auto* nc = dynamic_cast<NotCompleted*>(state)) {
-                State* update = resumed_state(nc, owned_state_, proposed_update, resume_mode, on_cancellation, nullptr);
+            if (is_not_completed(state)) {
+                State* update = resumed_state(state, owned_state_, proposed_update, resume_mode, on_cancellation, nullptr);
                 if (!state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
-                    delete update;
+                    discard_resumed_state(update);
                     continue; // retry on CAS failure
                 }
                 detach_child_if_non_reusable();
@@ -846,7 +977,7 @@ public:
                 return;
             }
 
-            if (auto* cancelled = dynamic_cast<CancelledContinuation*>(state)) {
+            if (auto* cancelled = as_cancelled(state)) {
                 if (cancelled->make_resumed()) {
                     if (on_cancellation) {
                         call_on_cancellation(on_cancellation, cancelled->cause, proposed_update);
@@ -886,35 +1017,69 @@ public:
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
 
-            // Active -> store segment marker (we use the segment pointer as state indicator)
-            if (dynamic_cast<Active*>(state)) {
-                // For segments, we store a marker indicating segment-based cancellation is pending
-                // The actual segment callback is called when cancellation occurs
-                segment_for_cancellation_ = segment;
+            // Active -> store the segment beside the state
+            if (state->kind == StateKind::ACTIVE) {
+                install_segment_for_cancellation(segment);
                 return;
             }
 
             // CompletedExceptionally (includes CancelledContinuation)
-            if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+            if (auto* ex = as_completed_exceptionally(state)) {
                 if (!ex->make_handled()) {
                     throw std::runtime_error("Multiple handlers prohibited");
                 }
                 // Call segment cancellation only if cancelled
-                if (dynamic_cast<CancelledContinuation*>(state)) {
+                if (as_cancelled(state)) {
                     call_segment_on_cancellation(segment, ex->cause);
                 }
                 return;
             }
 
             // CompletedCancellableContinuationState -> segment doesn't need to be called
-            if (dynamic_cast<CompletedCancellableContinuationState<T>*>(state)) {
+            if (as_completed_continuation<T>(state)) {
                 return;  // Kotlin: if (handler is Segment<*>) return
             }
         }
     }
 
+    /**
+     * C++ only: Kotlin CASes the segment in as the state. Here it is stored beside the Active
+     * state and retained, so that the channel keeps it until cancel() has called it. The fences
+     * here and in run_segment_on_cancellation make sure that either cancel() sees the segment or
+     * this sees the completed state; whichever takes the segment back calls or drops it.
+     */
+    void install_segment_for_cancellation(internal::SegmentBase* segment) {
+        segment->retain_for_cancellation();
+        segment_for_cancellation_.store(segment, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        State* state = state_.load(std::memory_order_acquire);
+        if (is_not_completed(state)) return;
+        if (auto* taken = segment_for_cancellation_.exchange(nullptr, std::memory_order_acq_rel)) {
+            if (auto* cancelled = as_cancelled(state)) {
+                call_segment_on_cancellation(taken, cancelled->cause);
+            }
+            taken->release_for_cancellation();
+        }
+    }
+
+    void run_segment_on_cancellation(std::exception_ptr cause) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (auto* segment = segment_for_cancellation_.exchange(nullptr, std::memory_order_acq_rel)) {
+            call_segment_on_cancellation(segment, cause);
+            segment->release_for_cancellation();
+        }
+    }
+
+    void drop_segment_for_cancellation() {
+        if (auto* segment = segment_for_cancellation_.exchange(nullptr, std::memory_order_acq_rel)) {
+            segment->release_for_cancellation();
+        }
+    }
+
     // callSegmentOnCancellation - Kotlin lines 241-245
     void call_segment_on_cancellation(internal::SegmentBase* segment, std::exception_ptr cause) {
+        // C++: the channel that owned the segment has been destroyed
+        if (segment->is_orphaned()) return;
         // val index = _decisionAndIndex.value.index
         int index = get_index(decision_and_index_.load(std::memory_order_acquire));
         // check(index != NO_INDEX) { "The index for Segment.onCancellation(..) is broken" }
@@ -950,7 +1115,7 @@ public:
             State* state = state_.load(std::memory_order_acquire);
 
             // Active -> store handler as the new state
-            if (dynamic_cast<Active*>(state)) {
+            if (state->kind == StateKind::ACTIVE) {
                 if (state_.compare_exchange_strong(state, handler.get(), std::memory_order_acq_rel)) {
                     // Keep handler alive - it's now the state
                     owned_state_ = handler;
@@ -960,24 +1125,24 @@ public:
             }
 
             // Already has a handler -> error
-            if (dynamic_cast<CancelHandler*>(state)) {
+            if (as_cancel_handler(state)) {
                 throw std::runtime_error("Multiple handlers prohibited");
             }
 
             // CompletedExceptionally (includes CancelledContinuation)
-            if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+            if (auto* ex = as_completed_exceptionally(state)) {
                 if (!ex->make_handled()) {
                     throw std::runtime_error("Multiple handlers prohibited");
                 }
                 // Call handler only if cancelled (not just exceptionally completed)
-                if (dynamic_cast<CancelledContinuation*>(state)) {
+                if (as_cancelled(state)) {
                     call_cancel_handler(handler, ex->cause);
                 }
                 return;
             }
 
             // CompletedCancellableContinuationState -> copy with handler
-            if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<T>*>(state)) {
+            if (auto* cc = as_completed_continuation<T>(state)) {
                 if (cc->cancel_handler) {
                     throw std::runtime_error("Multiple handlers prohibited");
                 }
@@ -997,7 +1162,7 @@ public:
 
             // Kotlin lines 448-458: else branch - raw completed value
             // CompletedWithValue -> wrap in CompletedCancellableContinuationState with handler
-            if (auto* cwv = dynamic_cast<CompletedWithValue<T>*>(state)) {
+            if (auto* cwv = as_completed_with_value<T>(state)) {
                 auto* update = new CompletedCancellableContinuationState<T>(
                     cwv->result, handler, nullptr, nullptr, nullptr);
                 if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
@@ -1083,24 +1248,31 @@ class CancellableContinuationImpl<void> : public DispatchedTask<void>,
                                            public std::enable_shared_from_this<CancellableContinuationImpl<void>> {
 private:
     std::shared_ptr<Continuation<void>> delegate;
+    internal::DispatchedContinuation<void>* dispatched_delegate_; // see the primary template
     std::atomic<int> decision_and_index_;
     std::atomic<State*> state_;
     std::shared_ptr<State> owned_state_; // Prevents use-after-free of dynamically allocated states
     std::shared_ptr<DisposableHandle> parent_handle_;
     std::shared_ptr<CoroutineContext> context_;
-    // Note: segment_for_cancellation_ omitted - invoke_on_cancellation(void*, int) is stub
-    // When implementing segment-based cancellation for void specialization, add field back
+    // For segment-based cancellation; see the primary template
+    std::atomic<internal::SegmentBase*> segment_for_cancellation_{nullptr};
+    internal::ReusableContinuationSlot* reusable_slot_ = nullptr;
 
 public:
-    CancellableContinuationImpl(std::shared_ptr<Continuation<void>> delegate_, int resume_mode_)
-        : DispatchedTask<void>(resume_mode_), delegate(delegate_) {
-        context_ = delegate->get_context();
-        state_.store(&Active::instance, std::memory_order_relaxed);
-        decision_and_index_.store(decision_and_index(UNDECIDED, NO_INDEX), std::memory_order_relaxed);
+    // Needs DispatchedContinuation for dispatched_delegate_; in CancellableContinuationImpl.cpp
+    CancellableContinuationImpl(std::shared_ptr<Continuation<void>> delegate_, int resume_mode_);
+
+    ~CancellableContinuationImpl() override {
+        drop_segment_for_cancellation();
     }
 
     std::shared_ptr<CoroutineContext> get_context() const override { return context_; }
     std::shared_ptr<Continuation<void>> get_delegate() override { return delegate; }
+    Continuation<void>* delegate_ptr() override { return delegate.get(); }
+    internal::DispatchedContinuation<void>* dispatched_delegate() override { return dispatched_delegate_; }
+
+    // Always created by std::make_shared, so this shares its control block
+    std::shared_ptr<SchedulerTask> shared_task() override { return this->shared_from_this(); }
 
     // getContinuationCancellationCause - Kotlin lines 266-267
     std::exception_ptr get_continuation_cancellation_cause(Job& parent) {
@@ -1113,6 +1285,10 @@ public:
     void release_claimed_reusable_continuation();          // Kotlin lines 351-356
     bool cancel_later(std::exception_ptr cause);           // Kotlin lines 194-199
 
+    void set_reusable_slot(internal::ReusableContinuationSlot* slot) {
+        reusable_slot_ = slot;
+    }
+
     /**
      * Resets cancellability state in order to suspendCancellableCoroutineReusable to work.
      * Kotlin lines 140-158.
@@ -1122,9 +1298,9 @@ public:
         assert(parent_handle_ != non_disposable_handle());
 
         State* state = state_.load(std::memory_order_acquire);
-        assert(dynamic_cast<NotCompleted*>(state) == nullptr);
+        assert(!is_not_completed(state));
 
-        if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<void>*>(state)) {
+        if (auto* cc = as_completed_continuation<void>(state)) {
             if (cc->idempotent_resume != nullptr) {
                 detach_child();
                 return false;
@@ -1133,6 +1309,7 @@ public:
 
         decision_and_index_.store(decision_and_index(UNDECIDED, NO_INDEX), std::memory_order_release);
         state_.store(&Active::instance, std::memory_order_release);
+        drop_segment_for_cancellation();
         return true;
     }
 
@@ -1177,11 +1354,11 @@ public:
     void cancel_completed_result(Result<void> taken_state, std::exception_ptr cause) override {
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
-            if (dynamic_cast<NotCompleted*>(state)) throw std::runtime_error("Not completed");
-            if (dynamic_cast<CompletedExceptionally*>(state)) return;
+            if (is_not_completed(state)) throw std::runtime_error("Not completed");
+            if (as_completed_exceptionally(state)) return;
 
             // Handle CompletedWithValue - promote to CompletedCancellableContinuationState with cancelCause
-            if (dynamic_cast<CompletedWithValue<void>*>(state)) {
+            if (as_completed_with_value<void>(state)) {
                 auto* update = new CompletedCancellableContinuationState<void>(nullptr, nullptr, nullptr, cause);
                 if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
                     owned_state_.reset(update);
@@ -1191,7 +1368,7 @@ public:
                 continue;
             }
 
-            if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<void>*>(state)) {
+            if (auto* cc = as_completed_continuation<void>(state)) {
                 if (cc->is_cancelled()) throw std::runtime_error("Must be called at most once");
                 auto* update = new CompletedCancellableContinuationState<void>(cc->cancel_handler, cc->on_cancellation, cc->idempotent_resume, cause);
                 if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
@@ -1208,14 +1385,16 @@ public:
 
     // Kotlin lines 201-217
     bool cancel(std::exception_ptr cause = nullptr) override {
+        // See the generic cancel(): the handler may drop the last outside reference
+        auto self = weak_from_this().lock();
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
             // if (state !is NotCompleted) return false
-            if (!dynamic_cast<NotCompleted*>(state)) return false;
+            if (!is_not_completed(state)) return false;
 
             // handled = state is CancelHandler || state is Segment<*>
-            bool is_cancel_handler = dynamic_cast<CancelHandler*>(state) != nullptr;
-            bool is_segment = dynamic_cast<internal::SegmentBase*>(state) != nullptr;
+            bool is_cancel_handler = as_cancel_handler(state) != nullptr;
+            bool is_segment = as_segment(state) != nullptr;
             bool handled = is_cancel_handler || is_segment;
 
             auto* update = new CancelledContinuation(cause, handled);
@@ -1238,7 +1417,9 @@ public:
             if (is_cancel_handler && handler_to_call) {
                 call_cancel_handler(handler_to_call, cause);
             } else if (is_segment) {
-                call_segment_on_cancellation(dynamic_cast<internal::SegmentBase*>(state), cause);
+                call_segment_on_cancellation(as_segment(state), cause);
+            } else {
+                run_segment_on_cancellation(cause);
             }
 
             detach_child_if_non_reusable();
@@ -1249,6 +1430,7 @@ public:
 
     // Kotlin lines 219-224
     void parent_cancelled(std::exception_ptr cause) {
+        auto self = weak_from_this().lock();
         if (cancel_later(cause)) return;
         cancel(cause);
         // Even if cancellation has failed, we should detach child to avoid potential leak
@@ -1268,8 +1450,44 @@ public:
         }
     }
 
+    /**
+     * C++ only: Kotlin CASes the segment in as the state. Here it is stored beside the Active
+     * state and retained, so that the channel keeps it until cancel() has called it. The fences
+     * here and in run_segment_on_cancellation make sure that either cancel() sees the segment or
+     * this sees the completed state; whichever takes the segment back calls or drops it.
+     */
+    void install_segment_for_cancellation(internal::SegmentBase* segment) {
+        segment->retain_for_cancellation();
+        segment_for_cancellation_.store(segment, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        State* state = state_.load(std::memory_order_acquire);
+        if (is_not_completed(state)) return;
+        if (auto* taken = segment_for_cancellation_.exchange(nullptr, std::memory_order_acq_rel)) {
+            if (auto* cancelled = as_cancelled(state)) {
+                call_segment_on_cancellation(taken, cancelled->cause);
+            }
+            taken->release_for_cancellation();
+        }
+    }
+
+    void run_segment_on_cancellation(std::exception_ptr cause) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (auto* segment = segment_for_cancellation_.exchange(nullptr, std::memory_order_acq_rel)) {
+            call_segment_on_cancellation(segment, cause);
+            segment->release_for_cancellation();
+        }
+    }
+
+    void drop_segment_for_cancellation() {
+        if (auto* segment = segment_for_cancellation_.exchange(nullptr, std::memory_order_acq_rel)) {
+            segment->release_for_cancellation();
+        }
+    }
+
     // Kotlin lines 241-245
     void call_segment_on_cancellation(internal::SegmentBase* segment, std::exception_ptr cause) {
+        // C++: the channel that owned the segment has been destroyed
+        if (segment->is_orphaned()) return;
         // val index = _decisionAndIndex.value.index
         int index = get_index(decision_and_index_.load(std::memory_order_acquire));
         // check(index != NO_INDEX) { "The index for Segment.onCancellation(..) is broken" }
@@ -1344,17 +1562,15 @@ public:
     void* try_resume(void* idempotent = nullptr) override {
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
-            if (dynamic_cast<NotCompleted*>(state)) {
-                auto* ch = dynamic_cast<CancelHandler*>(state);
+            if (is_not_completed(state)) {
+                auto* ch = as_cancel_handler(state);
 
                 // Use CompletedWithValue for simple case (no handlers, no idempotent)
                 if (!is_cancellable_mode(this->resume_mode) && idempotent == nullptr) {
-                    auto* update = new CompletedWithValue<void>();
-                    if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
+                    if (state_.compare_exchange_strong(state, &CompletedWithValue<void>::instance, std::memory_order_acq_rel)) {
                         detach_child_if_non_reusable();
                         return const_cast<void*>(RESUME_TOKEN);
                     }
-                    delete update;
                     continue;
                 }
 
@@ -1375,15 +1591,13 @@ public:
                 }
 
                 // Simple case - no handlers, no idempotent
-                auto* update = new CompletedWithValue<void>();
-                if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
+                if (state_.compare_exchange_strong(state, &CompletedWithValue<void>::instance, std::memory_order_acq_rel)) {
                     detach_child_if_non_reusable();
                     return const_cast<void*>(RESUME_TOKEN);
                 }
-                delete update;
                 continue;
             }
-            if (dynamic_cast<CancelledContinuation*>(state)) return nullptr;
+            if (as_cancelled(state)) return nullptr;
             return nullptr;
         }
     }
@@ -1395,8 +1609,8 @@ public:
     ) override {
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
-            if (dynamic_cast<NotCompleted*>(state)) {
-                auto* ch = dynamic_cast<CancelHandler*>(state);
+            if (is_not_completed(state)) {
+                auto* ch = as_cancel_handler(state);
 
                 // Adapt 3-param callback to 2-param (void specialization ignores the value)
                 std::function<void(std::exception_ptr, std::shared_ptr<CoroutineContext>)> adapted_on_cancellation;
@@ -1421,14 +1635,14 @@ public:
             }
 
             // Idempotent check for CompletedCancellableContinuationState
-            if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<void>*>(state)) {
+            if (auto* cc = as_completed_continuation<void>(state)) {
                 if (idempotent != nullptr && cc->idempotent_resume == idempotent) {
                     return const_cast<void*>(RESUME_TOKEN);
                 }
                 return nullptr;
             }
 
-            if (dynamic_cast<CancelledContinuation*>(state)) return nullptr;
+            if (as_cancelled(state)) return nullptr;
             return nullptr;
         }
     }
@@ -1436,7 +1650,7 @@ public:
     void* try_resume_with_exception(std::exception_ptr exception) override {
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
-            if (dynamic_cast<NotCompleted*>(state)) {
+            if (is_not_completed(state)) {
                 auto* update = new CompletedExceptionState(exception, false);
                 if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
                     return const_cast<void*>(RESUME_TOKEN);
@@ -1444,7 +1658,7 @@ public:
                 delete update;
                 continue;
             }
-            if (dynamic_cast<CancelledContinuation*>(state)) return nullptr;
+            if (as_cancelled(state)) return nullptr;
             return nullptr;
         }
     }
@@ -1507,22 +1721,19 @@ public:
         while (true) {
             State* state = state_.load(std::memory_order_acquire);
 
-            // Active -> store segment marker
-            if (dynamic_cast<Active*>(state)) {
-                // For segments, we store a marker indicating segment-based cancellation is pending
-                // Note: In Kotlin, the segment is stored as the state directly
-                // In C++ we'd need a SegmentState wrapper, but for now we store it elsewhere
-                // TODO(port): proper segment-as-state storage
+            // Active -> store the segment beside the state
+            if (state->kind == StateKind::ACTIVE) {
+                install_segment_for_cancellation(segment);
                 return;
             }
 
             // CompletedExceptionally (includes CancelledContinuation) - Kotlin lines 408-429
-            if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+            if (auto* ex = as_completed_exceptionally(state)) {
                 if (!ex->make_handled()) {
                     throw std::runtime_error("Multiple handlers prohibited");
                 }
                 // Call segment cancellation only if cancelled
-                if (dynamic_cast<CancelledContinuation*>(state)) {
+                if (as_cancelled(state)) {
                     call_segment_on_cancellation(segment, ex->cause);
                 }
                 return;
@@ -1530,13 +1741,13 @@ public:
 
             // CompletedCancellableContinuationState -> segment doesn't need to be called
             // Kotlin line 437-438: if (handler is Segment<*>) return
-            if (dynamic_cast<CompletedCancellableContinuationState<void>*>(state)) {
+            if (as_completed_continuation<void>(state)) {
                 return;
             }
 
             // CompletedWithValue -> segment doesn't need to be called on completed continuation
             // Kotlin line 454: if (handler is Segment<*>) return
-            if (dynamic_cast<CompletedWithValue<void>*>(state)) {
+            if (as_completed_with_value<void>(state)) {
                 return;
             }
 
@@ -1560,7 +1771,7 @@ public:
             State* state = state_.load(std::memory_order_acquire);
 
             // Active -> store handler as the new state
-            if (dynamic_cast<Active*>(state)) {
+            if (state->kind == StateKind::ACTIVE) {
                 if (state_.compare_exchange_strong(state, handler.get(), std::memory_order_acq_rel)) {
                     // Keep handler alive - it's now the state
                     owned_state_ = handler;
@@ -1570,25 +1781,25 @@ public:
             }
 
             // Already has a handler -> error (Kotlin line 407)
-            if (dynamic_cast<CancelHandler*>(state)) {
+            if (as_cancel_handler(state)) {
                 throw std::runtime_error("Multiple handlers prohibited");
             }
 
             // CompletedExceptionally (includes CancelledContinuation) - Kotlin lines 408-429
-            if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+            if (auto* ex = as_completed_exceptionally(state)) {
                 // if (!state.makeHandled()) multipleHandlersError(...)
                 if (!ex->make_handled()) {
                     throw std::runtime_error("Multiple handlers prohibited");
                 }
                 // Call handler only if cancelled (not just exceptionally completed)
-                if (dynamic_cast<CancelledContinuation*>(state)) {
+                if (as_cancelled(state)) {
                     call_cancel_handler(handler, ex->cause);
                 }
                 return;
             }
 
             // CompletedCancellableContinuationState -> copy with handler (Kotlin lines 432-446)
-            if (auto* cc = dynamic_cast<CompletedCancellableContinuationState<void>*>(state)) {
+            if (auto* cc = as_completed_continuation<void>(state)) {
                 if (cc->cancel_handler) {
                     throw std::runtime_error("Multiple handlers prohibited");
                 }
@@ -1609,7 +1820,7 @@ public:
 
             // Kotlin lines 448-458: else branch - raw completed value
             // CompletedWithValue -> wrap in CompletedCancellableContinuationState with handler
-            if (dynamic_cast<CompletedWithValue<void>*>(state)) {
+            if (as_completed_with_value<void>(state)) {
                 auto* update = new CompletedCancellableContinuationState<void>(handler, nullptr, nullptr, nullptr);
                 if (state_.compare_exchange_strong(state, update, std::memory_order_acq_rel)) {
                     owned_state_.reset(update);
@@ -1625,13 +1836,13 @@ public:
     }
 
     // ---- state helpers ----
-    bool is_active() const override { return dynamic_cast<NotCompleted*>(state_.load(std::memory_order_acquire)); }
+    bool is_active() const override { return is_not_completed(state_.load(std::memory_order_acquire)); }
     bool is_completed() const override { return !is_active(); }
-    bool is_cancelled() const override { return dynamic_cast<CancelledContinuation*>(state_.load(std::memory_order_acquire)); }
+    bool is_cancelled() const override { return as_cancelled(state_.load(std::memory_order_acquire)); }
 
     Result<void> take_state() override {
         State* st = state_.load(std::memory_order_acquire);
-        if (auto* ex = dynamic_cast<CompletedExceptionally*>(st)) {
+        if (auto* ex = as_completed_exceptionally(st)) {
             return Result<void>::failure(ex->cause);
         }
         return Result<void>::success();
@@ -1662,14 +1873,13 @@ public:
         }
 
         State* state = state_.load(std::memory_order_acquire);
-        if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+        if (auto* ex = as_completed_exceptionally(state)) {
             std::rethrow_exception(ex->cause);
         }
 
         // Check cancellable mode - Kotlin lines 328-334
         if (is_cancellable_mode(this->resume_mode) && context_) {
-            auto job_element = context_->get(Job::type_key);
-            if (auto job = std::dynamic_pointer_cast<Job>(job_element)) {
+            if (Job* job = context_->job_ptr()) {
                 if (!job->is_active()) {
                     std::exception_ptr cause = job->get_cancellation_exception();
                     cancel_completed_result(Result<void>(), cause);
@@ -1727,8 +1937,8 @@ inline void* suspend_cancellable_coroutine(
         }
     };
 
-    auto adapter = std::make_shared<ContinuationAdapter>(continuation);
-    auto impl = std::make_shared<CancellableContinuationImpl<T>>(adapter, 1);
+    auto adapter = internal::make_frame<ContinuationAdapter>(continuation);
+    auto impl = internal::make_frame<CancellableContinuationImpl<T>>(adapter, 1);
     impl->init_cancellability();
 
     // Execute user block with the cancellable continuation
@@ -1760,8 +1970,8 @@ inline void* suspend_cancellable_coroutine<void>(
         }
     };
 
-    auto adapter = std::make_shared<ContinuationAdapter>(continuation);
-    auto impl = std::make_shared<CancellableContinuationImpl<void>>(adapter, 1);
+    auto adapter = internal::make_frame<ContinuationAdapter>(continuation);
+    auto impl = internal::make_frame<CancellableContinuationImpl<void>>(adapter, 1);
     impl->init_cancellability();
 
     block(*impl);
@@ -62,7 +62,7 @@ public:
     // Transliterated from Deferred.kt: override fun getCompleted(): T = getCompletedInternal() as T
     T get_completed() const override {
         void* state = this->state_.load();
-        if (auto* ex = dynamic_cast<CompletedExceptionally*>(static_cast<JobState*>(state))) {
+        if (auto* ex = as_completed_exceptionally(static_cast<JobState*>(state))) {
             std::rethrow_exception(ex->cause);
         }
         if (!this->is_completed()) {
@@ -77,7 +77,7 @@ public:
         if (!this->is_completed()) {
             throw std::logic_error("This deferred value has not completed yet");
         }
-        if (auto* ex = dynamic_cast<CompletedExceptionally*>(static_cast<JobState*>(state))) {
+        if (auto* ex = as_completed_exceptionally(static_cast<JobState*>(state))) {
             return ex->cause;
         }
         return nullptr;
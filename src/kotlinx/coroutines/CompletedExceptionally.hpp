@@ -9,10 +9,37 @@
 
 #include <exception>
 #include <atomic>
+#include <cstdint>
 
 namespace kotlinx {
 namespace coroutines {
 
+/**
+ * @brief Tag of a JobState.
+ *
+ * No Kotlin counterpart: Kotlin tells states apart with `is` checks, which are a class pointer
+ * comparison on the JVM. A `dynamic_cast` walks the type hierarchy instead, so every state
+ * carries its kind and the job state machine checks it with one load.
+ *
+ * The incomplete kinds come first, the inactive ones before the active ones.
+ */
+enum class JobStateKind : std::uint8_t {
+    // Incomplete, not active
+    EMPTY_NEW,
+    INACTIVE_NODE_LIST,
+    // Incomplete, active
+    EMPTY_ACTIVE,
+    NODE_LIST,
+    JOB_NODE,
+    CHILD_HANDLE_NODE,
+    // Incomplete, active until cancelling
+    FINISHING,
+    // Final
+    COMPLETED_EXCEPTIONALLY,
+    INCOMPLETE_BOX,
+    VALUE,
+};
+
 /**
  * @brief Base class for job state representations.
  * 
@@ -21,6 +48,10 @@ namespace coroutines {
  * behavior and data storage.
  */
 struct JobState {
+    /** Set once by the concrete state type; see JobStateKind. */
+    const JobStateKind kind;
+
+    explicit JobState(JobStateKind kind = JobStateKind::VALUE) : kind(kind) {}
     virtual ~JobState() = default;
 };
 
@@ -73,7 +104,7 @@ public:
      * @param handled Whether the exception is initially marked as handled
      */
     CompletedExceptionally(std::exception_ptr cause, bool handled = false) 
-        : cause(cause), handled(handled) {}
+        : JobState(JobStateKind::COMPLETED_EXCEPTIONALLY), cause(cause), handled(handled) {}
         
     /**
      * @brief Copy constructor with atomic load of handled flag.
@@ -81,7 +112,7 @@ public:
      * @param other The CompletedExceptionally to copy from
      */
     CompletedExceptionally(const CompletedExceptionally& other) 
-        : cause(other.cause), handled(other.handled.load()) {}
+        : JobState(JobStateKind::COMPLETED_EXCEPTIONALLY), cause(other.cause), handled(other.handled.load()) {}
 
     /**
      * @brief Atomically marks the exception as handled.
@@ -98,5 +129,18 @@ public:
     }
 };
 
+/**
+ * Kotlin: `state as? CompletedExceptionally`, checked with the state's tag.
+ * [state] may be null (a job completed with a null value).
+ */
+inline CompletedExceptionally* as_completed_exceptionally(JobState* state) {
+    if (state == nullptr || state->kind != JobStateKind::COMPLETED_EXCEPTIONALLY) return nullptr;
+    return static_cast<CompletedExceptionally*>(state);
+}
+
+inline const CompletedExceptionally* as_completed_exceptionally(const JobState* state) {
+    return as_completed_exceptionally(const_cast<JobState*>(state));
+}
+
 } // namespace coroutines
 } // namespace kotlinx
@@ -26,7 +26,7 @@ void* to_state(Result<T> result) {
 // TODO: NOTE: T should be Unit for coroutines that don't return a value, NOT void.
 template<typename T>
 Result<T> recover_result(void* state, Continuation<T>* u_cont) {
-    if (auto* completed_exceptionally = dynamic_cast<CompletedExceptionally*>(static_cast<JobState*>(state))) {
+    if (auto* completed_exceptionally = as_completed_exceptionally(static_cast<JobState*>(state))) {
         return Result<T>::failure(completed_exceptionally->cause);
     } else {
         return Result<T>::success(*static_cast<T*>(state));
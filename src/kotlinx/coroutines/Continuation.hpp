@@ -9,6 +9,7 @@
 
 #include "kotlinx/coroutines/CoroutineContext.hpp"
 #include "kotlinx/coroutines/Result.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 #include <memory>
 #include <functional>
 
@@ -200,7 +201,7 @@ std::shared_ptr<Continuation<T>> make_continuation(
     std::shared_ptr<CoroutineContext> context,
     std::function<void(Result<T>)> resume_withFn
 ) {
-    return std::make_shared<FunctionalContinuation<T>>(
+    return internal::make_frame<FunctionalContinuation<T>>(
         std::move(context),
         std::move(resume_withFn)
     );
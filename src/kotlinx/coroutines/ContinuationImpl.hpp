@@ -17,6 +17,8 @@
 #include "kotlinx/coroutines/context_impl.hpp"
 #include "kotlinx/coroutines/CoroutineContext.hpp"
 #include "kotlinx/coroutines/Result.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
+#include "kotlinx/coroutines/internal/ReusableContinuationSlot.hpp"
 
 namespace kotlinx {
 namespace coroutines {
@@ -37,10 +39,8 @@ using AnyResult = Result<void*>;
  *
  * Transliterated from: internal abstract class BaseContinuationImpl in ContinuationImpl.kt
  *
- * This is the base class that all compiler-generated coroutine state machines inherit from.
- * The key method is resume_with() which runs the invoke_suspend() loop.
- *
- * Transliterated from: internal abstract class BaseContinuationImpl in ContinuationImpl.kt
+ * State machines are allocated by internal::FrameAllocator: `new` goes through the class-level
+ * operators below, and internal::make_frame() also pools the `shared_ptr` control block.
  */
 class BaseContinuationImpl : public Continuation<void*>,
                               public std::enable_shared_from_this<BaseContinuationImpl> {
@@ -54,6 +54,23 @@ public:
 
     virtual ~BaseContinuationImpl() = default;
 
+    static void* operator new(std::size_t size) {
+        return internal::FrameAllocator::allocate(size);
+    }
+
+    static void operator delete(void* frame) noexcept {
+        internal::FrameAllocator::deallocate(frame);
+    }
+
+    // Over-aligned state machines bypass the pool.
+    static void* operator new(std::size_t size, std::align_val_t alignment) {
+        return ::operator new(size, alignment);
+    }
+
+    static void operator delete(void* frame, std::align_val_t alignment) noexcept {
+        ::operator delete(frame, alignment);
+    }
+
     // This implementation is final. This fact is used to unroll resumeWith recursion.
     void resume_with(Result<void*> result) override final {
         // Invoke "resume" debug probe only once, even if previous frames are "resumed" in the loop below, too
@@ -81,7 +98,11 @@ public:
                     return; 
                 }
 
-                outcome = Result<void*>::success(suspend_result);
+                if (suspend_result == &current->forwarded_failure_) {
+                    outcome = Result<void*>::failure(std::move(current->forwarded_failure_));
+                } else {
+                    outcome = Result<void*>::success(suspend_result);
+                }
             } catch (...) {
                 outcome = Result<void*>::failure(std::current_exception());
             }
@@ -124,6 +145,20 @@ public:
         // todo: how continuation shall be rendered?
         return "Continuation @ BaseContinuationImpl";
     }
+
+protected:
+    /**
+     * Completes this frame with [cause] without throwing it: return the result from invoke_suspend.
+     * For frames that only pass on the failure they were resumed with before any user code could
+     * observe it, such as a coroutine cancelled before its block started.
+     */
+    void* forward_failure(std::exception_ptr cause) {
+        forwarded_failure_ = std::move(cause);
+        return &forwarded_failure_;
+    }
+
+private:
+    std::exception_ptr forwarded_failure_;
 };
 
 class RestrictedContinuationImpl : public BaseContinuationImpl {
@@ -165,14 +200,25 @@ public:
         return intercepted_;
     }
 
+    /**
+     * The CancellableContinuationImpl this state machine reuses in
+     * dsl::suspend_cancellable_coroutine_reusable. Kotlin keeps it in the intercepted
+     * DispatchedContinuation; here this is its own intercepted continuation.
+     */
+    internal::ReusableContinuationSlot& reusable_continuation_slot() {
+        return reusable_continuation_slot_;
+    }
+
 protected:
     void release_intercepted() override {
+        reusable_continuation_slot_.clear();
         intercepted_ = nullptr;
     }
 
 private:
     std::shared_ptr<CoroutineContext> context_;
     std::shared_ptr<Continuation<void*>> intercepted_;
+    internal::ReusableContinuationSlot reusable_continuation_slot_;
 };
 
 class CompletedContinuation : public kotlinx::coroutines::Continuation<void*> {
@@ -7,6 +7,7 @@
  * and other types to inherit from NotCompleted without circular includes.
  */
 
+#include <cstdint>
 #include <string>
 
 namespace kotlinx {
@@ -16,20 +17,56 @@ namespace coroutines {
 // State Hierarchy (Faithful to Kotlin "Any" state logic)
 // ------------------------------------------------------------------
 
+/**
+ * Tag of a State, checked with one load instead of a `dynamic_cast` (Kotlin's `is` checks are a
+ * class pointer comparison on the JVM; RTTI walks the hierarchy). The NotCompleted kinds come first.
+ *
+ * No Kotlin counterpart.
+ */
+enum class StateKind : std::uint8_t {
+    // NotCompleted
+    ACTIVE,
+    CANCEL_HANDLER,
+    SEGMENT,
+    NOT_COMPLETED,
+    // Completed
+    COMPLETED_WITH_VALUE,
+    COMPLETED_CONTINUATION,
+    CANCELLED,
+    COMPLETED_EXCEPTION,
+    OTHER,
+};
+
 /**
  * Base class for all states in CancellableContinuationImpl state machine.
  * Corresponds to `Any?` in `_state = atomic<Any?>(Active)`.
  */
 struct State {
+    /**
+     * Set by the constructor of the state type. NotCompleted is a virtual base, so its subclasses
+     * assign it in their constructor bodies, the most derived one last.
+     */
+    StateKind kind = StateKind::OTHER;
+
+    State() = default;
+    explicit State(StateKind kind) : kind(kind) {}
     virtual ~State() = default;
     virtual std::string to_string() const = 0;
 };
 
 // Internal interface NotCompleted
-struct NotCompleted : public virtual State {};
+struct NotCompleted : public virtual State {
+    NotCompleted() { kind = StateKind::NOT_COMPLETED; }
+};
+
+/** Kotlin: `state is NotCompleted`. */
+inline bool is_not_completed(const State* state) {
+    return state != nullptr && state->kind <= StateKind::NOT_COMPLETED;
+}
 
 struct Active : public NotCompleted {
     static Active instance;
+    Active() { kind = StateKind::ACTIVE; }
     std::string to_string() const override { return "Active"; }
 };
 inline Active Active::instance;
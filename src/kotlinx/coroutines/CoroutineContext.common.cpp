@@ -5,8 +5,12 @@
 // TODO: @InternalCoroutinesApi, @PublishedApi - no C++ equivalents
 
 #include "kotlinx/coroutines/Continuation.hpp"
+#include "kotlinx/coroutines/ContinuationInterceptor.hpp"
+#include "kotlinx/coroutines/CoroutineExceptionHandler.hpp"
 #include "kotlinx/coroutines/CoroutineName.hpp"
 #include "kotlinx/coroutines/CoroutineScope.hpp"
+#include "kotlinx/coroutines/Delay.hpp"
+#include "kotlinx/coroutines/Job.hpp"
 #include <string>
 #include <functional>
 #include "kotlinx/coroutines/context_impl.hpp"
@@ -14,19 +18,144 @@
 namespace kotlinx {
     namespace coroutines {
         std::shared_ptr<CoroutineContext> CoroutineContext::operator+(std::shared_ptr<CoroutineContext> other) const {
-            if (!other) return std::const_pointer_cast<CoroutineContext>(shared_from_this());
-
-            return other->fold<std::shared_ptr<CoroutineContext> >(
-                std::const_pointer_cast<CoroutineContext>(shared_from_this()),
-                [](std::shared_ptr<CoroutineContext> acc, std::shared_ptr<Element> element) {
-                    auto removed = acc->minus_key(element->key());
-                    if (!removed) {
-                        return std::static_pointer_cast<CoroutineContext>(element);
-                    }
-                    return std::static_pointer_cast<CoroutineContext>(
-                        std::make_shared<CombinedContext>(removed, element));
+            auto self = std::const_pointer_cast<CoroutineContext>(shared_from_this());
+            if (!other) return self;
+            if (auto *flat = dynamic_cast<const FlatCoroutineContext *>(this)) return flat->plus_memoized(other);
+            return FlatCoroutineContext::plus(self, *other);
+        }
+
+        Job *CoroutineContext::job_ptr() const {
+            return dynamic_cast<Job *>(get(Job::type_key).get());
+        }
+
+        ContinuationInterceptor *CoroutineContext::interceptor_ptr() const {
+            return dynamic_cast<ContinuationInterceptor *>(get(ContinuationInterceptor::type_key).get());
+        }
+
+        Delay *CoroutineContext::delay_ptr() const {
+            return dynamic_cast<Delay *>(get(ContinuationInterceptor::type_key).get());
+        }
+
+        FlatCoroutineContext::FlatCoroutineContext(std::vector<std::shared_ptr<Element>> elements)
+            : elements_(std::move(elements)) {
+            for (int &slot: slots_) slot = -1;
+            for (std::size_t i = 0; i < elements_.size(); ++i) {
+                const int slot = slot_of(elements_[i]->key());
+                if (slot >= 0) slots_[slot] = static_cast<int>(i);
+            }
+            // Resolved once, so that the resume path reads a pointer instead of casting.
+            if (slots_[JOB_SLOT] >= 0) {
+                job_ = dynamic_cast<Job *>(elements_[slots_[JOB_SLOT]].get());
+            }
+            if (slots_[INTERCEPTOR_SLOT] >= 0) {
+                Element *interceptor = elements_[slots_[INTERCEPTOR_SLOT]].get();
+                interceptor_ = dynamic_cast<ContinuationInterceptor *>(interceptor);
+                delay_ = dynamic_cast<Delay *>(interceptor);
+            }
+        }
+
+        int FlatCoroutineContext::slot_of(Key *key) {
+            if (key == Job::type_key) return JOB_SLOT;
+            if (key == ContinuationInterceptor::type_key) return INTERCEPTOR_SLOT;
+            if (key == CoroutineName::type_key) return NAME_SLOT;
+            if (key == CoroutineExceptionHandler::type_key) return EXCEPTION_HANDLER_SLOT;
+            return -1;
+        }
+
+        std::shared_ptr<CoroutineContext> FlatCoroutineContext::plus(const std::shared_ptr<CoroutineContext> &left,
+                                                                     const CoroutineContext &right) {
+            std::vector<std::shared_ptr<Element>> added;
+            right.for_each([&added](std::shared_ptr<Element> element) {
+                if (element) added.push_back(std::move(element));
+            });
+            if (added.empty()) return left;
+
+            // Kotlin: right.fold(left) { acc, element -> acc.minusKey(element.key) + element }
+            std::vector<std::shared_ptr<Element>> elements;
+            left->for_each([&elements, &added](std::shared_ptr<Element> element) {
+                if (!element) return;
+                for (const auto &replacement: added) {
+                    if (replacement->key() == element->key()) return;
+                }
+                elements.push_back(std::move(element));
+            });
+            for (auto &element: added) elements.push_back(std::move(element));
+            if (elements.size() == 1) return elements.front();
+            return std::make_shared<FlatCoroutineContext>(std::move(elements));
+        }
+
+        std::shared_ptr<FlatCoroutineContext> FlatCoroutineContext::with_borrowed_element(
+            const CoroutineContext &left, Element &element, std::weak_ptr<const void> owner) {
+            std::vector<std::shared_ptr<Element>> elements;
+            Key *key = element.key();
+            left.for_each([&elements, key](std::shared_ptr<Element> existing) {
+                if (existing && existing->key() != key) elements.push_back(std::move(existing));
+            });
+            const int index = static_cast<int>(elements.size());
+            // Aliasing an empty shared_ptr: a pointer that owns nothing.
+            elements.push_back(std::shared_ptr<Element>(std::shared_ptr<Element>(), &element));
+            auto context = std::make_shared<FlatCoroutineContext>(std::move(elements));
+            context->borrowed_index_ = index;
+            context->borrowed_owner_ = std::move(owner);
+            return context;
+        }
+
+        std::shared_ptr<CoroutineContext::Element> FlatCoroutineContext::element_at(int index) const {
+            const auto &element = elements_[index];
+            if (index != borrowed_index_) return element;
+            auto owner = borrowed_owner_.lock();
+            if (!owner) return nullptr;
+            return std::shared_ptr<Element>(std::move(owner), element.get());
+        }
+
+        std::shared_ptr<CoroutineContext::Element> FlatCoroutineContext::get(Key *key) const {
+            const int slot = slot_of(key);
+            if (slot >= 0) return slots_[slot] >= 0 ? element_at(slots_[slot]) : nullptr;
+            for (std::size_t i = 0; i < elements_.size(); ++i) {
+                if (elements_[i]->key() == key) return element_at(static_cast<int>(i));
+            }
+            return nullptr;
+        }
+
+        void FlatCoroutineContext::for_each(std::function<void(std::shared_ptr<Element>)> callback) const {
+            for (std::size_t i = 0; i < elements_.size(); ++i) {
+                if (auto element = element_at(static_cast<int>(i))) callback(std::move(element));
+            }
+        }
+
+        std::shared_ptr<CoroutineContext> FlatCoroutineContext::minus_key(Key *key) const {
+            int removed = -1;
+            for (std::size_t i = 0; i < elements_.size(); ++i) {
+                if (elements_[i]->key() == key) removed = static_cast<int>(i);
+            }
+            if (removed < 0) return std::const_pointer_cast<CoroutineContext>(shared_from_this());
+            std::vector<std::shared_ptr<Element>> rest;
+            for (std::size_t i = 0; i < elements_.size(); ++i) {
+                if (static_cast<int>(i) == removed) continue;
+                if (auto element = element_at(static_cast<int>(i))) rest.push_back(std::move(element));
+            }
+            if (rest.empty()) return nullptr; // nullptr represents EmptyCoroutineContext here
+            if (rest.size() == 1) return rest.front();
+            return std::make_shared<FlatCoroutineContext>(std::move(rest));
+        }
+
+        std::shared_ptr<CoroutineContext> FlatCoroutineContext::plus_memoized(
+            const std::shared_ptr<CoroutineContext> &other) const {
+            {
+                // Contexts are immutable: while [other] is alive, the sum does not change.
+                std::unique_lock<std::mutex> lock(memo_mutex_, std::try_to_lock);
+                if (lock.owns_lock() && memo_other_ == other.get() && !memo_other_ref_.expired()) {
+                    if (auto result = memo_result_.lock()) return result;
                 }
-            );
+            }
+            auto result = plus(std::const_pointer_cast<CoroutineContext>(shared_from_this()), *other);
+            std::unique_lock<std::mutex> lock(memo_mutex_, std::try_to_lock);
+            if (lock.owns_lock()) {
+                memo_other_ = other.get();
+                memo_other_ref_ = other;
+                memo_result_ = result;
+            }
+            return result;
         }
 
         // TODO: import kotlin.coroutines.* - use custom coroutine types
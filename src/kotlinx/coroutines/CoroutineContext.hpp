@@ -6,6 +6,10 @@
 namespace kotlinx {
 namespace coroutines {
 
+struct Job;
+struct ContinuationInterceptor;
+class Delay;
+
 /**
  * @file CoroutineContext.hpp
  * @brief Coroutine context system for kotlinx.coroutines-cpp
@@ -124,6 +128,18 @@ public:
      * @return A new context without the specified element
      */
     virtual std::shared_ptr<CoroutineContext> minus_key(Key* key) const = 0;
+
+    /**
+     * Kotlin: `context[Job]`, without taking a reference: the context keeps the job alive.
+     * A single load on a [FlatCoroutineContext]; other contexts look the key up.
+     */
+    virtual Job* job_ptr() const;
+
+    /** Kotlin: `context[ContinuationInterceptor]`, without taking a reference (see [job_ptr]). */
+    virtual ContinuationInterceptor* interceptor_ptr() const;
+
+    /** Kotlin: `context[ContinuationInterceptor] as? Delay`, without taking a reference (see [job_ptr]). */
+    virtual Delay* delay_ptr() const;
 };
 
 /**
@@ -15,33 +15,40 @@
 // kotlinx.coroutines.internal.* (from Kotlin)
 #include "kotlinx/coroutines/internal/DispatchedContinuation.hpp"
 #include "kotlinx/coroutines/internal/DispatchedTask.hpp"
+#include "kotlinx/coroutines/internal/IntrusiveTaskQueue.hpp"
 #include "kotlinx/coroutines/internal/Symbol.hpp"
 #include <mutex>
-#include <queue>
+#include <vector>
 #include <atomic>
 #include <iostream>
 
 namespace kotlinx {
     namespace coroutines {
-        // Internal LimitedDispatcher implementation
+        /**
+         * The result of limited_parallelism: runs the tasks dispatched to it on at most [parallelism]
+         * "worker-loop" tasks of the underlying dispatcher.
+         *
+         * Kotlin: internal class LimitedDispatcher(dispatcher, parallelism, name) (internal/LimitedDispatcher.kt)
+         *
+         * A dispatch allocates nothing: tasks wait in an intrusive queue, and the workers are created
+         * once (at most [parallelism] of them) and reused whenever a worker loop has to be started.
+         */
         class LimitedDispatcher : public CoroutineDispatcher {
+            /** Kotlin: the worker re-dispatches itself after this many tasks to let others run. */
+            static constexpr int FAIRNESS_BATCH = 16;
+
+            struct Worker;
+
             std::shared_ptr<CoroutineDispatcher> dispatcher;
             int parallelism;
             std::string name;
 
-            // Semantics:
-            // We need to limit concurrent tasks.
-            // Simplified implementation: internal queue + atomic counter.
-            // Real implementation would be more complex lock-free.
-
-            struct Task {
-                std::shared_ptr<Runnable> block;
-                std::shared_ptr<const CoroutineContext> context;
-            };
-
-            mutable std::mutex lock;
-            mutable std::queue<Task> queue;
-            mutable int running_workers = 0;
+            mutable internal::IntrusiveTaskQueue queue;
+            // Serializes the consumers of [queue] when there can be more than one running worker.
+            mutable std::mutex consume_lock;
+            mutable std::atomic<int> running_workers{0};
+            mutable std::mutex worker_allocation_lock;
+            mutable std::vector<std::shared_ptr<Worker>> idle_workers; // guarded by worker_allocation_lock
 
         public:
             LimitedDispatcher(std::shared_ptr<CoroutineDispatcher> dispatcher, int parallelism, std::string name)
@@ -49,82 +56,156 @@ namespace kotlinx {
             }
 
             void dispatch(const CoroutineContext &context, std::shared_ptr<Runnable> block) const override {
-                {
-                    std::lock_guard<std::mutex> g(lock);
-                    if (running_workers < parallelism) {
-                        running_workers++;
-                        // Dispatch directly to the underlying dispatcher
-                        // wrapper to decrement on completion
-                        // Dispatch directly to the underlying dispatcher
-                        // wrapper to decrement on completion
-                        auto self = std::dynamic_pointer_cast<LimitedDispatcher>(
-                            const_cast<LimitedDispatcher *>(this)->shared_from_this());
-                        auto worker = std::make_shared<Worker>(self, block);
-                        dispatcher->dispatch(context, worker);
-                        return;
+                if (auto worker = dispatch_internal(std::move(block))) {
+                    try {
+                        dispatcher->dispatch(*this, std::move(worker));
+                    } catch (...) {
+                        // Without the decrement the target parallelism could never be reached again.
+                        running_workers.fetch_sub(1);
+                        throw;
+                    }
+                }
+            }
+
+            void dispatch_yield(const CoroutineContext &context, std::shared_ptr<Runnable> block) const override {
+                if (auto worker = dispatch_internal(std::move(block))) {
+                    try {
+                        dispatcher->dispatch_yield(*this, std::move(worker));
+                    } catch (...) {
+                        running_workers.fetch_sub(1);
+                        throw;
                     }
-                    // Queue it
-                    queue.push({block, context.shared_from_this()}); // Capture context safely
                 }
             }
 
-            void on_worker_complete() {
-                // Check queue for more work
-                std::shared_ptr<Runnable> next_block;
-                // next_context removed as it was trying to instantiate abstract class
+            void dispatch_batch(std::vector<DispatchRequest> &requests) const override {
+                // Queue everything first; the workers this starts are handed over as a batch too.
+                for (auto &request: requests) queue.add_last(std::move(request.block));
+                std::vector<DispatchRequest> started;
+                while (static_cast<int>(started.size()) < static_cast<int>(requests.size()) &&
+                       running_workers.load() < parallelism) {
+                    if (!try_allocate_worker()) break;
+                    auto task = obtain_task_or_deallocate_worker();
+                    if (!task) break;
+                    started.push_back({this, start_worker(std::move(task))});
+                }
+                if (started.empty()) return;
+                try {
+                    dispatcher->dispatch_batch(started);
+                } catch (...) {
+                    running_workers.fetch_sub(static_cast<int>(started.size()));
+                    throw;
+                }
+            }
 
+            std::string to_string() const override {
+                return name.empty() ? "LimitedDispatcher" : name;
+            }
+
+        private:
+            // Kotlin: private inline fun dispatchInternal(block: Runnable, startWorker: (Worker) -> Unit)
+            std::shared_ptr<Runnable> dispatch_internal(std::shared_ptr<Runnable> block) const {
+                // Add task to queue so running workers will be able to see that
+                queue.add_last(std::move(block));
+                if (running_workers.load() >= parallelism) return nullptr;
+                // Allocation may fail if some workers were launched in parallel or a worker temporarily
+                // decreased `running_workers` when it observed an empty queue.
+                if (!try_allocate_worker()) return nullptr;
+                auto task = obtain_task_or_deallocate_worker();
+                if (!task) return nullptr;
+                return start_worker(std::move(task));
+            }
+
+            // Kotlin: private fun tryAllocateWorker(): Boolean
+            bool try_allocate_worker() const {
+                std::lock_guard<std::mutex> g(worker_allocation_lock);
+                if (running_workers.load() >= parallelism) return false;
+                running_workers.fetch_add(1);
+                return true;
+            }
+
+            std::shared_ptr<Runnable> poll() const {
+                if (parallelism == 1) return queue.remove_first_or_null(); // at most one worker consumes
+                std::lock_guard<std::mutex> g(consume_lock);
+                return queue.remove_first_or_null();
+            }
+
+            // Kotlin: private fun obtainTaskOrDeallocateWorker(): Runnable?
+            std::shared_ptr<Runnable> obtain_task_or_deallocate_worker(Worker *releasing = nullptr) const {
+                while (true) {
+                    if (auto next_task = poll()) return next_task;
+                    std::lock_guard<std::mutex> g(worker_allocation_lock);
+                    running_workers.fetch_sub(1);
+                    if (queue.size() == 0) {
+                        if (releasing != nullptr) idle_workers.push_back(releasing->self.lock());
+                        return nullptr;
+                    }
+                    running_workers.fetch_add(1);
+                }
+            }
+
+            /** Takes an idle worker (or creates one) for [task]; holds a running-worker permit. */
+            std::shared_ptr<Worker> start_worker(std::shared_ptr<Runnable> task) const {
+                auto self = std::dynamic_pointer_cast<const LimitedDispatcher>(shared_from_this());
+                std::shared_ptr<Worker> worker;
                 {
-                    std::lock_guard<std::mutex> g(lock);
-                    if (queue.empty()) {
-                        running_workers--;
-                        return;
+                    std::lock_guard<std::mutex> g(worker_allocation_lock);
+                    if (!idle_workers.empty()) {
+                        worker = std::move(idle_workers.back());
+                        idle_workers.pop_back();
                     }
-                    auto task = queue.front();
-                    queue.pop();
-                    next_block = task.block;
-                    // next_context = task.context; 
-                    // We need to dispatch this.
-
-                    // Re-dispatch:
-                    // running_workers stays same (we took one out, put one in)
-                    // Re-dispatch:
-                    // running_workers stays same (we took one out, put one in)
-                    // Re-dispatch:
-                    // running_workers stays same (we took one out, put one in)
-                    auto self = std::dynamic_pointer_cast<LimitedDispatcher>(shared_from_this());
-                    auto worker = std::make_shared<Worker>(self, next_block);
-                    dispatcher->dispatch(*task.context, worker);
                 }
+                if (!worker) {
+                    worker = std::make_shared<Worker>();
+                    worker->self = worker;
+                }
+                worker->parent = std::move(self);
+                worker->current_task = std::move(task);
+                return worker;
             }
 
+            /**
+             * Kotlin: private inner class Worker(private var currentTask: Runnable) : Runnable
+             *
+             * Reused: a worker that runs out of tasks parks itself in the dispatcher's idle list. While it
+             * is started, it keeps the dispatcher alive through [parent]; an idle worker does not.
+             */
             struct Worker : public Runnable {
-                std::shared_ptr<CoroutineDispatcher> parent; // actually LimitedDispatcher
-                std::shared_ptr<Runnable> wrapped;
-
-                Worker(std::shared_ptr<CoroutineDispatcher> parent, std::shared_ptr<Runnable> wrapped)
-                    : parent(parent), wrapped(wrapped) {
-                }
+                std::weak_ptr<Worker> self;
+                std::shared_ptr<const LimitedDispatcher> parent;
+                std::shared_ptr<Runnable> current_task;
 
                 void run() override {
-                    try {
-                        wrapped->run();
-                    } catch (const std::exception& e) {
-                        // Uncaught exception in dispatched task - report to stderr
-                        // TODO(port): Forward to CoroutineExceptionHandler when available
-                        std::cerr << "Uncaught exception in LimitedDispatcher task: " << e.what() << std::endl;
-                    } catch (...) {
-                        std::cerr << "Uncaught unknown exception in LimitedDispatcher task" << std::endl;
+                    // Once this worker is back among the idle ones another thread may restart it,
+                    // so the loop only works on locals.
+                    std::shared_ptr<const LimitedDispatcher> limited = std::move(parent);
+                    std::shared_ptr<Runnable> task = std::move(current_task);
+                    int fairness_counter = 0;
+                    while (true) {
+                        try {
+                            task->run();
+                        } catch (const std::exception &e) {
+                            // Uncaught exception in dispatched task - report to stderr
+                            // TODO(port): Forward to CoroutineExceptionHandler when available
+                            std::cerr << "Uncaught exception in LimitedDispatcher task: " << e.what() << std::endl;
+                        } catch (...) {
+                            std::cerr << "Uncaught unknown exception in LimitedDispatcher task" << std::endl;
+                        }
+                        task = limited->obtain_task_or_deallocate_worker(this);
+                        if (!task) return;
+                        // 16 is our out-of-thin-air constant to emulate fairness. Used in JS dispatchers as well
+                        if (++fairness_counter >= FAIRNESS_BATCH && limited->dispatcher->is_dispatch_needed(*limited)) {
+                            // Do "yield" to let other views execute their runnable as well
+                            // Note that we do not decrement 'runningWorkers' as we are still committed to our part of work
+                            const CoroutineDispatcher &underlying = *limited->dispatcher;
+                            current_task = std::move(task);
+                            parent = limited;
+                            underlying.dispatch(*limited, self.lock());
+                            return;
+                        }
                     }
-                    // Notify completion
-                    // We need to cast back to LimitedDispatcher
-                    auto limited = std::static_pointer_cast<LimitedDispatcher>(parent);
-                    limited->on_worker_complete();
                 }
             };
-
-            std::string to_string() const override {
-                return name.empty() ? "LimitedDispatcher" : name;
-            }
         };
 
         // CoroutineDispatcher implementation
@@ -143,6 +224,12 @@ namespace kotlinx {
             dispatch(context, block);
         }
 
+        void CoroutineDispatcher::dispatch_batch(std::vector<DispatchRequest> &requests) const {
+            for (auto &request: requests) {
+                dispatch(*request.context, std::move(request.block));
+            }
+        }
+
         // Template method intercept_continuation is in header
 
         // Explicit instantiation for common types if needed, or keep in header if possible.
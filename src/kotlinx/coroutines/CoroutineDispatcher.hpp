@@ -9,6 +9,7 @@
 
 #include <string>
 #include <memory>
+#include <vector>
 #include "kotlinx/coroutines/context_impl.hpp"
 #include "kotlinx/coroutines/ContinuationInterceptor.hpp"
 #include "kotlinx/coroutines/Runnable.hpp"
@@ -17,6 +18,15 @@
 namespace kotlinx {
 namespace coroutines {
 
+/**
+ * A runnable block together with the context it is dispatched in.
+ * The unit of work of CoroutineDispatcher::dispatch_batch.
+ */
+struct DispatchRequest {
+    const CoroutineContext* context;
+    std::shared_ptr<Runnable> block;
+};
+
 /**
  * Base class to be extended by all coroutine dispatcher implementations.
  *
@@ -126,6 +136,19 @@ public:
      * public open fun dispatchYield(context: CoroutineContext, block: Runnable): Unit = dispatch(context, block)
      */
     virtual void dispatch_yield(const CoroutineContext& context, std::shared_ptr<Runnable> block) const;
+
+    /**
+     * Dispatches several runnable blocks at once, each in its own context, with the same guarantees
+     * as calling dispatch for every one of them in order. The blocks are moved out of [requests].
+     *
+     * The default implementation does exactly that. Dispatchers backed by a shared queue should
+     * override it to enqueue the whole batch under one lock and to wake no more threads than
+     * the batch can keep busy.
+     *
+     * It is used when one event resumes many coroutines at once, such as a job completing with
+     * many awaiters or a shared flow emission; see internal::DispatchBatchScope.
+     */
+    virtual void dispatch_batch(std::vector<DispatchRequest>& requests) const;
     
     // ContinuationInterceptor overrides
     CoroutineContext::Key* key() const override { return ContinuationInterceptor::type_key; }
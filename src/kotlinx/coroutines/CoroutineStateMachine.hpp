@@ -137,9 +137,9 @@ public:
     void* invoke_suspend(Result<void*> result) override {
         result_ = std::move(result);
 
-        // Check for exception from previous resumption
+        // Check for exception from previous resumption; the block has not run, so pass it on unthrown
         if (result_.is_failure()) {
-            std::rethrow_exception(result_.exception_or_null());
+            return forward_failure(result_.exception_or_null());
         }
 
         // Run the block - if it contains suspend calls that actually suspend,
@@ -185,7 +185,7 @@ std::shared_ptr<BlockStateMachine<R, T>> create_coroutine(
     R receiver,
     std::shared_ptr<Continuation<void*>> completion
 ) {
-    return std::make_shared<BlockStateMachine<R, T>>(
+    return internal::make_frame<BlockStateMachine<R, T>>(
         std::move(block),
         receiver,
         std::move(completion)
@@ -47,12 +47,8 @@ namespace kotlinx {
                 auto context = cont.get_context();
                 // 2. Look for Delay interface in context (Dispatcher implements Delay?)
                 // In Kotlin: context[ContinuationInterceptor] as? Delay
-                // In C++: dynamic_cast
-                Delay *delay_impl = nullptr;
-                auto element = context->get(ContinuationInterceptor::type_key);
-                if (element) {
-                    delay_impl = dynamic_cast<Delay *>(element.get());
-                }
+                // In C++: resolved once when the context is built
+                Delay *delay_impl = context->delay_ptr();
 
                 if (delay_impl) {
                     if (time_millis < std::numeric_limits<long long>::max()) {
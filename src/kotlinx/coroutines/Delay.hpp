@@ -14,8 +14,6 @@
 #include "kotlinx/coroutines/Runnable.hpp"
 #include "kotlinx/coroutines/DisposableHandle.hpp"
 #include <memory>
-
-#include "kotlinx/coroutines/CancellableContinuationImpl.hpp"
 #include <chrono>
 #include <string>
 
@@ -134,3 +132,7 @@ void* await_cancellation(std::shared_ptr<Continuation<void*>> continuation);
 
 } // namespace coroutines
 } // namespace kotlinx
+
+// Included last: CancellableContinuationImpl.hpp pulls in EventLoop.hpp, whose
+// BlockingEventLoop implements Delay and therefore needs the complete class above.
+#include "kotlinx/coroutines/CancellableContinuationImpl.hpp"
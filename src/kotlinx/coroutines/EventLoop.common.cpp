@@ -7,6 +7,8 @@
  */
 
 #include "kotlinx/coroutines/EventLoop.hpp"
+#include <algorithm>
+#include <chrono>
 
 namespace kotlinx {
     namespace coroutines {
@@ -94,43 +96,214 @@ namespace kotlinx {
             event_loop = eventLoop.get();
         }
 
+        // DelayedTask Implementation
+
+        namespace {
+            // Kotlin: internal inline fun nanoTime(): Long
+            long long nano_time() {
+                return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count();
+            }
+
+            // Kotlin: internal fun delayToNanos(timeMillis: Long): Long
+            long long delay_to_nanos(long long time_millis) {
+                constexpr long long MAX_MS = LLONG_MAX / 1'000'000;
+                if (time_millis <= 0) return 0;
+                if (time_millis >= MAX_MS) return LLONG_MAX;
+                return time_millis * 1'000'000;
+            }
+
+            long long deadline_after(long long time_millis) {
+                const long long now = nano_time();
+                const long long nanos = delay_to_nanos(time_millis);
+                return nanos > LLONG_MAX - now ? LLONG_MAX : now + nanos;
+            }
+
+            // Kotlin: private inner class DelayedResumeTask
+            struct DelayedResumeTask : public DelayedTask {
+                BlockingEventLoop *loop;
+                std::shared_ptr<CancellableContinuationImpl<void>> cont;
+
+                DelayedResumeTask(long long nano_time, BlockingEventLoop *loop,
+                                  std::shared_ptr<CancellableContinuationImpl<void>> cont)
+                    : DelayedTask(nano_time), loop(loop), cont(std::move(cont)) {
+                }
+
+                // Kotlin: override fun run() { with(cont) { resumeUndispatched(Unit) } }
+                void run() override { cont->resume_undispatched(loop); }
+            };
+
+            // Kotlin: private class DelayedRunnableTask
+            struct DelayedRunnableTask : public DelayedTask {
+                std::shared_ptr<Runnable> block;
+
+                DelayedRunnableTask(long long nano_time, std::shared_ptr<Runnable> block)
+                    : DelayedTask(nano_time), block(std::move(block)) {
+                }
+
+                void run() override { block->run(); }
+            };
+
+            // Kotlin: DefaultExecutor.schedule(now, delayedTask), from rescheduleAllDelayed()
+            struct RescheduledTask : public Runnable {
+                std::shared_ptr<DelayedTask> task;
+
+                explicit RescheduledTask(std::shared_ptr<DelayedTask> task) : task(std::move(task)) {
+                }
+
+                void run() override {
+                    if (!task->disposed.load()) task->run();
+                }
+            };
+        } // namespace
+
+        void DelayedTask::dispose() {
+            disposed.store(true);
+            DelayedTaskQueue *q = queue.exchange(nullptr);
+            if (q == nullptr) return;
+            // Only the thread that actually unlinks the task releases the self-reference.
+            if (q->remove(this)) {
+                std::shared_ptr<DelayedTask> self = std::move(keep_alive);
+            }
+        }
+
         // BlockingEventLoop Implementation
 
         BlockingEventLoop::BlockingEventLoop(std::shared_ptr<std::thread> t) : thread(t) {
         }
 
+        BlockingEventLoop::~BlockingEventLoop() {
+            BlockingEventLoop::shutdown();
+            while (Runnable *task = task_queue.remove_first_or_null()) {
+                internal::release_queued(task);
+            }
+        }
+
         void BlockingEventLoop::dispatch(const CoroutineContext& context, std::shared_ptr<Runnable> block) const {
+            task_queue.add_last(internal::retain_queued(std::move(block)));
+            unpark();
+        }
+
+        void BlockingEventLoop::unpark() const {
+            // Pairs with the fence in run(): either the loop sees the new task before it waits,
+            // or this sees [parked] and notifies under the lock the loop waits with.
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!parked.load(std::memory_order_relaxed)) return;
+            std::lock_guard<std::mutex> lock(mtx);
+            cv.notify_one();
+        }
+
+        void BlockingEventLoop::schedule(std::shared_ptr<DelayedTask> task) {
+            DelayedTask *raw = task.get();
+            raw->keep_alive = std::move(task);
+            raw->queue.store(&delayed_queue);
+            bool earliest;
             {
                 std::lock_guard<std::mutex> lock(mtx);
-                // We need to cast away constness to push to queue if we keep task_queue mutable or use current implementation
-                // Actually `dispatch` is const in CoroutineDispatcher parent.
-                const_cast<BlockingEventLoop *>(this)->task_queue.push_back(block);
+                if (quit) {
+                    raw->queue.store(nullptr);
+                    std::shared_ptr<DelayedTask> self = std::move(raw->keep_alive);
+                    return;
+                }
+                delayed_queue.add_last(raw);
+                earliest = delayed_queue.peek() == raw;
+            }
+            // Kotlin: if (shouldUnpark(delayedTask)) unpark()
+            if (earliest) cv.notify_one();
+        }
+
+        void BlockingEventLoop::schedule_resume_after_delay(
+            long long time_millis, CancellableContinuation<void>& continuation) {
+            if (time_millis <= 0) {
+                continuation.resume(nullptr);
+                return;
+            }
+            auto *impl_ptr = dynamic_cast<CancellableContinuationImpl<void> *>(&continuation);
+            if (!impl_ptr) {
+                get_default_delay().schedule_resume_after_delay(time_millis, continuation);
+                return;
+            }
+            auto task = std::make_shared<DelayedResumeTask>(
+                deadline_after(time_millis), this, impl_ptr->shared_from_this());
+            schedule(task);
+            // Kotlin: continuation.disposeOnCancellation(task)
+            continuation.invoke_on_cancellation([task](std::exception_ptr) {
+                task->dispose();
+            });
+        }
+
+        std::shared_ptr<DisposableHandle> BlockingEventLoop::invoke_on_timeout(
+            long long time_millis,
+            std::shared_ptr<Runnable> block,
+            const CoroutineContext& context) {
+            auto task = std::make_shared<DelayedRunnableTask>(deadline_after(time_millis), std::move(block));
+            schedule(task);
+            return task;
+        }
+
+        void BlockingEventLoop::enqueue_due_delayed_tasks() {
+            if (delayed_queue.is_empty()) return;
+            const long long now = nano_time();
+            while (true) {
+                DelayedTask *due = delayed_queue.remove_first_if([now](DelayedTask *task) {
+                    return task->time_to_execute(now);
+                });
+                if (!due) break;
+                due->queue.store(nullptr);
+                task_queue.add_last(internal::retain_queued(std::move(due->keep_alive)));
             }
-            cv.notify_one();
         }
 
         long long BlockingEventLoop::process_next_event() {
             // Process unconfined first
             if (EventLoop::process_unconfined_event()) return 0;
 
-            std::shared_ptr<Runnable> task;
-            {
-                std::unique_lock<std::mutex> lock(mtx);
-                if (task_queue.empty()) return LLONG_MAX; // No events
-                task = task_queue.front();
-                task_queue.pop_front();
-            }
-            task->run();
+            // Kotlin: queue all delayed tasks that are due to be executed
+            enqueue_due_delayed_tasks();
+
+            Runnable *task = task_queue.remove_first_or_null();
+            if (!task) return next_time();
+            internal::release_queued(task)->run();
             return 0;
         }
 
+        bool BlockingEventLoop::is_empty() const {
+            if (!is_unconfined_queue_empty()) return false;
+            if (!delayed_queue.is_empty()) return false;
+            return task_queue.is_empty();
+        }
+
+        long long BlockingEventLoop::next_time() const {
+            if (EventLoop::next_time() == 0) return 0;
+            // Also counts a task whose producer is still adding it, so [run] comes back for it.
+            if (!task_queue.is_empty()) return 0;
+            DelayedTask *next = const_cast<DelayedTaskQueue &>(delayed_queue).peek();
+            if (!next) return LLONG_MAX;
+            return std::max(0LL, next->nano_time - nano_time());
+        }
+
         void BlockingEventLoop::run() {
             while (!quit) {
-                if (process_next_event() == LLONG_MAX) {
-                    // Wait
-                    std::unique_lock<std::mutex> lock(mtx);
-                    cv.wait(lock, [this] { return quit || !task_queue.empty(); });
+                const long long park_nanos = process_next_event();
+                if (park_nanos <= 0) continue;
+                std::unique_lock<std::mutex> lock(mtx);
+                parked.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                // [park_nanos] was read without the lock: schedule() may have added an earlier
+                // delayed task since and notified before this waits. It adds under the lock, so
+                // the deadline taken here is current and a later schedule() finds this waiting.
+                const long long wait_nanos = quit ? 0 : next_time();
+                if (wait_nanos <= 0) {
+                    parked.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+                if (wait_nanos == LLONG_MAX) {
+                    // Woken by dispatch() or by schedule() of a new earliest delayed task.
+                    cv.wait(lock);
+                } else {
+                    cv.wait_until(lock, std::chrono::steady_clock::now() + std::chrono::nanoseconds(wait_nanos));
                 }
+                parked.store(false, std::memory_order_relaxed);
             }
         }
 
@@ -140,6 +313,20 @@ namespace kotlinx {
                 quit = true;
             }
             cv.notify_all();
+            // Kotlin: rescheduleAllDelayed() -- the delayed tasks still pending move to DefaultExecutor,
+            // so a delay() or with_timeout() started on this loop still fires after the loop is gone.
+            // Due tasks wait at least a millisecond so that none runs inside shutdown().
+            const long long now = nano_time();
+            while (DelayedTask *task = delayed_queue.remove_first_or_null()) {
+                task->queue.store(nullptr);
+                std::shared_ptr<DelayedTask> self = std::move(task->keep_alive);
+                const long long remaining_nanos = task->nano_time - now;
+                const long long remaining_millis =
+                    std::max(1LL, remaining_nanos / 1'000'000 + (remaining_nanos % 1'000'000 > 0));
+                get_default_delay().invoke_on_timeout(
+                    remaining_millis, std::make_shared<RescheduledTask>(std::move(self)),
+                    *EmptyCoroutineContext::instance());
+            }
         }
     } // namespace coroutines
-} // namespace kotlinx
\ No newline at end of file
+} // namespace kotlinx
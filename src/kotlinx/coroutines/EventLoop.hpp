@@ -56,23 +56,107 @@ struct ThreadLocalEventLoop {
     static thread_local EventLoop* event_loop;
 };
 
+} // namespace coroutines
+} // namespace kotlinx
+
+// Included after EventLoop/ThreadLocalEventLoop: Delay.hpp pulls in CancellableContinuationImpl.hpp,
+// which (through DispatchedContinuation.hpp) needs the declarations above.
+#include "kotlinx/coroutines/Delay.hpp"
+#include "kotlinx/coroutines/internal/LockFreeTaskQueue.hpp"
+#include "kotlinx/coroutines/internal/ThreadSafeHeap.hpp"
+
+namespace kotlinx {
+namespace coroutines {
+
+/**
+ * A task scheduled on an event loop for a point in time.
+ *
+ * While queued, the task keeps itself alive through [keep_alive]; the strong reference is
+ * released by whoever removes it from the queue (the loop when it becomes due, or [dispose]).
+ *
+ * Transliterated from:
+ * internal abstract class DelayedTask(@JvmField var nanoTime: Long) :
+ *     Runnable, Comparable<DelayedTask>, DisposableHandle, ThreadSafeHeapNode
+ */
+struct DelayedTask : public Runnable, public DisposableHandle, public internal::ThreadSafeHeapNode {
+    long long nano_time;
+    std::atomic<internal::ThreadSafeHeap<DelayedTask>*> queue{nullptr};
+    std::shared_ptr<DelayedTask> keep_alive;
+    /** Set by [dispose]; a task handed to DefaultExecutor at shutdown checks it before running. */
+    std::atomic<bool> disposed{false};
+
+    explicit DelayedTask(long long nano_time) : nano_time(nano_time) {}
+
+    // Kotlin: fun timeToExecute(now: Long): Boolean = now - nanoTime >= 0L
+    bool time_to_execute(long long now) const { return now - nano_time >= 0; }
+
+    bool operator<(const DelayedTask& other) const { return nano_time < other.nano_time; }
+    bool operator<=(const DelayedTask& other) const { return nano_time <= other.nano_time; }
+
+    // Kotlin: final override fun dispose() { ... heap?.remove(this) ... }
+    void dispose() override;
+};
+
+/**
+ * Kotlin: internal class DelayedTaskQueue(@JvmField var timeNow: Long) : ThreadSafeHeap<DelayedTask>()
+ */
+using DelayedTaskQueue = internal::ThreadSafeHeap<DelayedTask>;
+
 /**
  * Event loop that blocks on `process_next_event`.
  * Used by `runBlocking`.
+ *
+ * Besides immediate tasks, the loop owns a queue of delayed tasks, so `delay()` and
+ * `with_timeout()` inside `run_blocking` are served on the loop's own thread: [run] parks
+ * with `wait_until` on the nearest deadline reported by [next_time].
+ *
+ * Transliterated from (delayed part):
+ * internal abstract class EventLoopImplBase : EventLoopImplPlatform(), Delay
  */
-struct BlockingEventLoop : public EventLoop {
+struct BlockingEventLoop : public EventLoop, public Delay {
     std::shared_ptr<std::thread> thread; // The thread running this loop
-    std::deque<std::shared_ptr<Runnable>> task_queue;
+    /**
+     * Immediate tasks, each keeping itself alive while queued (internal::retain_queued).
+     * Only the thread in [run] takes them, so the queue uses its single-consumer path.
+     */
+    mutable internal::LockFreeTaskQueue<Runnable> task_queue{true};
+    DelayedTaskQueue delayed_queue;
     mutable std::mutex mtx;
     mutable std::condition_variable cv;
+    /** Set while [run] waits on [cv]; [dispatch] only takes [mtx] to wake it. */
+    mutable std::atomic<bool> parked{false};
     bool quit = false;
 
     explicit BlockingEventLoop(std::shared_ptr<std::thread> t);
+    ~BlockingEventLoop() override;
 
     void dispatch(const CoroutineContext& context, std::shared_ptr<Runnable> block) const override;
     long long process_next_event() override;
+    bool is_empty() const override;
+    long long next_time() const override;
     void run();
     void shutdown() override;
+
+    // Delay overrides
+    void schedule_resume_after_delay(long long time_millis, CancellableContinuation<void>& continuation) override;
+    std::shared_ptr<DisposableHandle> invoke_on_timeout(
+        long long time_millis,
+        std::shared_ptr<Runnable> block,
+        const CoroutineContext& context) override;
+
+    /**
+     * Adds [task] to the delayed queue and wakes the loop if it became the earliest deadline.
+     *
+     * Kotlin: fun schedule(now: Long, delayedTask: DelayedTask)
+     */
+    void schedule(std::shared_ptr<DelayedTask> task);
+
+private:
+    /** Moves due delayed tasks to [task_queue]. Kotlin: part of processNextEvent() */
+    void enqueue_due_delayed_tasks();
+
+    /** Wakes [run] if it is parked. Kotlin: unpark() */
+    void unpark() const;
 };
 
 } // namespace coroutines
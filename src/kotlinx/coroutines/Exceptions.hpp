@@ -88,6 +88,29 @@ public:
  */
 CancellationException* make_cancellation_exception(const std::string& message, std::exception_ptr cause);
 
+/**
+ * The CancellationException of a job cancelled without a cause.
+ *
+ * It carries nothing specific to the job, so it is created once and shared: cancelling a scope
+ * with many children then neither allocates nor throws, and is_cancellation_exception()
+ * recognises it by identity.
+ */
+inline const std::exception_ptr& job_cancelled_exception() {
+    static const std::exception_ptr instance = std::make_exception_ptr(CancellationException("Job was cancelled"));
+    return instance;
+}
+
+/** The shared CancellationException a child is cancelled with when its parent is cancelled. */
+inline const std::exception_ptr& parent_cancelled_exception() {
+    static const std::exception_ptr instance = std::make_exception_ptr(CancellationException("Parent cancelled"));
+    return instance;
+}
+
+/** Whether [exception] is one of the shared instances above. Compares pointers only. */
+inline bool is_shared_cancellation_exception(const std::exception_ptr& exception) {
+    return exception == job_cancelled_exception() || exception == parent_cancelled_exception();
+}
+
 /**
  * Converts an exception_ptr to a CancellationException.
  * Transliterated from: protected fun Throwable.toCancellationException(message: String?): CancellationException
@@ -105,9 +128,10 @@ inline std::exception_ptr to_cancellation_exception(
     const std::string& message = ""
 ) {
     if (!exception) {
-        return std::make_exception_ptr(CancellationException(
-            message.empty() ? "Job was cancelled" : message));
+        if (message.empty()) return job_cancelled_exception();
+        return std::make_exception_ptr(CancellationException(message));
     }
+    if (is_shared_cancellation_exception(exception)) return exception;
 
     // Check if already a CancellationException
     try {
@@ -127,11 +151,14 @@ inline std::exception_ptr to_cancellation_exception(
  * Checks if an exception_ptr contains a CancellationException.
  * Transliterated from: cause is CancellationException (various places in JobSupport.kt)
  *
+ * The shared instances are recognised without rethrowing.
+ *
  * @param exception The exception to check
  * @return true if the exception is a CancellationException
  */
-inline bool is_cancellation_exception(std::exception_ptr exception) {
+inline bool is_cancellation_exception(const std::exception_ptr& exception) {
     if (!exception) return false;
+    if (is_shared_cancellation_exception(exception)) return true;
     try {
         std::rethrow_exception(exception);
     } catch (const CancellationException&) {
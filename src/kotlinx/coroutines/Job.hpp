@@ -400,8 +400,10 @@ private:
 
 // Convenience shared_ptr version
 inline std::shared_ptr<DisposableHandle> non_disposable_handle() {
-    // Return a shared_ptr that doesn't own (prevent double-delete of singleton)
-    return std::shared_ptr<DisposableHandle>(&NonDisposableHandle::instance(), [](DisposableHandle*){});
+    // A shared_ptr that doesn't own (prevent double-delete of singleton); made once, as a reused
+    // CancellableContinuationImpl takes it on every suspension
+    static const std::shared_ptr<DisposableHandle> handle(&NonDisposableHandle::instance(), [](DisposableHandle*){});
+    return handle;
 }
 
 // -------------------- Job extensions --------------------
@@ -464,8 +466,7 @@ inline void ensure_active(Job& job) {
  * See Job::is_active().
  */
 inline bool context_is_active(const CoroutineContext& ctx) {
-    auto job_element = ctx.get(Job::type_key);
-    if (auto job = std::dynamic_pointer_cast<Job>(job_element)) {
+    if (Job* job = ctx.job_ptr()) {
         return job->is_active();
     }
     return true; // No job in context means "active" by default
@@ -476,8 +477,7 @@ inline bool context_is_active(const CoroutineContext& ctx) {
  * See Job::cancel() for details.
  */
 inline void context_cancel(const CoroutineContext& ctx, std::exception_ptr cause = nullptr) {
-    auto job_element = ctx.get(Job::type_key);
-    if (auto job = std::dynamic_pointer_cast<Job>(job_element)) {
+    if (Job* job = ctx.job_ptr()) {
         job->cancel(cause);
     }
 }
@@ -506,8 +506,7 @@ inline std::shared_ptr<Job> context_job(const CoroutineContext& ctx) {
  * cannot be cancelled.
  */
 inline void context_ensure_active(const CoroutineContext& ctx) {
-    auto job_element = ctx.get(Job::type_key);
-    if (auto job = std::dynamic_pointer_cast<Job>(job_element)) {
+    if (Job* job = ctx.job_ptr()) {
         ensure_active(*job);
     }
 }
@@ -518,8 +517,7 @@ inline void context_ensure_active(const CoroutineContext& ctx) {
  * It does not do anything if there is no job in the context or it has no children.
  */
 inline void context_cancel_children(const CoroutineContext& ctx, std::exception_ptr cause = nullptr) {
-    auto job_element = ctx.get(Job::type_key);
-    if (auto job = std::dynamic_pointer_cast<Job>(job_element)) {
+    if (Job* job = ctx.job_ptr()) {
         cancel_children(*job, cause);
     }
 }
@@ -19,11 +19,12 @@
 #include "kotlinx/coroutines/internal/LockFreeLinkedList.hpp"
 #include "kotlinx/coroutines/internal/Symbol.hpp"
 #include "kotlinx/coroutines/internal/ConcurrentLinkedList.hpp"
+#include "kotlinx/coroutines/internal/DispatchBatch.hpp"
 #include "kotlinx/coroutines/internal/DispatchedContinuation.hpp"
+#include "kotlinx/coroutines/internal/FinishingExceptions.hpp"
 // kotlinx.coroutines.selects.* (from Kotlin)
 #include "kotlinx/coroutines/selects/Select.hpp"
 #include <atomic>
-#include <mutex>
 #include <thread>
 #include <vector>
 #include <cassert>
@@ -72,7 +73,8 @@ namespace kotlinx {
             bool is_active_;
 
         public:
-            explicit Empty(bool active) : is_active_(active) {
+            explicit Empty(bool active)
+                : Incomplete(active ? JobStateKind::EMPTY_ACTIVE : JobStateKind::EMPTY_NEW), is_active_(active) {
             }
 
             bool is_active() const override { return is_active_; }
@@ -91,7 +93,7 @@ namespace kotlinx {
             NodeList *list_;
 
         public:
-            explicit InactiveNodeList(NodeList *list) : list_(list) {
+            explicit InactiveNodeList(NodeList *list) : Incomplete(JobStateKind::INACTIVE_NODE_LIST), list_(list) {
             }
 
             bool is_active() const override { return false; }
@@ -101,88 +103,79 @@ namespace kotlinx {
         /**
  * State during job completion/cancellation.
  * Transliterated from: private class Finishing
+ *
+ * The root cause and the exceptions added later are kept in internal::FinishingExceptions,
+ * which guards them with a mutex as Kotlin does with `synchronized(state)`.
  */
         class Finishing : public Incomplete {
         public:
+            using AddResult = internal::FinishingExceptions::AddResult;
+
             NodeList *list;
             std::atomic<bool> is_completing{false};
-            std::atomic<std::exception_ptr *> root_cause_{nullptr};
-            std::atomic<void *> exceptions_holder{nullptr}; // null | exception_ptr* | vector* | SEALED
-            std::recursive_mutex mutex;
+            internal::FinishingExceptions exceptions;
 
             Finishing(NodeList *list, bool completing, std::exception_ptr root_cause)
-                : list(list) {
-                is_completing.store(completing);
-                if (root_cause) {
-                    root_cause_.store(new std::exception_ptr(root_cause));
-                }
+                : Incomplete(JobStateKind::FINISHING), list(list), exceptions(std::move(root_cause)) {
+                is_completing.store(completing, std::memory_order_relaxed);
             }
 
-            ~Finishing() {
-                auto *root = root_cause_.load();
-                if (root) delete root;
-                // TODO: Clean up exceptions_holder
-            }
-
-            bool is_active() const override { return root_cause_.load() == nullptr; }
+            bool is_active() const override { return !is_cancelling(); }
             NodeList *get_list() const override { return list; }
 
-            bool is_cancelling() const { return root_cause_.load() != nullptr; }
-            bool is_sealed() const { return exceptions_holder.load() == &SEALED_SYMBOL; }
+            bool is_cancelling() const { return exceptions.is_cancelling(); }
+            bool is_sealed() const { return exceptions.is_sealed(); }
+            std::exception_ptr get_root_cause() const { return exceptions.root_cause(); }
 
-            std::exception_ptr get_root_cause() const {
-                auto *ptr = root_cause_.load();
-                return ptr ? *ptr : nullptr;
+            /** Kotlin: sealLocked(proposedException). [was_cancelling] is whether there was a root cause. */
+            std::vector<std::exception_ptr> seal(std::exception_ptr proposed, bool &was_cancelling) {
+                return exceptions.seal(std::move(proposed), was_cancelling);
             }
 
-            void set_root_cause(std::exception_ptr cause) {
-                auto *old = root_cause_.exchange(new std::exception_ptr(cause));
-                if (old) delete old;
+            /** Kotlin: addExceptionLocked(exception); ROOT_CAUSE if [exception] became the root cause. */
+            AddResult add_exception(std::exception_ptr exception) {
+                return exceptions.add(std::move(exception));
             }
+        };
 
-            std::vector<std::exception_ptr> seal_locked(std::exception_ptr proposed);
+        // Tag checks for the private states; see JobStateKind.
+        Empty *as_empty(JobState *state) {
+            if (state == nullptr) return nullptr;
+            if (state->kind != JobStateKind::EMPTY_NEW && state->kind != JobStateKind::EMPTY_ACTIVE) return nullptr;
+            return static_cast<Empty *>(state);
+        }
 
-            void add_exception_locked(std::exception_ptr exception);
-        };
+        InactiveNodeList *as_inactive_node_list(JobState *state) {
+            if (state == nullptr || state->kind != JobStateKind::INACTIVE_NODE_LIST) return nullptr;
+            return static_cast<InactiveNodeList *>(state);
+        }
+
+        Finishing *as_finishing(JobState *state) {
+            if (state == nullptr || state->kind != JobStateKind::FINISHING) return nullptr;
+            return static_cast<Finishing *>(state);
+        }
 
         // ============================================================================
         // Handler Node Types (private in Kotlin)
         // ============================================================================
 
-        class InvokeOnCompletion : public JobNode {
-            std::function<void(std::exception_ptr)> handler_;
-
-        public:
-            explicit InvokeOnCompletion(std::function<void(std::exception_ptr)> h) : handler_(std::move(h)) {
-            }
-
-            bool get_on_cancelling() const override { return false; }
-            void invoke(std::exception_ptr cause) override { handler_(cause); }
-        };
-
-        class InvokeOnCancelling : public JobNode {
-            std::function<void(std::exception_ptr)> handler_;
-            std::atomic<bool> invoked_{false};
-
-        public:
-            explicit InvokeOnCancelling(std::function<void(std::exception_ptr)> h) : handler_(std::move(h)) {
-            }
-
-            bool get_on_cancelling() const override { return true; }
-
-            void invoke(std::exception_ptr cause) override {
-                bool expected = false;
-                if (invoked_.compare_exchange_strong(expected, true)) {
-                    handler_(cause);
-                }
-            }
-        };
-
+        /**
+         * Transliterated from: private class ChildHandleNode
+         *
+         * A child that is a JobSupport brings its own node (JobSupport::Impl::child_handle_node), so
+         * attaching it to its parent allocates nothing.
+         */
         class ChildHandleNode : public JobNode, public ChildHandle {
         public:
+            // TODO(abi-ownership): The child holds its parent in turn, so a parent and a child
+            // JobSupport keep each other alive, with all they own.
             std::shared_ptr<ChildJob> child_job;
 
-            explicit ChildHandleNode(std::shared_ptr<ChildJob> child) : child_job(std::move(child)) {
+            ChildHandleNode() : JobNode(JobStateKind::CHILD_HANDLE_NODE) {
+            }
+
+            explicit ChildHandleNode(std::shared_ptr<ChildJob> child)
+                : JobNode(JobStateKind::CHILD_HANDLE_NODE), child_job(std::move(child)) {
             }
 
             bool get_on_cancelling() const override { return true; }
@@ -257,7 +250,7 @@ namespace kotlinx {
 
             void invoke(std::exception_ptr cause) override {
                 auto *state = job->get_state_for_await();
-                if (auto *ex = dynamic_cast<CompletedExceptionally *>(state)) {
+                if (auto *ex = as_completed_exceptionally(state)) {
                     continuation_->resume_with(Result<void *>::failure(ex->cause));
                 } else {
                     continuation_->resume_with(Result<void *>::success(state));
@@ -274,6 +267,15 @@ namespace kotlinx {
             std::atomic<JobState *> state;
             std::shared_ptr<Job> parent;
             std::atomic<DisposableHandle *> parent_handle{nullptr};
+            // The node linking this job into its parent's list; claimed by the parent's attach_child()
+            ChildHandleNode child_handle_node;
+            std::atomic<bool> child_handle_node_claimed{false};
+            // C++ only: the lists, states and nodes this job allocated and published, chained through
+            // Incomplete::owned_next. A replaced state or a removed node may still be read by another
+            // thread, so they are all freed together, with the job.
+            std::atomic<Incomplete *> owned{nullptr};
+            // The final state when finalize_finishing_state() made it, not the caller
+            std::unique_ptr<CompletedExceptionally> final_exception_state;
 
             explicit Impl(bool active) {
                 state.store(active
@@ -281,24 +283,40 @@ namespace kotlinx {
                                 : static_cast<JobState *>(&EMPTY_NEW));
             }
 
-            // State query helpers
+            ~Impl() {
+                auto *s = owned.load(std::memory_order_acquire);
+                while (s) {
+                    auto *next = s->owned_next;
+                    delete s;
+                    s = next;
+                }
+            }
+
+            // Frees [s] with this job; [s] was just published, so no other thread owns it
+            void own(Incomplete *s) {
+                auto *head = owned.load(std::memory_order_relaxed);
+                do {
+                    s->owned_next = head;
+                } while (!owned.compare_exchange_weak(head, s, std::memory_order_release, std::memory_order_relaxed));
+            }
+
+            // State query helpers: tag loads; only Finishing needs to look further.
             bool is_active() const {
                 auto *s = state.load(std::memory_order_acquire);
-                if (auto *incomplete = dynamic_cast<Incomplete *>(s)) {
-                    return incomplete->is_active();
-                }
-                return false;
+                if (s == nullptr) return false;
+                if (s->kind == JobStateKind::FINISHING) return static_cast<Finishing *>(s)->is_active();
+                return s->kind >= JobStateKind::EMPTY_ACTIVE && s->kind < JobStateKind::FINISHING;
             }
 
             bool is_completed() const {
                 auto *s = state.load(std::memory_order_acquire);
-                return dynamic_cast<Incomplete *>(s) == nullptr;
+                return as_incomplete(s) == nullptr;
             }
 
             bool is_cancelled() const {
                 auto *s = state.load(std::memory_order_acquire);
-                if (dynamic_cast<CompletedExceptionally *>(s)) return true;
-                if (auto *finishing = dynamic_cast<Finishing *>(s)) {
+                if (as_completed_exceptionally(s)) return true;
+                if (auto *finishing = as_finishing(s)) {
                     return finishing->is_cancelling();
                 }
                 return false;
@@ -321,8 +339,8 @@ namespace kotlinx {
 
             bool cancel_parent(std::exception_ptr cause);
 
-            bool try_put_node_into_list(JobSupport *job, JobNode *node,
-                                        std::function<bool(Incomplete *, NodeList *)> try_add);
+            template<typename TryAdd>
+            bool try_put_node_into_list(JobSupport *job, JobNode *node, TryAdd try_add);
 
             void remove_node(JobNode *node);
 
@@ -383,15 +401,15 @@ namespace kotlinx {
         std::exception_ptr JobSupport::get_cancellation_exception() {
             auto *s = impl_->state.load(std::memory_order_acquire);
 
-            if (auto *finishing = dynamic_cast<Finishing *>(s)) {
+            if (auto *finishing = as_finishing(s)) {
                 auto root = finishing->get_root_cause();
                 if (root) return root;
                 throw std::logic_error("Job is still new or active: " + to_debug_string());
             }
-            if (dynamic_cast<Incomplete *>(s)) {
+            if (as_incomplete(s)) {
                 throw std::logic_error("Job is still new or active: " + to_debug_string());
             }
-            if (auto *ex = dynamic_cast<CompletedExceptionally *>(s)) {
+            if (auto *ex = as_completed_exceptionally(s)) {
                 return ex->cause;
             }
             return std::make_exception_ptr(CancellationException(
@@ -432,7 +450,7 @@ namespace kotlinx {
                 auto *s = impl_->state.load(std::memory_order_acquire);
 
                 // If not incomplete, job is done - no need to wait
-                if (!dynamic_cast<Incomplete *>(s)) {
+                if (!as_incomplete(s)) {
                     return false;
                 }
 
@@ -462,13 +480,15 @@ namespace kotlinx {
                 delete node;
                 return nullptr; // Unit - already complete
             }
+            impl_->own(node);
 
             // TODO: cont.disposeOnCancellation(handle) for proper cancellation support
             return COROUTINE_SUSPENDED;
         }
 
         void JobSupport::join_blocking() {
-            // Blocking version for non-coroutine contexts
+            // Blocking version for non-coroutine contexts; like join(), it starts a lazy job
+            if (!join_internal()) return;
             while (!is_completed()) {
                 std::this_thread::yield();
             }
@@ -491,8 +511,8 @@ namespace kotlinx {
                 auto *s = impl_->state.load(std::memory_order_acquire);
 
                 // If not incomplete, job is done - return result immediately
-                if (!dynamic_cast<Incomplete *>(s)) {
-                    if (auto *ex = dynamic_cast<CompletedExceptionally *>(s)) {
+                if (!as_incomplete(s)) {
+                    if (auto *ex = as_completed_exceptionally(s)) {
                         // Throw the exception
                         std::rethrow_exception(ex->cause);
                     }
@@ -528,11 +548,12 @@ namespace kotlinx {
                 // Job completed while we were setting up - return result immediately
                 delete node;
                 auto *s = impl_->state.load(std::memory_order_acquire);
-                if (auto *ex = dynamic_cast<CompletedExceptionally *>(s)) {
+                if (auto *ex = as_completed_exceptionally(s)) {
                     std::rethrow_exception(ex->cause);
                 }
                 return s; // Return the result
             }
+            impl_->own(node);
 
             // TODO: cont.disposeOnCancellation(handle) for proper cancellation support
             return COROUTINE_SUSPENDED;
@@ -544,7 +565,7 @@ namespace kotlinx {
                 std::this_thread::yield();
             }
             auto *s = impl_->state.load(std::memory_order_acquire);
-            if (auto *ex = dynamic_cast<CompletedExceptionally *>(s)) {
+            if (auto *ex = as_completed_exceptionally(s)) {
                 std::rethrow_exception(ex->cause);
             }
             return s;
@@ -553,7 +574,7 @@ namespace kotlinx {
         std::vector<std::shared_ptr<Job> > JobSupport::get_children() const {
             std::vector<std::shared_ptr<Job> > result;
             auto *s = impl_->state.load(std::memory_order_acquire);
-            if (auto *incomplete = dynamic_cast<Incomplete *>(s)) {
+            if (auto *incomplete = as_incomplete(s)) {
                 if (auto *list = incomplete->get_list()) {
                     list->for_each([&](internal::LockFreeLinkedListNode *node) {
                         if (auto *child_node = dynamic_cast<ChildHandleNode *>(node)) {
@@ -569,7 +590,16 @@ namespace kotlinx {
         }
 
         std::shared_ptr<ChildHandle> JobSupport::attach_child(std::shared_ptr<ChildJob> child) {
-            auto *node = new ChildHandleNode(std::move(child));
+            ChildHandleNode *node;
+            auto *child_support = dynamic_cast<JobSupport *>(child.get());
+            bool embedded = child_support != nullptr
+                            && !child_support->impl_->child_handle_node_claimed.exchange(true, std::memory_order_acq_rel);
+            if (embedded) {
+                node = &child_support->impl_->child_handle_node;
+                node->child_job = std::move(child);
+            } else {
+                node = new ChildHandleNode(std::move(child));
+            }
             node->job = this;
 
             bool added = impl_->try_put_node_into_list(this, node,
@@ -578,16 +608,20 @@ namespace kotlinx {
                                                        });
 
             if (added) {
-                return std::shared_ptr<ChildHandle>(node, [](ChildHandle *) {
-                    // Node lifetime managed by list
-                });
+                // Node owned by this job (or the child): the handle does not own it
+                if (!embedded) impl_->own(node);
+                return std::shared_ptr<ChildHandle>(std::shared_ptr<void>(), node);
             }
 
             // Already completed
             auto *s = impl_->state.load();
-            auto *ex = dynamic_cast<CompletedExceptionally *>(s);
+            auto *ex = as_completed_exceptionally(s);
             node->invoke(ex ? ex->cause : nullptr);
-            delete node;
+            if (embedded) {
+                node->child_job = nullptr;
+            } else {
+                delete node;
+            }
             // Return a non-disposable ChildHandle (cast the NonDisposableHandle)
             return std::shared_ptr<ChildHandle>(nullptr);
         }
@@ -601,16 +635,19 @@ namespace kotlinx {
             bool on_cancelling,
             bool invoke_immediately,
             std::function<void(std::exception_ptr)> handler) {
-            JobNode *node = on_cancelling
-                                ? static_cast<JobNode *>(new InvokeOnCancelling(std::move(handler)))
-                                : static_cast<JobNode *>(new InvokeOnCompletion(std::move(handler)));
+            return invoke_on_completion<std::function<void(std::exception_ptr)>>(
+                on_cancelling, invoke_immediately, std::move(handler));
+        }
+
+        std::shared_ptr<DisposableHandle> JobSupport::invoke_on_completion_node(
+            JobNode *node, bool on_cancelling, bool invoke_immediately) {
             node->job = this;
 
             bool added = impl_->try_put_node_into_list(this, node,
                                                        [on_cancelling, invoke_immediately, node](
                                                    Incomplete *state, NodeList *list) -> bool {
                                                            if (on_cancelling) {
-                                                               auto *finishing = dynamic_cast<Finishing *>(state);
+                                                               auto *finishing = as_finishing(state);
                                                                auto root_cause = finishing
                                                                    ? finishing->get_root_cause()
                                                                    : nullptr;
@@ -623,13 +660,14 @@ namespace kotlinx {
                                                        });
 
             if (added) {
-                return std::shared_ptr<DisposableHandle>(node, [](DisposableHandle *) {
-                });
+                // Node owned by this job: the handle does not own it
+                impl_->own(node);
+                return std::shared_ptr<DisposableHandle>(std::shared_ptr<void>(), node);
             }
 
             if (invoke_immediately) {
                 auto *s = impl_->state.load();
-                auto *ex = dynamic_cast<CompletedExceptionally *>(s);
+                auto *ex = as_completed_exceptionally(s);
                 node->invoke(ex ? ex->cause : nullptr);
             }
             delete node;
@@ -661,7 +699,7 @@ namespace kotlinx {
         }
 
         void JobSupport::parent_cancelled(ParentJob *parent) {
-            cancel(impl_->default_cancellation_exception("Parent cancelled"));
+            cancel(parent_cancelled_exception());
         }
 
         void JobSupport::handle_on_completion_exception(std::exception_ptr exception) {
@@ -674,15 +712,7 @@ namespace kotlinx {
 
         bool JobSupport::child_cancelled(std::exception_ptr cause) {
             // Check if it's a CancellationException
-            if (cause) {
-                try {
-                    std::rethrow_exception(cause);
-                } catch (const CancellationException &) {
-                    return true;
-                } catch (...) {
-                    // Not a CancellationException
-                }
-            }
+            if (is_cancellation_exception(cause)) return true;
 
             // Cancel this job and return whether we handle exceptions
             impl_->make_cancelling(this, cause);
@@ -702,17 +732,17 @@ namespace kotlinx {
             // Returns null if this job completed normally.
             // Throws if job has not completed nor is being cancelled yet.
             auto *s = impl_->state.load(std::memory_order_acquire);
-            if (auto *finishing = dynamic_cast<Finishing *>(s)) {
+            if (auto *finishing = as_finishing(s)) {
                 auto root = finishing->get_root_cause();
                 if (!root) {
                     throw std::logic_error("Job is still new or active: " + to_debug_string());
                 }
                 return root;
             }
-            if (dynamic_cast<Incomplete *>(s)) {
+            if (as_incomplete(s)) {
                 throw std::logic_error("Job is still new or active: " + to_debug_string());
             }
-            if (auto *ex = dynamic_cast<CompletedExceptionally *>(s)) {
+            if (auto *ex = as_completed_exceptionally(s)) {
                 return ex->cause;
             }
             // Normal completion - no cause
@@ -722,7 +752,7 @@ namespace kotlinx {
         bool JobSupport::get_completion_cause_handled() const {
             // Transliterated from: protected val completionCauseHandled: Boolean
             auto *s = impl_->state.load(std::memory_order_acquire);
-            if (auto *ex = dynamic_cast<CompletedExceptionally *>(s)) {
+            if (auto *ex = as_completed_exceptionally(s)) {
                 return ex->handled;
             }
             return false;
@@ -731,16 +761,16 @@ namespace kotlinx {
         bool JobSupport::is_completed_exceptionally() const {
             // Transliterated from: val isCompletedExceptionally: Boolean
             auto *s = impl_->state.load(std::memory_order_acquire);
-            return dynamic_cast<CompletedExceptionally *>(s) != nullptr;
+            return as_completed_exceptionally(s) != nullptr;
         }
 
         std::exception_ptr JobSupport::get_completion_exception_or_null() const {
             // Transliterated from: fun getCompletionExceptionOrNull(): Throwable?
             auto *s = impl_->state.load(std::memory_order_acquire);
-            if (dynamic_cast<Incomplete *>(s)) {
+            if (as_incomplete(s)) {
                 throw std::logic_error("This job has not completed yet");
             }
-            if (auto *ex = dynamic_cast<CompletedExceptionally *>(s)) {
+            if (auto *ex = as_completed_exceptionally(s)) {
                 return ex->cause;
             }
             return nullptr;
@@ -781,10 +811,10 @@ namespace kotlinx {
 
         JobState *JobSupport::get_completed_internal() const {
             auto *s = impl_->state.load(std::memory_order_acquire);
-            if (dynamic_cast<Incomplete *>(s)) {
+            if (as_incomplete(s)) {
                 throw std::logic_error("This job has not completed yet");
             }
-            if (auto *ex = dynamic_cast<CompletedExceptionally *>(s)) {
+            if (auto *ex = as_completed_exceptionally(s)) {
                 std::rethrow_exception(ex->cause);
             }
             return s;
@@ -800,15 +830,15 @@ namespace kotlinx {
 
         std::string JobSupport::state_string() const {
             auto *s = impl_->state.load();
-            if (auto *finishing = dynamic_cast<Finishing *>(s)) {
+            if (auto *finishing = as_finishing(s)) {
                 if (finishing->is_cancelling()) return "Cancelling";
                 if (finishing->is_completing.load()) return "Completing";
                 return "Active";
             }
-            if (auto *incomplete = dynamic_cast<Incomplete *>(s)) {
+            if (auto *incomplete = as_incomplete(s)) {
                 return incomplete->is_active() ? "Active" : "New";
             }
-            if (dynamic_cast<CompletedExceptionally *>(s)) {
+            if (as_completed_exceptionally(s)) {
                 return "Cancelled";
             }
             return "Completed";
@@ -830,7 +860,7 @@ namespace kotlinx {
                 return RETRY;
             }
 
-            if (auto *inactive_list = dynamic_cast<InactiveNodeList *>(s)) {
+            if (auto *inactive_list = as_inactive_node_list(s)) {
                 auto *expected = s;
                 if (state.compare_exchange_strong(expected, inactive_list->get_list())) {
                     job->on_start();
@@ -848,24 +878,27 @@ namespace kotlinx {
             while (true) {
                 auto *s = state.load(std::memory_order_acquire);
 
-                if (auto *finishing = dynamic_cast<Finishing *>(s)) {
-                    std::lock_guard<std::recursive_mutex> lock(finishing->mutex);
+                if (auto *finishing = as_finishing(s)) {
                     if (finishing->is_sealed()) return TOO_LATE_TO_CANCEL;
 
-                    bool was_cancelling = finishing->is_cancelling();
-                    if (cause || !was_cancelling) {
+                    // Only add a cancellation exception if it is the first one or has a cause
+                    if (cause || !finishing->is_cancelling()) {
                         if (!cause_cache) cause_cache = create_cause_exception(cause);
-                        finishing->add_exception_locked(cause_cache);
-                    }
-
-                    auto root = finishing->get_root_cause();
-                    if (root && !was_cancelling) {
-                        notify_cancelling(job, finishing->list, root);
+                        switch (finishing->add_exception(cause_cache)) {
+                            case Finishing::AddResult::SEALED:
+                                return TOO_LATE_TO_CANCEL;
+                            case Finishing::AddResult::ROOT_CAUSE:
+                                // Exactly one caller installs the root cause and notifies
+                                notify_cancelling(job, finishing->list, cause_cache);
+                                break;
+                            case Finishing::AddResult::ADDED:
+                                break;
+                        }
                     }
                     return COMPLETING_ALREADY;
                 }
 
-                if (auto *incomplete = dynamic_cast<Incomplete *>(s)) {
+                if (auto *incomplete = as_incomplete(s)) {
                     if (!cause_cache) cause_cache = create_cause_exception(cause);
                     if (incomplete->is_active()) {
                         if (try_make_cancelling(job, incomplete, cause_cache)) {
@@ -886,6 +919,7 @@ namespace kotlinx {
         }
 
         bool JobSupport::Impl::try_make_cancelling(JobSupport *job, Incomplete *s, std::exception_ptr root_cause) {
+            const bool new_list = as_empty(s) != nullptr;
             auto *list = get_or_promote_cancelling_list(s);
             if (!list) return false;
 
@@ -893,8 +927,11 @@ namespace kotlinx {
             auto *expected = static_cast<JobState *>(s);
             if (!state.compare_exchange_strong(expected, finishing)) {
                 delete finishing;
+                if (new_list) delete list;
                 return false;
             }
+            if (new_list) own(list);
+            own(finishing);
 
             notify_cancelling(job, list, root_cause);
             return true;
@@ -905,11 +942,11 @@ namespace kotlinx {
                 return list;
             }
 
-            if (dynamic_cast<Empty *>(s)) {
+            if (as_empty(s)) {
                 return new NodeList();
             }
 
-            if (auto *node = dynamic_cast<JobNode *>(s)) {
+            if (auto *node = as_job_node(s)) {
                 promote_single_to_node_list(node);
                 return nullptr; // Retry
             }
@@ -923,14 +960,19 @@ namespace kotlinx {
                 auto *expected = static_cast<JobState *>(empty);
                 if (!state.compare_exchange_strong(expected, list)) {
                     delete list;
+                    return;
                 }
+                own(list);
             } else {
                 auto *inactive = new InactiveNodeList(list);
                 auto *expected = static_cast<JobState *>(empty);
                 if (!state.compare_exchange_strong(expected, inactive)) {
                     delete inactive;
                     delete list;
+                    return;
                 }
+                own(list);
+                own(inactive);
             }
         }
 
@@ -939,6 +981,7 @@ namespace kotlinx {
             if (node->add_one_if_empty(list)) {
                 auto *expected = static_cast<JobState *>(node);
                 if (state.compare_exchange_strong(expected, list)) {
+                    own(list);
                     return;
                 }
             }
@@ -949,6 +992,8 @@ namespace kotlinx {
             job->on_cancelling(cause);
 
             std::exception_ptr handler_exception;
+            // Awaiters resumed by the handlers are handed to their dispatchers in one go.
+            internal::DispatchBatchScope batch;
             list->for_each([&](internal::LockFreeLinkedListNode *raw_node) {
                 if (auto *node = dynamic_cast<JobNode *>(raw_node)) {
                     if (node->get_on_cancelling()) {
@@ -960,6 +1005,11 @@ namespace kotlinx {
                     }
                 }
             });
+            try {
+                batch.flush();
+            } catch (...) {
+                if (!handler_exception) handler_exception = std::current_exception();
+            }
 
             cancel_parent(cause);
 
@@ -978,8 +1028,8 @@ namespace kotlinx {
             return false;
         }
 
-        bool JobSupport::Impl::try_put_node_into_list(JobSupport *job, JobNode *node,
-                                                      std::function<bool(Incomplete *, NodeList *)> try_add) {
+        template<typename TryAdd>
+        bool JobSupport::Impl::try_put_node_into_list(JobSupport *job, JobNode *node, TryAdd try_add) {
             while (true) {
                 auto *s = state.load(std::memory_order_acquire);
 
@@ -988,14 +1038,14 @@ namespace kotlinx {
                     continue;
                 }
 
-                if (auto *incomplete = dynamic_cast<Incomplete *>(s)) {
+                if (auto *incomplete = as_incomplete(s)) {
                     auto *list = incomplete->get_list();
                     if (!list) {
-                        if (auto *job_node = dynamic_cast<JobNode *>(s)) {
+                        if (auto *job_node = as_job_node(s)) {
                             promote_single_to_node_list(job_node);
                             continue;
                         }
-                        if (auto *empty = dynamic_cast<Empty *>(s)) {
+                        if (auto *empty = as_empty(s)) {
                             promote_empty_to_node_list(empty);
                             continue;
                         }
@@ -1012,7 +1062,7 @@ namespace kotlinx {
             while (true) {
                 auto *s = state.load(std::memory_order_acquire);
 
-                if (auto *state_node = dynamic_cast<JobNode *>(s)) {
+                if (auto *state_node = as_job_node(s)) {
                     if (state_node != node) return;
                     auto *expected = s;
                     if (state.compare_exchange_strong(expected, static_cast<JobState *>(&EMPTY_ACTIVE))) {
@@ -1021,7 +1071,7 @@ namespace kotlinx {
                     continue;
                 }
 
-                if (auto *incomplete = dynamic_cast<Incomplete *>(s)) {
+                if (auto *incomplete = as_incomplete(s)) {
                     if (incomplete->get_list()) {
                         node->remove();
                     }
@@ -1045,13 +1095,13 @@ namespace kotlinx {
         }
 
         JobState *JobSupport::Impl::try_make_completing(JobSupport *job, JobState *s, JobState *proposed) {
-            auto *incomplete = dynamic_cast<Incomplete *>(s);
+            auto *incomplete = as_incomplete(s);
             if (!incomplete) return COMPLETING_ALREADY;
 
-            bool is_proposed_exception = dynamic_cast<CompletedExceptionally *>(proposed) != nullptr;
+            bool is_proposed_exception = as_completed_exceptionally(proposed) != nullptr;
 
             // Fast path for simple states
-            if ((dynamic_cast<Empty *>(s) || (dynamic_cast<JobNode *>(s) && !dynamic_cast<ChildHandleNode *>(s)))
+            if ((as_empty(s) || s->kind == JobStateKind::JOB_NODE)
                 && !is_proposed_exception) {
                 if (try_finalize_simple_state(job, incomplete, proposed)) {
                     return s;
@@ -1063,27 +1113,28 @@ namespace kotlinx {
         }
 
         JobState *JobSupport::Impl::try_make_completing_slow_path(JobSupport *job, Incomplete *s, JobState *proposed) {
+            const bool new_list = as_empty(s) != nullptr;
             auto *list = get_or_promote_cancelling_list(s);
             if (!list) return COMPLETING_RETRY;
 
-            auto *finishing = dynamic_cast<Finishing *>(s);
+            auto *finishing = as_finishing(s);
             if (!finishing) {
                 finishing = new Finishing(list, false, nullptr);
                 auto *expected = static_cast<JobState *>(s);
                 if (!state.compare_exchange_strong(expected, finishing)) {
                     delete finishing;
+                    if (new_list) delete list;
                     return COMPLETING_RETRY;
                 }
+                if (new_list) own(list);
+                own(finishing);
             }
 
-            {
-                std::lock_guard<std::recursive_mutex> lock(finishing->mutex);
-                if (finishing->is_completing.load()) return COMPLETING_ALREADY;
-                finishing->is_completing.store(true);
+            // Mark as completing; exactly one caller gets past this
+            if (finishing->is_completing.exchange(true, std::memory_order_acq_rel)) return COMPLETING_ALREADY;
 
-                if (auto *ex = dynamic_cast<CompletedExceptionally *>(proposed)) {
-                    finishing->add_exception_locked(ex->cause);
-                }
+            if (auto *ex = as_completed_exceptionally(proposed)) {
+                finishing->add_exception(ex->cause);
             }
 
             // Check for children
@@ -1131,22 +1182,18 @@ namespace kotlinx {
                                                              JobState *proposed) {
             // Transliterated from: private fun finalizeFinishingState(state: Finishing, proposedUpdate: Any?): Any?
             //     (JobSupport.kt:191-235)
-            auto *proposed_ex = dynamic_cast<CompletedExceptionally *>(proposed);
+            auto *proposed_ex = as_completed_exceptionally(proposed);
             std::exception_ptr proposed_exception = proposed_ex ? proposed_ex->cause : nullptr;
 
             // Create the final exception and seal the state so that no more exceptions can be added
             bool was_cancelling;
             std::exception_ptr final_exception;
             std::vector<std::exception_ptr> exceptions;
-            {
-                std::lock_guard<std::recursive_mutex> lock(finishing->mutex);
-                was_cancelling = finishing->is_cancelling();
-                exceptions = finishing->seal_locked(proposed_exception);
-                final_exception = get_final_root_cause(finishing, exceptions);
-                // Add suppressed exceptions (semantic no-op in C++, see note above)
-                if (final_exception) {
-                    add_suppressed_exceptions(final_exception, exceptions);
-                }
+            exceptions = finishing->seal(proposed_exception, was_cancelling);
+            final_exception = get_final_root_cause(finishing, exceptions);
+            // Add suppressed exceptions (semantic no-op in C++, see note above)
+            if (final_exception) {
+                add_suppressed_exceptions(final_exception, exceptions);
             }
 
             JobState *final_state;
@@ -1155,13 +1202,14 @@ namespace kotlinx {
             } else if (final_exception == proposed_exception) {
                 final_state = proposed;
             } else {
-                final_state = new CompletedExceptionally(final_exception);
+                final_exception_state = std::make_unique<CompletedExceptionally>(final_exception);
+                final_state = final_exception_state.get();
             }
 
             if (final_exception) {
                 bool handled = cancel_parent(final_exception) || job->handle_job_exception(final_exception);
                 if (handled) {
-                    if (auto *ex_state = dynamic_cast<CompletedExceptionally *>(final_state)) {
+                    if (auto *ex_state = as_completed_exceptionally(final_state)) {
                         ex_state->make_handled();
                     }
                 }
@@ -1221,19 +1269,22 @@ namespace kotlinx {
             // All are CancellationExceptions
             std::exception_ptr first = exceptions[0];
 
-            // Check if first is TimeoutCancellationException
+            // Check if first is TimeoutCancellationException (the shared instances are not)
             bool first_is_timeout = false;
-            try {
-                std::rethrow_exception(first);
-            } catch (const TimeoutCancellationException&) {
-                first_is_timeout = true;
-            } catch (...) {
-                // Not a TimeoutCancellationException
+            if (!is_shared_cancellation_exception(first)) {
+                try {
+                    std::rethrow_exception(first);
+                } catch (const TimeoutCancellationException&) {
+                    first_is_timeout = true;
+                } catch (...) {
+                    // Not a TimeoutCancellationException
+                }
             }
 
             if (first_is_timeout) {
                 // Look for a different TimeoutCancellationException (with recovered stacktrace)
                 for (size_t i = 1; i < exceptions.size(); ++i) {
+                    if (is_shared_cancellation_exception(exceptions[i])) continue;
                     try {
                         std::rethrow_exception(exceptions[i]);
                     } catch (const TimeoutCancellationException&) {
@@ -1269,10 +1320,10 @@ namespace kotlinx {
                 parent_handle.store(&NonDisposableHandle::instance());
             }
 
-            auto *ex = dynamic_cast<CompletedExceptionally *>(update);
+            auto *ex = as_completed_exceptionally(update);
             std::exception_ptr cause = ex ? ex->cause : nullptr;
 
-            if (auto *node = dynamic_cast<JobNode *>(s)) {
+            if (auto *node = as_job_node(s)) {
                 try {
                     node->invoke(cause);
                 } catch (...) {
@@ -1301,16 +1352,23 @@ namespace kotlinx {
         bool JobSupport::Impl::try_wait_for_child(JobSupport *job, Finishing *finishing,
                                                   ChildHandleNode *child, JobState *proposed) {
             auto *completion = new ChildCompletion(job, finishing, child, proposed);
-            auto handle = child->child_job->invoke_on_completion(false, false,
-                                                                 [completion](std::exception_ptr cause) {
-                                                                     completion->invoke(cause);
-                                                                 });
-
-            if (handle.get() != &NonDisposableHandle::instance()) {
-                return true;
+            if (auto *child_support = dynamic_cast<JobSupport *>(child->child_job.get())) {
+                // Kotlin: child.childJob.invokeOnCompletion(handler = ChildCompletion(...)), no wrapper
+                auto handle = child_support->invoke_on_completion_node(completion, false, false);
+                if (handle.get() != &NonDisposableHandle::instance()) {
+                    return true;
+                }
+                // completion was deleted by invoke_on_completion_node
+            } else {
+                auto handle = child->child_job->invoke_on_completion(false, false,
+                                                                     [completion](std::exception_ptr cause) {
+                                                                         completion->invoke(cause);
+                                                                     });
+                if (handle.get() != &NonDisposableHandle::instance()) {
+                    return true;
+                }
+                delete completion;
             }
-
-            delete completion;
             auto *next = next_child(child);
             if (!next) return false;
             return try_wait_for_child(job, finishing, next, proposed);
@@ -1340,48 +1398,14 @@ namespace kotlinx {
         }
 
         std::exception_ptr JobSupport::Impl::default_cancellation_exception(const char *message) {
-            return std::make_exception_ptr(CancellationException(message ? message : "Job was cancelled"));
+            if (!message) return job_cancelled_exception();
+            return std::make_exception_ptr(CancellationException(message));
         }
 
         // ============================================================================
         // Finishing Methods
         // ============================================================================
 
-        std::vector<std::exception_ptr> Finishing::seal_locked(std::exception_ptr proposed) {
-            std::vector<std::exception_ptr> result;
-            auto *eh = exceptions_holder.load();
-
-            if (eh == nullptr) {
-                // No exceptions yet
-            } else if (eh == &SEALED_SYMBOL) {
-                return result;
-            } else {
-                // eh is exception_ptr* or vector*
-                // Simplified: assume single exception
-                result.push_back(*static_cast<std::exception_ptr *>(eh));
-            }
-
-            auto root = get_root_cause();
-            if (root) result.insert(result.begin(), root);
-            if (proposed && proposed != root) result.push_back(proposed);
-
-            exceptions_holder.store(&SEALED_SYMBOL);
-            return result;
-        }
-
-        void Finishing::add_exception_locked(std::exception_ptr exception) {
-            auto root = get_root_cause();
-            if (!root) {
-                set_root_cause(exception);
-                return;
-            }
-            // Store additional exceptions (simplified)
-            auto *eh = exceptions_holder.load();
-            if (eh == nullptr) {
-                exceptions_holder.store(new std::exception_ptr(exception));
-            }
-        }
-
         // ============================================================================
         // Other Internal Class Methods
         // ============================================================================
@@ -1396,6 +1420,8 @@ namespace kotlinx {
             close(LIST_ON_COMPLETION_PERMISSION);
 
             std::exception_ptr handler_exception;
+            // Awaiters resumed by the handlers are handed to their dispatchers in one go.
+            internal::DispatchBatchScope batch;
             for_each([&](internal::LockFreeLinkedListNode *raw_node) {
                 if (auto *node = dynamic_cast<JobNode *>(raw_node)) {
                     try {
@@ -1407,6 +1433,13 @@ namespace kotlinx {
                     }
                 }
             });
+            try {
+                batch.flush();
+            } catch (...) {
+                if (!handler_exception) {
+                    handler_exception = std::current_exception();
+                }
+            }
 
             if (handler_exception) {
                 std::rethrow_exception(handler_exception);
@@ -14,8 +14,10 @@
 #include "kotlinx/coroutines/DisposableHandle.hpp"
 #include "kotlinx/coroutines/CompletedExceptionally.hpp"
 #include "kotlinx/coroutines/internal/LockFreeLinkedList.hpp"
+#include <atomic>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <functional>
 #include <exception>
 
@@ -38,8 +40,23 @@ public:
     virtual bool is_active() const = 0;
     virtual NodeList* get_list() const = 0;
     virtual ~Incomplete() = default;
+
+    /**
+     * C++ only: the next of the states and nodes owned by the same job, which frees them all when
+     * it is destroyed. Kotlin leaves replaced states and removed nodes to the garbage collector.
+     */
+    Incomplete* owned_next = nullptr;
+
+protected:
+    explicit Incomplete(JobStateKind kind) : JobState(kind) {}
 };
 
+/** Kotlin: `state as? Incomplete`, checked with the state's tag. [state] may be null. */
+inline Incomplete* as_incomplete(JobState* state) {
+    if (state == nullptr || state->kind > JobStateKind::FINISHING) return nullptr;
+    return static_cast<Incomplete*>(state);
+}
+
 /**
  * Box for Incomplete states used as final job results.
  * Transliterated from: private class IncompleteStateBox (JobSupport.kt:1393)
@@ -52,7 +69,7 @@ class IncompleteStateBox : public JobState {
 public:
     Incomplete* state;
 
-    explicit IncompleteStateBox(Incomplete* s) : state(s) {}
+    explicit IncompleteStateBox(Incomplete* s) : JobState(JobStateKind::INCOMPLETE_BOX), state(s) {}
 };
 
 /**
@@ -63,7 +80,7 @@ public:
  * @return IncompleteStateBox if state is Incomplete, otherwise state unchanged
  */
 inline JobState* box_incomplete(JobState* state) {
-    if (auto* incomplete = dynamic_cast<Incomplete*>(state)) {
+    if (auto* incomplete = as_incomplete(state)) {
         return new IncompleteStateBox(incomplete);
     }
     return state;
@@ -77,8 +94,8 @@ inline JobState* box_incomplete(JobState* state) {
  * @return The unboxed Incomplete if boxed, otherwise state unchanged
  */
 inline JobState* unbox_state(JobState* state) {
-    if (auto* box = dynamic_cast<IncompleteStateBox*>(state)) {
-        return box->state;
+    if (state != nullptr && state->kind == JobStateKind::INCOMPLETE_BOX) {
+        return static_cast<IncompleteStateBox*>(state)->state;
     }
     return state;
 }
@@ -89,6 +106,8 @@ inline JobState* unbox_state(JobState* state) {
  */
 class NodeList : public Incomplete, public internal::LockFreeLinkedListHead {
 public:
+    NodeList() : Incomplete(JobStateKind::NODE_LIST) {}
+
     bool is_active() const override { return true; }
     NodeList* get_list() const override { return const_cast<NodeList*>(this); }
 
@@ -115,6 +134,8 @@ class JobNode : public Incomplete,
 public:
     JobSupport* job = nullptr;
 
+    explicit JobNode(JobStateKind kind = JobStateKind::JOB_NODE) : Incomplete(kind) {}
+
     /**
      * If false, invoke will be called once the job is cancelled or is complete.
      * If true, invoke is invoked as soon as the job becomes _cancelling_ instead.
@@ -134,6 +155,54 @@ public:
     void dispose() override;
 };
 
+/** Kotlin: `state as? JobNode`, checked with the state's tag. [state] may be null. */
+inline JobNode* as_job_node(JobState* state) {
+    if (state == nullptr) return nullptr;
+    if (state->kind != JobStateKind::JOB_NODE && state->kind != JobStateKind::CHILD_HANDLE_NODE) return nullptr;
+    return static_cast<JobNode*>(state);
+}
+
+/**
+ * Node of a handler installed with invoke_on_completion().
+ * Transliterated from: private class InvokeOnCompletion in JobSupport.kt
+ *
+ * The handler is stored in the node: registering a lambda allocates the node and nothing else.
+ */
+template<typename Handler>
+class InvokeOnCompletion : public JobNode {
+public:
+    explicit InvokeOnCompletion(Handler handler) : handler_(std::move(handler)) {}
+
+    bool get_on_cancelling() const override { return false; }
+    void invoke(std::exception_ptr cause) override { handler_(cause); }
+
+private:
+    Handler handler_;
+};
+
+/**
+ * Node of a handler installed with invoke_on_completion(on_cancelling = true); invoked at most once.
+ * Transliterated from: private class InvokeOnCancelling in JobSupport.kt
+ */
+template<typename Handler>
+class InvokeOnCancelling : public JobNode {
+public:
+    explicit InvokeOnCancelling(Handler handler) : handler_(std::move(handler)) {}
+
+    bool get_on_cancelling() const override { return true; }
+
+    void invoke(std::exception_ptr cause) override {
+        bool expected = false;
+        if (invoked_.compare_exchange_strong(expected, true)) {
+            handler_(cause);
+        }
+    }
+
+private:
+    Handler handler_;
+    std::atomic<bool> invoked_{false};
+};
+
 /**
  * @brief Base class for Job implementations providing core lifecycle management.
  *
@@ -223,6 +292,27 @@ public:
         bool invoke_immediately,
         std::function<void(std::exception_ptr)> handler) override;
 
+    /**
+     * invoke_on_completion() for any callable. The callable is stored in the handler node
+     * instead of a std::function, so the node is the only allocation.
+     */
+    template<typename Handler>
+    std::shared_ptr<DisposableHandle> invoke_on_completion(
+        bool on_cancelling,
+        bool invoke_immediately,
+        Handler&& handler) {
+        using H = std::decay_t<Handler>;
+        JobNode* node = on_cancelling
+            ? static_cast<JobNode*>(new InvokeOnCancelling<H>(std::forward<Handler>(handler)))
+            : static_cast<JobNode*>(new InvokeOnCompletion<H>(std::forward<Handler>(handler)));
+        return invoke_on_completion_node(node, on_cancelling, invoke_immediately);
+    }
+
+    template<typename Handler>
+    std::shared_ptr<DisposableHandle> invoke_on_completion(Handler&& handler) {
+        return invoke_on_completion(false, true, std::forward<Handler>(handler));
+    }
+
     // disposeOnCompletion extension function equivalent
     std::shared_ptr<DisposableHandle> dispose_on_completion(std::shared_ptr<DisposableHandle> handle);
 
@@ -436,6 +526,11 @@ private:
     // Internal await helpers
     void* await_suspend(Continuation<void*>* continuation);
 
+    // Installs [node], which this job then owns; deletes it if the job is already complete (or
+    // cancelling, for [on_cancelling])
+    std::shared_ptr<DisposableHandle> invoke_on_completion_node(
+        JobNode* node, bool on_cancelling, bool invoke_immediately);
+
     // Opaque pointer to implementation state
     // All internal state machine logic is in JobSupport.cpp
     class Impl;
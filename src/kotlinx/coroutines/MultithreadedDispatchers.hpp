@@ -14,23 +14,46 @@
 
 #include "kotlinx/coroutines/CloseableCoroutineDispatcher.hpp"
 #include "kotlinx/coroutines/Runnable.hpp"
+#include <memory>
 #include <string>
 #include <vector>
-#include <thread>
-#include <deque>
-#include <mutex>
-#include <condition_variable>
-#include <atomic>
 
 namespace kotlinx {
 namespace coroutines {
 
+namespace scheduling {
+class CoroutineScheduler;
+} // namespace scheduling
+
+/**
+ * Placement of the threads of a pool created by new_fixed_thread_pool_context.
+ *
+ * No Kotlin counterpart. A default-constructed value leaves the threads unpinned.
+ * Pinned workers are allocated on their NUMA node and steal from the workers of their own
+ * node before they cross to another one; see scheduling/Affinity.hpp.
+ */
+struct ThreadPoolOptions {
+    /**
+     * NUMA nodes to run the workers on, assigned round-robin: worker `i` is pinned to all CPUs
+     * of `numa_nodes[i % numa_nodes.size()]`.
+     */
+    std::vector<int> numa_nodes;
+
+    /**
+     * Explicit CPU sets, assigned round-robin like [numa_nodes], which they take precedence over.
+     * A worker belongs to the NUMA node of the first CPU of its set.
+     */
+    std::vector<std::vector<int>> cpu_sets;
+};
+
 /**
  * Implementation of a thread pool-based coroutine dispatcher.
  *
- * This dispatcher maintains a fixed-size pool of worker threads that
- * execute submitted tasks. Tasks are queued and executed in FIFO order
- * by available workers.
+ * This dispatcher maintains a pool of worker threads backed by a work-stealing
+ * scheduling::CoroutineScheduler, started lazily up to the requested size. Tasks dispatched
+ * from one of the pool's workers go to that worker's local queue (a resumed continuation runs
+ * next on the same worker); tasks dispatched from other threads go through a shared injection
+ * queue. Idle workers steal from each other, so there is no single lock shared by all submissions.
  */
 class ExecutorCoroutineDispatcherImpl : public CloseableCoroutineDispatcher {
 public:
@@ -42,6 +65,26 @@ public:
      */
     ExecutorCoroutineDispatcherImpl(int n_threads, std::string name);
 
+    /**
+     * Creates a new dispatcher whose scheduler runs CPU tasks on at most [core_pool_size] threads
+     * and grows up to [max_pool_size] threads for blocking tasks submitted through views such as
+     * scheduling::IoDispatcher. Threads are started lazily and retired when idle.
+     *
+     * @param core_pool_size the number of threads available to CPU tasks
+     * @param max_pool_size the maximum number of threads, including those running blocking tasks
+     * @param name the name of this dispatcher (used in to_string())
+     */
+    ExecutorCoroutineDispatcherImpl(int core_pool_size, int max_pool_size, std::string name);
+
+    /**
+     * Creates a new dispatcher with the specified number of threads, placed according to [options].
+     *
+     * @param n_threads the number of worker threads to create
+     * @param name the name of this dispatcher (used in to_string())
+     * @param options where to pin the worker threads
+     */
+    ExecutorCoroutineDispatcherImpl(int n_threads, std::string name, const ThreadPoolOptions& options);
+
     /**
      * Destructor. Closes the dispatcher and joins all worker threads.
      */
@@ -64,22 +107,39 @@ public:
      */
     void dispatch(const CoroutineContext& context, std::shared_ptr<Runnable> block) const override;
 
+    /**
+     * Dispatches a task that yields: unlike [dispatch], it is queued behind the tasks already
+     * waiting on the current worker instead of running right after the current one.
+     */
+    void dispatch_yield(const CoroutineContext& context, std::shared_ptr<Runnable> block) const override;
+
+    /**
+     * Dispatches the whole batch with at most one lock of the shared injection queue, waking
+     * at most as many idle workers as there are tasks.
+     */
+    void dispatch_batch(std::vector<DispatchRequest>& requests) const override;
+
     /**
      * Closes this dispatcher, preventing new tasks from being submitted
      * and signaling all worker threads to complete.
      */
     void close() override;
 
-private:
-    void worker_loop();
+    /**
+     * Returns a view of this dispatcher that runs its tasks on the workers of NUMA [node].
+     * Views created from it with limited_parallelism stay on that node too.
+     *
+     * @throws std::invalid_argument if none of the workers is placed on [node]
+     */
+    std::shared_ptr<CoroutineDispatcher> numa_node_view(int node) const;
+
+    /** The scheduler backing this dispatcher, shared with views like Dispatchers.IO. */
+    scheduling::CoroutineScheduler& scheduler() const { return *scheduler_; }
 
+private:
     std::string name_;
     int n_threads_;
-    std::vector<std::thread> workers_;
-    std::deque<std::shared_ptr<Runnable>> task_queue_;
-    mutable std::mutex queue_mutex_;
-    mutable std::condition_variable condition_;
-    std::atomic<bool> closed_;
+    std::unique_ptr<scheduling::CoroutineScheduler> scheduler_;
 };
 
 /**
@@ -99,5 +159,17 @@ CloseableCoroutineDispatcher* new_single_thread_context(const std::string& name)
  */
 CloseableCoroutineDispatcher* new_fixed_thread_pool_context(int n_threads, const std::string& name);
 
+/**
+ * Creates a coroutine execution context with the fixed-size thread-pool whose threads are pinned
+ * to CPU sets or NUMA nodes.
+ *
+ * @param n_threads the number of threads.
+ * @param name the base name of the created threads.
+ * @param options where to pin the threads.
+ * @return the dispatcher, which also gives access to per-node views (ExecutorCoroutineDispatcherImpl::numa_node_view)
+ */
+ExecutorCoroutineDispatcherImpl* new_fixed_thread_pool_context(int n_threads, const std::string& name,
+                                                              const ThreadPoolOptions& options);
+
 } // namespace coroutines
 } // namespace kotlinx
@@ -3,6 +3,8 @@
 #include <variant>
 #include <stdexcept>
 
+#include "kotlinx/coroutines/Exceptions.hpp"
+
 namespace kotlinx {
 namespace coroutines {
 
@@ -37,8 +39,15 @@ public:
         return nullptr;
     }
 
+    /** Whether this is a failure with a CancellationException; the shared instances are checked without rethrowing. */
+    bool is_cancellation() const {
+        return is_failure() && is_cancellation_exception(std::get<std::exception_ptr>(content));
+    }
+
     static Result<T> success(T value) { return Result<T>(std::move(value)); }
     static Result<T> failure(std::exception_ptr e) { return Result<T>(e); }
+    /** A failure with the shared job_cancelled_exception(); allocates nothing. */
+    static Result<T> cancelled() { return Result<T>(job_cancelled_exception()); }
 };
 
 // Void specialization
@@ -60,8 +69,11 @@ public:
 
     std::exception_ptr exception_or_null() const { return exception; }
 
+    bool is_cancellation() const { return is_cancellation_exception(exception); }
+
     static Result<void> success() { return Result<void>(); }
     static Result<void> failure(std::exception_ptr e) { return Result<void>(e); }
+    static Result<void> cancelled() { return Result<void>(job_cancelled_exception()); }
 };
 
 } // namespace coroutines
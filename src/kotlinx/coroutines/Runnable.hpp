@@ -1,12 +1,85 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+
 namespace kotlinx {
 namespace coroutines {
 
+struct Runnable;
+
+namespace internal {
+
+class IntrusiveTaskQueue;
+Runnable* retain_queued(std::shared_ptr<Runnable> task);
+std::shared_ptr<Runnable> release_queued(Runnable* task);
+
+/**
+ * Link of a Runnable in an internal::IntrusiveTaskQueue. While queued, the task owns itself
+ * through [owner], so queuing it needs no allocation.
+ */
+struct TaskQueueHook {
+    std::atomic<TaskQueueHook*> next{nullptr};
+    std::shared_ptr<Runnable> owner;
+    // Whether the task is in a queue: taken with an exchange, so that queuing a task that is
+    // already queued throws instead of corrupting the queue it is in, in every build
+    std::atomic<bool> queued{false};
+
+    /** Marks the task as queued; throws std::logic_error if it already is. */
+    void claim() {
+        if (queued.exchange(true, std::memory_order_acquire)) {
+            throw std::logic_error("Runnable is already queued");
+        }
+    }
+
+    /** Takes the task out of its queue: it gives up [owner] and can be queued again. */
+    std::shared_ptr<Runnable> unclaim() {
+        std::shared_ptr<Runnable> task = std::move(owner);
+        queued.store(false, std::memory_order_release);
+        return task;
+    }
+};
+
+} // namespace internal
+
 struct Runnable {
+    Runnable() = default;
+    // A copy is a different task: it is not in any queue.
+    Runnable(const Runnable&) {}
+    Runnable& operator=(const Runnable&) { return *this; }
+
     virtual void run() = 0;
     virtual ~Runnable() = default;
+
+private:
+    friend class internal::IntrusiveTaskQueue;
+    friend Runnable* internal::retain_queued(std::shared_ptr<Runnable> task);
+    friend std::shared_ptr<Runnable> internal::release_queued(Runnable* task);
+    internal::TaskQueueHook queue_hook_;
 };
 
+namespace internal {
+
+/**
+ * Hands [task] to a queue of raw pointers such as LockFreeTaskQueue<Runnable>: until
+ * [release_queued] takes it back, the task keeps itself alive through its queue hook, so
+ * queuing it needs no allocation. As with IntrusiveTaskQueue, a Runnable can be in at most
+ * one queue at a time: retaining one that is queued throws std::logic_error.
+ */
+inline Runnable* retain_queued(std::shared_ptr<Runnable> task) {
+    Runnable* raw = task.get();
+    raw->queue_hook_.claim();
+    raw->queue_hook_.owner = std::move(task);
+    return raw;
+}
+
+/** Takes back a task handed out by [retain_queued]. */
+inline std::shared_ptr<Runnable> release_queued(Runnable* task) {
+    return task->queue_hook_.unclaim();
+}
+
+} // namespace internal
+
 } // namespace coroutines
 } // namespace kotlinx
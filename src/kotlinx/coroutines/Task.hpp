@@ -0,0 +1,450 @@
+#pragma once
+/**
+ * @file Task.hpp
+ * @brief C++20 coroutines (`co_await`) on top of the coroutine runtime.
+ *
+ * No Kotlin counterpart: Kotlin suspend functions are compiled into the state machines this port
+ * writes by hand (BaseContinuationImpl). A `Task<T>` is a C++20 coroutine whose frame is driven
+ * by the same runtime: its promise is the `Continuation<void*>` handed to suspend functions, so
+ * a task suspends on Deferred::await, channel send/receive, delay and Mutex::lock like any
+ * state machine and is resumed through its dispatcher.
+ *
+ * ```cpp
+ * Task<int> fetch(std::shared_ptr<Channel<int>> channel) {
+ *     co_await co::delay(10);
+ *     int value = co_await co::receive(*channel);
+ *     co_return value + 1;
+ * }
+ *
+ * Task<void> worker(std::shared_ptr<Channel<int>> channel) {
+ *     int value = co_await fetch(channel);   // nested tasks: symmetric transfer, no stack growth
+ *     co_await co::send(*channel, value);
+ * }
+ *
+ * auto job = launch_task(scope, nullptr, worker(channel));
+ * auto deferred = async_task<int>(scope, nullptr, fetch(channel));
+ * ```
+ *
+ * - A task is lazy: it runs once it is awaited by another task or started by launch_task or
+ *   async_task, which give it a StandaloneCoroutine / DeferredCoroutine as its job.
+ * - An awaited task runs undispatched in the context of the task awaiting it; control passes
+ *   between the two by symmetric transfer, so a chain of nested tasks uses constant stack.
+ * - Frames are allocated by internal::FrameAllocator, like state machines.
+ * - An exception escaping a task is rethrown by `co_await`, or completes its job exceptionally.
+ */
+
+#include "kotlinx/coroutines/AbstractCoroutine.hpp"
+#include "kotlinx/coroutines/Builders.hpp"
+#include "kotlinx/coroutines/Continuation.hpp"
+#include "kotlinx/coroutines/CoroutineDispatcher.hpp"
+#include "kotlinx/coroutines/CoroutineScope.hpp"
+#include "kotlinx/coroutines/Deferred.hpp"
+#include "kotlinx/coroutines/Delay.hpp"
+#include "kotlinx/coroutines/Result.hpp"
+#include "kotlinx/coroutines/Runnable.hpp"
+#include "kotlinx/coroutines/Unit.hpp"
+#include "kotlinx/coroutines/channels/Channel.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
+#include "kotlinx/coroutines/intrinsics/Intrinsics.hpp"
+#include "kotlinx/coroutines/sync/Mutex.hpp"
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace kotlinx {
+namespace coroutines {
+
+template<typename T = void>
+class Task;
+
+namespace internal {
+
+/**
+ * The part of a task's promise that does not depend on its result type: the continuation
+ * suspend functions resume, and the task that runs when its dispatcher dispatches it.
+ */
+class TaskPromiseBase : public Continuation<void*>, public Runnable {
+public:
+    static void* operator new(std::size_t size) {
+        return FrameAllocator::allocate(size);
+    }
+
+    static void operator delete(void* frame) noexcept {
+        FrameAllocator::deallocate(frame);
+    }
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { exception_ = std::current_exception(); }
+
+    std::shared_ptr<CoroutineContext> get_context() const override { return context_; }
+
+    /** Resumes the task from the suspend function it awaits; [take_resumed] hands over [result]. */
+    void resume_with(Result<void*> result) override {
+        resumed_ = std::move(result);
+        resume_in_context();
+    }
+
+    void run() override { handle_.resume(); }
+
+    /** Result of the suspend function the task resumes from: the boxed value, or it throws. */
+    void* take_resumed() {
+        Result<void*> result = std::move(resumed_);
+        return result.get_or_throw();
+    }
+
+    /** The suspend function completed without suspending. */
+    void set_resumed(void* value) { resumed_ = Result<void*>::success(value); }
+
+    /**
+     * Makes this task, not yet started, resume [awaiter] when it completes; it runs in the
+     * context of [parent], the task awaiting it, and takes its dispatcher as already resolved.
+     */
+    void set_awaiter(const TaskPromiseBase& parent, std::coroutine_handle<> awaiter) {
+        context_ = parent.context_;
+        dispatcher_ = parent.dispatcher_;
+        awaiter_ = awaiter;
+    }
+
+protected:
+    /** Sets the context the task runs in, resolving its dispatcher once for every resume. */
+    void set_context(std::shared_ptr<CoroutineContext> context) {
+        context_ = std::move(context);
+        dispatcher_ = dynamic_cast<CoroutineDispatcher*>(context_->interceptor_ptr());
+    }
+
+    /** Runs the task in place, or through [dispatcher_] if it needs dispatching. */
+    void resume_in_context() {
+        if (dispatcher_ != nullptr && dispatcher_->is_dispatch_needed(*context_)) {
+            // The frame owns the promise: the dispatcher's reference must not.
+            dispatcher_->dispatch(*context_, std::shared_ptr<Runnable>(std::shared_ptr<void>(), this));
+        } else {
+            handle_.resume();
+        }
+    }
+
+    std::coroutine_handle<> handle_;
+    std::shared_ptr<CoroutineContext> context_;
+    // The interceptor of [context_] if it is a dispatcher; [context_] keeps it alive
+    CoroutineDispatcher* dispatcher_ = nullptr;
+    std::coroutine_handle<> awaiter_;
+    Result<void*> resumed_;
+    std::exception_ptr exception_;
+};
+
+/**
+ * Ends a task: transfers to the task awaiting it, or completes the job it was started with and
+ * frees the frame.
+ */
+template<typename Promise>
+struct TaskFinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+        Promise& promise = handle.promise();
+        if (promise.awaiter()) return promise.awaiter();
+        promise.complete_detached();
+        return std::noop_coroutine();
+    }
+
+    void await_resume() const noexcept {}
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase {
+public:
+    using Completion = Continuation<T>;
+
+    Task<T> get_return_object();
+
+    TaskFinalAwaiter<TaskPromise> final_suspend() noexcept { return {}; }
+
+    template<typename U>
+    void return_value(U&& value) { value_.emplace(std::forward<U>(value)); }
+
+    T get() {
+        if (exception_) std::rethrow_exception(exception_);
+        return std::move(*value_);
+    }
+
+    std::coroutine_handle<> awaiter() const { return awaiter_; }
+
+    void start(std::shared_ptr<CoroutineContext> context, std::shared_ptr<Completion> completion) {
+        set_context(std::move(context));
+        completion_ = std::move(completion);
+        resume_in_context();
+    }
+
+    void complete_detached() noexcept {
+        auto completion = std::move(completion_);
+        Result<T> result = exception_ ? Result<T>::failure(exception_) : Result<T>::success(std::move(*value_));
+        handle_.destroy();
+        if (completion) completion->resume_with(std::move(result));
+    }
+
+private:
+    std::optional<T> value_;
+    std::shared_ptr<Completion> completion_;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase {
+public:
+    using Completion = Continuation<Unit>;
+
+    Task<void> get_return_object();
+
+    TaskFinalAwaiter<TaskPromise> final_suspend() noexcept { return {}; }
+
+    void return_void() noexcept {}
+
+    void get() {
+        if (exception_) std::rethrow_exception(exception_);
+    }
+
+    std::coroutine_handle<> awaiter() const { return awaiter_; }
+
+    void start(std::shared_ptr<CoroutineContext> context, std::shared_ptr<Completion> completion) {
+        set_context(std::move(context));
+        completion_ = std::move(completion);
+        resume_in_context();
+    }
+
+    void complete_detached() noexcept {
+        auto completion = std::move(completion_);
+        Result<Unit> result = exception_ ? Result<Unit>::failure(exception_) : Result<Unit>::success(Unit());
+        handle_.destroy();
+        if (completion) completion->resume_with(std::move(result));
+    }
+
+private:
+    std::shared_ptr<Completion> completion_;
+};
+
+/**
+ * Awaits a suspend function `void* f(Continuation<void*>*)` from a task.
+ *
+ * [suspend] is called with the task's promise as continuation. If it returns a value the task
+ * goes on without suspending; on COROUTINE_SUSPENDED the function owns the resumption and the
+ * awaiter, which may already be gone, is not touched again. [unbox] turns the `void*` result
+ * into the value of the `co_await` expression.
+ */
+template<typename Suspend, typename Unbox>
+class SuspendAwaiter {
+public:
+    SuspendAwaiter(Suspend suspend, Unbox unbox)
+        : suspend_(std::move(suspend)), unbox_(std::move(unbox)) {}
+
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    bool await_suspend(std::coroutine_handle<Promise> awaiting) {
+        TaskPromiseBase* promise = &awaiting.promise();
+        promise_ = promise;
+        void* result = suspend_(static_cast<Continuation<void*>*>(promise));
+        if (intrinsics::is_coroutine_suspended(result)) return true;
+        promise->set_resumed(result);
+        return false;
+    }
+
+    decltype(auto) await_resume() { return unbox_(promise_->take_resumed()); }
+
+private:
+    Suspend suspend_;
+    Unbox unbox_;
+    TaskPromiseBase* promise_ = nullptr;
+};
+
+/** `co_await task`: see Task::operator co_await. */
+template<typename T>
+struct TaskAwaiter {
+    std::coroutine_handle<TaskPromise<T>> handle;
+
+    bool await_ready() const noexcept { return false; }
+
+    template<typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> awaiting) noexcept {
+        TaskPromiseBase& parent = awaiting.promise();
+        handle.promise().set_awaiter(parent, awaiting);
+        return handle;
+    }
+
+    T await_resume() { return handle.promise().get(); }
+};
+
+} // namespace internal
+
+/**
+ * A lazily started C++20 coroutine returning [T]; see the file comment.
+ *
+ * Move-only. Dropping a task that has not been started destroys its frame.
+ */
+template<typename T>
+class [[nodiscard]] Task {
+public:
+    using promise_type = internal::TaskPromise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    /** Runs this task in the context of the awaiting task and resumes that one with its result. */
+    internal::TaskAwaiter<T> operator co_await() && noexcept {
+        return internal::TaskAwaiter<T>{handle_};
+    }
+
+    /**
+     * Starts this task in [context]; [completion] is resumed with its result. The frame frees
+     * itself when the task completes.
+     */
+    void start(std::shared_ptr<CoroutineContext> context,
+               std::shared_ptr<typename promise_type::Completion> completion) && {
+        auto handle = std::exchange(handle_, {});
+        handle.promise().start(std::move(context), std::move(completion));
+    }
+
+private:
+    std::coroutine_handle<promise_type> handle_;
+};
+
+namespace internal {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() {
+    handle_ = std::coroutine_handle<TaskPromise>::from_promise(*this);
+    return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() {
+    handle_ = std::coroutine_handle<TaskPromise>::from_promise(*this);
+    return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+}
+
+} // namespace internal
+
+/** `co_await deferred` from a task: Deferred::await, then its value or exception. */
+template<typename T>
+auto operator co_await(Deferred<T>& deferred) {
+    return internal::SuspendAwaiter(
+        [&deferred](Continuation<void*>* c) { return deferred.await(c); },
+        [&deferred](void*) { return deferred.get_completed(); });
+}
+
+/**
+ * Awaitable suspend functions for tasks.
+ */
+namespace co {
+
+/**
+ * Awaits the suspend function [function] (`void* (Continuation<void*>*)`). For a non-void [R]
+ * its result is a new'd `R*`, which is moved out and freed.
+ */
+template<typename R = void, typename Function>
+auto suspend(Function&& function) {
+    return internal::SuspendAwaiter(std::forward<Function>(function), [](void* boxed) {
+        if constexpr (std::is_void_v<R>) {
+            (void)boxed;
+        } else {
+            std::unique_ptr<R> box(static_cast<R*>(boxed));
+            return R(std::move(*box));
+        }
+    });
+}
+
+/** kotlinx::coroutines::delay(). */
+inline auto delay(long long time_millis) {
+    return suspend([time_millis](Continuation<void*>* c) {
+        return kotlinx::coroutines::delay(time_millis, c);
+    });
+}
+
+/** SendChannel::send(). */
+template<typename E>
+auto send(channels::SendChannel<E>& channel, E element) {
+    return suspend([&channel, element = std::move(element)](Continuation<void*>* c) mutable {
+        return channel.send(std::move(element), c);
+    });
+}
+
+/** ReceiveChannel::receive(). */
+template<typename E>
+auto receive(channels::ReceiveChannel<E>& channel) {
+    return suspend<E>([&channel](Continuation<void*>* c) { return channel.receive(c); });
+}
+
+/** SendChannel::send_all(). [elements] must outlive the await. */
+template<typename E>
+auto send_all(channels::SendChannel<E>& channel, std::span<const E> elements) {
+    return suspend([&channel, elements](Continuation<void*>* c) { return channel.send_all(elements, c); });
+}
+
+/** ReceiveChannel::receive_many(); resumes with how many elements were appended to [out]. */
+template<typename E>
+auto receive_many(channels::ReceiveChannel<E>& channel, std::size_t max, std::vector<E>& out) {
+    const std::size_t before = out.size();
+    return internal::SuspendAwaiter(
+        [&channel, max, &out](Continuation<void*>* c) { return channel.receive_many(max, out, c); },
+        [&out, before](void*) { return out.size() - before; });
+}
+
+/** Mutex::lock(); resumes holding the lock. */
+inline auto lock(sync::Mutex& mutex, void* owner = nullptr) {
+    return suspend([&mutex, owner](Continuation<void*>* c) { return mutex.lock(owner, c); });
+}
+
+} // namespace co
+
+/**
+ * launch() for a task: the task runs as a StandaloneCoroutine in the scope, which is the job
+ * returned.
+ */
+inline std::shared_ptr<Job> launch_task(
+    CoroutineScope* scope,
+    std::shared_ptr<CoroutineContext> context,
+    Task<void> task
+) {
+    if (!context) context = empty_context();
+    auto new_context = scope->get_coroutine_context()->operator+(context);
+    auto coroutine = internal::make_frame<StandaloneCoroutine>(new_context, true);
+    std::move(task).start(coroutine->get_context(), coroutine);
+    return coroutine;
+}
+
+/** async() for a task: the task runs as a DeferredCoroutine in the scope. */
+template<typename T>
+std::shared_ptr<Deferred<T>> async_task(
+    CoroutineScope* scope,
+    std::shared_ptr<CoroutineContext> context,
+    Task<T> task
+) {
+    if (!context) context = empty_context();
+    auto new_context = scope->get_coroutine_context()->operator+(context);
+    auto coroutine = internal::make_frame<DeferredCoroutine<T>>(new_context, true);
+    std::move(task).start(static_cast<Continuation<T>*>(coroutine.get())->get_context(), coroutine);
+    return coroutine;
+}
+
+} // namespace coroutines
+} // namespace kotlinx
@@ -36,6 +36,7 @@
 #include "kotlinx/coroutines/internal/ScopeCoroutine.hpp"
 #include "kotlinx/coroutines/intrinsics/Intrinsics.hpp"
 #include "kotlinx/coroutines/ContinuationInterceptor.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 
 namespace kotlinx {
 namespace coroutines {
@@ -91,8 +92,9 @@ namespace coroutines {
                 }
                 if (!delay) delay = &get_default_delay();
 
-                auto exception = make_timeout_cancellation_exception(time, delay, std::dynamic_pointer_cast<Job>(this->JobSupport::shared_from_this()));
-                this->cancel(std::make_exception_ptr(exception));
+                // Moved into the exception_ptr rather than copied
+                this->cancel(std::make_exception_ptr(make_timeout_cancellation_exception(
+                    time, delay, std::dynamic_pointer_cast<Job>(this->JobSupport::shared_from_this()))));
             }
 
             std::string name_string() const override {
@@ -165,7 +167,7 @@ namespace coroutines {
         // In strict ABI, completion is Continuation<void*>. We assume T is layout-compatible or erased.
         auto uCont = std::reinterpret_pointer_cast<Continuation<T>>(completion);
 
-        auto coroutine = std::make_shared<detail::TimeoutCoroutine<T, T>>(time_millis, uCont);
+        auto coroutine = internal::make_frame<detail::TimeoutCoroutine<T, T>>(time_millis, uCont);
         return detail::setup_timeout(coroutine, block);
     }
 
@@ -205,7 +207,7 @@ namespace coroutines {
         std::shared_ptr<detail::TimeoutCoroutine<T*, T*>> coroutine = nullptr;
         
         try {
-            auto timeoutCoroutine = std::make_shared<detail::TimeoutCoroutine<T*, T*>>(time_millis, uCont);
+            auto timeoutCoroutine = internal::make_frame<detail::TimeoutCoroutine<T*, T*>>(time_millis, uCont);
             coroutine = timeoutCoroutine;
             return detail::setup_timeout(timeoutCoroutine, block);
         } catch (const TimeoutCancellationException& e) {
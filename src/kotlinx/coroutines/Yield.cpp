@@ -80,21 +80,14 @@ void* yield(std::shared_ptr<Continuation<void*>> completion) {
 
     // 2. Check for cancellation - context.ensureActive()
     // Get Job from context and check if cancelled
-    auto job_element = context->get(Job::type_key);
-    if (job_element) {
-        auto job = std::dynamic_pointer_cast<Job>(job_element);
-        if (job && !job->is_active()) {
-            // Job is cancelled - throw CancellationException
-            std::rethrow_exception(job->get_cancellation_exception());
-        }
+    Job* job = context->job_ptr();
+    if (job && !job->is_active()) {
+        // Job is cancelled - throw CancellationException
+        std::rethrow_exception(job->get_cancellation_exception());
     }
 
     // 3. Get the dispatcher from context
-    auto interceptor_element = context->get(ContinuationInterceptor::type_key);
-    CoroutineDispatcher* dispatcher = nullptr;
-    if (interceptor_element) {
-        dispatcher = dynamic_cast<CoroutineDispatcher*>(interceptor_element.get());
-    }
+    auto* dispatcher = dynamic_cast<CoroutineDispatcher*>(context->interceptor_ptr());
 
     // 4. If no dispatcher, check for thread-local event loop
     if (!dispatcher) {
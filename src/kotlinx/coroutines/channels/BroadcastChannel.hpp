@@ -306,6 +306,11 @@ public:
         return ChannelResult<void>::success();
     }
 
+    // Each element is broadcast to the subscribers by try_send
+    std::size_t try_send_batch(std::span<const E> elements) override {
+        return SendChannel<E>::try_send_batch(elements);
+    }
+
     // ###########################################
     // # The `select` Expression: onSend { ... } #
     // ###########################################
@@ -25,11 +25,16 @@
 #include "kotlinx/coroutines/CancellableContinuation.hpp"
 #include "kotlinx/coroutines/CancellableContinuationImpl.hpp"
 #include "kotlinx/coroutines/Waiter.hpp"
+#include "kotlinx/coroutines/dsl/CancellableReusable.hpp"
 #include "kotlinx/coroutines/internal/Symbol.hpp"
 #include "kotlinx/coroutines/internal/ConcurrentLinkedList.hpp"
+#include "kotlinx/coroutines/internal/EpochReclamation.hpp"
 #include "kotlinx/coroutines/selects/Select.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 #include <atomic>
 #include <memory>
+#include <mutex>
+#include <new>
 #include <string>
 #include <sstream>
 #include <algorithm>
@@ -37,6 +42,10 @@
 #include <cassert>
 #include <cstdint>
 #include <array>
+#include <type_traits>
+#include <span>
+#include <utility>
+#include <vector>
 
 namespace kotlinx {
 namespace coroutines {
@@ -70,6 +79,16 @@ inline int64_t initial_buffer_end(int capacity) {
 // internal val SEGMENT_SIZE = systemProp("kotlinx.coroutines.bufferedChannel.segmentSize", 32)
 constexpr int SEGMENT_SIZE = 32;
 
+/**
+ * Whether a ChannelSegment<E> keeps its elements in the cells instead of boxing each one in a
+ * `new E`. Holds for small trivially copyable types, which need neither a destructor nor a
+ * liveness flag in the cell; specialize it to force either storage.
+ */
+template <typename E>
+struct inline_channel_element
+    : std::bool_constant<std::is_trivially_copyable_v<E> && std::is_default_constructible_v<E>
+                         && sizeof(E) <= 2 * sizeof(void*)> {};
+
 // until the numbers of started and completed expandBuffer calls coincide.
 constexpr int EXPAND_BUFFER_COMPLETION_WAIT_ITERATIONS = 10000;
 
@@ -494,9 +513,15 @@ class ChannelSegment : public internal::Segment<ChannelSegment<E>> {
 private:
     BufferedChannel<E>* channel_;
 
-    // 2 registers per slot: state + element
+    static constexpr bool kInlineElements = inline_channel_element<E>::value;
+
+    // 2 registers per slot: state + element. The element register is unused for inline elements.
     std::atomic<void*> data_[SEGMENT_SIZE * 2];
 
+    // Inline elements: written before the cell state is published, read after it is observed
+    struct NoInlineElements {};
+    [[no_unique_address]] std::conditional_t<kInlineElements, std::array<E, SEGMENT_SIZE>, NoInlineElements> elements_{};
+
     // C++ lifetime management: holds shared_ptr to waiters stored in state slots.
     // In Kotlin, GC keeps waiters alive. In C++, we need explicit ownership.
     // The raw void* in data_[] is used for CAS operations; this array keeps the object alive.
@@ -517,8 +542,17 @@ public:
         return channel_;
     }
 
+    // Boxed elements still stored when the channel frees or reuses this segment
+    ~ChannelSegment() override {
+        for (int i = 0; i < SEGMENT_SIZE; ++i) clean_element(i);
+    }
+
     int number_of_slots() const override { return SEGMENT_SIZE; }
 
+    // C++ only: the channel frees its segments in id order once all three references have passed
+    // them, so a segment stays linked, and `prev` only ever points to the preceding id, until then.
+    void on_all_slots_cleaned() override {}
+
     // ########################################
     // # Manipulation with the Element Fields #
     // ########################################
@@ -530,15 +564,21 @@ public:
     // The element field stores the value being sent through the channel.
     // Following the safe publication pattern, the element is stored BEFORE
     // updating the state, ensuring receivers always see a valid element.
+    // For inline_channel_element types the element lives in elements_ and the
+    // state store is its only fence.
 
     /**
      * Stores an element in the specified slot.
-     * The element is heap-allocated to allow type-erased storage.
+     * The element is heap-allocated to allow type-erased storage, unless it is inline.
      *
      * Transliterated from: fun storeElement(index: Int, value: E)
      */
     void store_element(int index, E element) {
-        set_element_lazy(index, reinterpret_cast<void*>(new E(std::move(element))));
+        if constexpr (kInlineElements) {
+            elements_[index] = element;
+        } else {
+            set_element_lazy(index, reinterpret_cast<void*>(new E(std::move(element))));
+        }
     }
 
     /**
@@ -547,6 +587,7 @@ public:
      * Transliterated from: fun getElement(index: Int): E
      */
     E get_element(int index) const {
+        if constexpr (kInlineElements) return elements_[index];
         void* ptr = data_[index * 2].load(std::memory_order_acquire);
         if (ptr == nullptr) return E{};
         return *reinterpret_cast<E*>(ptr);
@@ -566,11 +607,13 @@ public:
 
     /**
      * Cleans (removes) the element from the specified slot.
-     * Frees the heap-allocated element to avoid memory leaks.
+     * Frees the heap-allocated element to avoid memory leaks. An inline element has
+     * nothing to free and is left in place.
      *
      * Transliterated from: fun cleanElement(index: Int)
      */
     void clean_element(int index) {
+        if constexpr (kInlineElements) return;
         void* ptr = data_[index * 2].exchange(nullptr, std::memory_order_acq_rel);
         if (ptr != nullptr) {
             delete reinterpret_cast<E*>(ptr);
@@ -703,8 +746,12 @@ public:
                     static_cast<void*>(&INTERRUPTED_RCV());
                 if (cas_state(index, cur, update)) {
                     // The waiter has been successfully cancelled.
-                    // C++ lifetime: release the waiter ref since we're done with it
-                    clear_waiter_ref(index);
+                    // C++ lifetime: a receiver moves a waiting sender's cell to RESUMING_BY_RCV
+                    // before resuming it, so nobody else holds a cancelled sender. A sender
+                    // resumes a waiting receiver straight from the cell, so the ref of a
+                    // cancelled receiver stays until that sender is done with it or the segment
+                    // is freed.
+                    if (is_sender) clear_waiter_ref(index);
                     clean_element(index);
                     on_cancelled_request(index, !is_sender);
                     // Call onUndeliveredElement if needed (sender case).
@@ -866,6 +913,7 @@ public:
         // @Suppress("LeakingThis")
         // val firstSegment = ChannelSegment(id = 0, prev = null, channel = this, pointers = 3)
         auto* first_segment = new ChannelSegment<E>(0, nullptr, this, 3);
+        oldest_segment_ = first_segment;
         send_segment_.store(first_segment, std::memory_order_release);
         receive_segment_.store(first_segment, std::memory_order_release);
 
@@ -881,6 +929,23 @@ public:
     // Destructor
     ~BufferedChannel() override {
         close(std::make_exception_ptr(std::runtime_error("Channel destroyed")));
+
+        // C++ lifetime: no operation can reach the segments anymore, but a suspended waiter that
+        // is cancelled later may still call back into one; such a segment is freed by its last
+        // release_for_cancellation() instead. Cancelling concurrently with this is not supported.
+        ChannelSegment<E>* segment = oldest_segment_;
+        while (segment != nullptr) {
+            ChannelSegment<E>* next = segment->next();
+            segment->orphan();
+            segment = next;
+        }
+        for (auto& retired : retired_segments_) retired.first->orphan();
+        for (ChannelSegment<E>* free_segment : free_segments_) delete free_segment;
+
+        void* cause = close_cause_.load(std::memory_order_acquire);
+        if (cause != static_cast<void*>(&NO_CLOSE_CAUSE()) && cause != nullptr) {
+            delete reinterpret_cast<std::exception_ptr*>(cause);
+        }
     }
 
     OnUndeliveredElement<E> on_undelivered_element() const { return on_undelivered_element_; }
@@ -933,6 +998,7 @@ public:
      * Transliterated from: override suspend fun send(element: E): Unit
      */
     void* send(E element, Continuation<void*>* completion) override {
+        internal::EpochGuard epoch_guard;
         // Lines 241-348: sendImpl inline function
         ChannelSegment<E>* segment = send_segment_.load(std::memory_order_acquire);
 
@@ -1057,12 +1123,13 @@ public:
      * Transliterated from: internal open suspend fun sendBroadcast(element: E): Boolean
      */
     virtual void* send_broadcast(E element, Continuation<void*>* continuation) {
+        internal::EpochGuard epoch_guard;
         if (on_undelivered_element_) {
             throw std::logic_error("the `onUndeliveredElement` feature is unsupported for `sendBroadcast(e)`");
         }
 
         // Create a CancellableContinuationImpl for the result
-        auto cont = std::make_shared<CancellableContinuationImpl<bool>>(
+        auto cont = internal::make_frame<CancellableContinuationImpl<bool>>(
             std::dynamic_pointer_cast<Continuation<bool>>(
                 std::shared_ptr<Continuation<void*>>(continuation, [](Continuation<void*>*){})
             ),
@@ -1139,24 +1206,61 @@ public:
      * Transliterated from: override suspend fun receive(): E
      */
     void* receive(Continuation<void*>* continuation) override {
-        auto result = try_receive();
-        if (result.is_success()) {
-            // Return boxed element
-            return new E(result.get_or_throw());
-        }
-        if (result.is_closed()) {
-            if (result.exception_or_null()) {
-                std::rethrow_exception(result.exception_or_null());
+        return receive_impl(continuation, nullptr);
+    }
+
+    /**
+     * Like [receive], but the element is assigned to [slot] rather than boxed in a `new E`: the
+     * result, returned or resumed with, is [slot] itself. The caller owns [slot], usually a
+     * member of its frame, and does not delete the result, so a state machine that receives in
+     * a loop allocates nothing once its continuation is reused.
+     *
+     * C++ only: no Kotlin counterpart.
+     */
+    void* receive_into(E* slot, Continuation<void*>* continuation) {
+        return receive_impl(continuation, slot);
+    }
+
+private:
+    // Lines 685-704: receiveImpl inline function; [slot] as in receive_into, or null to box
+    void* receive_impl(Continuation<void*>* continuation, E* slot) {
+        internal::EpochGuard epoch_guard;
+        // Lines 685-704: receiveImpl inline function
+        ChannelSegment<E>* segment = receive_segment_.load(std::memory_order_acquire);
+
+        while (true) {
+            // if (isClosedForReceive) return onClosed()
+            if (is_closed_for_receive()) {
+                std::rethrow_exception(receive_exception());
             }
-            throw ClosedReceiveChannelException("Channel was closed");
-        }
 
-        // Need to suspend - full state machine implementation required
-        (void)continuation;
-        throw std::logic_error("BufferedChannel::receive suspend path requires full state machine implementation");
-        return nullptr;
+            int64_t r = receivers_.fetch_add(1, std::memory_order_acq_rel);
+            int64_t id = r / SEGMENT_SIZE;
+            int i = static_cast<int>(r % SEGMENT_SIZE);
+
+            if (segment->id != id) {
+                ChannelSegment<E>* found = find_segment_receive(id, segment);
+                if (found == nullptr) continue;
+                segment = found;
+            }
+
+            void* upd_cell_result = update_cell_receive(segment, i, r, nullptr, slot);
+
+            if (upd_cell_result == static_cast<void*>(&SUSPEND_NO_WAITER())) {
+                return receive_on_no_waiter_suspend(segment, i, r, continuation, slot);
+            } else if (upd_cell_result == static_cast<void*>(&FAILED())) {
+                if (r < senders_counter()) segment->clean_prev();
+                continue;
+            } else {
+                segment->clean_prev();
+                // The cell hands out the element boxed, or in [slot]: it is the result already.
+                return upd_cell_result;
+            }
+        }
     }
 
+public:
+
     /**
      * Receives an element from this channel, wrapping the result in ChannelResult.
      *
@@ -1204,6 +1308,120 @@ public:
         return receive_impl_try_receive();
     }
 
+    /**
+     * Sends a prefix of [elements] that fits without suspension with a single increment of the
+     * senders counter, then walks the claimed cells segment by segment.
+     *
+     * A cell that a concurrent operation made unusable is given up as by [try_send], and the
+     * element goes to the next claimed cell, so the elements sent are still a prefix.
+     *
+     * C++ only: no Kotlin counterpart.
+     */
+    std::size_t try_send_batch(std::span<const E> elements) override {
+        internal::EpochGuard epoch_guard;
+        int64_t senders_and_close_status_cur = senders_and_close_status_.load(std::memory_order_acquire);
+        if (elements.empty() || is_closed_for_send_internal(senders_and_close_status_cur)) return 0;
+
+        // The cells that buffer_or_rendezvous_send accepts right now
+        int64_t s = channels::senders_counter(senders_and_close_status_cur);
+        int64_t limit = std::max(buffer_end_counter(), receivers_counter() + capacity_);
+        if (limit <= s) return 0;
+        int64_t count = static_cast<int64_t>(std::min<uint64_t>(elements.size(), static_cast<uint64_t>(limit - s)));
+
+        senders_and_close_status_cur = senders_and_close_status_.fetch_add(count, std::memory_order_acq_rel);
+        s = channels::senders_counter(senders_and_close_status_cur);
+        bool closed = is_closed_for_send_internal(senders_and_close_status_cur);
+
+        ChannelSegment<E>* segment = send_segment_.load(std::memory_order_acquire);
+        std::size_t sent = 0;
+        for (int64_t cell = s; cell < s + count; ++cell) {
+            int64_t id = cell / SEGMENT_SIZE;
+            int i = static_cast<int>(cell % SEGMENT_SIZE);
+
+            if (segment->id != id) {
+                ChannelSegment<E>* found = find_segment_send(id, segment);
+                // The channel is being closed, which takes care of the remaining cells
+                if (found == nullptr) break;
+                segment = found;
+            }
+
+            // Every claimed cell takes an element: there are at least as many elements as cells
+            switch (update_cell_send(segment, i, elements[sent], cell,
+                                     static_cast<void*>(&INTERRUPTED_SEND()), closed)) {
+                case RESULT_RENDEZVOUS:
+                    segment->clean_prev();
+                    ++sent;
+                    break;
+                case RESULT_BUFFERED:
+                    ++sent;
+                    break;
+                case RESULT_SUSPEND:
+                    segment->on_slot_cleaned();
+                    if (closed) return sent;
+                    break;
+                case RESULT_CLOSED:
+                    if (cell < receivers_counter()) segment->clean_prev();
+                    if (closed) return sent;
+                    break;
+                case RESULT_FAILED:
+                    segment->clean_prev();
+                    break;
+                default:
+                    break;
+            }
+        }
+        return sent;
+    }
+
+    /**
+     * Receives up to [max] elements that are available without suspension into [out], with a
+     * single increment of the receivers counter, then walks the claimed cells segment by segment.
+     * Returns how many were received; a claimed cell that turns out to be empty is given up as
+     * by [try_receive].
+     *
+     * C++ only: no Kotlin counterpart.
+     */
+    std::size_t try_receive_many(std::size_t max, std::vector<E>& out) override {
+        internal::EpochGuard epoch_guard;
+        int64_t r = receivers_.load(std::memory_order_acquire);
+        int64_t senders_and_close_status_cur = senders_and_close_status_.load(std::memory_order_acquire);
+        if (max == 0 || is_closed_for_receive_internal(senders_and_close_status_cur)) return 0;
+
+        int64_t s = channels::senders_counter(senders_and_close_status_cur);
+        if (r >= s) return 0;
+        int64_t count = static_cast<int64_t>(std::min<uint64_t>(max, static_cast<uint64_t>(s - r)));
+
+        r = receivers_.fetch_add(count, std::memory_order_acq_rel);
+        ChannelSegment<E>* segment = receive_segment_.load(std::memory_order_acquire);
+        std::size_t received = 0;
+        out.reserve(out.size() + static_cast<std::size_t>(count));
+        for (int64_t cell = r; cell < r + count; ++cell) {
+            int64_t id = cell / SEGMENT_SIZE;
+            int i = static_cast<int>(cell % SEGMENT_SIZE);
+
+            if (segment->id != id) {
+                ChannelSegment<E>* found = find_segment_receive(id, segment);
+                if (found == nullptr) break;
+                segment = found;
+            }
+
+            E element{};
+            void* result = update_cell_receive(segment, i, cell, static_cast<void*>(&INTERRUPTED_RCV()), &element);
+            if (result == static_cast<void*>(&SUSPEND())) {
+                // Emulate cancelled receive
+                wait_expand_buffer_completion(cell);
+                segment->on_slot_cleaned();
+            } else if (result == static_cast<void*>(&FAILED())) {
+                if (cell < senders_counter()) segment->clean_prev();
+            } else {
+                segment->clean_prev();
+                out.push_back(std::move(element));
+                ++received;
+            }
+        }
+        return received;
+    }
+
     // =========================================================================
     // Lines 1186-1467: The expandBuffer() procedure
     // =========================================================================
@@ -1234,6 +1452,7 @@ public:
      * Transliterated from: private fun expandBuffer()
      */
     void expand_buffer() {
+        internal::EpochGuard epoch_guard;
         if (is_rendezvous_or_unlimited()) return;
 
         ChannelSegment<E>* segment = buffer_end_segment_.load(std::memory_order_acquire);
@@ -1718,6 +1937,7 @@ public:
     }
 
     bool has_elements() const {
+        internal::EpochGuard epoch_guard;
         while (true) {
             ChannelSegment<E>* segment = receive_segment_.load(std::memory_order_acquire);
             int64_t r = receivers_counter();
@@ -1825,6 +2045,7 @@ protected:
     // Note: temporarily in BufferedChannel due to KT-65554
     // -------------------------------------------------------------------------
     ChannelResult<void> try_send_drop_oldest(E element) {
+        internal::EpochGuard epoch_guard;
         ChannelSegment<E>* segment = send_segment_.load(std::memory_order_acquire);
 
         while (true) {
@@ -1887,6 +2108,16 @@ private:
     mutable std::atomic<ChannelSegment<E>*> receive_segment_;
     std::atomic<ChannelSegment<E>*> buffer_end_segment_;
 
+    // C++ only: segments are freed here instead of by the garbage collector. The ones that all
+    // three references have passed are retired in id order, starting from oldest_segment_, and
+    // reused for new segments once no operation can still read them. Guarded by segment_pool_lock_.
+    std::mutex segment_pool_lock_;
+    ChannelSegment<E>* oldest_segment_ = nullptr;
+    std::vector<std::pair<ChannelSegment<E>*, uint64_t>> retired_segments_;
+    std::vector<ChannelSegment<E>*> free_segments_;
+
+    static constexpr std::size_t SEGMENT_POOL_CAPACITY = 16;
+
     mutable std::atomic<void*> close_cause_;
 
     std::atomic<void*> close_handler_;
@@ -1920,23 +2151,15 @@ private:
         int64_t s,
         Continuation<void*>* completion
     ) {
-        // Create a CancellableContinuationImpl like suspendCancellableCoroutineReusable does
-        // Note: completion is Continuation<void*>*, wrap in shared_ptr with no-op deleter
-        auto completion_wrapper = std::shared_ptr<Continuation<void>>(
-            reinterpret_cast<Continuation<void>*>(completion),
-            [](Continuation<void>*){} // no-op deleter, we don't own completion
-        );
-        auto cont = std::make_shared<CancellableContinuationImpl<void>>(
-            completion_wrapper, MODE_CANCELLABLE_REUSABLE
-        );
-
-        send_impl_on_no_waiter(
-            segment, index, element, s,
-            cont.get(),
-            [cont]() { cont->resume({}); },
-            [this, element, cont]() { on_closed_send_on_no_waiter_suspend(element, cont.get()); }
-        );
-        return COROUTINE_SUSPENDED;
+        return dsl::suspend_cancellable_coroutine_reusable<void>(completion,
+            [&](CancellableContinuationImpl<void>* cont) {
+                send_impl_on_no_waiter(
+                    segment, index, element, s,
+                    cont,
+                    [cont]() { cont->resume({}); },
+                    [this, &element, cont]() { on_closed_send_on_no_waiter_suspend(element, cont); }
+                );
+            });
     }
 
     // -------------------------------------------------------------------------
@@ -1977,6 +2200,27 @@ private:
         waiter->invoke_on_cancellation(segment, index);
     }
 
+    // -------------------------------------------------------------------------
+    // Lines 706-729: private suspend fun receiveOnNoWaiterSuspend(...)
+    // -------------------------------------------------------------------------
+    void* receive_on_no_waiter_suspend(
+        ChannelSegment<E>* segment,
+        int index,
+        int64_t r,
+        Continuation<void*>* completion,
+        E* slot
+    ) {
+        return dsl::suspend_cancellable_coroutine_reusable<E>(completion,
+            [&](CancellableContinuationImpl<E>* cont) {
+                receive_impl_on_no_waiter(
+                    segment, index, r,
+                    cont,
+                    [this, cont](E element) { cont->resume_impl(std::move(element), cont->resume_mode, bind_cancellation_fun()); },
+                    [this, cont]() { on_closed_receive_on_no_waiter_suspend(cont); }
+                );
+            }, slot);
+    }
+
     // -------------------------------------------------------------------------
     // Lines 740-742: private fun onClosedReceiveOnNoWaiterSuspend(...)
     // -------------------------------------------------------------------------
@@ -1995,15 +2239,19 @@ private:
     // -------------------------------------------------------------------------
     // Lines 963-1004: private inline fun receiveImplOnNoWaiter(...)
     // -------------------------------------------------------------------------
+    // Kotlin inlines the callbacks; they are template parameters here so that calling them
+    // does not allocate.
+    template<typename OnElementRetrieved, typename OnClosed>
     void receive_impl_on_no_waiter(
         ChannelSegment<E>* segment,
         int index,
         int64_t r,
         Waiter* waiter,
-        std::function<void(E)> on_element_retrieved,
-        std::function<void()> on_closed
+        const OnElementRetrieved& on_element_retrieved,
+        const OnClosed& on_closed
     ) {
-        void* upd_cell_result = update_cell_receive(segment, index, r, waiter);
+        E element{};
+        void* upd_cell_result = update_cell_receive(segment, index, r, waiter, &element);
 
         if (upd_cell_result == static_cast<void*>(&SUSPEND())) {
             prepare_receiver_for_suspension(waiter, segment, index);
@@ -2012,18 +2260,20 @@ private:
             receive_impl_with_waiter(waiter, on_element_retrieved, on_closed);
         } else {
             segment->clean_prev();
-            on_element_retrieved(*static_cast<E*>(upd_cell_result));
+            on_element_retrieved(std::move(element));
         }
     }
 
     // -------------------------------------------------------------------------
     // Helper for receive_impl_on_no_waiter RESULT_FAILED case
     // -------------------------------------------------------------------------
+    template<typename OnElementRetrieved, typename OnClosed>
     void receive_impl_with_waiter(
         Waiter* waiter,
-        std::function<void(E)> on_element_retrieved,
-        std::function<void()> on_closed
+        const OnElementRetrieved& on_element_retrieved,
+        const OnClosed& on_closed
     ) {
+        internal::EpochGuard epoch_guard;
         // Increment receivers counter and get segment/index
         int64_t r = receivers_.fetch_add(1, std::memory_order_acq_rel);
         int64_t id = r / SEGMENT_SIZE;
@@ -2161,14 +2411,17 @@ private:
     // -------------------------------------------------------------------------
     // Lines 373-421: private inline fun sendImplOnNoWaiter(...)
     // -------------------------------------------------------------------------
+    // Kotlin inlines the callbacks; they are template parameters here so that calling them
+    // does not allocate.
+    template<typename OnRendezvousOrBuffered, typename OnClosed>
     void send_impl_on_no_waiter(
         ChannelSegment<E>* segment,
         int index,
         E element,
         int64_t s,
         Waiter* waiter,
-        std::function<void()> on_rendezvous_or_buffered,
-        std::function<void()> on_closed
+        const OnRendezvousOrBuffered& on_rendezvous_or_buffered,
+        const OnClosed& on_closed
     ) {
         int result = update_cell_send(segment, index, element, s, waiter, false);
         switch (result) {
@@ -2201,12 +2454,14 @@ private:
     // Lines 244-369: Helper for send_impl_on_no_waiter RESULT_FAILED case
     // Simplified version that attempts send with an existing waiter
     // -------------------------------------------------------------------------
+    template<typename OnRendezvousOrBuffered, typename OnClosed>
     void send_impl_with_waiter(
         E element,
         Waiter* waiter,
-        std::function<void()> on_rendezvous_or_buffered,
-        std::function<void()> on_closed
+        const OnRendezvousOrBuffered& on_rendezvous_or_buffered,
+        const OnClosed& on_closed
     ) {
+        internal::EpochGuard epoch_guard;
         // Increment senders counter and get a segment/index
         int64_t s = senders_and_close_status_.fetch_add(1, std::memory_order_acq_rel) & SENDERS_COUNTER_MASK;
         int64_t id = s / SEGMENT_SIZE;
@@ -2382,10 +2637,15 @@ public:
             sb->cont->resume_with(Result<bool>::success(false));
             return;
         }
-        // Check if it's a CancellableContinuation (via CancellableContinuationImpl)
-        if (auto* cc = dynamic_cast<CancellableContinuationImpl<void*>*>(waiter)) {
+        // Check if it's a CancellableContinuation: senders park on a <void> one, receivers on an <E> one
+        if (auto* cc = dynamic_cast<CancellableContinuationImpl<void>*>(waiter)) {
+            auto exc = receiver ? receive_exception() : send_exception();
+            cc->resume_with(Result<void>::failure(exc));
+            return;
+        }
+        if (auto* cc = dynamic_cast<CancellableContinuationImpl<E>*>(waiter)) {
             auto exc = receiver ? receive_exception() : send_exception();
-            cc->resume_with(Result<void*>::failure(exc));
+            cc->resume_with(Result<E>::failure(exc));
             return;
         }
         // Check if it's a ReceiveCatching
@@ -2408,6 +2668,7 @@ public:
 
     // Simplified sendImpl for trySend
     ChannelResult<void> send_impl_try_send(E element) {
+        internal::EpochGuard epoch_guard;
         ChannelSegment<E>* segment = send_segment_.load(std::memory_order_acquire);
 
         while (true) {
@@ -2458,6 +2719,7 @@ public:
 
     // Simplified receiveImpl for tryReceive
     ChannelResult<E> receive_impl_try_receive() {
+        internal::EpochGuard epoch_guard;
         ChannelSegment<E>* segment = receive_segment_.load(std::memory_order_acquire);
 
         while (true) {
@@ -2474,7 +2736,8 @@ public:
                 if (segment == nullptr) continue;
             }
 
-            void* result = update_cell_receive(segment, i, r, static_cast<void*>(&INTERRUPTED_RCV()));
+            E element{};
+            void* result = update_cell_receive(segment, i, r, static_cast<void*>(&INTERRUPTED_RCV()), &element);
 
             if (result == static_cast<void*>(&SUSPEND())) {
                 // Emulate cancelled receive
@@ -2486,7 +2749,7 @@ public:
                 continue;
             } else {
                 segment->clean_prev();
-                return ChannelResult<E>::success(*reinterpret_cast<E*>(result));
+                return ChannelResult<E>::success(std::move(element));
             }
         }
     }
@@ -2583,9 +2846,7 @@ public:
             } else {
                 // state is Waiter or WaiterEB
                 segment->clean_element(index);
-                void* receiver = state;
-                WaiterEB* waiter_eb = dynamic_cast<WaiterEB*>(reinterpret_cast<WaiterEB*>(state));
-                if (waiter_eb) receiver = waiter_eb->waiter;
+                void* receiver = get_waiter(state);
 
                 if (try_resume_receiver(receiver, element)) {
                     // C++ lifetime: release the waiter ref since we're done with it
@@ -2606,7 +2867,18 @@ public:
         }
     }
 
-    void* update_cell_receive(ChannelSegment<E>* segment, int index, int64_t r, void* waiter) {
+    /**
+     * Hands an element retrieved by update_cell_receive to its caller: into [slot] if the caller
+     * gives one, else boxed in a `new E` as the suspend ABI returns it.
+     */
+    static void* deliver_element(E element, E* slot) {
+        if (slot == nullptr) return new E(std::move(element));
+        *slot = std::move(element);
+        return slot;
+    }
+
+    void* update_cell_receive(ChannelSegment<E>* segment, int index, int64_t r, void* waiter,
+                              E* slot = nullptr) {
         // Fast path
         void* state = segment->get_state(index);
 
@@ -2624,15 +2896,15 @@ public:
         } else if (state == static_cast<void*>(&BUFFERED())) {
             if (segment->cas_state(index, state, static_cast<void*>(&DONE_RCV()))) {
                 expand_buffer();
-                E elem = segment->retrieve_element(index);
-                return new E(std::move(elem));
+                return deliver_element(segment->retrieve_element(index), slot);
             }
         }
 
-        return update_cell_receive_slow(segment, index, r, waiter);
+        return update_cell_receive_slow(segment, index, r, waiter, slot);
     }
 
-    void* update_cell_receive_slow(ChannelSegment<E>* segment, int index, int64_t r, void* waiter) {
+    void* update_cell_receive_slow(ChannelSegment<E>* segment, int index, int64_t r, void* waiter,
+                                   E* slot) {
         while (true) {
             void* state = segment->get_state(index);
 
@@ -2655,8 +2927,7 @@ public:
             } else if (state == static_cast<void*>(&BUFFERED())) {
                 if (segment->cas_state(index, state, static_cast<void*>(&DONE_RCV()))) {
                     expand_buffer();
-                    E elem = segment->retrieve_element(index);
-                    return new E(std::move(elem));
+                    return deliver_element(segment->retrieve_element(index), slot);
                 }
             } else if (state == static_cast<void*>(&INTERRUPTED_SEND())) {
                 return static_cast<void*>(&FAILED());
@@ -2670,18 +2941,15 @@ public:
             } else {
                 // state is a sender
                 if (segment->cas_state(index, state, static_cast<void*>(&RESUMING_BY_RCV()))) {
-                    bool help_expand_buffer = (dynamic_cast<WaiterEB*>(reinterpret_cast<WaiterEB*>(state)) != nullptr);
-                    void* sender = state;
-                    WaiterEB* waiter_eb = dynamic_cast<WaiterEB*>(reinterpret_cast<WaiterEB*>(state));
-                    if (waiter_eb) sender = waiter_eb->waiter;
+                    bool help_expand_buffer = is_waiter_eb(state);
+                    void* sender = get_waiter(state);
 
                     if (try_resume_sender(sender, segment, index)) {
                         // C++ lifetime: release the waiter ref since we're done with it
                         segment->clear_waiter_ref(index);
                         segment->set_state(index, static_cast<void*>(&DONE_RCV()));
                         expand_buffer();
-                        E elem = segment->retrieve_element(index);
-                        return new E(std::move(elem));
+                        return deliver_element(segment->retrieve_element(index), slot);
                     } else {
                         // C++ lifetime: release the waiter ref since we're done with it
                         segment->clear_waiter_ref(index);
@@ -2834,6 +3102,7 @@ public:
     }
 
     ChannelSegment<E>* complete_close(int64_t senders_cur) {
+        internal::EpochGuard epoch_guard;
         ChannelSegment<E>* last_segment = close_linked_list();
 
         if (is_conflated_drop_oldest()) {
@@ -2848,6 +3117,7 @@ public:
     }
 
     void complete_cancel(int64_t senders_cur) {
+        internal::EpochGuard epoch_guard;
         ChannelSegment<E>* last_segment = complete_close(senders_cur);
         remove_unprocessed_elements(last_segment);
     }
@@ -2910,7 +3180,8 @@ public:
                 }
                 segment = found;
             }
-            void* upd_cell_result = update_cell_receive(segment, i, r, nullptr);
+            E element{};
+            void* upd_cell_result = update_cell_receive(segment, i, r, nullptr, &element);
             if (upd_cell_result == &FAILED()) {
                 // To avoid memory leaks, we also need to reset the `prev` pointer.
                 if (r < senders_counter()) {
@@ -2920,7 +3191,6 @@ public:
                 // Clean the reference to the previous segment.
                 segment->clean_prev();
                 if (on_undelivered_element_) {
-                    E element = *static_cast<E*>(upd_cell_result);
                     std::exception_ptr ex = call_undelivered_element_catching_exception(element);
                     if (ex) {
                         std::rethrow_exception(ex);
@@ -3056,13 +3326,71 @@ public:
         }
     }
 
+    // C++ only: creates the segment following prev, reusing a freed one when the pool lock is free
+    ChannelSegment<E>* new_segment(int64_t id, ChannelSegment<E>* prev) {
+        std::unique_lock<std::mutex> lock(segment_pool_lock_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            reclaim_segments();
+            if (!free_segments_.empty()) {
+                ChannelSegment<E>* segment = free_segments_.back();
+                free_segments_.pop_back();
+                segment->~ChannelSegment();
+                return new (segment) ChannelSegment<E>(id, prev, this, 0);
+            }
+        }
+        return create_segment<E>(id, prev);
+    }
+
+    // Retires the segments that send_segment_, receive_segment_ and buffer_end_segment_ have all
+    // passed, and frees the retired ones no operation can still be reading. Every operation that
+    // reads segments holds an EpochGuard. Called with segment_pool_lock_ held.
+    void reclaim_segments() {
+        int64_t frontier = std::min(send_segment_.load(std::memory_order_acquire)->id,
+                                    receive_segment_.load(std::memory_order_acquire)->id);
+        if (!is_rendezvous_or_unlimited()) {
+            frontier = std::min(frontier, buffer_end_segment_.load(std::memory_order_acquire)->id);
+        }
+        const std::size_t first_retired = retired_segments_.size();
+        while (oldest_segment_->id < frontier) {
+            ChannelSegment<E>* next = oldest_segment_->next();
+            if (next == nullptr) break;
+            // Walks over prev stop before the retired segment
+            next->clean_prev();
+            retired_segments_.emplace_back(oldest_segment_, 0);
+            oldest_segment_ = next;
+        }
+        if (retired_segments_.size() > first_retired) {
+            const uint64_t epoch = internal::EpochReclamation::retire_epoch();
+            for (std::size_t i = first_retired; i < retired_segments_.size(); ++i) {
+                retired_segments_[i].second = epoch;
+            }
+        }
+
+        // Retire epochs never decrease, so the safe segments form a prefix. A safe segment that a
+        // suspended waiter may still call on cancellation stays retired until it is released.
+        std::size_t kept = 0;
+        std::size_t safe = 0;
+        for (; safe < retired_segments_.size()
+               && internal::EpochReclamation::is_safe(retired_segments_[safe].second); ++safe) {
+            ChannelSegment<E>* segment = retired_segments_[safe].first;
+            if (segment->has_pending_cancellation()) {
+                retired_segments_[kept++] = retired_segments_[safe];
+            } else if (free_segments_.size() < SEGMENT_POOL_CAPACITY) {
+                free_segments_.push_back(segment);
+            } else {
+                delete segment;
+            }
+        }
+        retired_segments_.erase(retired_segments_.begin() + kept, retired_segments_.begin() + safe);
+    }
+
     ChannelSegment<E>* find_segment_send(int64_t id, ChannelSegment<E>* start_from) {
         // Simplified segment finding
         ChannelSegment<E>* segment = start_from;
         while (segment != nullptr && segment->id < id) {
             ChannelSegment<E>* next = segment->next();
             if (next == nullptr) {
-                next = create_segment<E>(segment->id + 1, segment);
+                next = new_segment(segment->id + 1, segment);
                 if (!segment->try_set_next(next)) {
                     delete next;
                     next = segment->next();
@@ -3089,7 +3417,7 @@ public:
         while (segment != nullptr && segment->id < id) {
             ChannelSegment<E>* next = segment->next();
             if (next == nullptr) {
-                next = create_segment<E>(segment->id + 1, segment);
+                next = new_segment(segment->id + 1, segment);
                 if (!segment->try_set_next(next)) {
                     delete next;
                     next = segment->next();
@@ -3118,7 +3446,7 @@ public:
         while (segment != nullptr && segment->id < id) {
             ChannelSegment<E>* next = segment->next();
             if (next == nullptr) {
-                next = create_segment<E>(segment->id + 1, segment);
+                next = new_segment(segment->id + 1, segment);
                 if (!segment->try_set_next(next)) {
                     delete next;
                     next = segment->next();
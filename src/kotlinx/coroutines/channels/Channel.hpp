@@ -15,14 +15,20 @@
 #include "kotlinx/coroutines/CancellableContinuation.hpp"
 #include "kotlinx/coroutines/selects/Select.hpp"
 #include "kotlinx/coroutines/channels/BufferOverflow.hpp"
+#include "kotlinx/coroutines/channels/ChannelMode.hpp"
 #include "kotlinx/coroutines/internal/Symbol.hpp"
 #include "kotlinx/coroutines/internal/SystemProps.hpp"
+#include "kotlinx/coroutines/intrinsics/Intrinsics.hpp"
+#include <cstddef>
 #include <memory>
 #include <exception>
 #include <functional>
+#include <limits>
+#include <span>
 #include <string>
 #include <stdexcept>
 #include <type_traits>
+#include <vector>
 #include "kotlinx/coroutines/CoroutineScope.hpp"
 
 namespace kotlinx {
@@ -42,6 +48,7 @@ template <typename E> class ChannelIterator;
 template <typename T> class ChannelResult;
 template <typename E> class BufferedChannel;
 template <typename E> class ConflatedBufferedChannel;
+template <typename E> class SpscChannel;
 
 // =============================================================================
 // Channel capacity constants (namespace level for easy access)
@@ -796,6 +803,102 @@ public:
     virtual E next() = 0;
 };
 
+// =============================================================================
+// Suspending batch send and receive
+// =============================================================================
+
+namespace detail {
+
+/**
+ * The rest of a [SendChannel::send_all] that did not fit without waiting: sends it one [send]
+ * and one [try_send_batch] at a time. It is created only when the first batch falls short and
+ * deletes itself when it resumes the caller.
+ */
+template <typename E>
+class SendAllFrame : public Continuation<void*> {
+public:
+    SendAllFrame(SendChannel<E>& channel, std::span<const E> elements, Continuation<void*>* completion)
+        : channel_(channel), elements_(elements), completion_(completion) {}
+
+    std::shared_ptr<CoroutineContext> get_context() const override { return completion_->get_context(); }
+
+    /** Sends until every element is sent or [send] suspends; then the channel resumes this. */
+    void* send_rest() {
+        while (!elements_.empty()) {
+            const E& element = elements_.front();
+            elements_ = elements_.subspan(1);
+            if (intrinsics::is_coroutine_suspended(channel_.send(element, this))) {
+                return intrinsics::get_COROUTINE_SUSPENDED();
+            }
+            elements_ = elements_.subspan(channel_.try_send_batch(elements_));
+        }
+        return nullptr;
+    }
+
+    void resume_with(Result<void*> result) override {
+        Continuation<void*>* completion = completion_;
+        std::exception_ptr cause = result.exception_or_null();
+        if (!cause) {
+            try {
+                elements_ = elements_.subspan(channel_.try_send_batch(elements_));
+                if (intrinsics::is_coroutine_suspended(send_rest())) return;
+            } catch (...) {
+                cause = std::current_exception();
+            }
+        }
+        delete this;
+        completion->resume_with(cause ? Result<void*>::failure(cause) : Result<void*>::success(nullptr));
+    }
+
+private:
+    SendChannel<E>& channel_;
+    std::span<const E> elements_;
+    Continuation<void*>* completion_;
+};
+
+/**
+ * A [ReceiveChannel::receive_many] that found the channel empty: waits in [receive] for one
+ * element, then takes what arrived with it. It deletes itself when it resumes the caller.
+ */
+template <typename E>
+class ReceiveManyFrame : public Continuation<void*> {
+public:
+    ReceiveManyFrame(ReceiveChannel<E>& channel, std::size_t max, std::vector<E>& out,
+                     Continuation<void*>* completion)
+        : channel_(channel), max_(max), out_(out), completion_(completion) {}
+
+    std::shared_ptr<CoroutineContext> get_context() const override { return completion_->get_context(); }
+
+    /** Appends [element], the boxed result of [receive], and up to `max - 1` more. */
+    void take(void* element) {
+        std::unique_ptr<E> box(static_cast<E*>(element));
+        out_.push_back(std::move(*box));
+        channel_.try_receive_many(max_ - 1, out_);
+    }
+
+    void resume_with(Result<void*> result) override {
+        Continuation<void*>* completion = completion_;
+        std::exception_ptr cause = result.exception_or_null();
+        if (!cause) {
+            try {
+                take(result.get_or_throw());
+            } catch (...) {
+                cause = std::current_exception();
+            }
+        }
+        delete this;
+        completion->resume_with(cause ? Result<void*>::failure(cause) : Result<void*>::success(nullptr));
+    }
+
+private:
+    ReceiveChannel<E>& channel_;
+    std::size_t max_;
+    std::vector<E>& out_;
+    Continuation<void*>* completion_;
+};
+
+} // namespace detail
+
 // =============================================================================
 // SendChannel Interface
 // =============================================================================
@@ -971,6 +1074,55 @@ public:
      */
     virtual ChannelResult<void> try_send(E element) = 0;
 
+    /**
+     * Attempts to add the specified [elements] to this channel without waiting,
+     * in order, and returns how many of them were added.
+     *
+     * The added elements are always a prefix of [elements]: adding stops
+     * where [try_send] would fail, because the channel is full or
+     * [closed][close]. The rest were not delivered, and the
+     * `on_undelivered_element` callback does *not* get called for them.
+     *
+     * The default implementation calls [try_send] for each element;
+     * [BufferedChannel] claims the cells for the whole batch at once.
+     *
+     * [send_all] is the suspending counterpart.
+     *
+     * C++ only: no Kotlin counterpart.
+     */
+    virtual std::size_t try_send_batch(std::span<const E> elements) {
+        std::size_t sent = 0;
+        while (sent < elements.size() && try_send(elements[sent]).is_success()) ++sent;
+        return sent;
+    }
+
+    /**
+     * Sends all of [elements] in order, suspending while the channel is full.
+     *
+     * As many as fit go with one [try_send_batch]; only the rest are sent
+     * one [send] at a time, each followed by another [try_send_batch]. The
+     * frame holding that rest is allocated only when the first batch falls
+     * short. [elements] must stay valid until this resumes.
+     *
+     * Like [send], this throws (or resumes [continuation] with) the close
+     * cause if the channel is closed; the elements sent before that stay
+     * sent. Cancellation while suspended leaves the unsent ones unsent.
+     *
+     * @param continuation The continuation to resume when all are sent.
+     * @return COROUTINE_SUSPENDED or `nullptr` (Unit).
+     *
+     * C++ only: no Kotlin counterpart.
+     */
+    void* send_all(std::span<const E> elements, Continuation<void*>* continuation) {
+        elements = elements.subspan(try_send_batch(elements));
+        if (elements.empty()) return nullptr;
+        auto frame = std::make_unique<detail::SendAllFrame<E>>(*this, elements, continuation);
+        void* result = frame->send_rest();
+        // Once suspended, the frame belongs to the channel and deletes itself
+        if (intrinsics::is_coroutine_suspended(result)) frame.release();
+        return result;
+    }
+
     /**
      * Closes this channel so that subsequent attempts to [send] to it fail.
      *
@@ -1415,6 +1567,76 @@ public:
      */
     virtual ChannelResult<E> try_receive() = 0;
 
+    /**
+     * Retrieves up to [max] elements from this channel without waiting,
+     * appends them to [out] in order, and returns how many were retrieved.
+     *
+     * Returns `0` when the channel is empty or
+     * [closed for receive][is_closed_for_receive]; unlike [try_receive],
+     * the close cause is not reported.
+     *
+     * The default implementation calls [try_receive] for each element;
+     * [BufferedChannel] claims the cells for the whole batch at once.
+     *
+     * [receive_many] is the suspending counterpart.
+     *
+     * C++ only: no Kotlin counterpart.
+     */
+    virtual std::size_t try_receive_many(std::size_t max, std::vector<E>& out) {
+        std::size_t received = 0;
+        while (received < max) {
+            ChannelResult<E> result = try_receive();
+            if (!result.is_success()) break;
+            out.push_back(result.get_or_throw());
+            ++received;
+        }
+        return received;
+    }
+
+    /**
+     * Retrieves between one and [max] elements from this channel and appends
+     * them to [out] in order, suspending while the channel is empty.
+     *
+     * The elements already there are taken with one [try_receive_many]. Only
+     * when there are none does this wait in [receive] for the first one and
+     * then take up to `max - 1` more that arrived with it; the frame for
+     * that wait is allocated only then. How many were retrieved is the
+     * growth of [out], which must stay valid until this resumes. With a
+     * [max] of `0` this returns at once.
+     *
+     * Like [receive], this throws (or resumes [continuation] with)
+     * [ClosedReceiveChannelException] or the close cause once the channel
+     * is closed for receive.
+     *
+     * @param continuation The continuation to resume when elements arrived.
+     * @return COROUTINE_SUSPENDED or `nullptr` (Unit).
+     *
+     * C++ only: no Kotlin counterpart.
+     */
+    void* receive_many(std::size_t max, std::vector<E>& out, Continuation<void*>* continuation) {
+        if (max == 0 || try_receive_many(max, out) > 0) return nullptr;
+        auto frame = std::make_unique<detail::ReceiveManyFrame<E>>(*this, max, out, continuation);
+        void* element = receive(frame.get());
+        if (intrinsics::is_coroutine_suspended(element)) {
+            // Once suspended, the frame belongs to the channel and deletes itself
+            frame.release();
+            return element;
+        }
+        frame->take(element);
+        return nullptr;
+    }
+
+    /**
+     * Appends every element that can be retrieved from this channel without
+     * waiting to [out] and returns how many there were: [try_receive_many]
+     * without a limit.
+     *
+     * C++ only: no Kotlin counterpart.
+     */
+    std::size_t drain_to(std::vector<E>& out) {
+        return try_receive_many(std::numeric_limits<std::size_t>::max(), out);
+    }
+
     /**
      * Returns a new iterator to receive elements from this channel using
      * a `for` loop.
@@ -1889,6 +2111,31 @@ std::shared_ptr<Channel<E>> create_channel(
     OnUndeliveredElement<E> on_undelivered_element = nullptr
 );
 
+/**
+ * Creates a channel for the given [mode]; the other parameters are those of
+ * `create_channel(capacity, on_buffer_overflow, on_undelivered_element)`.
+ *
+ * With [ChannelMode::SPSC], a suspending channel of a finite capacity is a
+ * [SpscChannel], which must have at most one sender and one receiver at a
+ * time. Every other combination gets the channel that the overload without
+ * [mode] creates.
+ *
+ * ```cpp
+ * // A pipeline stage that hands batches to exactly one consumer
+ * auto batches = create_channel<Batch>(ChannelMode::SPSC, 16);
+ * ```
+ *
+ * C++ only: no Kotlin counterpart.
+ */
+// Declaration - implementation in Channels.hpp
+template <typename E>
+std::shared_ptr<Channel<E>> create_channel(
+    ChannelMode mode,
+    int capacity = Channel<E>::RENDEZVOUS,
+    BufferOverflow on_buffer_overflow = BufferOverflow::SUSPEND,
+    OnUndeliveredElement<E> on_undelivered_element = nullptr
+);
+
 } // namespace channels
 } // namespace coroutines
 } // namespace kotlinx
@@ -34,6 +34,8 @@ public:
 
     ChannelResult<void> try_send(E element) override { return _channel->try_send(std::move(element)); }
 
+    std::size_t try_send_batch(std::span<const E> elements) override { return _channel->try_send_batch(elements); }
+
     bool close(std::exception_ptr cause = nullptr) override { return _channel->close(cause); }
 
     void invoke_on_close(std::function<void(std::exception_ptr)> handler) override {
@@ -54,6 +56,10 @@ public:
 
     ChannelResult<E> try_receive() override { return _channel->try_receive(); }
 
+    std::size_t try_receive_many(std::size_t max, std::vector<E>& out) override {
+        return _channel->try_receive_many(max, out);
+    }
+
     selects::SelectClause2<E, SendChannel<E>*>& on_send() override {
         return _channel->on_send();
     }
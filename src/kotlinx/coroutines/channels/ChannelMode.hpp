@@ -0,0 +1,36 @@
+#pragma once
+
+/**
+ * C++ only: no Kotlin counterpart.
+ */
+
+namespace kotlinx::coroutines::channels {
+
+/**
+ * How many coroutines a [channel][Channel] is used by, passed to `create_channel()` as a hint
+ * for choosing the implementation:
+ *
+ * - [MPMC] &mdash; any number of senders and receivers; the default.
+ * - [SPSC] &mdash; exactly one sender and one receiver.
+ */
+enum class ChannelMode {
+    /**
+     * Any number of coroutines send and receive concurrently.
+     * The channel is a [BufferedChannel] or a [ConflatedBufferedChannel].
+     */
+    MPMC,
+
+    /**
+     * At most one coroutine sends and at most one receives at a time; they may be on different
+     * threads. For a suspending buffer overflow and a capacity other than
+     * [UNLIMITED][Channel::UNLIMITED] and [CONFLATED][Channel::CONFLATED] the channel is a
+     * [SpscChannel], a bounded ring buffer without the cell protocol of [BufferedChannel];
+     * otherwise the hint is ignored.
+     *
+     * Concurrent sends, or concurrent receives, on such a channel are undefined behavior.
+     * Closing and cancelling it are allowed from anywhere.
+     */
+    SPSC
+};
+
+} // namespace kotlinx::coroutines::channels
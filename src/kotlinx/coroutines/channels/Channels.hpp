@@ -13,10 +13,12 @@
 #include "kotlinx/coroutines/channels/Channel.hpp"
 #include "kotlinx/coroutines/channels/BufferedChannel.hpp"
 #include "kotlinx/coroutines/channels/ConflatedBufferedChannel.hpp"
+#include "kotlinx/coroutines/channels/SpscChannel.hpp"
 #include "kotlinx/coroutines/channels/BufferOverflow.hpp"
 #include "kotlinx/coroutines/CoroutineScope.hpp"
 #include "kotlinx/coroutines/Exceptions.hpp"
 #include "kotlinx/coroutines/selects/Select.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 #include <functional>
 #include <vector>
 #include <exception>
@@ -78,6 +80,28 @@ std::shared_ptr<Channel<E>> create_channel(
     }
 }
 
+/**
+ * Creates a channel for the given mode: a SpscChannel for ChannelMode::SPSC when the channel
+ * suspends on overflow and its capacity is finite, otherwise the channel created without a mode.
+ */
+template <typename E>
+std::shared_ptr<Channel<E>> create_channel(
+    ChannelMode mode,
+    int capacity,
+    BufferOverflow on_buffer_overflow,
+    OnUndeliveredElement<E> on_undelivered_element
+) {
+    if (mode == ChannelMode::SPSC && on_buffer_overflow == BufferOverflow::SUSPEND) {
+        if (capacity == Channel<E>::BUFFERED) {
+            return std::make_shared<SpscChannel<E>>(Channel<E>::channel_default_capacity(), on_undelivered_element);
+        }
+        if (capacity >= Channel<E>::RENDEZVOUS && capacity != Channel<E>::UNLIMITED) {
+            return std::make_shared<SpscChannel<E>>(capacity, on_undelivered_element);
+        }
+    }
+    return create_channel<E>(capacity, on_buffer_overflow, on_undelivered_element);
+}
+
 /**
  * Adds element to this channel, **blocking** the caller while this channel is full,
  * and returning either successful result when the element was added, or
@@ -126,7 +150,7 @@ ChannelResult<void> try_send_blocking(SendChannel<E>* channel, E element) {
         }
     };
 
-    auto cont = std::make_shared<BlockingContinuation>(mtx, cv, done, ex);
+    auto cont = kotlinx::coroutines::internal::make_frame<BlockingContinuation>(mtx, cv, done, ex);
 
     try {
         void* send_result = channel->send(std::move(element), cont.get());
@@ -76,6 +76,11 @@ public:
         return try_send_impl(std::move(element), false);
     }
 
+    // Overflowing elements are conflated one by one
+    std::size_t try_send_batch(std::span<const E> elements) override {
+        return SendChannel<E>::try_send_batch(elements);
+    }
+
     bool should_send_suspend() const override {
         return false;  // never suspends
     }
@@ -103,10 +108,9 @@ private:
         return ChannelResult<void>::success();
     }
 
-    // The DROP_OLDEST logic is handled by isConflatedDropOldest() being true
     ChannelResult<void> try_send_drop_oldest(E element) {
-        // When isConflatedDropOldest is true, BufferedChannel handles dropping
-        return BufferedChannel<E>::try_send(std::move(element));
+        // Drops the oldest buffered element when the buffer is full
+        return BufferedChannel<E>::try_send_drop_oldest(std::move(element));
     }
 };
 
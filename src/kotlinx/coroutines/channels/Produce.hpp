@@ -14,6 +14,7 @@
 #include "kotlinx/coroutines/CoroutineStart.hpp"
 #include "kotlinx/coroutines/channels/BufferOverflow.hpp"
 #include "kotlinx/coroutines/context_impl.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 #include <functional>
 #include <memory>
 
@@ -161,7 +162,7 @@ std::shared_ptr<ReceiveChannel<E>> produce(
     auto newContext = scope->get_coroutine_context()->operator+(context);
 
     // 3. Create Coroutine
-    auto coroutine = std::make_shared<ProducerCoroutine<E>>(newContext, channel);
+    auto coroutine = kotlinx::coroutines::internal::make_frame<ProducerCoroutine<E>>(newContext, channel);
 
     // 4. Start
     if (block) {
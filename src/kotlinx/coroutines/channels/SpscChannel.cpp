@@ -0,0 +1,21 @@
+/**
+ * @file SpscChannel.cpp
+ * @brief Implementation of SpscChannel.
+ *
+ * NOTE: The detailed API documentation and class definitions are located
+ * in the companion header file: `include/kotlinx/coroutines/channels/SpscChannel.hpp`.
+ */
+
+#include "kotlinx/coroutines/channels/SpscChannel.hpp"
+
+namespace kotlinx {
+    namespace coroutines {
+        namespace channels {
+            // Template implementation is in the header.
+
+            // Explicit instantiation for common types to ensure compilation validity and linkage.
+            template class SpscChannel<int>;
+            template class SpscChannel<std::string>;
+        } // namespace channels
+    } // namespace coroutines
+} // namespace kotlinx
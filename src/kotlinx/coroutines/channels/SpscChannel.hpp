@@ -0,0 +1,855 @@
+#pragma once
+/**
+ * @file SpscChannel.hpp
+ * @brief A channel for one sender and one receiver: a bounded ring buffer.
+ *
+ * C++ only: no Kotlin counterpart. `create_channel(ChannelMode::SPSC, ...)` returns one.
+ */
+
+#include "kotlinx/coroutines/channels/Channel.hpp"
+#include "kotlinx/coroutines/channels/BufferedChannel.hpp"
+#include "kotlinx/coroutines/CancellableContinuationImpl.hpp"
+#include "kotlinx/coroutines/dsl/CancellableReusable.hpp"
+#include "kotlinx/coroutines/internal/CacheLine.hpp"
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <new>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+
+namespace kotlinx {
+namespace coroutines {
+namespace channels {
+
+/**
+ * A [Channel] with a fixed capacity for exactly one sending and one receiving coroutine, which
+ * may run on different threads. [close] and [cancel] may be called from anywhere.
+ *
+ * The buffer is a ring of `capacity` elements. `tail_` is advanced only by the sender and
+ * `head_` only by the receiver; each side caches the other's index and reads it again only
+ * when the ring looks full or empty. The top bit of `tail_` is the close flag, so a send and
+ * a close are ordered by the same atomic. A rendezvous channel has no ring: elements go
+ * straight from a suspended side to the other.
+ *
+ * The side that cannot go on parks its continuation in the single waiter slot; at most one side
+ * is parked at a time, since the other would not have to wait. Whoever comes next claims the
+ * parked continuation: the slot stays claimed while the claimer acts for the parked side, pushing
+ * the element of a parked sender or handing the head of the ring to a parked receiver, and
+ * resumes it. A parked continuation that is cancelled takes itself out of the slot from its
+ * cancellation handler, unless someone has claimed it already.
+ *
+ * Select clauses are not supported.
+ */
+template <typename E>
+class SpscChannel : public Channel<E> {
+public:
+    explicit SpscChannel(int capacity, OnUndeliveredElement<E> on_undelivered_element = nullptr)
+        : capacity_(checked_capacity(capacity))
+        , ring_mask_(capacity > 0 ? std::bit_ceil(static_cast<uint64_t>(capacity)) - 1 : 0)
+        , ring_(capacity > 0 ? std::make_unique<Slot[]>(ring_mask_ + 1) : nullptr)
+        , on_undelivered_element_(std::move(on_undelivered_element)) {}
+
+    SpscChannel(const SpscChannel&) = delete;
+    SpscChannel& operator=(const SpscChannel&) = delete;
+
+    ~SpscChannel() override {
+        const uint64_t tail = index_of(tail_.load(std::memory_order_acquire));
+        for (uint64_t head = head_.load(std::memory_order_acquire); head != tail; ++head) {
+            slot(head).get()->~E();
+        }
+        if (is_sender(waiter_.load(std::memory_order_acquire))) pending_.get()->~E();
+
+        void* cause = close_cause_.load(std::memory_order_acquire);
+        if (cause != static_cast<void*>(&NO_CLOSE_CAUSE()) && cause != nullptr) {
+            delete static_cast<std::exception_ptr*>(cause);
+        }
+        void* handler = close_handler_.load(std::memory_order_acquire);
+        if (handler != nullptr && handler != static_cast<void*>(&CLOSE_HANDLER_CLOSED()) &&
+            handler != static_cast<void*>(&CLOSE_HANDLER_INVOKED())) {
+            delete static_cast<std::function<void(std::exception_ptr)>*>(handler);
+        }
+    }
+
+    int capacity() const { return capacity_; }
+
+    // =========================================================================
+    // Sending
+    // =========================================================================
+
+    bool is_closed_for_send() const override {
+        return (tail_.load(std::memory_order_acquire) & CLOSED_BIT) != 0;
+    }
+
+    void* send(E element, Continuation<void*>* completion) override {
+        switch (send_attempt(element, true)) {
+            case Attempt::DONE:
+                return nullptr;
+            case Attempt::CLOSED:
+                call_undelivered_element(element);
+                std::rethrow_exception(send_exception());
+            case Attempt::WAIT:
+                break;
+        }
+        WaiterReservation reservation(this);
+        return dsl::suspend_cancellable_coroutine_reusable<void>(completion,
+            [this, &element, &reservation](CancellableContinuationImpl<void>* cont) {
+                park_sender(cont, std::move(element), reservation);
+            });
+    }
+
+    ChannelResult<void> try_send(E element) override {
+        switch (send_attempt(element, false)) {
+            case Attempt::DONE:
+                return ChannelResult<void>::success();
+            case Attempt::WAIT:
+                return ChannelResult<void>::failure();
+            case Attempt::CLOSED:
+                break;
+        }
+        return ChannelResult<void>::closed(send_exception());
+    }
+
+    selects::SelectClause2<E, SendChannel<E>*>& on_send() override {
+        throw std::logic_error("SpscChannel::on_send select clause is not supported");
+    }
+
+    // =========================================================================
+    // Receiving
+    // =========================================================================
+
+    bool is_closed_for_receive() const override {
+        if (cancelled_.load(std::memory_order_acquire)) return true;
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        return (tail & CLOSED_BIT) != 0 && index_of(tail) == head_.load(std::memory_order_acquire) &&
+               !is_sender(waiter_.load(std::memory_order_acquire));
+    }
+
+    bool is_empty() const override {
+        if (is_closed_for_receive()) return false;
+        return index_of(tail_.load(std::memory_order_acquire)) == head_.load(std::memory_order_acquire) &&
+               !is_sender(waiter_.load(std::memory_order_acquire));
+    }
+
+    void* receive(Continuation<void*>* completion) override {
+        std::optional<E> element;
+        switch (receive_attempt(element, true)) {
+            case Attempt::DONE:
+                return new E(std::move(*element));
+            case Attempt::CLOSED:
+                std::rethrow_exception(receive_exception());
+            case Attempt::WAIT:
+                break;
+        }
+        WaiterReservation reservation(this);
+        return dsl::suspend_cancellable_coroutine_reusable<E>(completion,
+            [this, &reservation](CancellableContinuationImpl<E>* cont) {
+                park_receiver(cont, ReceiveKind::RECEIVE, nullptr, reservation);
+            });
+    }
+
+    selects::SelectClause1<E>& on_receive() override {
+        throw std::logic_error("SpscChannel::on_receive select clause is not supported");
+    }
+
+    void* receive_catching(Continuation<void*>* completion) override {
+        std::optional<E> element;
+        switch (receive_attempt(element, true)) {
+            case Attempt::DONE:
+                return new ChannelResult<E>(ChannelResult<E>::success(std::move(*element)));
+            case Attempt::CLOSED:
+                return new ChannelResult<E>(ChannelResult<E>::closed(close_cause()));
+            case Attempt::WAIT:
+                break;
+        }
+        WaiterReservation reservation(this);
+        return dsl::suspend_cancellable_coroutine_reusable<ChannelResult<E>>(completion,
+            [this, &reservation](CancellableContinuationImpl<ChannelResult<E>>* cont) {
+                park_receiver(cont, ReceiveKind::RECEIVE_CATCHING, nullptr, reservation);
+            });
+    }
+
+    selects::SelectClause1<ChannelResult<E>>& on_receive_catching() override {
+        throw std::logic_error("SpscChannel::on_receive_catching select clause is not supported");
+    }
+
+    ChannelResult<E> try_receive() override {
+        std::optional<E> element;
+        switch (receive_attempt(element, false)) {
+            case Attempt::DONE:
+                return ChannelResult<E>::success(std::move(*element));
+            case Attempt::WAIT:
+                return ChannelResult<E>::failure();
+            case Attempt::CLOSED:
+                break;
+        }
+        return ChannelResult<E>::closed(close_cause());
+    }
+
+    std::unique_ptr<ChannelIterator<E>> iterator() override {
+        return std::make_unique<SpscChannelIterator>(this);
+    }
+
+    // =========================================================================
+    // Closing and cancellation
+    // =========================================================================
+
+    std::exception_ptr close_cause() const {
+        void* cause = close_cause_.load(std::memory_order_acquire);
+        if (cause == static_cast<void*>(&NO_CLOSE_CAUSE()) || cause == nullptr) return nullptr;
+        return *static_cast<std::exception_ptr*>(cause);
+    }
+
+    std::exception_ptr send_exception() const {
+        auto cause = close_cause();
+        if (cause) return cause;
+        return std::make_exception_ptr(ClosedSendChannelException("Channel was closed"));
+    }
+
+    std::exception_ptr receive_exception() const {
+        auto cause = close_cause();
+        if (cause) return cause;
+        return std::make_exception_ptr(ClosedReceiveChannelException("Channel was closed"));
+    }
+
+    /**
+     * Closes this channel for sending. The buffered elements and the element of a suspended
+     * sender can still be received.
+     */
+    bool close(std::exception_ptr cause = nullptr) override {
+        return close_or_cancel(cause, false);
+    }
+
+    /**
+     * Cancels this channel: a suspended sender or receiver is resumed with the cause, and the
+     * buffered elements are dropped by the next receive attempt, or when the channel is
+     * destroyed, going to `on_undelivered_element` in the former case.
+     */
+    void cancel(std::exception_ptr cause = nullptr) override {
+        if (!cause) cause = std::make_exception_ptr(std::runtime_error("Channel was cancelled"));
+        close_or_cancel(cause, true);
+    }
+
+    void invoke_on_close(std::function<void(std::exception_ptr)> handler) override {
+        void* null_handler = nullptr;
+        auto* handler_ptr = new std::function<void(std::exception_ptr)>(handler);
+        if (close_handler_.compare_exchange_strong(null_handler, handler_ptr,
+                std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return;
+        }
+        delete handler_ptr;
+
+        void* cur = close_handler_.load(std::memory_order_acquire);
+        if (cur == static_cast<void*>(&CLOSE_HANDLER_CLOSED()) &&
+            close_handler_.compare_exchange_strong(cur, static_cast<void*>(&CLOSE_HANDLER_INVOKED()),
+                std::memory_order_acq_rel, std::memory_order_acquire)) {
+            handler(close_cause());
+            return;
+        }
+        if (cur == static_cast<void*>(&CLOSE_HANDLER_INVOKED())) {
+            throw std::logic_error("Another handler was already registered and successfully invoked");
+        }
+        throw std::logic_error("Another handler is already registered");
+    }
+
+private:
+    // What a send or receive attempt ended with; WAIT leaves the waiter slot reserved when asked to.
+    enum class Attempt { DONE, WAIT, CLOSED };
+
+    // The continuation type of a parked receiver
+    enum class ReceiveKind { RECEIVE, RECEIVE_CATCHING, HAS_NEXT };
+
+    class SpscChannelIterator;
+
+    struct Slot {
+        alignas(E) unsigned char storage[sizeof(E)];
+
+        E* get() { return std::launder(reinterpret_cast<E*>(storage)); }
+    };
+
+    // A continuation taken out of the waiter slot, with what it parked
+    struct Parked {
+        std::uintptr_t waiter = NO_WAITER;
+        ReceiveKind kind = ReceiveKind::RECEIVE;
+        SpscChannelIterator* iterator = nullptr;
+        std::shared_ptr<void> ref;
+        std::optional<E> element;
+    };
+
+    static constexpr uint64_t CLOSED_BIT = uint64_t{1} << 63;
+
+    // The waiter slot holds nothing, a claim in progress, or a parked continuation tagged with
+    // its side; continuations are aligned, so the low bits of their address are free.
+    static constexpr std::uintptr_t NO_WAITER = 0;
+    static constexpr std::uintptr_t WAITER_CLAIMED = 1;
+    static constexpr std::uintptr_t SENDER_TAG = 2;
+
+    static int checked_capacity(int capacity) {
+        if (capacity < 0 || capacity == Channel<E>::UNLIMITED) {
+            throw std::invalid_argument(
+                "SpscChannel capacity must be finite and non-negative, but " + std::to_string(capacity) +
+                " was specified");
+        }
+        return capacity;
+    }
+
+    static uint64_t index_of(uint64_t tail) { return tail & ~CLOSED_BIT; }
+
+    static bool is_sender(std::uintptr_t waiter) { return (waiter & SENDER_TAG) != 0; }
+
+    static bool is_receiver(std::uintptr_t waiter) {
+        return waiter > WAITER_CLAIMED && (waiter & SENDER_TAG) == 0;
+    }
+
+    Slot& slot(uint64_t index) { return ring_[index & ring_mask_]; }
+
+    // -------------------------------------------------------------------------
+    // The ring
+    // -------------------------------------------------------------------------
+
+    // Sender side: appends [element] unless the ring is full or closed.
+    Attempt push(E& element) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        if ((tail & CLOSED_BIT) != 0) return Attempt::CLOSED;
+        if (tail - head_cache_ >= static_cast<uint64_t>(capacity_)) {
+            head_cache_ = head_.load(std::memory_order_seq_cst);
+            if (tail - head_cache_ >= static_cast<uint64_t>(capacity_)) return Attempt::WAIT;
+        }
+        E* cell = new (slot(tail).storage) E(std::move(element));
+        // Fails only when close() set the close flag meanwhile
+        if (!tail_.compare_exchange_strong(tail, tail + 1, std::memory_order_seq_cst)) {
+            element = std::move(*cell);
+            cell->~E();
+            return Attempt::CLOSED;
+        }
+        return Attempt::DONE;
+    }
+
+    // Sender side, acting for a parked sender that was resumed: the receiver made room, and
+    // the element is delivered even if the channel was closed since the sender parked.
+    void push_parked(E&& element) {
+        const uint64_t tail = index_of(tail_.load(std::memory_order_relaxed));
+        new (slot(tail).storage) E(std::move(element));
+        tail_.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    // Receiver side: the oldest element, or nullptr when the ring is empty.
+    E* front() {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_) {
+            tail_cache_ = index_of(tail_.load(std::memory_order_seq_cst));
+            if (head == tail_cache_) return nullptr;
+        }
+        return slot(head).get();
+    }
+
+    // Receiver side: destroys the element returned by front().
+    void pop_front() {
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        slot(head).get()->~E();
+        head_.store(head + 1, std::memory_order_seq_cst);
+    }
+
+    // -------------------------------------------------------------------------
+    // The waiter slot
+    // -------------------------------------------------------------------------
+
+    // Reserves the empty slot for parking.
+    bool reserve_waiter() {
+        std::uintptr_t expected = NO_WAITER;
+        return waiter_.compare_exchange_strong(expected, WAITER_CLAIMED, std::memory_order_seq_cst);
+    }
+
+    /**
+     * Takes the parked [waiter] with what it parked, leaving the slot claimed until release();
+     * fails if someone else took it first.
+     */
+    bool claim(std::uintptr_t waiter, Parked& parked) {
+        if (!waiter_.compare_exchange_strong(waiter, WAITER_CLAIMED, std::memory_order_seq_cst)) return false;
+        parked.waiter = waiter;
+        parked.kind = receive_kind_;
+        parked.iterator = receive_iterator_;
+        parked.ref = std::move(waiter_ref_);
+        if (is_sender(waiter)) {
+            E* element = pending_.get();
+            parked.element.emplace(std::move(*element));
+            element->~E();
+        }
+        return true;
+    }
+
+    void release() { waiter_.store(NO_WAITER, std::memory_order_seq_cst); }
+
+    /**
+     * The slot reserved by an attempt that returned WAIT, held while that side parks. If
+     * parking throws before the continuation is in the slot, the slot is given back; otherwise
+     * the other side would wait for the claim to end forever.
+     */
+    class WaiterReservation {
+    public:
+        explicit WaiterReservation(SpscChannel* channel) : channel_(channel) {}
+        WaiterReservation(const WaiterReservation&) = delete;
+        WaiterReservation& operator=(const WaiterReservation&) = delete;
+
+        ~WaiterReservation() {
+            if (!held_) return;
+            channel_->waiter_ref_.reset();
+            channel_->release();
+        }
+
+        // The continuation was published in the slot, which is no longer ours
+        void parked() { held_ = false; }
+
+        // A later attempt reserved the slot again
+        void reserved() { held_ = true; }
+
+    private:
+        SpscChannel* channel_;
+        bool held_ = true;
+    };
+
+    // Takes [waiter], cancelled while it was parked, out of the slot unless someone claimed it.
+    void remove_cancelled(std::uintptr_t waiter) {
+        Parked parked;
+        if (!claim(waiter, parked)) return;
+        release();
+        if (is_sender(waiter)) call_undelivered_element(*parked.element);
+    }
+
+    // -------------------------------------------------------------------------
+    // Send
+    // -------------------------------------------------------------------------
+
+    /**
+     * Sends [element] without suspending. On WAIT with [reserve] the waiter slot is reserved
+     * for the sender to park; [element] is moved from only on DONE.
+     */
+    Attempt send_attempt(E& element, bool reserve) {
+        while (true) {
+            if (cancelled_.load(std::memory_order_acquire)) return Attempt::CLOSED;
+            const std::uintptr_t waiter = waiter_.load(std::memory_order_seq_cst);
+            if (waiter == WAITER_CLAIMED) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (waiter != NO_WAITER) {
+                Parked parked;
+                if (!claim(waiter, parked)) continue;
+                if (is_sender(waiter)) {
+                    // Ours, cancelled while it waited
+                    release();
+                    call_undelivered_element(*parked.element);
+                    continue;
+                }
+                // The ring is empty, but for elements sent while the receiver parked
+                if (E* head = front()) {
+                    void* token = try_resume_receiver(parked, *head);
+                    if (token != nullptr) pop_front();
+                    release();
+                    if (token != nullptr) complete_resume_receiver(parked, token);
+                    continue;
+                }
+                void* token = try_resume_receiver(parked, element);
+                release();
+                if (token == nullptr) continue;
+                complete_resume_receiver(parked, token);
+                return Attempt::DONE;
+            }
+            const Attempt pushed = push(element);
+            if (pushed == Attempt::DONE) {
+                notify_receiver();
+                return Attempt::DONE;
+            }
+            if (pushed == Attempt::CLOSED || !reserve) return pushed;
+            if (reserve_waiter()) return Attempt::WAIT;
+        }
+    }
+
+    // Resumes a receiver that parked before the element just pushed was visible to it.
+    void notify_receiver() {
+        const std::uintptr_t waiter = waiter_.load(std::memory_order_seq_cst);
+        if (!is_receiver(waiter)) return;
+        Parked parked;
+        if (!claim(waiter, parked)) return;
+        void* token = nullptr;
+        if (E* head = front()) {
+            token = try_resume_receiver(parked, *head);
+            if (token != nullptr) pop_front();
+        }
+        release();
+        if (token != nullptr) complete_resume_receiver(parked, token);
+    }
+
+    void park_sender(CancellableContinuationImpl<void>* cont, E element, WaiterReservation& reservation) {
+        // The slot is reserved by send_attempt
+        while (true) {
+            waiter_ref_ = cont->shared_from_this();
+            new (pending_.storage) E(std::move(element));
+            const std::uintptr_t waiter = reinterpret_cast<std::uintptr_t>(cont) | SENDER_TAG;
+            waiter_.store(waiter, std::memory_order_seq_cst);
+            reservation.parked();
+
+            // A suspended sender survives close(); room or cancellation may have been missed
+            const uint64_t tail = index_of(tail_.load(std::memory_order_seq_cst));
+            if (tail - head_.load(std::memory_order_seq_cst) >= static_cast<uint64_t>(capacity_) &&
+                !cancelled_.load(std::memory_order_seq_cst)) {
+                cont->invoke_on_cancellation([this, waiter](std::exception_ptr) { remove_cancelled(waiter); });
+                return;
+            }
+            Parked parked;
+            if (!claim(waiter, parked)) return;
+            release();
+            element = std::move(*parked.element);
+            switch (send_attempt(element, true)) {
+                case Attempt::DONE:
+                    cont->resume_with(Result<void>::success());
+                    return;
+                case Attempt::CLOSED:
+                    call_undelivered_element(element);
+                    cont->resume_with(Result<void>::failure(send_exception()));
+                    return;
+                case Attempt::WAIT:
+                    reservation.reserved();
+                    break;
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Receive
+    // -------------------------------------------------------------------------
+
+    /**
+     * Retrieves an element into [element] without suspending. On WAIT with [reserve] the
+     * waiter slot is reserved for the receiver to park.
+     */
+    Attempt receive_attempt(std::optional<E>& element, bool reserve) {
+        while (true) {
+            const std::uintptr_t waiter = waiter_.load(std::memory_order_seq_cst);
+            // Someone may be acting for a receiver of ours that was cancelled while it waited
+            if (waiter == WAITER_CLAIMED) {
+                std::this_thread::yield();
+                continue;
+            }
+            if (is_receiver(waiter)) {
+                Parked parked;
+                if (claim(waiter, parked)) release();
+                continue;
+            }
+            if (cancelled_.load(std::memory_order_acquire)) {
+                drain();
+                return Attempt::CLOSED;
+            }
+            if (E* head = front()) {
+                element.emplace(std::move(*head));
+                pop_front();
+                notify_sender();
+                return Attempt::DONE;
+            }
+            if (is_sender(waiter)) {
+                // A rendezvous, or a sender that parked while the ring was full
+                Parked parked;
+                if (!claim(waiter, parked)) continue;
+                release();
+                auto* sender = reinterpret_cast<CancellableContinuationImpl<void>*>(waiter & ~SENDER_TAG);
+                void* token = sender->try_resume(nullptr);
+                if (token == nullptr) {
+                    call_undelivered_element(*parked.element);
+                    continue;
+                }
+                sender->complete_resume(token);
+                element = std::move(parked.element);
+                return Attempt::DONE;
+            }
+            if ((tail_.load(std::memory_order_seq_cst) & CLOSED_BIT) != 0) {
+                // A sender that parked before the close may still be publishing its element
+                if (waiter_.load(std::memory_order_seq_cst) != NO_WAITER || front() != nullptr) continue;
+                return Attempt::CLOSED;
+            }
+            if (!reserve) return Attempt::WAIT;
+            if (reserve_waiter()) return Attempt::WAIT;
+        }
+    }
+
+    // Pushes the element of a sender that parked while the ring was full and resumes it.
+    void notify_sender() {
+        const std::uintptr_t waiter = waiter_.load(std::memory_order_seq_cst);
+        if (!is_sender(waiter)) return;
+        Parked parked;
+        if (!claim(waiter, parked)) return;
+        auto* sender = reinterpret_cast<CancellableContinuationImpl<void>*>(waiter & ~SENDER_TAG);
+        void* token = sender->try_resume(nullptr);
+        if (token == nullptr) {
+            release();
+            call_undelivered_element(*parked.element);
+            return;
+        }
+        push_parked(std::move(*parked.element));
+        release();
+        sender->complete_resume(token);
+    }
+
+    // Drops the buffered elements of a cancelled channel.
+    void drain() {
+        while (E* head = front()) {
+            std::optional<E> element(std::move(*head));
+            pop_front();
+            call_undelivered_element(*element);
+        }
+    }
+
+    template <typename T>
+    void park_receiver(CancellableContinuationImpl<T>* cont, ReceiveKind kind, SpscChannelIterator* iterator,
+                       WaiterReservation& reservation) {
+        // The slot is reserved by receive_attempt
+        while (true) {
+            waiter_ref_ = cont->shared_from_this();
+            receive_kind_ = kind;
+            receive_iterator_ = iterator;
+            const std::uintptr_t waiter = reinterpret_cast<std::uintptr_t>(cont);
+            waiter_.store(waiter, std::memory_order_seq_cst);
+            reservation.parked();
+
+            // An element, close or cancellation may have been missed; only a claimer may act
+            // for the receiver from here on, so the indexes are read, not the caches
+            const uint64_t tail = tail_.load(std::memory_order_seq_cst);
+            if (index_of(tail) == head_.load(std::memory_order_seq_cst) && (tail & CLOSED_BIT) == 0 &&
+                !cancelled_.load(std::memory_order_seq_cst)) {
+                cont->invoke_on_cancellation([this, waiter](std::exception_ptr) { remove_cancelled(waiter); });
+                return;
+            }
+            Parked parked;
+            if (!claim(waiter, parked)) return;
+            release();
+            std::optional<E> element;
+            switch (receive_attempt(element, true)) {
+                case Attempt::DONE:
+                    if (void* token = try_resume_receiver(parked, *element)) {
+                        complete_resume_receiver(parked, token);
+                    } else {
+                        call_undelivered_element(*element);
+                    }
+                    return;
+                case Attempt::CLOSED:
+                    resume_receiver_on_closed(parked);
+                    return;
+                case Attempt::WAIT:
+                    reservation.reserved();
+                    break;
+            }
+        }
+    }
+
+    template <typename T>
+    std::function<void(std::exception_ptr, T, std::shared_ptr<CoroutineContext>)>
+    undelivered_on_cancellation(const E& element) const {
+        if (!on_undelivered_element_) return nullptr;
+        return [callback = on_undelivered_element_, element](std::exception_ptr, T, std::shared_ptr<CoroutineContext>) {
+            callback(element);
+        };
+    }
+
+    /**
+     * Takes the resumption of a claimed receiver with [element]; nullptr if it was cancelled.
+     * The receiver runs only in complete_resume_receiver(), called once the slot is released:
+     * it may be resumed in place and receive again.
+     */
+    void* try_resume_receiver(Parked& receiver, const E& element) {
+        switch (receiver.kind) {
+            case ReceiveKind::RECEIVE:
+                return reinterpret_cast<CancellableContinuationImpl<E>*>(receiver.waiter)
+                    ->try_resume(element, nullptr, undelivered_on_cancellation<E>(element));
+            case ReceiveKind::RECEIVE_CATCHING:
+                return reinterpret_cast<CancellableContinuationImpl<ChannelResult<E>>*>(receiver.waiter)
+                    ->try_resume(ChannelResult<E>::success(element), nullptr,
+                                 undelivered_on_cancellation<ChannelResult<E>>(element));
+            case ReceiveKind::HAS_NEXT: {
+                void* token = reinterpret_cast<CancellableContinuationImpl<bool>*>(receiver.waiter)
+                    ->try_resume(true, nullptr, undelivered_on_cancellation<bool>(element));
+                if (token != nullptr) receiver.iterator->element_.emplace(element);
+                return token;
+            }
+        }
+        return nullptr;
+    }
+
+    void complete_resume_receiver(Parked& receiver, void* token) {
+        switch (receiver.kind) {
+            case ReceiveKind::RECEIVE:
+                reinterpret_cast<CancellableContinuationImpl<E>*>(receiver.waiter)->complete_resume(token);
+                return;
+            case ReceiveKind::RECEIVE_CATCHING:
+                reinterpret_cast<CancellableContinuationImpl<ChannelResult<E>>*>(receiver.waiter)
+                    ->complete_resume(token);
+                return;
+            case ReceiveKind::HAS_NEXT:
+                reinterpret_cast<CancellableContinuationImpl<bool>*>(receiver.waiter)->complete_resume(token);
+                return;
+        }
+    }
+
+    void resume_receiver_on_closed(Parked& receiver) {
+        switch (receiver.kind) {
+            case ReceiveKind::RECEIVE:
+                reinterpret_cast<CancellableContinuationImpl<E>*>(receiver.waiter)
+                    ->resume_with(Result<E>::failure(receive_exception()));
+                return;
+            case ReceiveKind::RECEIVE_CATCHING:
+                reinterpret_cast<CancellableContinuationImpl<ChannelResult<E>>*>(receiver.waiter)
+                    ->resume_with(Result<ChannelResult<E>>::success(ChannelResult<E>::closed(close_cause())));
+                return;
+            case ReceiveKind::HAS_NEXT: {
+                auto* cont = reinterpret_cast<CancellableContinuationImpl<bool>*>(receiver.waiter);
+                receiver.iterator->closed_ = true;
+                auto cause = close_cause();
+                if (cause) {
+                    cont->resume_with(Result<bool>::failure(cause));
+                } else {
+                    cont->resume_with(Result<bool>::success(false));
+                }
+                return;
+            }
+        }
+    }
+
+    // -------------------------------------------------------------------------
+    // Close and cancel
+    // -------------------------------------------------------------------------
+
+    bool close_or_cancel(std::exception_ptr cause, bool cancel) {
+        void* no_cause = static_cast<void*>(&NO_CLOSE_CAUSE());
+        void* cause_ptr = cause ? new std::exception_ptr(cause) : nullptr;
+        const bool closed_by_this_operation = close_cause_.compare_exchange_strong(
+            no_cause, cause_ptr, std::memory_order_acq_rel, std::memory_order_acquire);
+        if (!closed_by_this_operation && cause_ptr) delete static_cast<std::exception_ptr*>(cause_ptr);
+
+        if (cancel) cancelled_.store(true, std::memory_order_seq_cst);
+        tail_.fetch_or(CLOSED_BIT, std::memory_order_seq_cst);
+
+        // A parked receiver learns about the close now; a parked sender is left to deliver its
+        // element unless the channel is cancelled. Parking sides check again after parking.
+        while (true) {
+            const std::uintptr_t waiter = waiter_.load(std::memory_order_seq_cst);
+            if (waiter == NO_WAITER || waiter == WAITER_CLAIMED) break;
+            if (is_sender(waiter) && !cancel) break;
+            Parked parked;
+            if (!claim(waiter, parked)) continue;
+            if (is_sender(waiter)) {
+                release();
+                call_undelivered_element(*parked.element);
+                reinterpret_cast<CancellableContinuationImpl<void>*>(waiter & ~SENDER_TAG)
+                    ->resume_with(Result<void>::failure(send_exception()));
+            } else if (E* head = cancel ? nullptr : front()) {
+                void* token = try_resume_receiver(parked, *head);
+                if (token != nullptr) pop_front();
+                release();
+                if (token != nullptr) complete_resume_receiver(parked, token);
+            } else {
+                release();
+                resume_receiver_on_closed(parked);
+            }
+            break;
+        }
+
+        if (closed_by_this_operation) invoke_close_handler();
+        return closed_by_this_operation;
+    }
+
+    void invoke_close_handler() {
+        void* handler = close_handler_.exchange(static_cast<void*>(&CLOSE_HANDLER_INVOKED()),
+                                                std::memory_order_acq_rel);
+        if (handler == nullptr) {
+            close_handler_.store(static_cast<void*>(&CLOSE_HANDLER_CLOSED()), std::memory_order_release);
+            return;
+        }
+        auto* fn = static_cast<std::function<void(std::exception_ptr)>*>(handler);
+        (*fn)(close_cause());
+        delete fn;
+    }
+
+    void call_undelivered_element(const E& element) {
+        if (on_undelivered_element_) on_undelivered_element_(element);
+    }
+
+    // -------------------------------------------------------------------------
+    // Iterator
+    // -------------------------------------------------------------------------
+
+    class SpscChannelIterator : public ChannelIterator<E> {
+    public:
+        explicit SpscChannelIterator(SpscChannel<E>* channel) : channel_(channel) {}
+
+        void* has_next(Continuation<void*>* completion) override {
+            if (element_) return new bool(true);
+            if (closed_) return new bool(false);
+            switch (channel_->receive_attempt(element_, true)) {
+                case Attempt::DONE:
+                    return new bool(true);
+                case Attempt::CLOSED: {
+                    closed_ = true;
+                    auto cause = channel_->close_cause();
+                    if (cause) std::rethrow_exception(cause);
+                    return new bool(false);
+                }
+                case Attempt::WAIT:
+                    break;
+            }
+            WaiterReservation reservation(channel_);
+            return dsl::suspend_cancellable_coroutine_reusable<bool>(completion,
+                [this, &reservation](CancellableContinuationImpl<bool>* cont) {
+                    channel_->park_receiver(cont, ReceiveKind::HAS_NEXT, this, reservation);
+                });
+        }
+
+        E next() override {
+            if (!element_) {
+                if (closed_) std::rethrow_exception(channel_->receive_exception());
+                throw std::logic_error("`hasNext()` has not been invoked");
+            }
+            E element = std::move(*element_);
+            element_.reset();
+            return element;
+        }
+
+    private:
+        friend class SpscChannel<E>;
+
+        SpscChannel<E>* channel_;
+        std::optional<E> element_;
+        bool closed_ = false;
+    };
+
+    const int capacity_;
+    const uint64_t ring_mask_;
+    const std::unique_ptr<Slot[]> ring_;
+    OnUndeliveredElement<E> on_undelivered_element_;
+
+    // The sender side: the next index to write with the close flag, and the last head it saw
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<uint64_t> tail_{0};
+    uint64_t head_cache_ = 0;
+
+    // The receiver side: the next index to read, and the last tail it saw
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+    uint64_t tail_cache_ = 0;
+
+    // The waiter slot, and what the parked continuation left with it
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<std::uintptr_t> waiter_{NO_WAITER};
+    std::shared_ptr<void> waiter_ref_;
+    ReceiveKind receive_kind_ = ReceiveKind::RECEIVE;
+    SpscChannelIterator* receive_iterator_ = nullptr;
+    Slot pending_;
+
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<void*> close_cause_{static_cast<void*>(&NO_CLOSE_CAUSE())};
+    std::atomic<bool> cancelled_{false};
+    std::atomic<void*> close_handler_{nullptr};
+};
+
+} // namespace channels
+} // namespace coroutines
+} // namespace kotlinx
@@ -6,7 +6,8 @@
  * - kotlinx-coroutines-core/common/src/CoroutineContext.common.kt (expect declarations)
  * - kotlinx-coroutines-core/native/src/CoroutineContext.kt (native actuals)
  *
- * On native, these helpers are no-ops that just run the block.
+ * On native, these helpers are no-ops that just run the block. The block is a template
+ * parameter rather than a std::function, so the dispatch path does not allocate for it.
  */
 
 #include "kotlinx/coroutines/CoroutineContext.hpp"
@@ -22,11 +23,11 @@ namespace coroutines {
  * Kotlin: internal actual inline fun <T> withCoroutineContext(...)
  * Native actual is a no-op wrapper.
  */
-template<typename R>
+template<typename R, typename Block>
 inline R with_coroutine_context(
     const std::shared_ptr<CoroutineContext>& context,
     void* count_or_element,
-    std::function<R()> block
+    Block&& block
 ) {
     return block();
 }
@@ -35,11 +36,11 @@ inline R with_coroutine_context(
  * Kotlin: internal actual inline fun <T> withContinuationContext(...)
  * Native actual is a no-op wrapper.
  */
-template<typename R, typename T>
+template<typename R, typename T, typename Block>
 inline R with_continuation_context(
-    const std::shared_ptr<Continuation<T>>& continuation,
+    Continuation<T>* continuation,
     void* count_or_element,
-    std::function<R()> block
+    Block&& block
 ) {
     return block();
 }
@@ -47,25 +47,29 @@ void DispatchedTask<T>::handle_fatal_exception(std::exception_ptr exception) {
 template<typename T>
 void DispatchedTask<T>::run() {
     assert(resume_mode != MODE_UNINITIALIZED);
-    auto delegate = get_delegate();
+    // The queue that ran this task keeps it alive, and the task keeps its delegate alive:
+    // plain pointers are enough, no reference counts are touched.
+    Continuation<T>* delegate = delegate_ptr();
     try {
         // Kotlin: val delegate = delegate as DispatchedContinuation<T>
-        auto dispatched_delegate = std::dynamic_pointer_cast<internal::DispatchedContinuation<T>>(delegate);
-        auto continuation = dispatched_delegate ? dispatched_delegate->continuation : delegate;
+        auto* dispatched_delegate = this->dispatched_delegate();
+        Continuation<T>* continuation = dispatched_delegate ? dispatched_delegate->continuation.get() : delegate;
         void* count_or_element = dispatched_delegate ? dispatched_delegate->count_or_element : nullptr;
 
         with_continuation_context<void, T>(
             continuation,
             count_or_element,
             [this, continuation, dispatched_delegate]() {
-                auto context = continuation->get_context();
+                std::shared_ptr<CoroutineContext> own_context;
+                const CoroutineContext* context = dispatched_delegate
+                    ? dispatched_delegate->context_ptr()
+                    : (own_context = continuation->get_context()).get();
                 auto state = take_state(); // must take state even if cancelled
                 auto exception = get_exceptional_result(state);
 
-                std::shared_ptr<Job> job = nullptr;
+                Job* job = nullptr;
                 if (!exception && is_cancellable_mode(resume_mode) && context) {
-                    auto job_element = context->get(Job::type_key);
-                    job = std::dynamic_pointer_cast<Job>(job_element);
+                    job = context->job_ptr();
                 }
 
                 if (job && !job->is_active()) {
@@ -101,22 +105,19 @@ template<typename T>
 static void resume_unconfined(DispatchedTask<T>* task) {
     auto event_loop = ThreadLocalEventLoop::get_event_loop();
     if (!event_loop) {
-        resume(task, task->get_delegate(), true);
+        resume(task, *task->delegate_ptr(), true);
         return;
     }
 
     if (event_loop->is_unconfined_loop_active()) {
-        // TODO(abi-ownership): No-op deleter used because DispatchedTask<T> doesn't inherit
-        // enable_shared_from_this directly (concrete subclasses do). This assumes the task
-        // stays alive through the call chain. Consider adding virtual get_shared_ptr() method.
-        event_loop->dispatch_unconfined(std::shared_ptr<SchedulerTask>(task, [](SchedulerTask*){}));
+        event_loop->dispatch_unconfined(task->shared_task());
         return;
     }
 
     // Kotlin: runUnconfinedEventLoop(eventLoop) { resume(delegate, undispatched = true) }
     event_loop->increment_use_count(true);
     try {
-        resume(task, task->get_delegate(), true);
+        resume(task, *task->delegate_ptr(), true);
         while (true) {
             if (!event_loop->process_unconfined_event()) break;
         }
@@ -131,26 +132,26 @@ template<typename T>
 void dispatch(DispatchedTask<T>* task, int mode) {
     assert(mode != MODE_UNINITIALIZED);
 
-    auto delegate = task->get_delegate();
+    // The caller keeps the task alive, and the task its delegate, dispatcher and context.
+    Continuation<T>* delegate = task->delegate_ptr();
     bool undispatched = (mode == MODE_UNDISPATCHED);
 
-    auto dispatched = std::dynamic_pointer_cast<internal::DispatchedContinuation<T>>(delegate);
+    auto* dispatched = task->dispatched_delegate();
     if (!undispatched && dispatched && is_cancellable_mode(mode) == is_cancellable_mode(task->resume_mode)) {
-        auto dispatcher = dispatched->dispatcher;
-        auto context = dispatched->get_context();
+        CoroutineDispatcher* dispatcher = dispatched->dispatcher.get();
+        const CoroutineContext* context = dispatched->context_ptr();
         if (dispatcher && context && internal::safe_is_dispatch_needed(*dispatcher, *context)) {
-            // TODO(abi-ownership): Same no-op deleter issue as resume_unconfined above.
-            internal::safe_dispatch(*dispatcher, *context, std::shared_ptr<Runnable>(task, [](Runnable*){}));
+            internal::safe_dispatch(*dispatcher, *context, task->shared_task());
         } else {
             resume_unconfined(task);
         }
     } else {
-        resume(task, delegate, undispatched);
+        resume(task, *delegate, undispatched);
     }
 }
 
 template<typename T>
-void resume(DispatchedTask<T>* task, std::shared_ptr<Continuation<T>> delegate, bool undispatched) {
+void resume(DispatchedTask<T>* task, Continuation<T>& delegate, bool undispatched) {
     auto state = task->take_state();
     auto exception = task->get_exceptional_result(state);
 
@@ -166,19 +167,21 @@ void resume(DispatchedTask<T>* task, std::shared_ptr<Continuation<T>> delegate,
     }
 
     if (undispatched) {
-        if (auto dispatched = std::dynamic_pointer_cast<internal::DispatchedContinuation<T>>(delegate)) {
+        // [delegate] is the delegate of [task], which knows whether it is dispatched
+        assert(&delegate == task->delegate_ptr());
+        if (auto* dispatched = task->dispatched_delegate()) {
             with_continuation_context<void, T>(
-                dispatched->continuation,
+                dispatched->continuation.get(),
                 dispatched->count_or_element,
-                [dispatched, result]() mutable {
-                    dispatched->continuation->resume_with(result);
+                [dispatched, &result]() {
+                    dispatched->continuation->resume_with(std::move(result));
                     return;
                 });
             return;
         }
     }
 
-    delegate->resume_with(std::move(result));
+    delegate.resume_with(std::move(result));
 }
 
 } // namespace coroutines
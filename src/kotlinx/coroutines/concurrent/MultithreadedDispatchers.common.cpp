@@ -11,56 +11,53 @@
  */
 
 #include "kotlinx/coroutines/MultithreadedDispatchers.hpp"
-#include <iostream>
+#include "kotlinx/coroutines/scheduling/CoroutineScheduler.hpp"
+#include "kotlinx/coroutines/scheduling/Dispatcher.hpp"
 
 namespace kotlinx {
     namespace coroutines {
-        //
-        // ExecutorCoroutineDispatcherImpl implementation
-        //
-
-        void ExecutorCoroutineDispatcherImpl::worker_loop() {
-            while (true) {
-                std::shared_ptr<Runnable> task;
-                {
-                    std::unique_lock<std::mutex> lock(queue_mutex_);
-                    condition_.wait(lock, [this] { return closed_ || !task_queue_.empty(); });
-
-                    if (closed_ &&task_queue_
-                    .
-                    empty()
-                    )
-                    return;
-
-                    if (!task_queue_.empty()) {
-                        task = task_queue_.front();
-                        task_queue_.pop_front();
+        namespace {
+            std::vector<scheduling::WorkerPlacement> to_placements(const ThreadPoolOptions &options) {
+                std::vector<scheduling::WorkerPlacement> placements;
+                if (!options.cpu_sets.empty()) {
+                    for (const auto &cpus: options.cpu_sets) {
+                        placements.push_back({cpus, cpus.empty() ? -1 : scheduling::numa_node_of_cpu(cpus.front())});
                     }
-                }
-                if (task) {
-                    try {
-                        task->run();
-                    } catch (const std::exception &e) {
-                        std::cerr << "Exception in worker thread: " << e.what() << std::endl;
-                    } catch (...) {
-                        std::cerr << "Unknown exception in worker thread" << std::endl;
+                } else {
+                    for (int node: options.numa_nodes) {
+                        placements.push_back({scheduling::numa_node_cpus(node), node});
                     }
                 }
+                return placements;
             }
-        }
+        } // namespace
+
+        //
+        // ExecutorCoroutineDispatcherImpl implementation
+        //
 
         ExecutorCoroutineDispatcherImpl::ExecutorCoroutineDispatcherImpl(int n_threads, std::string name)
-            : name_(std::move(name)), n_threads_(n_threads), closed_(false) {
-            for (int i = 0; i < n_threads; ++i) {
-                workers_.emplace_back(&ExecutorCoroutineDispatcherImpl::worker_loop, this);
-            }
+            : name_(std::move(name)), n_threads_(n_threads),
+              scheduler_(std::make_unique<scheduling::CoroutineScheduler>(n_threads, name_)) {
+        }
+
+        ExecutorCoroutineDispatcherImpl::ExecutorCoroutineDispatcherImpl(int core_pool_size, int max_pool_size,
+                                                                         std::string name)
+            : name_(std::move(name)), n_threads_(core_pool_size),
+              scheduler_(std::make_unique<scheduling::CoroutineScheduler>(core_pool_size, max_pool_size, name_)) {
+        }
+
+        ExecutorCoroutineDispatcherImpl::ExecutorCoroutineDispatcherImpl(int n_threads, std::string name,
+                                                                         const ThreadPoolOptions &options)
+            : name_(std::move(name)), n_threads_(n_threads),
+              scheduler_(std::make_unique<scheduling::CoroutineScheduler>(
+                  n_threads, n_threads, name_, scheduling::CoroutineScheduler::IDLE_WORKER_KEEP_ALIVE_MS,
+                  to_placements(options))) {
         }
 
         ExecutorCoroutineDispatcherImpl::~ExecutorCoroutineDispatcherImpl() {
+            // The scheduler's destructor closes it and joins the worker threads.
             ExecutorCoroutineDispatcherImpl::close();
-            for (auto &t: workers_) {
-                if (t.joinable()) t.join();
-            }
         }
 
         std::string ExecutorCoroutineDispatcherImpl::to_string() const {
@@ -69,22 +66,28 @@ namespace kotlinx {
 
         void ExecutorCoroutineDispatcherImpl::dispatch(const CoroutineContext & context,
                                                        std::shared_ptr<Runnable> block) const {
-            if (closed_) return;
-            {
-                auto self = const_cast<ExecutorCoroutineDispatcherImpl *>(this);
-                std::lock_guard<std::mutex> lock(self->queue_mutex_);
-                self->task_queue_.push_back(std::move(block));
-            }
-            auto self = const_cast<ExecutorCoroutineDispatcherImpl *>(this);
-            self->condition_.notify_one();
+            scheduler_->dispatch(std::move(block));
+        }
+
+        void ExecutorCoroutineDispatcherImpl::dispatch_yield(const CoroutineContext &context,
+                                                             std::shared_ptr<Runnable> block) const {
+            scheduler_->dispatch(std::move(block), /* blocking = */ false, /* fair = */ true);
+        }
+
+        void ExecutorCoroutineDispatcherImpl::dispatch_batch(std::vector<DispatchRequest> &requests) const {
+            std::vector<std::shared_ptr<Runnable>> blocks;
+            blocks.reserve(requests.size());
+            for (auto &request: requests) blocks.push_back(std::move(request.block));
+            scheduler_->dispatch_batch(blocks);
+        }
+
+        std::shared_ptr<CoroutineDispatcher> ExecutorCoroutineDispatcherImpl::numa_node_view(int node) const {
+            return std::make_shared<scheduling::NumaNodeDispatcher>(
+                *scheduler_, node, name_ + ".node" + std::to_string(node));
         }
 
         void ExecutorCoroutineDispatcherImpl::close() {
-            {
-                std::lock_guard<std::mutex> lock(queue_mutex_);
-                closed_ = true;
-            }
-            condition_.notify_all();
+            scheduler_->close();
         }
 
         //
@@ -98,5 +101,10 @@ namespace kotlinx {
         CloseableCoroutineDispatcher *new_fixed_thread_pool_context(int n_threads, const std::string &name) {
             return new ExecutorCoroutineDispatcherImpl(n_threads, name);
         }
+
+        ExecutorCoroutineDispatcherImpl *new_fixed_thread_pool_context(int n_threads, const std::string &name,
+                                                                       const ThreadPoolOptions &options) {
+            return new ExecutorCoroutineDispatcherImpl(n_threads, name, options);
+        }
     } // namespace coroutines
 } // namespace kotlinx
\ No newline at end of file
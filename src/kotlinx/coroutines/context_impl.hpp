@@ -3,7 +3,10 @@
 #include "kotlinx/coroutines/Runnable.hpp"
 #include "kotlinx/coroutines/Continuation.hpp"
 #include "kotlinx/coroutines/ContinuationInterceptor.hpp"
+#include <cstddef>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace kotlinx {
 namespace coroutines {
@@ -47,6 +50,78 @@ public:
     }
 };
 
+/**
+ * Immutable context that keeps its elements in one array.
+ *
+ * No Kotlin counterpart: Kotlin's `plus` builds a left-leaning list of CombinedContext nodes,
+ * and every `get` walks it. Here `plus` flattens both operands into a FlatCoroutineContext:
+ *
+ * - The well-known elements (Job, ContinuationInterceptor, CoroutineName, CoroutineExceptionHandler)
+ *   have fixed slots, so looking them up is an index, and [job_ptr], [interceptor_ptr] and
+ *   [delay_ptr] are a single load of a pointer resolved when the context was built.
+ * - Other keys are found by a scan of the (short) array.
+ * - `plus` is memoized: adding the same context again returns the previous result while it is
+ *   alive, so launching many coroutines from one scope with the same dispatcher shares the context.
+ *
+ * A coroutine's own context ([with_borrowed_element]) does not own the coroutine, which owns the
+ * context: [get] and [for_each] lock a weak reference for that one element.
+ */
+class FlatCoroutineContext : public CoroutineContext {
+public:
+    /** Slots of the well-known keys. */
+    enum Slot { JOB_SLOT, INTERCEPTOR_SLOT, NAME_SLOT, EXCEPTION_HANDLER_SLOT, SLOT_COUNT };
+
+    explicit FlatCoroutineContext(std::vector<std::shared_ptr<Element>> elements);
+
+    /**
+     * Kotlin: `left + right`. Elements of [right] replace the elements of [left] with the same key.
+     *
+     * @return [left] if [right] adds nothing, the element itself if only one is left
+     */
+    static std::shared_ptr<CoroutineContext> plus(const std::shared_ptr<CoroutineContext>& left,
+                                                  const CoroutineContext& right);
+
+    /**
+     * Kotlin: `left + element` for a coroutine's own context. [element] is borrowed: it is not
+     * owned by the new context, and [owner] keeps it alive.
+     */
+    static std::shared_ptr<FlatCoroutineContext> with_borrowed_element(
+        const CoroutineContext& left, Element& element, std::weak_ptr<const void> owner);
+
+    std::shared_ptr<Element> get(Key* key) const override;
+    void for_each(std::function<void(std::shared_ptr<Element>)> callback) const override;
+    std::shared_ptr<CoroutineContext> minus_key(Key* key) const override;
+
+    Job* job_ptr() const override { return job_; }
+    ContinuationInterceptor* interceptor_ptr() const override { return interceptor_; }
+    Delay* delay_ptr() const override { return delay_; }
+
+    std::size_t size() const { return elements_.size(); }
+
+    /** [plus] with this context on the left, memoized for the last [other]. */
+    std::shared_ptr<CoroutineContext> plus_memoized(const std::shared_ptr<CoroutineContext>& other) const;
+
+private:
+    static int slot_of(Key* key);
+    std::shared_ptr<Element> element_at(int index) const;
+
+    std::vector<std::shared_ptr<Element>> elements_;
+    int slots_[SLOT_COUNT];
+    Job* job_ = nullptr;
+    ContinuationInterceptor* interceptor_ = nullptr;
+    Delay* delay_ = nullptr;
+
+    // The borrowed element of a coroutine's own context: elements_[borrowed_index_] does not own it.
+    int borrowed_index_ = -1;
+    std::weak_ptr<const void> borrowed_owner_;
+
+    // Last result of plus_memoized; weak, so that the memo keeps neither context alive.
+    mutable std::mutex memo_mutex_;
+    mutable const CoroutineContext* memo_other_ = nullptr;
+    mutable std::weak_ptr<CoroutineContext> memo_other_ref_;
+    mutable std::weak_ptr<CoroutineContext> memo_result_;
+};
+
 class EmptyCoroutineContext : public CoroutineContext {
 public:
     static std::shared_ptr<EmptyCoroutineContext> instance() {
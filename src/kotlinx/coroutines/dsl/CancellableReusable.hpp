@@ -12,10 +12,13 @@
  */
 
 #include "kotlinx/coroutines/CancellableContinuationImpl.hpp"
+#include "kotlinx/coroutines/ContinuationImpl.hpp"
 #include "kotlinx/coroutines/internal/DispatchedContinuation.hpp"
+#include "kotlinx/coroutines/internal/ReusableContinuationSlot.hpp"
 #include "kotlinx/coroutines/intrinsics/Intrinsics.hpp"
 #include <memory>
 #include <functional>
+#include <type_traits>
 
 namespace kotlinx {
 namespace coroutines {
@@ -55,11 +58,91 @@ std::shared_ptr<CancellableContinuationImpl<T>> get_or_create_cancellable_contin
         }
         // Fall through to create new with reusable mode
         // Kotlin: ?: CancellableContinuationImpl(uCont.intercepted(), MODE_CANCELLABLE_REUSABLE)
-        return std::make_shared<CancellableContinuationImpl<T>>(delegate, MODE_CANCELLABLE_REUSABLE);
+        return internal::make_frame<CancellableContinuationImpl<T>>(delegate, MODE_CANCELLABLE_REUSABLE);
     }
     // Not a dispatched continuation - create new with regular cancellable mode
     // Kotlin: CancellableContinuationImpl(uCont.intercepted(), MODE_CANCELLABLE)
-    return std::make_shared<CancellableContinuationImpl<T>>(delegate, MODE_CANCELLABLE);
+    return internal::make_frame<CancellableContinuationImpl<T>>(delegate, MODE_CANCELLABLE);
+}
+
+/**
+ * Resumes a state machine (a `Continuation<void*>`) with the result of a
+ * CancellableContinuationImpl<T>, boxing it per the `void*` ABI convention, or assigning it to
+ * the result slot the state machine gave for this suspension.
+ *
+ * Kotlin resumes `uCont` with the value directly; here it is the delegate of the reusable
+ * continuation, so it lives as long as that continuation does.
+ */
+template<typename T>
+class BoxingContinuation : public Continuation<T> {
+public:
+    explicit BoxingContinuation(Continuation<void*>* completion) : completion_(completion) {}
+
+    std::shared_ptr<CoroutineContext> get_context() const override { return completion_->get_context(); }
+
+    void resume_with(Result<T> result) override {
+        if (result.is_failure()) {
+            completion_->resume_with(Result<void*>::failure(result.exception_or_null()));
+        } else if constexpr (std::is_void_v<T>) {
+            completion_->resume_with(Result<void*>::success(nullptr));
+        } else if (slot_ != nullptr) {
+            *slot_ = result.get_or_throw();
+            completion_->resume_with(Result<void*>::success(slot_));
+        } else {
+            completion_->resume_with(Result<void*>::success(new T(result.get_or_throw())));
+        }
+    }
+
+    /** The slot the next value goes to instead of a `new T`; null to box it. */
+    void set_slot(T* slot) { slot_ = slot; }
+
+private:
+    Continuation<void*>* completion_;
+    T* slot_ = nullptr;
+};
+
+/**
+ * Get or create the CancellableContinuationImpl a state machine suspends on.
+ *
+ * Kotlin: getOrCreateCancellableContinuation(uCont.intercepted())
+ *
+ * If [completion] is a ContinuationImpl, the continuation is claimed from its
+ * reusable_continuation_slot(): a state machine that suspends in a loop (a consumer draining
+ * a channel, say) allocates it once and then only resets it. The caller must release it with
+ * release_claimed_reusable_continuation(), which get_result() does. Otherwise a new
+ * MODE_CANCELLABLE continuation is created.
+ *
+ * C++ only: a non-null [result_slot] receives the value, whether get_result() returns it or the
+ * state machine is resumed with it, instead of a `new T`. The state machine owns the slot,
+ * usually a member of its frame, and must not delete the `void*` result.
+ */
+template<typename T>
+std::shared_ptr<CancellableContinuationImpl<T>> get_or_create_cancellable_continuation(
+    Continuation<void*>* completion,
+    T* result_slot = nullptr
+) {
+    std::shared_ptr<CancellableContinuationImpl<T>> cont;
+    auto* frame = dynamic_cast<ContinuationImpl*>(completion);
+    internal::ReusableContinuationSlot* slot = frame != nullptr ? &frame->reusable_continuation_slot() : nullptr;
+    if (slot != nullptr && slot->claim(cont)) {
+        // Kotlin: ?.takeIf { it.resetStateReusable() }
+        if (!cont || !cont->reset_state_reusable()) {
+            // Kotlin: ?: CancellableContinuationImpl(uCont.intercepted(), MODE_CANCELLABLE_REUSABLE)
+            cont = internal::make_frame<CancellableContinuationImpl<T>>(
+                internal::make_frame<BoxingContinuation<T>>(completion), MODE_CANCELLABLE_REUSABLE);
+            cont->set_reusable_slot(slot);
+        }
+    } else {
+        // Kotlin: CancellableContinuationImpl(uCont.intercepted(), MODE_CANCELLABLE)
+        cont = internal::make_frame<CancellableContinuationImpl<T>>(
+            internal::make_frame<BoxingContinuation<T>>(completion), MODE_CANCELLABLE);
+    }
+    if constexpr (!std::is_void_v<T>) {
+        // A reused continuation keeps the slot of its last suspension until it is set again
+        cont->set_result_slot(result_slot);
+        static_cast<BoxingContinuation<T>*>(cont->delegate_ptr())->set_slot(result_slot);
+    }
+    return cont;
 }
 
 /**
@@ -81,17 +164,17 @@ std::shared_ptr<CancellableContinuationImpl<T>> get_or_create_cancellable_contin
  *
  * @param completion The completion continuation
  * @param block The block that receives the cancellable continuation
+ * @param result_slot Where the result goes instead of a `new T`; see get_or_create_cancellable_continuation
  * @return COROUTINE_SUSPENDED or the result
  */
 template<typename T, typename Block>
 void* suspend_cancellable_coroutine_reusable(
     Continuation<void*>* completion,
-    Block&& block
+    Block&& block,
+    T* result_slot = nullptr
 ) {
     // Kotlin: val cancellable = getOrCreateCancellableContinuation(uCont.intercepted())
-    auto cont = get_or_create_cancellable_continuation<T>(
-        std::shared_ptr<Continuation<T>>(completion, [](Continuation<T>*){})
-    );
+    auto cont = get_or_create_cancellable_continuation<T>(completion, result_slot);
 
     try {
         // Kotlin: block(cancellable)
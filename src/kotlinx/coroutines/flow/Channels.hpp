@@ -176,9 +176,9 @@ private:
  */
 template <typename T>
 void* emit_all_impl(FlowCollector<T>* collector, channels::ReceiveChannel<T>* channel, bool consume, Continuation<void*>* cont) {
-    auto sm = std::make_shared<EmitAllContinuation<T>>(
+    auto sm = kotlinx::coroutines::internal::make_frame<EmitAllContinuation<T>>(
         collector, channel, consume,
-        cont ? std::make_shared<detail::RawContinuationWrapper>(cont) : nullptr
+        cont ? kotlinx::coroutines::internal::make_frame<detail::RawContinuationWrapper>(cont) : nullptr
     );
     return sm->invoke_suspend(Result<void*>::success(nullptr));
 }
@@ -14,6 +14,7 @@
 #include "kotlinx/coroutines/Continuation.hpp"
 #include "kotlinx/coroutines/Job.hpp"
 #include "kotlinx/coroutines/CoroutineContext.hpp"
+#include "kotlinx/coroutines/internal/DispatchBatch.hpp"
 #include "kotlinx/coroutines/internal/Symbol.hpp"
 #include "kotlinx/coroutines/dsl/Suspend.hpp"
 #include "kotlinx/coroutines/intrinsics/Intrinsics.hpp"
@@ -351,9 +352,11 @@ public:
             }
         }
 
+        kotlinx::coroutines::internal::DispatchBatchScope batch;
         for (auto cont : resumes) {
             if (cont) cont->resume_with(Result<Unit>::success(Unit{}));
         }
+        batch.flush();
         return emitted;
     }
 
@@ -651,9 +654,11 @@ private:
             }
         }
 
+        kotlinx::coroutines::internal::DispatchBatchScope batch;
         for (auto resume : resumes) {
             if (resume) resume->resume_with(Result<Unit>::success(Unit{}));
         }
+        batch.flush();
 
         return value;
     }
@@ -781,9 +786,11 @@ private:
                     dispose_on_cancellation(cont, emitter);
                 }
 
+                kotlinx::coroutines::internal::DispatchBatchScope batch;
                 for (auto r : resumes) {
                     if (r) r->resume_with(Result<Unit>::success(Unit{}));
                 }
+                batch.flush();
             },
             continuation);
     }
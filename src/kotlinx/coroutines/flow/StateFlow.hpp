@@ -11,6 +11,7 @@
 #include "kotlinx/coroutines/channels/Channel.hpp"
 #include "kotlinx/coroutines/internal/Symbol.hpp"
 #include "kotlinx/coroutines/CancellableContinuation.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 #include <mutex>
 #include <atomic>
 #include <vector>
@@ -470,7 +471,7 @@ public:
                     }
                 };
                 
-                auto loop = std::make_shared<CollectLoop>(this, slot, collector, &cont);
+                auto loop = kotlinx::coroutines::internal::make_frame<CollectLoop>(this, slot, collector, &cont);
                 loop->start();
             }, continuation);
             
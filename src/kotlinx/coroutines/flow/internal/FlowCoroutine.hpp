@@ -7,6 +7,7 @@
 #include "kotlinx/coroutines/CoroutineScope.hpp"
 #include "kotlinx/coroutines/internal/ScopeCoroutine.hpp"
 #include "kotlinx/coroutines/flow/Flow.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 #include <functional>
 
 namespace kotlinx::coroutines::flow::internal {
@@ -54,7 +55,7 @@ void* flow_scope(std::function<void*(CoroutineScope*, Continuation<R>*)> block,
     auto uCont = std::dynamic_pointer_cast<Continuation<R>>(cont->shared_from_this());
     if (!uCont) return nullptr; // Should not happen
 
-    auto coroutine = std::make_shared<FlowCoroutine<R>>(uCont->get_context(), uCont);
+    auto coroutine = kotlinx::coroutines::internal::make_frame<FlowCoroutine<R>>(uCont->get_context(), uCont);
     
     // Wrapping block to match signature expected by start_undispatched_or_return
     // FlowCoroutine extends ScopeCoroutine which has start_undispatched_or_return_ignore_timeout, 
@@ -0,0 +1,24 @@
+#pragma once
+/**
+ * @file CacheLine.hpp
+ * @brief The cache-line size used to keep independently written fields apart.
+ *
+ * No Kotlin counterpart: the JVM port pads hot fields through `@Contended` or padding classes.
+ *
+ * This is a fixed 64 rather than std::hardware_destructive_interference_size. GCC warns when
+ * that value is used in a header, because it can change with the -mtune flags of each
+ * translation unit and so break the layout of types shared between them.
+ */
+
+#include <cstddef>
+
+namespace kotlinx {
+namespace coroutines {
+namespace internal {
+
+/** Alignment that puts a field, and whatever follows it, on a cache line of its own. */
+inline constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+} // namespace internal
+} // namespace coroutines
+} // namespace kotlinx
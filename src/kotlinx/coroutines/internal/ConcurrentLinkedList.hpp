@@ -11,6 +11,7 @@
  */
 
 #include <atomic>
+#include <cstdint>
 #include <functional>
 #include <cassert>
 #include "kotlinx/coroutines/internal/Symbol.hpp"
@@ -44,6 +45,7 @@ template <typename S> struct SegmentOrClosed;
  */
 class SegmentBase : public NotCompleted {
 public:
+    SegmentBase() { kind = StateKind::SEGMENT; }
     virtual ~SegmentBase() = default;
 
     /**
@@ -55,6 +57,40 @@ public:
         std::shared_ptr<CoroutineContext> context) = 0;
 
     std::string to_string() const override { return "Segment"; }
+
+    /**
+     * C++ only: Kotlin's GC keeps a segment alive while a cancellable continuation references
+     * it. Here a continuation that may still call [on_cancellation] retains the segment; a list
+     * that frees its own segments keeps retained ones, and [orphan]s them when it is destroyed
+     * so that the last release frees them instead.
+     */
+    void retain_for_cancellation() {
+        pending_cancellations_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release_for_cancellation() {
+        if (pending_cancellations_.fetch_sub(1, std::memory_order_acq_rel) == (ORPHANED | 1)) {
+            delete this;
+        }
+    }
+
+    bool has_pending_cancellation() const {
+        return (pending_cancellations_.load(std::memory_order_acquire) & ~ORPHANED) != 0;
+    }
+
+    // The list is gone: [on_cancellation] must not be called any more
+    bool is_orphaned() const {
+        return (pending_cancellations_.load(std::memory_order_acquire) & ORPHANED) != 0;
+    }
+
+    // Called by the list instead of deleting the segment; frees it now unless it is retained
+    void orphan() {
+        if (pending_cancellations_.fetch_or(ORPHANED, std::memory_order_acq_rel) == 0) delete this;
+    }
+
+private:
+    static constexpr uint32_t ORPHANED = 1u << 31;
+    std::atomic<uint32_t> pending_cancellations_{0};
 };
 
 /**
@@ -272,9 +308,17 @@ public:
      */
     void on_slot_cleaned() {
         if (cleaned_and_pointers.fetch_add(1, std::memory_order_acq_rel) + 1 == number_of_slots()) {
-            this->remove();
+            on_all_slots_cleaned();
         }
     }
+
+    /**
+     * Invoked once every slot is cleaned; removes this segment physically by default.
+     * C++ only: lists that free their segments in id order keep them linked instead.
+     */
+    virtual void on_all_slots_cleaned() {
+        this->remove();
+    }
 };
 
 /**
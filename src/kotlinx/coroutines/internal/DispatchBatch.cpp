@@ -0,0 +1,86 @@
+/**
+ * @file DispatchBatch.cpp
+ * @brief Thread-local scope that collects dispatches and hands them over in batches.
+ *
+ * NOTE: The design notes live in the companion header
+ * `kotlinx/coroutines/internal/DispatchBatch.hpp`.
+ */
+
+#include "kotlinx/coroutines/internal/DispatchBatch.hpp"
+#include "kotlinx/coroutines/internal/DispatchedTask.hpp"
+#include <exception>
+#include <iostream>
+#include <utility>
+
+namespace kotlinx {
+    namespace coroutines {
+        namespace internal {
+            thread_local DispatchBatchScope *DispatchBatchScope::current_ = nullptr;
+
+            DispatchBatchScope::DispatchBatchScope() : active_(current_ == nullptr) {
+                if (active_) current_ = this;
+            }
+
+            DispatchBatchScope::~DispatchBatchScope() {
+                if (!active_) return;
+                try {
+                    flush();
+                } catch (const std::exception &e) {
+                    std::cerr << "Exception while flushing dispatch batch: " << e.what() << std::endl;
+                } catch (...) {
+                    std::cerr << "Unknown exception while flushing dispatch batch" << std::endl;
+                }
+                current_ = nullptr;
+            }
+
+            void DispatchBatchScope::flush() {
+                if (!active_) return;
+                // Dispatchers may resume more continuations while we flush (e.g. an undispatched
+                // LimitedDispatcher worker); let those go straight through.
+                std::vector<Group> groups = std::move(groups_);
+                groups_.clear();
+                current_ = nullptr;
+                std::exception_ptr failure;
+                for (auto &group: groups) {
+                    try {
+                        if (group.requests.size() == 1) {
+                            auto &request = group.requests.front();
+                            group.dispatcher->dispatch(*request.context, std::move(request.block));
+                        } else {
+                            group.dispatcher->dispatch_batch(group.requests);
+                        }
+                    } catch (...) {
+                        if (!failure) {
+                            failure = std::make_exception_ptr(DispatchException(
+                                std::current_exception(), group.dispatcher, group.requests.front().context));
+                        }
+                    }
+                }
+                current_ = this;
+                if (failure) std::rethrow_exception(failure);
+            }
+
+            bool DispatchBatchScope::try_defer(const CoroutineDispatcher &dispatcher, const CoroutineContext &context,
+                                               std::shared_ptr<Runnable> &runnable) {
+                DispatchBatchScope *scope = current_;
+                if (scope == nullptr) return false;
+                std::shared_ptr<const CoroutineContext> owner = context.weak_from_this().lock();
+                if (!owner) return false; // not owned by a shared_ptr: cannot outlive this call
+                Group *target = nullptr;
+                for (auto &group: scope->groups_) {
+                    if (group.dispatcher == &dispatcher) {
+                        target = &group;
+                        break;
+                    }
+                }
+                if (target == nullptr) {
+                    scope->groups_.push_back({&dispatcher, {}, {}});
+                    target = &scope->groups_.back();
+                }
+                target->requests.push_back({&context, std::move(runnable)});
+                target->contexts.push_back(std::move(owner));
+                return true;
+            }
+        } // namespace internal
+    } // namespace coroutines
+} // namespace kotlinx
@@ -0,0 +1,77 @@
+#pragma once
+/**
+ * @file DispatchBatch.hpp
+ * @brief Thread-local scope that collects dispatches and hands them over in batches.
+ *
+ * No Kotlin counterpart: kotlinx.coroutines dispatches every resumed continuation on its own.
+ *
+ * When one event resumes many coroutines -- a job completing with many awaiters, a shared
+ * flow emission waking its collectors -- dispatching them one by one costs a lock and a
+ * wake-up each. Inside a DispatchBatchScope, internal::safe_dispatch only records the
+ * request; when the scope ends, the requests are grouped by dispatcher and handed to
+ * CoroutineDispatcher::dispatch_batch, which can enqueue a whole group at once.
+ */
+
+#include "kotlinx/coroutines/CoroutineDispatcher.hpp"
+#include <memory>
+#include <vector>
+
+namespace kotlinx {
+namespace coroutines {
+namespace internal {
+
+/**
+ * RAII scope batching the dispatches made on the current thread.
+ *
+ * Scopes nest: an inner scope joins the outermost one, which flushes when it ends.
+ * Dispatch order is preserved per dispatcher.
+ *
+ * Usage:
+ * ```cpp
+ * internal::DispatchBatchScope batch;
+ * for (auto* cont : resumes) cont->resume_with(...);
+ * batch.flush();
+ * ```
+ */
+class DispatchBatchScope {
+public:
+    DispatchBatchScope();
+
+    /** Flushes whatever is left; dispatch failures are reported to stderr as they cannot be rethrown here. */
+    ~DispatchBatchScope();
+
+    DispatchBatchScope(const DispatchBatchScope&) = delete;
+    DispatchBatchScope& operator=(const DispatchBatchScope&) = delete;
+
+    /**
+     * Dispatches the collected requests. Does nothing in a nested scope.
+     *
+     * @throws DispatchException if a dispatcher throws
+     */
+    void flush();
+
+    /**
+     * Records a dispatch of [runnable] if a scope is active on the current thread.
+     *
+     * @return `false` if there is no active scope: the caller has to dispatch by itself
+     */
+    static bool try_defer(const CoroutineDispatcher& dispatcher, const CoroutineContext& context,
+                          std::shared_ptr<Runnable>& runnable);
+
+private:
+    struct Group {
+        const CoroutineDispatcher* dispatcher;
+        std::vector<DispatchRequest> requests;
+        // Keeps the requests' contexts (and through them the dispatcher) alive until the flush.
+        std::vector<std::shared_ptr<const CoroutineContext>> contexts;
+    };
+
+    std::vector<Group> groups_;
+    bool active_;
+
+    static thread_local DispatchBatchScope* current_;
+};
+
+} // namespace internal
+} // namespace coroutines
+} // namespace kotlinx
@@ -12,10 +12,12 @@
 #include "kotlinx/coroutines/Continuation.hpp"
 #include "kotlinx/coroutines/common/CoroutineContextUtils.hpp"
 #include "kotlinx/coroutines/internal/CoroutineStackFrame.hpp"
+#include "kotlinx/coroutines/internal/DispatchBatch.hpp"
 #include "kotlinx/coroutines/internal/DispatchedTask.hpp"
 #include "kotlinx/coroutines/internal/Symbol.hpp"
 #include "kotlinx/coroutines/internal/ThreadContext.hpp"
 #include "kotlinx/coroutines/EventLoop.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
 
 #include <atomic>
 #include <cassert>
@@ -66,6 +68,10 @@ public:
     std::shared_ptr<CoroutineDispatcher> dispatcher;
     std::shared_ptr<Continuation<T>> continuation;
 
+    // Context cache -- Kotlin: override val context: CoroutineContext get() = continuation.context
+    // The context of a continuation does not change; reading it once spares a shared_ptr copy per resume.
+    const std::shared_ptr<CoroutineContext> context_;
+
     // Kotlin: internal val countOrElement = threadContextElements(context)
     void* count_or_element;
 
@@ -78,13 +84,17 @@ public:
     ) :
         DispatchedTask<T>(MODE_UNINITIALIZED),
         dispatcher(std::move(dispatcher_)),
-        continuation(std::move(continuation_)) {
-        auto ctx = DispatchedContinuation<T>::get_context();
-        count_or_element = ctx ? thread_context_elements(*ctx) : nullptr;
+        continuation(std::move(continuation_)),
+        context_(continuation->get_context()) {
+        count_or_element = context_ ? thread_context_elements(*context_) : nullptr;
     }
 
     std::shared_ptr<CoroutineContext> get_context() const override {
-        return continuation->get_context();
+        return context_;
+    }
+
+    const CoroutineContext* context_ptr() const {
+        return context_.get();
     }
 
     // Kotlin: override val callerFrame: CoroutineStackFrame? get() = continuation as? CoroutineStackFrame
@@ -102,6 +112,18 @@ public:
         return this->shared_from_this();
     }
 
+    Continuation<T>* delegate_ptr() override {
+        return this;
+    }
+
+    DispatchedContinuation<T>* dispatched_delegate() override {
+        return this;
+    }
+
+    std::shared_ptr<SchedulerTask> shared_task() override {
+        return this->shared_from_this();
+    }
+
     // Kotlin: override fun takeState(): Any?
     Result<T> take_state() override {
         assert(state_.has_value());
@@ -234,14 +256,13 @@ public:
     // Kotlin: override fun resumeWith(result: Result<T>)
     void resume_with(Result<T> result) override {
         auto state = result;
-        auto context = get_context();
-        if (context && safe_is_dispatch_needed(*dispatcher, *context)) {
+        if (context_ && safe_is_dispatch_needed(*dispatcher, *context_)) {
             state_ = state;
             this->resume_mode = MODE_ATOMIC;
-            safe_dispatch(*dispatcher, *context, this->shared_from_this());
+            safe_dispatch(*dispatcher, *context_, shared_task());
         } else {
-            execute_unconfined(state, MODE_ATOMIC, false, [this, result = std::move(result), context]() mutable {
-                with_coroutine_context<void>(context, count_or_element, [this, result = std::move(result)]() mutable {
+            execute_unconfined(state, MODE_ATOMIC, false, [this, result = std::move(result)]() mutable {
+                with_coroutine_context<void>(context_, count_or_element, [this, result = std::move(result)]() mutable {
                     continuation->resume_with(std::move(result));
                     return;
                 });
@@ -252,11 +273,10 @@ public:
     // Kotlin: internal inline fun resumeCancellableWith(result: Result<T>)
     void resume_cancellable_with(Result<T> result) {
         auto state = result;
-        auto context = get_context();
-        if (context && safe_is_dispatch_needed(*dispatcher, *context)) {
+        if (context_ && safe_is_dispatch_needed(*dispatcher, *context_)) {
             state_ = state;
             this->resume_mode = MODE_CANCELLABLE;
-            safe_dispatch(*dispatcher, *context, this->shared_from_this());
+            safe_dispatch(*dispatcher, *context_, shared_task());
         } else {
             execute_unconfined(state, MODE_CANCELLABLE, false, [this, result = std::move(result), state]() mutable {
                 if (!resume_cancelled(state)) {
@@ -268,12 +288,7 @@ public:
 
     // Kotlin: internal inline fun resumeCancelled(state: Any?): Boolean
     bool resume_cancelled(const Result<T>& state) {
-        auto context = get_context();
-        std::shared_ptr<Job> job = nullptr;
-        if (context) {
-            auto job_element = context->get(Job::type_key);
-            job = std::dynamic_pointer_cast<Job>(job_element);
-        }
+        Job* job = context_ ? context_->job_ptr() : nullptr;
         if (job && !job->is_active()) {
             auto cause = job->get_cancellation_exception();
             this->cancel_completed_result(state, cause);
@@ -285,7 +300,7 @@ public:
 
     // Kotlin: internal inline fun resumeUndispatchedWith(result: Result<T>)
     void resume_undispatched_with(Result<T> result) {
-        with_continuation_context<void, T>(continuation, count_or_element, [this, result = std::move(result)]() mutable {
+        with_continuation_context<void, T>(continuation.get(), count_or_element, [this, result = std::move(result)]() mutable {
             continuation->resume_with(std::move(result));
             return;
         });
@@ -355,9 +370,7 @@ public:
         if (event_loop->is_unconfined_loop_active()) {
             state_ = cont_state;
             this->resume_mode = mode;
-            auto self = this->shared_from_this();
-            event_loop->dispatch_unconfined(
-                std::shared_ptr<SchedulerTask>(self, static_cast<SchedulerTask*>(self.get())));
+            event_loop->dispatch_unconfined(shared_task());
             return true;
         }
 
@@ -382,6 +395,7 @@ inline void safe_dispatch(
     const CoroutineContext& context,
     std::shared_ptr<Runnable> runnable
 ) {
+    if (DispatchBatchScope::try_defer(dispatcher, context, runnable)) return;
     try {
         dispatcher.dispatch(context, std::move(runnable));
     } catch (...) {
@@ -424,7 +438,7 @@ inline bool yield_undispatched(internal::DispatchedContinuation<void>& continuat
 // Implement CoroutineDispatcher::intercept_continuation here to avoid circular dependency
 template <typename T>
 std::shared_ptr<Continuation<T>> CoroutineDispatcher::intercept_continuation(std::shared_ptr<Continuation<T>> continuation) {
-    return std::make_shared<internal::DispatchedContinuation<T>>(
+    return internal::make_frame<internal::DispatchedContinuation<T>>(
         std::dynamic_pointer_cast<CoroutineDispatcher>(shared_from_this()),
         std::move(continuation));
 }
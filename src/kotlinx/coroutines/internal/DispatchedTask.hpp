@@ -50,6 +50,10 @@ inline bool is_reusable_mode(int mode) {
     return mode == MODE_CANCELLABLE_REUSABLE;
 }
 
+namespace internal {
+template<typename T> class DispatchedContinuation;
+}
+
 /**
  * A Runnable optimized for dispatcher queues.
  *
@@ -77,6 +81,25 @@ public:
     // Kotlin: internal abstract val delegate: Continuation<T>
     virtual std::shared_ptr<Continuation<T>> get_delegate() = 0;
 
+    /**
+     * [get_delegate] without taking a reference, for the dispatch and run paths: the task owns
+     * its delegate, and whoever dispatches or runs the task keeps the task alive.
+     */
+    virtual Continuation<T>* delegate_ptr() = 0;
+
+    /**
+     * [delegate_ptr] if it is a DispatchedContinuation, otherwise null: Kotlin's
+     * `delegate as DispatchedContinuation<T>`, known when the delegate is set, so that dispatch
+     * and run do not need a dynamic_cast.
+     */
+    virtual internal::DispatchedContinuation<T>* dispatched_delegate() = 0;
+
+    /**
+     * An owning pointer to this task, for the dispatcher's queue. Taking it is the only
+     * reference count increment of a resume-and-dispatch.
+     */
+    virtual std::shared_ptr<SchedulerTask> shared_task() = 0;
+
     // Kotlin: internal abstract fun takeState(): Any?
     virtual Result<T> take_state() = 0;
 
@@ -107,7 +130,7 @@ void dispatch(DispatchedTask<T>* task, int mode);
 
 // Kotlin: internal fun <T> DispatchedTask<T>.resume(delegate: Continuation<T>, undispatched: Boolean)
 template<typename T>
-void resume(DispatchedTask<T>* task, std::shared_ptr<Continuation<T>> delegate, bool undispatched);
+void resume(DispatchedTask<T>* task, Continuation<T>& delegate, bool undispatched);
 
 namespace internal {
 
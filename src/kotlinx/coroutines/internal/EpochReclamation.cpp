@@ -0,0 +1,101 @@
+/**
+ * @file EpochReclamation.cpp
+ * @brief Epoch-based reclamation of nodes that lock-free readers may still be looking at.
+ *
+ * NOTE: The design notes live in the companion header
+ * `kotlinx/coroutines/internal/EpochReclamation.hpp`.
+ */
+
+#include "kotlinx/coroutines/internal/EpochReclamation.hpp"
+#include <atomic>
+
+namespace kotlinx {
+    namespace coroutines {
+        namespace internal {
+            namespace {
+                // Epoch of a record whose thread holds no guard; the global epoch starts above it.
+                constexpr std::uint64_t QUIESCENT = 0;
+
+                struct ThreadRecord {
+                    std::atomic<std::uint64_t> epoch{QUIESCENT};
+                    std::atomic<bool> in_use{true};
+                    ThreadRecord *next = nullptr; // immutable once published
+                };
+
+                std::atomic<std::uint64_t> global_epoch{1};
+                std::atomic<ThreadRecord *> records{nullptr};
+
+                ThreadRecord *acquire_record() {
+                    for (ThreadRecord *record = records.load(std::memory_order_acquire); record != nullptr;
+                         record = record->next) {
+                        bool expected = false;
+                        if (!record->in_use.load(std::memory_order_relaxed)
+                            && record->in_use.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                            return record;
+                        }
+                    }
+                    auto *record = new ThreadRecord();
+                    ThreadRecord *head = records.load(std::memory_order_relaxed);
+                    do {
+                        record->next = head;
+                    } while (!records.compare_exchange_weak(head, record, std::memory_order_release,
+                                                            std::memory_order_relaxed));
+                    return record;
+                }
+
+                struct RecordHolder {
+                    ThreadRecord *record = acquire_record();
+                    int depth = 0;
+
+                    ~RecordHolder() {
+                        record->epoch.store(QUIESCENT, std::memory_order_release);
+                        record->in_use.store(false, std::memory_order_release);
+                    }
+                };
+
+                RecordHolder &holder() {
+                    static thread_local RecordHolder instance;
+                    return instance;
+                }
+
+                // Every thread holding a guard has seen [epoch]: it can move on.
+                void try_advance(std::uint64_t epoch) {
+                    for (ThreadRecord *record = records.load(std::memory_order_acquire); record != nullptr;
+                         record = record->next) {
+                        const std::uint64_t seen = record->epoch.load(std::memory_order_acquire);
+                        if (seen != QUIESCENT && seen != epoch) return;
+                    }
+                    global_epoch.compare_exchange_strong(epoch, epoch + 1, std::memory_order_acq_rel,
+                                                         std::memory_order_relaxed);
+                }
+            } // namespace
+
+            void EpochReclamation::enter() noexcept {
+                RecordHolder &h = holder();
+                if (h.depth++ != 0) return;
+                h.record->epoch.store(global_epoch.load(std::memory_order_relaxed), std::memory_order_relaxed);
+                // Publishes the epoch before any shared node is read.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+
+            void EpochReclamation::leave() noexcept {
+                RecordHolder &h = holder();
+                if (--h.depth != 0) return;
+                h.record->epoch.store(QUIESCENT, std::memory_order_release);
+            }
+
+            std::uint64_t EpochReclamation::retire_epoch() noexcept {
+                // Orders the unlinking before the epoch is read.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                return global_epoch.load(std::memory_order_relaxed);
+            }
+
+            bool EpochReclamation::is_safe(std::uint64_t retired_at) noexcept {
+                std::uint64_t epoch = global_epoch.load(std::memory_order_acquire);
+                if (epoch >= retired_at + 2) return true;
+                try_advance(epoch);
+                return global_epoch.load(std::memory_order_acquire) >= retired_at + 2;
+            }
+        } // namespace internal
+    } // namespace coroutines
+} // namespace kotlinx
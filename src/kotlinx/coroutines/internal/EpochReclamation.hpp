@@ -0,0 +1,59 @@
+#pragma once
+/**
+ * @file EpochReclamation.hpp
+ * @brief Epoch-based reclamation of nodes that lock-free readers may still be looking at.
+ *
+ * No Kotlin counterpart: there the garbage collector frees a node once no reader holds it.
+ *
+ * A thread reads shared nodes only while it holds an [EpochGuard]. A node made unreachable is
+ * retired: its owner records [EpochReclamation::retire_epoch] and keeps the node until
+ * [EpochReclamation::is_safe] says that no guard taken before that point is still held. Then it
+ * may free or reuse the node. Owners keep their retired nodes themselves, so a structure that is
+ * destroyed simply frees the nodes it still holds.
+ *
+ * - The global epoch advances only once every thread holding a guard has seen the current one;
+ *   a node retired at epoch `e` is safe from epoch `e + 2` on.
+ * - Guards nest: only the outermost one publishes the thread's epoch. Taking one costs a
+ *   thread-local counter and, for the outermost guard, a store and a fence.
+ * - Each thread has a record of its epoch in a global list. The record of a thread that exits is
+ *   adopted by the next thread that takes a guard; records are never freed.
+ *
+ * A guard must not be held across a suspension: a thread that never releases its guard stops
+ * the epoch, and nothing retired after that is reclaimed.
+ */
+
+#include <cstdint>
+
+namespace kotlinx {
+namespace coroutines {
+namespace internal {
+
+class EpochReclamation {
+public:
+    /** Epoch to record for a node that was just made unreachable. */
+    static std::uint64_t retire_epoch() noexcept;
+
+    /**
+     * Whether no thread can still hold a node retired at [retired_at]. If not yet, tries to
+     * advance the global epoch first.
+     */
+    static bool is_safe(std::uint64_t retired_at) noexcept;
+
+    /** Entered and left by [EpochGuard]. */
+    static void enter() noexcept;
+    static void leave() noexcept;
+};
+
+/** Protects the shared nodes the current thread reads while it lives. */
+class EpochGuard {
+public:
+    EpochGuard() noexcept { EpochReclamation::enter(); }
+    ~EpochGuard() { EpochReclamation::leave(); }
+
+    EpochGuard(const EpochGuard&) = delete;
+    EpochGuard& operator=(const EpochGuard&) = delete;
+};
+
+} // namespace internal
+} // namespace coroutines
+} // namespace kotlinx
@@ -0,0 +1,85 @@
+#pragma once
+/**
+ * @file FinishingExceptions.hpp
+ * @brief The exceptions a finishing job collects.
+ *
+ * Kotlin keeps the root cause and `_exceptionsHolder` of `JobSupport.Finishing` in atomics and
+ * updates them under `synchronized(state)`. Here they are one list guarded by a mutex: the root
+ * cause first, then the exceptions added later. Sealing takes the list; nothing is added after.
+ * [is_cancelling] and [is_sealed] are also kept in atomics, so state queries do not take the lock.
+ */
+
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace kotlinx {
+namespace coroutines {
+namespace internal {
+
+class FinishingExceptions {
+public:
+    // Result of add()
+    enum class AddResult { SEALED, ADDED, ROOT_CAUSE };
+
+    explicit FinishingExceptions(std::exception_ptr root_cause = nullptr) {
+        if (root_cause) {
+            exceptions_.push_back(std::move(root_cause));
+            cancelling_.store(true, std::memory_order_relaxed);
+        }
+    }
+
+    FinishingExceptions(const FinishingExceptions&) = delete;
+    FinishingExceptions& operator=(const FinishingExceptions&) = delete;
+
+    bool is_cancelling() const { return cancelling_.load(std::memory_order_acquire); }
+
+    bool is_sealed() const { return sealed_.load(std::memory_order_acquire); }
+
+    std::exception_ptr root_cause() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return exceptions_.empty() ? nullptr : exceptions_.front();
+    }
+
+    /** Kotlin: addExceptionLocked(exception); ROOT_CAUSE if [exception] became the root cause. */
+    AddResult add(std::exception_ptr exception) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sealed_.load(std::memory_order_relaxed)) return AddResult::SEALED;
+        if (exceptions_.empty()) {
+            exceptions_.push_back(std::move(exception));
+            cancelling_.store(true, std::memory_order_release);
+            return AddResult::ROOT_CAUSE;
+        }
+        // The root cause and the latest exception are not added twice
+        if (exceptions_.front() != exception && exceptions_.back() != exception) {
+            exceptions_.push_back(std::move(exception));
+        }
+        return AddResult::ADDED;
+    }
+
+    /**
+     * Kotlin: sealLocked(proposedException). Returns the exceptions, the root cause first, and
+     * [proposed] last unless it is the root cause; [was_cancelling] is whether there was a root cause.
+     */
+    std::vector<std::exception_ptr> seal(std::exception_ptr proposed, bool& was_cancelling) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        sealed_.store(true, std::memory_order_release);
+        std::vector<std::exception_ptr> result = exceptions_;
+        auto root = exceptions_.empty() ? nullptr : exceptions_.front();
+        was_cancelling = root != nullptr;
+        if (proposed && proposed != root) result.push_back(std::move(proposed));
+        return result;
+    }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::exception_ptr> exceptions_; // the root cause first
+    std::atomic<bool> cancelling_{false};
+    std::atomic<bool> sealed_{false};
+};
+
+} // namespace internal
+} // namespace coroutines
+} // namespace kotlinx
@@ -0,0 +1,264 @@
+/**
+ * @file FrameAllocator.cpp
+ * @brief Size-classed, thread-caching allocator for coroutine frames.
+ *
+ * NOTE: The design notes live in the companion header
+ * `kotlinx/coroutines/internal/FrameAllocator.hpp`.
+ */
+
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
+#include "kotlinx/coroutines/internal/SystemProps.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace kotlinx {
+    namespace coroutines {
+        namespace internal {
+            namespace {
+                constexpr std::uint32_t UNPOOLED = ~std::uint32_t(0);
+
+                class ThreadCache;
+
+                // Precedes every block; keeps the payload at the default new alignment.
+                struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) BlockHeader {
+                    ThreadCache *owner; // nullptr for blocks that bypass the pool
+                    std::uint32_t size_class;
+                };
+
+                // Overlays the payload of a free block.
+                struct FreeBlock {
+                    FreeBlock *next;
+                };
+
+                BlockHeader *header_of(void *block) {
+                    return static_cast<BlockHeader *>(block) - 1;
+                }
+
+                void *payload_of(BlockHeader *header) {
+                    return header + 1;
+                }
+
+                std::size_t payload_size(std::uint32_t size_class) {
+                    return (size_class + 1) * FrameAllocator::GRANULARITY;
+                }
+
+                // Owner-only counter: a relaxed load and store instead of a read-modify-write.
+                void bump(std::atomic<std::uint64_t> &counter, std::uint64_t delta = 1) {
+                    counter.store(counter.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+                }
+
+                int max_cached_per_size() {
+                    static int value = system_prop_int("kotlinx.coroutines.frames.maxCachedPerSize", 256, 0);
+                    return value;
+                }
+
+                class ThreadCache {
+                public:
+                    void *pop(std::uint32_t size_class) {
+                        FreeBlock *block = free_lists_[size_class];
+                        if (block == nullptr) {
+                            if (remote_frees_.load(std::memory_order_relaxed) == nullptr) return nullptr;
+                            drain_remote();
+                            block = free_lists_[size_class];
+                            if (block == nullptr) return nullptr;
+                        }
+                        free_lists_[size_class] = block->next;
+                        --free_counts_[size_class];
+                        return block;
+                    }
+
+                    void push(BlockHeader *header) {
+                        const std::uint32_t size_class = header->size_class;
+                        if (free_counts_[size_class] >= max_cached_) {
+                            bump(system_deallocations);
+                            ::operator delete(header);
+                            return;
+                        }
+                        auto *block = static_cast<FreeBlock *>(payload_of(header));
+                        block->next = free_lists_[size_class];
+                        free_lists_[size_class] = block;
+                        ++free_counts_[size_class];
+                    }
+
+                    // Called from any thread other than the owner.
+                    void push_remote(void *payload) noexcept {
+                        auto *block = static_cast<FreeBlock *>(payload);
+                        FreeBlock *head = remote_frees_.load(std::memory_order_relaxed);
+                        do {
+                            block->next = head;
+                        } while (!remote_frees_.compare_exchange_weak(head, block, std::memory_order_release,
+                                                                      std::memory_order_relaxed));
+                    }
+
+                    void drain_remote() {
+                        // Taking the whole list at once makes the pop ABA-free.
+                        FreeBlock *block = remote_frees_.exchange(nullptr, std::memory_order_acquire);
+                        std::uint64_t count = 0;
+                        while (block != nullptr) {
+                            FreeBlock *next = block->next;
+                            push(header_of(block));
+                            block = next;
+                            ++count;
+                        }
+                        bump(deallocations, count);
+                        bump(remote_deallocations, count);
+                    }
+
+                    void release() noexcept {
+                        drain_remote();
+                        for (std::size_t size_class = 0; size_class < FrameAllocator::SIZE_CLASSES; ++size_class) {
+                            FreeBlock *block = free_lists_[size_class];
+                            while (block != nullptr) {
+                                FreeBlock *next = block->next;
+                                ::operator delete(header_of(block));
+                                bump(system_deallocations);
+                                block = next;
+                            }
+                            free_lists_[size_class] = nullptr;
+                            free_counts_[size_class] = 0;
+                        }
+                    }
+
+                    void add_to(FrameAllocatorStats &stats) const {
+                        stats.allocations += allocations.load(std::memory_order_relaxed);
+                        stats.deallocations += deallocations.load(std::memory_order_relaxed);
+                        stats.system_allocations += system_allocations.load(std::memory_order_relaxed);
+                        stats.system_deallocations += system_deallocations.load(std::memory_order_relaxed);
+                        stats.remote_deallocations += remote_deallocations.load(std::memory_order_relaxed);
+                    }
+
+                    std::atomic<std::uint64_t> allocations{0};
+                    std::atomic<std::uint64_t> deallocations{0};
+                    std::atomic<std::uint64_t> system_allocations{0};
+                    std::atomic<std::uint64_t> system_deallocations{0};
+                    std::atomic<std::uint64_t> remote_deallocations{0};
+
+                private:
+                    const int max_cached_ = max_cached_per_size();
+                    FreeBlock *free_lists_[FrameAllocator::SIZE_CLASSES] = {};
+                    int free_counts_[FrameAllocator::SIZE_CLASSES] = {};
+                    std::atomic<FreeBlock *> remote_frees_{nullptr};
+                };
+
+                // Caches are never destroyed: blocks point to their cache for as long as they live.
+                // Their number is bounded by the peak number of threads that allocated frames.
+                struct Registry {
+                    std::mutex mutex;
+                    std::vector<ThreadCache *> caches;
+                    std::vector<ThreadCache *> orphans; // caches of exited threads, waiting for adoption
+                    // Allocations of threads whose cache is already gone (thread_local destructors).
+                    std::atomic<std::uint64_t> uncached_allocations{0};
+                    std::atomic<std::uint64_t> uncached_deallocations{0};
+                };
+
+                Registry &registry() {
+                    static Registry *instance = new Registry(); // leaked on purpose: frames outlive statics
+                    return *instance;
+                }
+
+                thread_local ThreadCache *tls_cache = nullptr;
+                thread_local bool tls_cache_released = false;
+
+                struct CacheHolder {
+                    ThreadCache *cache = nullptr;
+
+                    ~CacheHolder() {
+                        if (cache == nullptr) return;
+                        tls_cache = nullptr;
+                        tls_cache_released = true;
+                        cache->release();
+                        Registry &reg = registry();
+                        std::lock_guard<std::mutex> lock(reg.mutex);
+                        reg.orphans.push_back(cache);
+                    }
+                };
+
+                ThreadCache *acquire_cache() {
+                    static thread_local CacheHolder holder;
+                    Registry &reg = registry();
+                    ThreadCache *cache;
+                    {
+                        std::lock_guard<std::mutex> lock(reg.mutex);
+                        if (!reg.orphans.empty()) {
+                            cache = reg.orphans.back();
+                            reg.orphans.pop_back();
+                        } else {
+                            cache = new ThreadCache();
+                            reg.caches.push_back(cache);
+                        }
+                    }
+                    holder.cache = cache;
+                    tls_cache = cache;
+                    return cache;
+                }
+
+                ThreadCache *current_cache() {
+                    if (tls_cache != nullptr) return tls_cache;
+                    if (tls_cache_released) return nullptr;
+                    return acquire_cache();
+                }
+
+                void *allocate_from_system(ThreadCache *owner, std::uint32_t size_class, std::size_t size) {
+                    void *raw = ::operator new(sizeof(BlockHeader) + size);
+                    return payload_of(new(raw) BlockHeader{owner, size_class});
+                }
+            } // namespace
+
+            void *FrameAllocator::allocate(std::size_t size) {
+                ThreadCache *cache = current_cache();
+                if (cache == nullptr) {
+                    registry().uncached_allocations.fetch_add(1, std::memory_order_relaxed);
+                    return allocate_from_system(nullptr, UNPOOLED, size);
+                }
+                bump(cache->allocations);
+                if (size > MAX_POOLED_SIZE) {
+                    bump(cache->system_allocations);
+                    return allocate_from_system(nullptr, UNPOOLED, size);
+                }
+                const auto size_class = static_cast<std::uint32_t>(size == 0 ? 0 : (size - 1) / GRANULARITY);
+                if (void *block = cache->pop(size_class)) return block;
+                bump(cache->system_allocations);
+                return allocate_from_system(cache, size_class, payload_size(size_class));
+            }
+
+            void FrameAllocator::deallocate(void *block) noexcept {
+                if (block == nullptr) return;
+                BlockHeader *header = header_of(block);
+                ThreadCache *cache = tls_cache;
+                if (header->owner == nullptr) {
+                    if (cache != nullptr) {
+                        bump(cache->deallocations);
+                        bump(cache->system_deallocations);
+                    } else {
+                        registry().uncached_deallocations.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    ::operator delete(header);
+                } else if (header->owner == cache) {
+                    bump(cache->deallocations);
+                    cache->push(header);
+                } else {
+                    header->owner->push_remote(block);
+                }
+            }
+
+            FrameAllocatorStats FrameAllocator::stats() {
+                FrameAllocatorStats stats;
+                Registry &reg = registry();
+                std::lock_guard<std::mutex> lock(reg.mutex);
+                for (ThreadCache *cache: reg.caches) cache->add_to(stats);
+                const std::uint64_t uncached_allocations = reg.uncached_allocations.load(std::memory_order_relaxed);
+                const std::uint64_t uncached_deallocations = reg.uncached_deallocations.load(std::memory_order_relaxed);
+                stats.allocations += uncached_allocations;
+                stats.system_allocations += uncached_allocations;
+                stats.deallocations += uncached_deallocations;
+                stats.system_deallocations += uncached_deallocations;
+                return stats;
+            }
+
+            void FrameAllocator::trim() noexcept {
+                if (ThreadCache *cache = tls_cache) cache->release();
+            }
+        } // namespace internal
+    } // namespace coroutines
+} // namespace kotlinx
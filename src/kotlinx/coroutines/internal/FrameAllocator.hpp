@@ -0,0 +1,132 @@
+#pragma once
+/**
+ * @file FrameAllocator.hpp
+ * @brief Size-classed, thread-caching allocator for coroutine frames.
+ *
+ * No Kotlin counterpart: on the JVM and on Kotlin/Native, state machines are ordinary
+ * garbage-collected objects and allocating one is a pointer bump.
+ *
+ * Here every suspend call creates a state machine (a [BaseContinuationImpl]) and drops it when
+ * it completes, which makes frames the most frequently allocated objects of the library.
+ * The frame allocator keeps the memory of completed frames for the next ones:
+ *
+ * - Requests are rounded up to a multiple of [FrameAllocator::GRANULARITY] bytes; every size
+ *   class up to [FrameAllocator::MAX_POOLED_SIZE] has its own free list. Larger requests go to
+ *   `::operator new` directly.
+ * - Free lists are per thread, so every dispatcher worker has its own and allocating or freeing
+ *   a frame on the thread that owns the block takes no lock and no atomic read-modify-write.
+ *   A thread keeps at most `kotlinx.coroutines.frames.maxCachedPerSize` (256) free blocks per
+ *   size class and returns the rest to the system.
+ * - A frame freed on another thread (a coroutine that moved between workers) is pushed onto
+ *   its owner's lock-free return list, which the owner takes over as a whole once the free list
+ *   of a size class runs dry.
+ * - The cache of a thread that exits gives its free blocks back to the system and is adopted by
+ *   the next thread that allocates a frame; blocks still in use are returned there.
+ *
+ * [BaseContinuationImpl] allocates through the frame allocator by default (class-level
+ * `operator new`); [make_frame] also puts the `shared_ptr` control block in the same pooled block.
+ * The counters of [FrameAllocator::stats] tell whether a steady-state loop still reaches the system
+ * allocator.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace kotlinx {
+namespace coroutines {
+namespace internal {
+
+/** Counters of the frame allocator, summed over all threads. */
+struct FrameAllocatorStats {
+    /** Frames allocated, whether from a free list or from the system. */
+    std::uint64_t allocations = 0;
+    /** Frames freed, whether kept for reuse or returned to the system. */
+    std::uint64_t deallocations = 0;
+    /** Allocations that had to go to `::operator new`. */
+    std::uint64_t system_allocations = 0;
+    /** Blocks given back with `::operator delete`. */
+    std::uint64_t system_deallocations = 0;
+    /**
+     * Frames freed on a thread other than the one whose cache they belong to. They are counted
+     * (here and in [deallocations]) once the owner takes them back.
+     */
+    std::uint64_t remote_deallocations = 0;
+};
+
+/**
+ * Allocation entry points of the frame pool.
+ *
+ * All functions are thread-safe. Blocks have the default new alignment.
+ */
+class FrameAllocator {
+public:
+    /** Size classes are multiples of this many bytes. */
+    static constexpr std::size_t GRANULARITY = 16;
+    /** Largest request served from the free lists. */
+    static constexpr std::size_t MAX_POOLED_SIZE = 1024;
+    static constexpr std::size_t SIZE_CLASSES = MAX_POOLED_SIZE / GRANULARITY;
+
+    /** Allocates [size] bytes; throws `std::bad_alloc` like `::operator new`. */
+    static void* allocate(std::size_t size);
+
+    /** Frees a block returned by [allocate] on any thread. Does nothing for `nullptr`. */
+    static void deallocate(void* block) noexcept;
+
+    /** Snapshot of the counters. Threads keep allocating while it is taken, so it is not atomic. */
+    static FrameAllocatorStats stats();
+
+    /** Returns the free blocks cached by the calling thread to the system. */
+    static void trim() noexcept;
+};
+
+/**
+ * Standard allocator over [FrameAllocator], for `std::allocate_shared` and containers.
+ * Over-aligned types bypass the pool.
+ */
+template<typename T>
+class FramePoolAllocator {
+public:
+    using value_type = T;
+
+    FramePoolAllocator() noexcept = default;
+
+    template<typename U>
+    FramePoolAllocator(const FramePoolAllocator<U>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        } else {
+            return static_cast<T*>(FrameAllocator::allocate(n * sizeof(T)));
+        }
+    }
+
+    void deallocate(T* block, std::size_t) noexcept {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(block, std::align_val_t(alignof(T)));
+        } else {
+            FrameAllocator::deallocate(block);
+        }
+    }
+
+    template<typename U>
+    bool operator==(const FramePoolAllocator<U>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const FramePoolAllocator<U>&) const noexcept { return false; }
+};
+
+/**
+ * `std::make_shared` for coroutine frames: the frame and its control block share one pooled block.
+ */
+template<typename T, typename... Args>
+std::shared_ptr<T> make_frame(Args&&... args) {
+    return std::allocate_shared<T>(FramePoolAllocator<T>(), std::forward<Args>(args)...);
+}
+
+} // namespace internal
+} // namespace coroutines
+} // namespace kotlinx
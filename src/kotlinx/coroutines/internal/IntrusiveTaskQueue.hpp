@@ -0,0 +1,98 @@
+#pragma once
+/**
+ * @file IntrusiveTaskQueue.hpp
+ * @brief Allocation-free multi-producer, single-consumer queue of Runnables.
+ *
+ * No Kotlin counterpart: LimitedDispatcher.kt uses a LockFreeTaskQueue, which needs a
+ * separately allocated slot per element in this port.
+ *
+ * This is Dmitry Vyukov's intrusive MPSC queue: the link lives in the Runnable itself
+ * (Runnable::queue_hook_), and a queued Runnable keeps itself alive through the hook, so
+ * neither add_last nor remove_first_or_null allocates. Producers never block each other
+ * (one exchange and one store each). A consumer may briefly see the queue as empty while a
+ * producer is between those two steps; [size] counts that element already.
+ *
+ * A Runnable can be in at most one such queue at a time. Its hook records whether it is
+ * queued, so adding one that already is throws std::logic_error rather than linking it twice.
+ */
+
+#include "kotlinx/coroutines/Runnable.hpp"
+#include "kotlinx/coroutines/internal/CacheLine.hpp"
+#include <atomic>
+#include <memory>
+
+namespace kotlinx {
+namespace coroutines {
+namespace internal {
+
+class IntrusiveTaskQueue {
+public:
+    IntrusiveTaskQueue() : head_(&stub_), tail_(&stub_) {}
+
+    ~IntrusiveTaskQueue() {
+        while (remove_first_or_null()) {}
+    }
+
+    IntrusiveTaskQueue(const IntrusiveTaskQueue&) = delete;
+    IntrusiveTaskQueue& operator=(const IntrusiveTaskQueue&) = delete;
+
+    /**
+     * Adds [task] at the tail. Safe to call from any number of threads. Throws
+     * std::logic_error, leaving every queue as it was, if [task] is already queued.
+     */
+    void add_last(std::shared_ptr<Runnable> task) {
+        TaskQueueHook* node = &task->queue_hook_;
+        node->claim();
+        // Counted before it is linked, so that size() never misses an element being added.
+        size_.fetch_add(1, std::memory_order_seq_cst);
+        node->owner = std::move(task);
+        push(node);
+    }
+
+    /**
+     * Removes the head element, or returns nullptr if there is none (or if the next element
+     * is still being linked in by its producer). Only one thread at a time may call this.
+     */
+    std::shared_ptr<Runnable> remove_first_or_null() {
+        TaskQueueHook* head = head_;
+        TaskQueueHook* next = head->next.load(std::memory_order_acquire);
+        if (head == &stub_) {
+            if (next == nullptr) return nullptr;
+            head_ = next;
+            head = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next == nullptr) {
+            if (head != tail_.load(std::memory_order_acquire)) return nullptr; // a producer is mid-push
+            // The head is the last element: put the stub behind it so that it can be unlinked.
+            push(&stub_);
+            next = head->next.load(std::memory_order_acquire);
+            if (next == nullptr) return nullptr;
+        }
+        head_ = next;
+        head->next.store(nullptr, std::memory_order_relaxed);
+        size_.fetch_sub(1, std::memory_order_seq_cst);
+        return head->unclaim();
+    }
+
+    /** Number of elements, including those still being added. Safe to call from any thread. */
+    int size() const { return size_.load(std::memory_order_seq_cst); }
+
+    bool is_empty() const { return size() == 0; }
+
+private:
+    void push(TaskQueueHook* node) {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        TaskQueueHook* prev = tail_.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    TaskQueueHook stub_;
+    TaskQueueHook* head_;                       // consumer only
+    alignas(CACHE_LINE_SIZE) std::atomic<TaskQueueHook*> tail_;
+    alignas(CACHE_LINE_SIZE) std::atomic<int> size_{0};
+};
+
+} // namespace internal
+} // namespace coroutines
+} // namespace kotlinx
@@ -0,0 +1,329 @@
+#pragma once
+/**
+ * @file LockFreeTaskQueue.hpp
+ * @brief Lock-free multi-producer queue for task scheduling purposes.
+ *
+ * Modeled after: kotlinx-coroutines-core/common/src/internal/LockFreeTaskQueue.kt
+ *
+ * ### Differences from the Kotlin implementation
+ *
+ * Kotlin packs head, tail and the frozen/closed flags into one `Long` and copies the array
+ * into a twice larger one when it fills up, leaving placeholders for slots whose producer
+ * has not written its element yet. Here:
+ *
+ * - Every core is a bounded ring of contiguous slots, each with a sequence number
+ *   (Vyukov's bounded MPMC queue). Head and tail are separate counters on their own cache
+ *   lines, so producers and consumers do not invalidate each other's line on every operation.
+ * - A full core is frozen (a flag in its tail word, so no producer can claim a slot after
+ *   that) and a twice larger core is linked behind it. Elements never move: consumers drain
+ *   the frozen core and then continue with the next one, so no placeholders are needed.
+ *   Drained cores are kept until the queue is destroyed, because a slow producer or consumer
+ *   may still be looking at them; as every core is twice as large as the previous one, they
+ *   take at most as much memory as the current core.
+ * - With `single_consumer`, the consumer owns the head: it removes elements with plain
+ *   stores, without any compare-and-swap.
+ *
+ * **Note 1: This queue is NOT linearizable. It provides only quiescent consistency for its operations.**
+ * However, this guarantee is strong enough for task-scheduling purposes.
+ * In particular, [remove_first_or_null] may return `nullptr` while a concurrent [add_last] has
+ * already claimed its slot but not written the element yet; [size] and [is_empty] count such
+ * an element already, so a consumer that retries while the queue is not empty gets it.
+ *
+ * **Note 2: Elements are raw pointers and the queue does not own them.**
+ */
+
+#include "kotlinx/coroutines/internal/CacheLine.hpp"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace kotlinx {
+namespace coroutines {
+namespace internal {
+
+template<typename E>
+class LockFreeTaskQueueCore;
+
+/**
+ * Lock-free Multiply-Producer xxx-Consumer Queue for task scheduling purposes.
+ *
+ * Transliterated from:
+ * internal open class LockFreeTaskQueue<E : Any>(singleConsumer: Boolean)
+ */
+template<typename E>
+class LockFreeTaskQueue {
+public:
+    using Core = LockFreeTaskQueueCore<E>;
+
+    /**
+     * @param single_consumer whether at most one thread at a time calls [remove_first_or_null];
+     *   enables the compare-and-swap-free consumer path
+     */
+    explicit LockFreeTaskQueue(bool single_consumer)
+        : first_(new Core(Core::INITIAL_CAPACITY, single_consumer)),
+          head_core_(first_), tail_core_(first_) {}
+
+    ~LockFreeTaskQueue() {
+        Core* core = first_;
+        while (core != nullptr) {
+            Core* next = core->next_.load(std::memory_order_relaxed);
+            delete core;
+            core = next;
+        }
+    }
+
+    LockFreeTaskQueue(const LockFreeTaskQueue&) = delete;
+    LockFreeTaskQueue& operator=(const LockFreeTaskQueue&) = delete;
+
+    // Note: it is not atomic w.r.t. remove operation (remove can transiently fail when is_empty is false)
+    bool is_empty() const { return size() == 0; }
+
+    // Note: it is not atomic w.r.t. remove operation (remove can transiently fail when size is not 0)
+    int size() const {
+        std::size_t total = 0;
+        for (Core* core = head_core_.load(std::memory_order_acquire); core != nullptr;
+             core = core->next_.load(std::memory_order_acquire)) {
+            total += core->size();
+        }
+        return static_cast<int>(total);
+    }
+
+    /** Stops accepting elements; [add_last] returns `false` afterwards. Elements already added stay. */
+    void close() {
+        Core* core = tail_core_.load(std::memory_order_acquire);
+        while (true) {
+            if (core->close()) return; // closed this core
+            core = advance_tail(core); // it was frozen: close the next one
+        }
+    }
+
+    /** Adds [element] at the tail; returns `false` if the queue is closed. */
+    bool add_last(E* element) {
+        Core* core = tail_core_.load(std::memory_order_acquire);
+        while (true) {
+            switch (core->add_last(element)) {
+                case Core::ADD_SUCCESS: return true;
+                case Core::ADD_CLOSED: return false;
+                default: core = advance_tail(core); // frozen (possibly by us): move to next
+            }
+        }
+    }
+
+    /**
+     * Removes the head element, or returns `nullptr` if the queue is empty or its head element is
+     * still being added. Must not be called concurrently from several threads if the queue was
+     * created with `single_consumer`.
+     */
+    E* remove_first_or_null() {
+        Core* core = head_core_.load(std::memory_order_acquire);
+        while (true) {
+            E* element = nullptr;
+            if (core->remove_first_or_null(element)) return element;
+            // Drained and frozen: everything else is in the next core.
+            Core* next = core->next_core();
+            if (core->single_consumer_) {
+                head_core_.store(next, std::memory_order_release);
+            } else {
+                head_core_.compare_exchange_strong(core, next, std::memory_order_acq_rel);
+            }
+            core = head_core_.load(std::memory_order_acquire);
+        }
+    }
+
+    // Used for validation in tests only
+    template<typename R>
+    std::vector<R> map(std::function<R(E*)> transform) const {
+        std::vector<R> res;
+        for (Core* core = head_core_.load(std::memory_order_acquire); core != nullptr;
+             core = core->next_.load(std::memory_order_acquire)) {
+            core->for_each([&](E* element) { res.push_back(transform(element)); });
+        }
+        return res;
+    }
+
+    // Used for validation in tests only
+    bool is_closed() const {
+        Core* core = tail_core_.load(std::memory_order_acquire);
+        while (Core* next = core->next_.load(std::memory_order_acquire)) core = next;
+        return core->is_closed();
+    }
+
+private:
+    // Kotlin: _cur.compareAndSet(cur, cur.next())
+    Core* advance_tail(Core* core) {
+        Core* next = core->next_core();
+        tail_core_.compare_exchange_strong(core, next, std::memory_order_acq_rel);
+        return next;
+    }
+
+    Core* const first_; // owns the chain of cores
+    alignas(CACHE_LINE_SIZE) std::atomic<Core*> head_core_;
+    alignas(CACHE_LINE_SIZE) std::atomic<Core*> tail_core_;
+};
+
+/**
+ * Lock-free Multiply-Producer xxx-Consumer Queue core: a bounded ring that is frozen when full.
+ * @see LockFreeTaskQueue
+ *
+ * Transliterated from:
+ * internal class LockFreeTaskQueueCore<E : Any>(private val capacity: Int, private val singleConsumer: Boolean)
+ */
+template<typename E>
+class LockFreeTaskQueueCore {
+public:
+    static constexpr int INITIAL_CAPACITY = 8;
+    static constexpr int CAPACITY_BITS = 30;
+    static constexpr int MAX_CAPACITY_MASK = (1 << CAPACITY_BITS) - 1;
+
+    static constexpr int ADD_SUCCESS = 0;
+    static constexpr int ADD_FROZEN = 1;
+    static constexpr int ADD_CLOSED = 2;
+
+    LockFreeTaskQueueCore(int capacity, bool single_consumer)
+        : capacity_(capacity), mask_(static_cast<uint64_t>(capacity) - 1), single_consumer_(single_consumer),
+          slots_(new Slot[capacity]) {
+        // Kotlin: check(mask <= MAX_CAPACITY_MASK); check(capacity and mask == 0)
+        if (capacity < 1 || capacity - 1 > MAX_CAPACITY_MASK || (capacity & (capacity - 1)) != 0) {
+            throw std::invalid_argument("LockFreeTaskQueue capacity must be a power of two up to 2^30");
+        }
+        for (int i = 0; i < capacity; ++i) slots_[i].sequence.store(static_cast<uint64_t>(i), std::memory_order_relaxed);
+    }
+
+    LockFreeTaskQueueCore(const LockFreeTaskQueueCore&) = delete;
+    LockFreeTaskQueueCore& operator=(const LockFreeTaskQueueCore&) = delete;
+
+    /** Elements added (or being added) and not yet removed. */
+    std::size_t size() const {
+        const uint64_t tail = tail_.load(std::memory_order_acquire) & POSITION_MASK;
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? static_cast<std::size_t>(tail - head) : 0;
+    }
+
+    /** Returns `false` if this core is frozen: the queue has to be closed in the next one. */
+    bool close() {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            if ((tail & CLOSED_BIT) != 0) return true;  // ok - already closed
+            if ((tail & FROZEN_BIT) != 0) return false; // frozen -- try next
+            if (tail_.compare_exchange_weak(tail, tail | CLOSED_BIT, std::memory_order_acq_rel)) return true;
+        }
+    }
+
+    bool is_closed() const { return (tail_.load(std::memory_order_acquire) & CLOSED_BIT) != 0; }
+
+    // ADD_CLOSED | ADD_FROZEN | ADD_SUCCESS
+    int add_last(E* element) {
+        uint64_t tail = tail_.load(std::memory_order_relaxed);
+        while (true) {
+            if ((tail & (FROZEN_BIT | CLOSED_BIT)) != 0) return (tail & CLOSED_BIT) != 0 ? ADD_CLOSED : ADD_FROZEN;
+            Slot& slot = slots_[tail & mask_];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<int64_t>(sequence - tail);
+            if (diff == 0) {
+                // The slot is free on this lap: claim it. Fails if another producer was faster or the
+                // core got frozen or closed in the meantime.
+                if (tail_.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed)) {
+                    slot.element = element;
+                    slot.sequence.store(tail + 1, std::memory_order_release);
+                    return ADD_SUCCESS;
+                }
+            } else if (diff < 0) {
+                // Overfull: the consumer has not freed the slot from the previous lap. Freeze & grow.
+                tail_.fetch_or(FROZEN_BIT, std::memory_order_acq_rel);
+                return ADD_FROZEN;
+            } else {
+                tail = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Removes the head element into [element] (`nullptr` if there is none yet).
+     * Returns `false` only if this core is frozen and drained: the caller has to move to the next one.
+     */
+    bool remove_first_or_null(E*& element) {
+        uint64_t head = head_.load(single_consumer_ ? std::memory_order_relaxed : std::memory_order_acquire);
+        while (true) {
+            Slot& slot = slots_[head & mask_];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<int64_t>(sequence - (head + 1));
+            if (diff == 0) {
+                if (single_consumer_) {
+                    // Fast path: we own the head, nobody else can take this element.
+                    element = slot.element;
+                    head_.store(head + 1, std::memory_order_release);
+                    slot.sequence.store(head + capacity_, std::memory_order_release);
+                    return true;
+                }
+                if (head_.compare_exchange_weak(head, head + 1, std::memory_order_acq_rel)) {
+                    element = slot.element;
+                    slot.sequence.store(head + capacity_, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                // Nothing at the head yet. Either the core is empty, or the producer that claimed this
+                // slot has not written it yet (consider it not added yet).
+                const uint64_t tail = tail_.load(std::memory_order_acquire);
+                if ((tail & FROZEN_BIT) != 0 && (tail & POSITION_MASK) == head) return false;
+                element = nullptr;
+                return true;
+            } else {
+                // Multi-consumer: another consumer took this element.
+                head = head_.load(std::memory_order_acquire);
+            }
+        }
+    }
+
+    /** The twice larger core that follows this one once it is frozen; allocated by the first who asks. */
+    LockFreeTaskQueueCore* next_core() {
+        LockFreeTaskQueueCore* next = next_.load(std::memory_order_acquire);
+        if (next != nullptr) return next;
+        if (capacity_ > (MAX_CAPACITY_MASK >> 1)) throw std::length_error("LockFreeTaskQueue capacity overflow");
+        auto* allocated = new LockFreeTaskQueueCore(capacity_ * 2, single_consumer_);
+        if (next_.compare_exchange_strong(next, allocated, std::memory_order_acq_rel)) return allocated;
+        delete allocated;
+        return next;
+    }
+
+    // Used for validation in tests only
+    template<typename F>
+    void for_each(F&& block) const {
+        const uint64_t tail = tail_.load(std::memory_order_acquire) & POSITION_MASK;
+        for (uint64_t index = head_.load(std::memory_order_acquire); index < tail; ++index) {
+            const Slot& slot = slots_[index & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) == index + 1) block(slot.element);
+        }
+    }
+
+private:
+    friend class LockFreeTaskQueue<E>;
+
+    static constexpr uint64_t FROZEN_BIT = uint64_t{1} << 62;
+    static constexpr uint64_t CLOSED_BIT = uint64_t{1} << 63;
+    static constexpr uint64_t POSITION_MASK = FROZEN_BIT - 1;
+
+    struct Slot {
+        // `index + 1` once the element for position `index` is written, `index + capacity` once it is
+        // removed and the slot is free for the next lap.
+        std::atomic<uint64_t> sequence;
+        E* element = nullptr;
+    };
+
+    const int capacity_;
+    const uint64_t mask_;
+    const bool single_consumer_;
+    const std::unique_ptr<Slot[]> slots_;
+    std::atomic<LockFreeTaskQueueCore*> next_{nullptr};
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+    // Position in the low bits, FROZEN_BIT and CLOSED_BIT on top: setting a flag makes every
+    // pending slot claim fail.
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> tail_{0};
+};
+
+} // namespace internal
+} // namespace coroutines
+} // namespace kotlinx
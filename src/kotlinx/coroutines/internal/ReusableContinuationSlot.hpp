@@ -0,0 +1,108 @@
+#pragma once
+/**
+ * @file ReusableContinuationSlot.hpp
+ * @brief The CancellableContinuationImpl a state machine reuses across suspensions.
+ *
+ * Kotlin keeps it in `DispatchedContinuation._reusableCancellableContinuation`, and the
+ * DispatchedContinuation is cached in `ContinuationImpl.intercepted`. In this port a
+ * ContinuationImpl is its own intercepted continuation, so it holds the slot itself; see
+ * dsl::suspend_cancellable_coroutine_reusable.
+ *
+ * The states are Kotlin's: empty, claimed (its owner runs the suspend block and has not yet
+ * released the continuation) and parked. Only the owner of the claim touches the parked
+ * continuation, so it needs no lock. A slot parks one kind of continuation at a time: a
+ * claim for another kind leaves it parked and gets nothing.
+ */
+
+#include <atomic>
+#include <cassert>
+#include <memory>
+
+namespace kotlinx {
+namespace coroutines {
+namespace internal {
+
+class ReusableContinuationSlot {
+public:
+    ReusableContinuationSlot() = default;
+
+    ~ReusableContinuationSlot() {
+        clear();
+    }
+
+    ReusableContinuationSlot(const ReusableContinuationSlot&) = delete;
+    ReusableContinuationSlot& operator=(const ReusableContinuationSlot&) = delete;
+
+    /**
+     * Kotlin: `claimReusableCancellableContinuation()`.
+     *
+     * Returns true if the caller now owns the claim and must [release] a continuation: then
+     * [reused] is the parked one, or null if there was none. Returns false if the slot parks
+     * another kind of continuation; the caller then suspends on a fresh, non-reusable one.
+     */
+    template<typename C>
+    bool claim(std::shared_ptr<C>& reused) {
+        while (true) {
+            int state = state_.load(std::memory_order_acquire);
+            if (state == CLAIMED) continue; // the previous suspension is about to release it
+            int expected = state;
+            if (!state_.compare_exchange_weak(expected, CLAIMED, std::memory_order_acquire)) continue;
+            if (state == PARKED) {
+                if (parked_kind_ != kind_of<C>()) {
+                    state_.store(PARKED, std::memory_order_release);
+                    return false;
+                }
+                reused = std::static_pointer_cast<C>(std::move(parked_));
+            }
+            return true;
+        }
+    }
+
+    /** Kotlin: `tryReleaseClaimedContinuation(continuation)`. Parks [cont]; the caller must own the claim. */
+    template<typename C>
+    void release(std::shared_ptr<C> cont) {
+        assert(state_.load(std::memory_order_relaxed) == CLAIMED);
+        parked_ = std::move(cont);
+        parked_kind_ = kind_of<C>();
+        detach_ = [](void* c) { static_cast<C*>(c)->detach_child(); };
+        state_.store(PARKED, std::memory_order_release);
+    }
+
+    /**
+     * Kotlin: `DispatchedContinuation.release()`, called when the state machine terminates.
+     * Waits for a pending release, then detaches the parked continuation from its parent job.
+     */
+    void clear() {
+        while (true) {
+            int state = state_.load(std::memory_order_acquire);
+            if (state == EMPTY) return;
+            if (state == CLAIMED) continue;
+            int expected = state;
+            if (!state_.compare_exchange_weak(expected, CLAIMED, std::memory_order_acquire)) continue;
+            std::shared_ptr<void> parked = std::move(parked_);
+            detach_(parked.get());
+            state_.store(EMPTY, std::memory_order_release);
+            return;
+        }
+    }
+
+private:
+    static constexpr int EMPTY = 0;
+    static constexpr int CLAIMED = 1;
+    static constexpr int PARKED = 2;
+
+    template<typename C>
+    static const void* kind_of() {
+        static const char kind = 0;
+        return &kind;
+    }
+
+    std::atomic<int> state_{EMPTY};
+    std::shared_ptr<void> parked_;
+    const void* parked_kind_ = nullptr;
+    void (*detach_)(void*) = nullptr;
+};
+
+} // namespace internal
+} // namespace coroutines
+} // namespace kotlinx
@@ -32,7 +32,7 @@ namespace internal {
  */
 template <typename T>
 Result<T> recover_result(JobState* state) {
-    if (auto* ex = dynamic_cast<CompletedExceptionally*>(state)) {
+    if (auto* ex = as_completed_exceptionally(state)) {
         return Result<T>::failure(ex->cause);
     }
     if (auto* completed = dynamic_cast<CompletedValue<T>*>(state)) {
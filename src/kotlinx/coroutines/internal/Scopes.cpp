@@ -25,7 +25,7 @@ namespace coroutines {
  * @return true if ex IS a TimeoutCancellationException from coroutine_ptr, false otherwise
  */
 bool is_own_timeout_exception(std::exception_ptr ex, const void* coroutine_ptr) {
-    if (!ex) return false;
+    if (!ex || is_shared_cancellation_exception(ex)) return false;
 
     try {
         std::rethrow_exception(ex);
@@ -49,7 +49,7 @@ public:
     
     // Clear functionality if needed by C++ specific lifecycle
     void clear() {
-        synchronized(static_cast<SynchronizedObject&>(*this), [&]() {
+        synchronized<int>(static_cast<SynchronizedObject&>(*this), [&]() {
             _size.store(0);
             a_.clear();
             return 0; // dummy return
@@ -58,7 +58,7 @@ public:
 
     template<typename Predicate>
     T* find(Predicate predicate) {
-        return synchronized(static_cast<SynchronizedObject&>(*this), [&]() -> T* {
+        return synchronized<T*>(static_cast<SynchronizedObject&>(*this), [&]() -> T* {
              int s = size();
              for (int i = 0; i < s; ++i) {
                  T* value = a_[i];
@@ -69,13 +69,13 @@ public:
     }
 
     T* peek() {
-        return synchronized(static_cast<SynchronizedObject&>(*this), [&]() -> T* {
+        return synchronized<T*>(static_cast<SynchronizedObject&>(*this), [&]() -> T* {
             return first_impl();
         });
     }
 
     T* remove_first_or_null() {
-         return synchronized(static_cast<SynchronizedObject&>(*this), [&]() -> T* {
+         return synchronized<T*>(static_cast<SynchronizedObject&>(*this), [&]() -> T* {
             if (size() > 0) {
                 return remove_at_impl(0);
             }
@@ -85,7 +85,7 @@ public:
 
     template<typename Predicate>
     T* remove_first_if(Predicate predicate) {
-        return synchronized(static_cast<SynchronizedObject&>(*this), [&]() -> T* {
+        return synchronized<T*>(static_cast<SynchronizedObject&>(*this), [&]() -> T* {
             auto first = first_impl();
             if (!first) return nullptr;
             if (predicate(first)) {
@@ -96,7 +96,7 @@ public:
     }
 
     void add_last(T* node) {
-        synchronized(static_cast<SynchronizedObject&>(*this), [&]() {
+        synchronized<int>(static_cast<SynchronizedObject&>(*this), [&]() {
             add_impl(node);
             return 0;
         });
@@ -104,7 +104,7 @@ public:
 
     template<typename Condition>
     bool add_last_if(T* node, Condition cond) {
-         return synchronized(static_cast<SynchronizedObject&>(*this), [&]() -> bool {
+         return synchronized<bool>(static_cast<SynchronizedObject&>(*this), [&]() -> bool {
              if (cond(first_impl())) {
                  add_impl(node);
                  return true;
@@ -114,7 +114,7 @@ public:
     }
 
     bool remove(T* node) {
-        return synchronized(static_cast<SynchronizedObject&>(*this), [&]() -> bool {
+        return synchronized<bool>(static_cast<SynchronizedObject&>(*this), [&]() -> bool {
             if (node->heap == nullptr) {
                 return false;
             }
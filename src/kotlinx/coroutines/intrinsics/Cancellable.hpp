@@ -28,7 +28,7 @@ public:
     LambdaContinuation(
         std::function<void*(Continuation<T>*)> block,
         std::shared_ptr<Continuation<T>> completion
-    ) : ContinuationImpl(std::make_shared<Continuation<void>>(), completion->get_context()),
+    ) : ContinuationImpl(kotlinx::coroutines::internal::make_frame<Continuation<void>>(), completion->get_context()),
         block_(block), completion_(completion) {
         (void)completion; // Supress lint if needed, though used in init list
     }
@@ -58,7 +58,7 @@ public:
         std::function<void*(R, Continuation<T>*)> block,
         R receiver,
         std::shared_ptr<Continuation<T>> completion
-    ) : ContinuationImpl(std::make_shared<Continuation<void>>(), completion->get_context()),
+    ) : ContinuationImpl(kotlinx::coroutines::internal::make_frame<Continuation<void>>(), completion->get_context()),
         block_(block), receiver_(receiver), completion_(completion) {
         (void)completion; 
     }
@@ -82,7 +82,7 @@ std::shared_ptr<Continuation<void*>> create_coroutine_unintercepted(
     std::function<void*(Continuation<T>*)> block,
     std::shared_ptr<Continuation<T>> completion
 ) {
-    return std::make_shared<LambdaContinuation<T>>(block, completion);
+    return kotlinx::coroutines::internal::make_frame<LambdaContinuation<T>>(block, completion);
 }
 
 template <typename R, typename T>
@@ -91,7 +91,7 @@ std::shared_ptr<Continuation<void*>> create_coroutine_unintercepted(
     R receiver,
     std::shared_ptr<Continuation<T>> completion
 ) {
-    return std::make_shared<ReceiverLambdaContinuation<R, T>>(block, receiver, completion);
+    return kotlinx::coroutines::internal::make_frame<ReceiverLambdaContinuation<R, T>>(block, receiver, completion);
 }
 
 // Internal helper for dispatcherFailure
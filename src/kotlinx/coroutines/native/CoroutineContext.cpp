@@ -9,7 +9,9 @@
  * TODO:
  * - TODO(port): implement WorkerDispatcher parity for native threading
  * - TODO(semantics): DefaultExecutor scheduling parity vs Kotlin/Native Worker
- * - TODO(perf): replace detached-thread timers with shared event loop
+ *
+ * Timers are served by a single shared scheduling::TimerQueue thread instead of a
+ * detached thread per delay()/with_timeout() call.
  */
 
 #include "kotlinx/coroutines/CoroutineContext.hpp"
@@ -18,9 +20,7 @@
 #include "kotlinx/coroutines/Dispatchers.hpp"
 #include "kotlinx/coroutines/CancellableContinuationImpl.hpp"
 #include "kotlinx/coroutines/context_impl.hpp"
-#include <thread>
-#include <chrono>
-#include <atomic>
+#include "kotlinx/coroutines/scheduling/TimerQueue.hpp"
 
 namespace kotlinx {
     namespace coroutines {
@@ -48,7 +48,6 @@ namespace kotlinx {
                         return;
                     }
 
-                    // Fallback timer until WorkerDispatcher is ported.
                     auto* impl_ptr = dynamic_cast<CancellableContinuationImpl<void>*>(&continuation);
                     if (!impl_ptr) {
                         // TODO(semantics): capture shared continuation handle parity.
@@ -56,11 +55,14 @@ namespace kotlinx {
                         return;
                     }
 
-                    auto shared_impl = impl_ptr->shared_from_this();
-                    std::thread([time_millis, shared_impl]() {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(time_millis));
-                        shared_impl->resume(nullptr);
-                    }).detach();
+                    // Kotlin: EventLoopImplBase.scheduleResumeAfterDelay
+                    //   schedule(now, DelayedResumeTask(...)); continuation.disposeOnCancellation(task)
+                    // Resuming on the timer thread hands the continuation back to its own dispatcher.
+                    auto handle = timer_queue_.schedule(
+                        time_millis, std::make_shared<ResumeAfterDelayTask>(impl_ptr->shared_from_this()));
+                    continuation.invoke_on_cancellation([handle](std::exception_ptr) {
+                        handle->dispose();
+                    });
                 }
 
                 std::shared_ptr<DisposableHandle> invoke_on_timeout(
@@ -76,28 +78,33 @@ namespace kotlinx {
                         return std::shared_ptr<DisposableHandle>(NoOpDisposableHandle::instance(), [](DisposableHandle*){});
                     }
 
-                    struct TimeoutHandle : public DisposableHandle {
-                        std::shared_ptr<std::atomic<bool>> cancelled;
-                        explicit TimeoutHandle(std::shared_ptr<std::atomic<bool>> c) : cancelled(std::move(c)) {}
-                        void dispose() override { cancelled->store(true, std::memory_order_relaxed); }
-                    };
-
-                    auto cancelled = std::make_shared<std::atomic<bool>>(false);
-                    std::thread([time_millis, block, cancelled]() {
-                        std::this_thread::sleep_for(std::chrono::milliseconds(time_millis));
-                        if (!cancelled->load(std::memory_order_relaxed)) {
-                            block->run();
-                        }
-                    }).detach();
-
-                    // TODO(perf): timer wheel/heap instead of detached thread.
-                    return std::make_shared<TimeoutHandle>(cancelled);
+                    // The timer thread only forwards the block, so a slow handler cannot hold up other timers.
+                    return timer_queue_.schedule(time_millis, std::make_shared<EnqueueTask>(*this, std::move(block)));
                 }
 
                 void enqueue(std::shared_ptr<Runnable> task) {
                     // Kotlin: delegate.dispatch(EmptyCoroutineContext, task)
                     dispatch(*EmptyCoroutineContext::instance(), std::move(task));
                 }
+
+            private:
+                // Kotlin: private inner class DelayedResumeTask
+                struct ResumeAfterDelayTask : public Runnable {
+                    std::shared_ptr<CancellableContinuationImpl<void>> continuation;
+                    explicit ResumeAfterDelayTask(std::shared_ptr<CancellableContinuationImpl<void>> c)
+                        : continuation(std::move(c)) {}
+                    void run() override { continuation->resume(nullptr); }
+                };
+
+                // Kotlin: private class DelayedRunnableTask
+                struct EnqueueTask : public Runnable {
+                    DefaultExecutor& executor;
+                    std::shared_ptr<Runnable> block;
+                    EnqueueTask(DefaultExecutor& e, std::shared_ptr<Runnable> b) : executor(e), block(std::move(b)) {}
+                    void run() override { executor.enqueue(std::move(block)); }
+                };
+
+                scheduling::TimerQueue timer_queue_{"DefaultExecutor"};
             };
 
             DefaultExecutor& default_executor() {
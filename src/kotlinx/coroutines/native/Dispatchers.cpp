@@ -6,6 +6,7 @@
 #include "kotlinx/coroutines/Dispatchers.hpp"
 #include "kotlinx/coroutines/MainCoroutineDispatcher.hpp"
 #include "kotlinx/coroutines/MultithreadedDispatchers.hpp"
+#include "kotlinx/coroutines/scheduling/Dispatcher.hpp"
 #include <thread>
 #include <algorithm>
 #include <iostream>
@@ -15,13 +16,16 @@ namespace kotlinx {
     namespace coroutines {
         // Internal helpers
         static std::atomic<ExecutorCoroutineDispatcherImpl *> default_dispatcher_ptr{nullptr};
-        static std::atomic<ExecutorCoroutineDispatcherImpl *> io_dispatcher_ptr{nullptr};
+        static std::atomic<scheduling::IoDispatcher *> io_dispatcher_ptr{nullptr};
 
-        static CoroutineDispatcher &create_default_dispatcher_impl() {
+        static ExecutorCoroutineDispatcherImpl &create_default_dispatcher_impl() {
             ExecutorCoroutineDispatcherImpl *ptr = default_dispatcher_ptr.load();
             if (ptr == nullptr) {
+                // Kotlin: DefaultScheduler -- the pool also hosts the blocking tasks of Dispatchers.IO,
+                // so it may grow past the CPU count by the IO parallelism.
+                const int core_pool_size = static_cast<int>(std::max(2u, std::thread::hardware_concurrency()));
                 auto *new_dispatcher = new ExecutorCoroutineDispatcherImpl(
-                    std::max(2u, std::thread::hardware_concurrency()), "Dispatchers.Default");
+                    core_pool_size, core_pool_size + scheduling::default_io_parallelism(), "Dispatchers.Default");
                 ExecutorCoroutineDispatcherImpl *expected = nullptr;
                 if (default_dispatcher_ptr.compare_exchange_strong(expected, new_dispatcher)) {
                     ptr = new_dispatcher;
@@ -34,10 +38,13 @@ namespace kotlinx {
         }
 
         static CoroutineDispatcher &create_io_dispatcher_impl() {
-            ExecutorCoroutineDispatcherImpl *ptr = io_dispatcher_ptr.load();
+            scheduling::IoDispatcher *ptr = io_dispatcher_ptr.load();
             if (ptr == nullptr) {
-                auto *new_dispatcher = new ExecutorCoroutineDispatcherImpl(64, "Dispatchers.IO");
-                ExecutorCoroutineDispatcherImpl *expected = nullptr;
+                // Kotlin: DefaultIoScheduler -- a view over the Default scheduler, not a pool of its own.
+                auto *new_dispatcher = new scheduling::IoDispatcher(
+                    create_default_dispatcher_impl().scheduler(), scheduling::default_io_parallelism(),
+                    "Dispatchers.IO");
+                scheduling::IoDispatcher *expected = nullptr;
                 if (io_dispatcher_ptr.compare_exchange_strong(expected, new_dispatcher)) {
                     ptr = new_dispatcher;
                 } else {
@@ -113,14 +120,13 @@ namespace kotlinx {
         }
 
         void Dispatchers::shutdown() {
+            auto *io = io_dispatcher_ptr.exchange(nullptr);
+            // IO runs on Default's scheduler: drain and join it before the IO view goes away.
             if (auto *ptr = default_dispatcher_ptr.exchange(nullptr)) {
                 ptr->close();
                 delete ptr;
             }
-            if (auto *ptr = io_dispatcher_ptr.exchange(nullptr)) {
-                ptr->close();
-                delete ptr;
-            }
+            delete io;
         }
 
         // MainCoroutineDispatcher base implementation
@@ -0,0 +1,138 @@
+/**
+ * @file Affinity.cpp
+ * @brief CPU and NUMA topology helpers for pinning scheduler workers.
+ *
+ * NOTE: The design notes live in the companion header
+ * `kotlinx/coroutines/scheduling/Affinity.hpp`.
+ */
+
+#include "kotlinx/coroutines/scheduling/Affinity.hpp"
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <thread>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace kotlinx {
+    namespace coroutines {
+        namespace scheduling {
+            namespace {
+                bool read_node_cpu_list(int node, std::string &list) {
+                    std::ifstream file("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                    return file && std::getline(file, list);
+                }
+
+                CpuSet all_cpus() {
+                    CpuSet cpus;
+                    const unsigned count = std::thread::hardware_concurrency();
+                    for (unsigned cpu = 0; cpu < (count > 0 ? count : 1); ++cpu) cpus.push_back(static_cast<int>(cpu));
+                    return cpus;
+                }
+            } // namespace
+
+            int numa_node_count() {
+                static const int count = [] {
+                    int nodes = 0;
+                    std::string list;
+                    while (read_node_cpu_list(nodes, list)) ++nodes;
+                    return nodes > 0 ? nodes : 1;
+                }();
+                return count;
+            }
+
+            CpuSet numa_node_cpus(int node) {
+                std::string list;
+                if (read_node_cpu_list(node, list)) return parse_cpu_list(list);
+                return node == 0 && numa_node_count() == 1 ? all_cpus() : CpuSet{};
+            }
+
+            int numa_node_of_cpu(int cpu) {
+                static const std::vector<int> nodes_of_cpus = [] {
+                    std::vector<int> nodes;
+                    std::string list;
+                    for (int node = 0; read_node_cpu_list(node, list); ++node) {
+                        for (int c: parse_cpu_list(list)) {
+                            if (c >= static_cast<int>(nodes.size())) nodes.resize(c + 1, -1);
+                            nodes[c] = node;
+                        }
+                    }
+                    return nodes;
+                }();
+                if (cpu < 0 || cpu >= static_cast<int>(nodes_of_cpus.size())) return -1;
+                return nodes_of_cpus[cpu];
+            }
+
+            CpuSet parse_cpu_list(const std::string &list) {
+                CpuSet cpus;
+                std::stringstream ranges(list);
+                std::string range;
+                while (std::getline(ranges, range, ',')) {
+                    if (range.empty()) continue;
+                    const auto dash = range.find('-');
+                    try {
+                        const int first = std::stoi(range.substr(0, dash));
+                        const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+                    } catch (const std::exception &) {
+                        // Malformed entry: skip it, the rest of the list is still usable.
+                    }
+                }
+                return cpus;
+            }
+
+            bool pin_current_thread(const CpuSet &cpus) {
+#if defined(__linux__)
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                bool any = false;
+                for (int cpu: cpus) {
+                    if (cpu < 0 || cpu >= CPU_SETSIZE) continue;
+                    CPU_SET(cpu, &set);
+                    any = true;
+                }
+                return any && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+                (void) cpus;
+                return false;
+#endif
+            }
+
+            void *allocate_on_node(std::size_t size, int node) {
+#if defined(__linux__)
+                void *memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (memory == MAP_FAILED) throw std::bad_alloc();
+                if (node >= 0 && node < 1024) {
+                    // MPOL_PREFERRED: pages are faulted in on [node] when it has free memory. Called
+                    // through syscall() so that we do not depend on libnuma; failure is harmless.
+                    constexpr int MPOL_PREFERRED_MODE = 1;
+                    constexpr std::size_t BITS = 8 * sizeof(unsigned long);
+                    unsigned long mask[1024 / BITS] = {};
+                    mask[node / BITS] = 1UL << (node % BITS);
+                    syscall(SYS_mbind, memory, size, MPOL_PREFERRED_MODE, mask, 1024UL, 0U);
+                }
+                return memory;
+#else
+                (void) node;
+                return ::operator new(size, std::align_val_t(64));
+#endif
+            }
+
+            void deallocate_on_node(void *memory, std::size_t size) noexcept {
+                if (memory == nullptr) return;
+#if defined(__linux__)
+                munmap(memory, size);
+#else
+                (void) size;
+                ::operator delete(memory, std::align_val_t(64));
+#endif
+            }
+        } // namespace scheduling
+    } // namespace coroutines
+} // namespace kotlinx
@@ -0,0 +1,69 @@
+#pragma once
+/**
+ * @file Affinity.hpp
+ * @brief CPU and NUMA topology helpers for pinning scheduler workers.
+ *
+ * No Kotlin counterpart: the JVM leaves thread placement to the operating system.
+ *
+ * On a multi-socket machine, a worker that runs on one socket and steals from, or allocates
+ * next to, a worker on another one pays a cross-socket cache miss for every such access.
+ * A [CoroutineScheduler] created with [WorkerPlacement]s pins each worker to its CPU set,
+ * allocates the worker's structures on its NUMA node, and steals within that node first.
+ *
+ * The topology is read from `/sys/devices/system/node` and pinning uses
+ * `pthread_setaffinity_np`; both are Linux-only. Elsewhere the machine looks like a single
+ * node and pinning is a no-op, so placements only affect the stealing order.
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace kotlinx {
+namespace coroutines {
+namespace scheduling {
+
+/** A set of CPU indices, as used by the operating system. */
+using CpuSet = std::vector<int>;
+
+/** Where a scheduler worker runs. */
+struct WorkerPlacement {
+    /** CPUs the worker is pinned to; empty leaves it unpinned. */
+    CpuSet cpus;
+    /** NUMA node the worker belongs to for stealing and allocation; -1 if unknown. */
+    int numa_node = -1;
+};
+
+/** Number of NUMA nodes of this machine (1 if the topology is not available). */
+int numa_node_count();
+
+/** CPUs of NUMA [node]; all CPUs for node 0 if the topology is not available. */
+CpuSet numa_node_cpus(int node);
+
+/** NUMA node of [cpu], or -1 if the topology is not available. */
+int numa_node_of_cpu(int cpu);
+
+/** Parses a kernel CPU list such as `0-3,8,10-11`. */
+CpuSet parse_cpu_list(const std::string& list);
+
+/**
+ * Pins the calling thread to [cpus].
+ *
+ * @return `false` if the platform does not support pinning or the CPU set was rejected
+ */
+bool pin_current_thread(const CpuSet& cpus);
+
+/**
+ * Allocates [size] bytes of page-aligned memory whose pages prefer NUMA [node]
+ * (any node if [node] is -1). Release it with [deallocate_on_node].
+ *
+ * @throws std::bad_alloc if the memory cannot be allocated
+ */
+void* allocate_on_node(std::size_t size, int node);
+
+/** Releases memory obtained from [allocate_on_node] with the same [size]. */
+void deallocate_on_node(void* memory, std::size_t size) noexcept;
+
+} // namespace scheduling
+} // namespace coroutines
+} // namespace kotlinx
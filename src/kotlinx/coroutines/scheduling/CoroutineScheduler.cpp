@@ -0,0 +1,679 @@
+/**
+ * @file CoroutineScheduler.cpp
+ * @brief Work-stealing thread pool backing the multi-threaded dispatchers.
+ *
+ * Modeled after: kotlinx-coroutines-core/jvm/src/scheduling/CoroutineScheduler.kt
+ *
+ * NOTE: The structural overview lives in the companion header
+ * `kotlinx/coroutines/scheduling/CoroutineScheduler.hpp`.
+ */
+
+#include "kotlinx/coroutines/scheduling/CoroutineScheduler.hpp"
+#include "kotlinx/coroutines/scheduling/WorkQueue.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace kotlinx {
+    namespace coroutines {
+        namespace scheduling {
+            /**
+             * Kotlin: internal inner class Worker : Thread
+             */
+            class CoroutineScheduler::Worker {
+            public:
+                Worker(CoroutineScheduler *scheduler, int index, const WorkerPlacement *placement)
+                    : scheduler(scheduler), index(index), placement(placement),
+                      node(placement != nullptr ? placement->numa_node : -1),
+                      rng_state(static_cast<uint32_t>(index + 1) * 0x9E3779B9u) {
+                }
+
+                // Workers (and their local queues, which take most of their size) live on their own node.
+                static void *operator new(std::size_t size, int numa_node) {
+                    return allocate_on_node(size, numa_node);
+                }
+
+                static void operator delete(void *memory, int) noexcept {
+                    deallocate_on_node(memory, sizeof(Worker));
+                }
+
+                static void operator delete(void *memory, std::size_t size) noexcept {
+                    deallocate_on_node(memory, size);
+                }
+
+                // Kotlin: internal fun nextInt(upperBound: Int): Int (xorshift)
+                int next_int(int upper_bound) {
+                    uint32_t r = rng_state;
+                    r ^= r << 13;
+                    r ^= r >> 17;
+                    r ^= r << 5;
+                    rng_state = r;
+                    return static_cast<int>(r % static_cast<uint32_t>(upper_bound));
+                }
+
+                CoroutineScheduler *const scheduler;
+                const int index;
+                const WorkerPlacement *const placement; // nullptr when the scheduler has no placements
+                const int node;
+                WorkQueue local_queue;
+                uint32_t rng_state;
+                unsigned tick = 0;
+                // Kotlin: WorkerState.CPU_ACQUIRED
+                bool has_cpu_permit = false;
+                // Set when this worker submitted a blocking task: it polls the blocking queue
+                // first after its current task, so that the task usually stays on this thread.
+                bool prefer_blocking = false;
+                // Kotlin: minDelayUntilStealableTaskNs -- set when only tasks reserved for other
+                // workers were found; the worker then parks for that long instead of indefinitely.
+                long long min_delay_until_stealable_ns = 0;
+                // Set when this worker found work by spinning; see run_worker().
+                bool was_spinning = false;
+                // Tasks taken in a row from the "next" slot of local_queue.
+                int run_next_streak = 0;
+                bool terminated = false; // guarded by workers_mutex_
+                std::thread thread;
+            };
+
+            thread_local CoroutineScheduler::Worker *CoroutineScheduler::current_worker_ = nullptr;
+
+            namespace {
+                // Hint to the CPU that we are in a spin-wait loop.
+                inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+                    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+                    asm volatile("yield");
+#endif
+                }
+
+                long long nano_time() {
+                    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now().time_since_epoch()).count();
+                }
+            } // namespace
+
+            CoroutineScheduler::CoroutineScheduler(int core_pool_size, std::string scheduler_name)
+                : CoroutineScheduler(core_pool_size, core_pool_size, std::move(scheduler_name)) {
+            }
+
+            CoroutineScheduler::CoroutineScheduler(int core_pool_size, int max_pool_size, std::string scheduler_name,
+                                                   long long idle_worker_keep_alive_ms,
+                                                   std::vector<WorkerPlacement> placements)
+                : core_pool_size_(core_pool_size), max_pool_size_(max_pool_size),
+                  idle_worker_keep_alive_(idle_worker_keep_alive_ms),
+                  scheduler_name_(std::move(scheduler_name)),
+                  placements_(std::move(placements)),
+                  worker_slots_(max_pool_size > 0 ? max_pool_size : 0),
+                  cpu_permits_(core_pool_size) {
+                if (core_pool_size < 1) {
+                    throw std::invalid_argument(
+                        "Core pool size " + std::to_string(core_pool_size) + " should be at least 1");
+                }
+                if (max_pool_size < core_pool_size) {
+                    throw std::invalid_argument(
+                        "Max pool size " + std::to_string(max_pool_size) +
+                        " should be greater than or equals to core pool size " + std::to_string(core_pool_size));
+                }
+                if (idle_worker_keep_alive_ms <= 0) {
+                    throw std::invalid_argument(
+                        "Idle worker keep alive time " + std::to_string(idle_worker_keep_alive_ms) +
+                        " must be positive");
+                }
+                workers_.reserve(max_pool_size);
+                int max_node = -1;
+                for (const auto &placement: placements_) max_node = std::max(max_node, placement.numa_node);
+                node_queues_.resize(max_node + 1);
+                node_pool_sizes_.resize(max_node + 1, 0);
+                if (!placements_.empty()) {
+                    for (int slot = 0; slot < core_pool_size; ++slot) {
+                        const int node = placements_[slot % placements_.size()].numa_node;
+                        if (node >= 0) ++node_pool_sizes_[node];
+                    }
+                }
+            }
+
+            CoroutineScheduler::~CoroutineScheduler() {
+                close();
+                {
+                    std::lock_guard<std::mutex> lock(workers_mutex_);
+                    joining_ = true;
+                }
+                for (auto &worker: workers_) {
+                    if (!worker->thread.joinable()) continue;
+                    if (worker->thread.get_id() == std::this_thread::get_id()) {
+                        // Destroyed from one of our own tasks: cannot join ourselves.
+                        worker->thread.detach();
+                    } else {
+                        worker->thread.join();
+                    }
+                }
+            }
+
+            std::string CoroutineScheduler::to_string() const {
+                return scheduler_name_;
+            }
+
+            void CoroutineScheduler::dispatch(std::shared_ptr<Runnable> block, bool blocking, bool fair) {
+                Worker *worker = current_worker_;
+                if (worker != nullptr && worker->scheduler != this) worker = nullptr;
+                if (blocking) {
+                    {
+                        std::lock_guard<std::mutex> lock(global_mutex_);
+                        if (closed_.load(std::memory_order_relaxed)) return;
+                        blocking_queue_.push_back(BlockingTask{std::move(block), worker, worker ? nano_time() : 0});
+                        blocking_size_.fetch_add(1, std::memory_order_release);
+                        blocking_tasks_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                    if (worker != nullptr) worker->prefer_blocking = true;
+                    signal_blocking_work();
+                    return;
+                }
+                if (worker != nullptr) {
+                    dispatch_local(*worker, std::move(block), fair);
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(global_mutex_);
+                    if (closed_.load(std::memory_order_relaxed)) return;
+                    global_queue_.push_back(std::move(block));
+                    global_size_.fetch_add(1, std::memory_order_release);
+                }
+                signal_cpu_work();
+            }
+
+            void CoroutineScheduler::dispatch_local(Worker &worker, std::shared_ptr<Runnable> block, bool fair) {
+                if (closed_.load(std::memory_order_acquire)) return;
+                // Fast path: no shared lock is taken when a worker submits to its own queue.
+                if (!fair) {
+                    // Kotlin: lastScheduledTask -- the displaced task goes to the FIFO part.
+                    block = worker.local_queue.add_next(std::move(block), nano_time());
+                    if (!block) {
+                        signal_cpu_work();
+                        return;
+                    }
+                }
+                if (!worker.local_queue.add(block)) {
+                    add_to_global_queue(std::move(block));
+                    return; // add_to_global_queue already signalled
+                }
+                signal_cpu_work();
+            }
+
+            void CoroutineScheduler::dispatch_on_node(std::shared_ptr<Runnable> block, int node, bool fair) {
+                if (!has_numa_node(node)) {
+                    dispatch(std::move(block), false, fair);
+                    return;
+                }
+                Worker *worker = current_worker_;
+                if (worker != nullptr && worker->scheduler == this && worker->node == node) {
+                    dispatch_local(*worker, std::move(block), fair);
+                    return;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(global_mutex_);
+                    if (closed_.load(std::memory_order_relaxed)) return;
+                    node_queues_[node].push_back(std::move(block));
+                    node_queued_.fetch_add(1, std::memory_order_release);
+                }
+                signal_cpu_work();
+            }
+
+            bool CoroutineScheduler::has_numa_node(int node) const {
+                return node >= 0 && node < static_cast<int>(node_pool_sizes_.size()) && node_pool_sizes_[node] > 0;
+            }
+
+            void CoroutineScheduler::dispatch_batch(std::vector<std::shared_ptr<Runnable>> &blocks) {
+                if (blocks.empty()) return;
+                Worker *worker = current_worker_;
+                if (worker != nullptr && worker->scheduler != this) worker = nullptr;
+                std::size_t next = 0;
+                if (worker != nullptr) {
+                    if (closed_.load(std::memory_order_acquire)) return;
+                    while (next < blocks.size() && worker->local_queue.add(blocks[next])) ++next;
+                }
+                if (next < blocks.size()) {
+                    std::lock_guard<std::mutex> lock(global_mutex_);
+                    if (closed_.load(std::memory_order_relaxed)) return;
+                    for (std::size_t i = next; i < blocks.size(); ++i) {
+                        global_queue_.push_back(std::move(blocks[i]));
+                    }
+                    global_size_.fetch_add(static_cast<int>(blocks.size() - next), std::memory_order_release);
+                }
+                signal_cpu_work(static_cast<int>(blocks.size()));
+            }
+
+            void CoroutineScheduler::close() {
+                bool has_pending;
+                {
+                    std::lock_guard<std::mutex> lock(global_mutex_);
+                    closed_.store(true, std::memory_order_release);
+                    has_pending = !global_queue_.empty() || !blocking_queue_.empty() ||
+                                  node_queued_.load(std::memory_order_relaxed) > 0;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(park_mutex_);
+                }
+                park_cv_.notify_all();
+                // Tasks submitted before close are still executed, even if no worker is alive to drain them.
+                if (has_pending && alive_workers_.load(std::memory_order_acquire) == 0) try_create_worker(true);
+            }
+
+            void CoroutineScheduler::add_to_global_queue(std::shared_ptr<Runnable> task) {
+                {
+                    std::lock_guard<std::mutex> lock(global_mutex_);
+                    global_queue_.push_back(std::move(task));
+                    global_size_.fetch_add(1, std::memory_order_release);
+                }
+                signal_cpu_work();
+            }
+
+            void CoroutineScheduler::add_to_local_queue(Worker &worker, std::shared_ptr<Runnable> task) {
+                if (!worker.local_queue.add(task)) add_to_global_queue(std::move(task));
+            }
+
+            std::shared_ptr<Runnable> CoroutineScheduler::poll_local_queue(Worker &worker) {
+                if (worker.local_queue.has_next()) {
+                    if (worker.run_next_streak < RUN_NEXT_FAIRNESS_LIMIT) {
+                        if (auto task = worker.local_queue.poll_next()) {
+                            ++worker.run_next_streak;
+                            return task;
+                        }
+                    } else if (auto task = worker.local_queue.poll_next()) {
+                        // Fairness: the "next" slot has had its turn; requeue it behind the others.
+                        add_to_local_queue(worker, std::move(task));
+                    }
+                }
+                worker.run_next_streak = 0;
+                return worker.local_queue.poll();
+            }
+
+            std::shared_ptr<Runnable> CoroutineScheduler::poll_global_queue(Worker &worker) {
+                if (global_size_.load(std::memory_order_acquire) == 0) return nullptr;
+                std::lock_guard<std::mutex> lock(global_mutex_);
+                if (global_queue_.empty()) return nullptr;
+                std::shared_ptr<Runnable> task = std::move(global_queue_.front());
+                global_queue_.pop_front();
+                // Amortize the lock for a fan-out burst from an external submitter: grab a fair
+                // share of the remaining tasks into the local queue, where they can be stolen lock-free.
+                int batch = std::min<int>(static_cast<int>(global_queue_.size()) / core_pool_size_,
+                                          BUFFER_CAPACITY / 2);
+                int moved = 1;
+                while (batch-- > 0 && worker.local_queue.add(global_queue_.front())) {
+                    global_queue_.pop_front();
+                    ++moved;
+                }
+                global_size_.fetch_sub(moved, std::memory_order_release);
+                return task;
+            }
+
+            std::shared_ptr<Runnable> CoroutineScheduler::poll_node_queue(Worker &worker, int node) {
+                if (node < 0 || node_queued_.load(std::memory_order_acquire) == 0) return nullptr;
+                std::lock_guard<std::mutex> lock(global_mutex_);
+                auto &queue = node_queues_[node];
+                if (queue.empty()) return nullptr;
+                std::shared_ptr<Runnable> task = std::move(queue.front());
+                queue.pop_front();
+                int moved = 1;
+                if (node == worker.node) {
+                    // Same amortization as poll_global_queue(), shared among the node's workers only.
+                    int batch = std::min<int>(static_cast<int>(queue.size()) / std::max(1, node_pool_sizes_[node]),
+                                              BUFFER_CAPACITY / 2);
+                    while (batch-- > 0 && worker.local_queue.add(queue.front())) {
+                        queue.pop_front();
+                        ++moved;
+                    }
+                }
+                node_queued_.fetch_sub(moved, std::memory_order_release);
+                return task;
+            }
+
+            std::shared_ptr<Runnable> CoroutineScheduler::poll_blocking_queue(Worker &worker) {
+                if (blocking_size_.load(std::memory_order_acquire) == 0) return nullptr;
+                std::lock_guard<std::mutex> lock(global_mutex_);
+                const bool closed = closed_.load(std::memory_order_relaxed);
+                long long now = 0;
+                for (auto it = blocking_queue_.begin(); it != blocking_queue_.end(); ++it) {
+                    if (it->submitter != nullptr && it->submitter != &worker && !closed) {
+                        if (now == 0) now = nano_time();
+                        const long long age = now - it->submission_time_ns;
+                        if (age < WORK_STEALING_TIME_RESOLUTION_NS) {
+                            // Still reserved for its submitter; come back when it becomes stealable.
+                            const long long delay = WORK_STEALING_TIME_RESOLUTION_NS - age;
+                            if (worker.min_delay_until_stealable_ns == 0 || delay < worker.min_delay_until_stealable_ns) {
+                                worker.min_delay_until_stealable_ns = delay;
+                            }
+                            continue;
+                        }
+                    }
+                    std::shared_ptr<Runnable> task = std::move(it->task);
+                    blocking_queue_.erase(it);
+                    blocking_size_.fetch_sub(1, std::memory_order_release);
+                    return task;
+                }
+                return nullptr;
+            }
+
+            std::shared_ptr<Runnable> CoroutineScheduler::find_task(Worker &worker, bool &blocking) {
+                // Kotlin: findTask(mayHaveLocalTasks) -- without a CPU permit only blocking tasks are eligible.
+                // Once closed, permits no longer matter: whoever is left drains everything.
+                worker.min_delay_until_stealable_ns = 0;
+                const bool may_run_cpu = worker.has_cpu_permit || try_acquire_cpu_permit(worker) ||
+                                         closed_.load(std::memory_order_acquire);
+                if (worker.prefer_blocking || !may_run_cpu) {
+                    worker.prefer_blocking = false;
+                    if (auto task = poll_blocking_queue(worker)) {
+                        blocking = true;
+                        return task;
+                    }
+                    if (!may_run_cpu) return nullptr;
+                }
+                if (++worker.tick % GLOBAL_QUEUE_CHECK_INTERVAL == 0) {
+                    if (auto task = poll_global_queue(worker)) return task;
+                }
+                if (auto task = poll_local_queue(worker)) return task;
+                if (auto task = poll_node_queue(worker, worker.node)) return task;
+                if (auto task = poll_global_queue(worker)) return task;
+                if (auto task = poll_blocking_queue(worker)) {
+                    blocking = true;
+                    return task;
+                }
+                return try_steal(worker);
+            }
+
+            std::shared_ptr<Runnable> CoroutineScheduler::try_steal(Worker &worker) {
+                const int created = created_workers_.load(std::memory_order_acquire);
+                const long long resolution_ns =
+                        closed_.load(std::memory_order_acquire) ? 0 : WORK_STEALING_TIME_RESOLUTION_NS;
+                long long now = 0;
+                const int start = created < 2 ? 0 : worker.next_int(created);
+                // With placements, stay on our own node as long as it has something to take: a task
+                // stolen from another node drags its working set across the interconnect.
+                const bool node_local_first = worker.node >= 0;
+                for (int pass = node_local_first ? 0 : 1; pass < 2; ++pass) {
+                    if (pass == 1 && node_local_first) {
+                        for (int node = 0; node < static_cast<int>(node_queues_.size()); ++node) {
+                            if (node == worker.node) continue;
+                            if (auto task = poll_node_queue(worker, node)) return task;
+                        }
+                    }
+                    for (int i = 0; i < created; ++i) {
+                        Worker *victim = worker_slots_[(start + i) % created].load(std::memory_order_acquire);
+                        if (victim == &worker) continue;
+                        if (node_local_first && (victim->node == worker.node) != (pass == 0)) continue;
+                        if (auto task = steal_from(worker, *victim, now, resolution_ns)) return task;
+                    }
+                }
+                return nullptr;
+            }
+
+            std::shared_ptr<Runnable> CoroutineScheduler::steal_from(Worker &worker, Worker &victim, long long &now,
+                                                                      long long resolution_ns) {
+                if (victim.local_queue.is_empty()) return nullptr;
+                std::shared_ptr<Runnable> task = victim.local_queue.poll();
+                if (!task) {
+                    // Only the victim's "next" slot is left, which stays reserved for a while.
+                    if (now == 0) now = nano_time();
+                    long long delay = 0;
+                    task = victim.local_queue.steal_next(now, resolution_ns, delay);
+                    if (task) return task;
+                    if (delay > 0 && (worker.min_delay_until_stealable_ns == 0 ||
+                                      delay < worker.min_delay_until_stealable_ns)) {
+                        worker.min_delay_until_stealable_ns = delay;
+                    }
+                    return nullptr;
+                }
+                // Take half of what is left so that a fan-out does not need a steal per task.
+                int batch = victim.local_queue.size() / 2;
+                bool stole_more = false;
+                while (batch-- > 0) {
+                    std::shared_ptr<Runnable> next = victim.local_queue.poll();
+                    if (!next) break;
+                    if (!worker.local_queue.add(next)) {
+                        add_to_global_queue(std::move(next));
+                        break;
+                    }
+                    stole_more = true;
+                }
+                if (stole_more) signal_cpu_work();
+                return task;
+            }
+
+            void CoroutineScheduler::run_task(Worker &worker, std::shared_ptr<Runnable> task, bool blocking) {
+                if (blocking && worker.has_cpu_permit) {
+                    // Kotlin: beforeTask(taskMode) -- hand the CPU permit over for the duration of the task.
+                    release_cpu_permit(worker);
+                    if (has_cpu_work()) signal_cpu_work();
+                }
+                try {
+                    task->run();
+                } catch (const std::exception &e) {
+                    std::cerr << "Exception in worker thread: " << e.what() << std::endl;
+                } catch (...) {
+                    std::cerr << "Unknown exception in worker thread" << std::endl;
+                }
+                if (blocking) blocking_tasks_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            bool CoroutineScheduler::try_acquire_cpu_permit(Worker &worker) {
+                int available = cpu_permits_.load(std::memory_order_relaxed);
+                while (available > 0) {
+                    if (cpu_permits_.compare_exchange_weak(available, available - 1, std::memory_order_acquire)) {
+                        worker.has_cpu_permit = true;
+                        return true;
+                    }
+                }
+                return false;
+            }
+
+            void CoroutineScheduler::release_cpu_permit(Worker &worker) {
+                worker.has_cpu_permit = false;
+                cpu_permits_.fetch_add(1, std::memory_order_seq_cst);
+            }
+
+            bool CoroutineScheduler::has_cpu_work() const {
+                if (global_size_.load(std::memory_order_acquire) > 0) return true;
+                if (node_queued_.load(std::memory_order_acquire) > 0) return true;
+                const int created = created_workers_.load(std::memory_order_acquire);
+                for (int i = 0; i < created; ++i) {
+                    if (!worker_slots_[i].load(std::memory_order_acquire)->local_queue.is_empty()) return true;
+                }
+                return false;
+            }
+
+            bool CoroutineScheduler::has_work_for_parked() const {
+                if (blocking_size_.load(std::memory_order_acquire) > 0) return true;
+                // Without a free permit a woken worker could not run CPU tasks anyway; the permit
+                // holders will find them.
+                return cpu_permits_.load(std::memory_order_acquire) > 0 && has_cpu_work();
+            }
+
+            bool CoroutineScheduler::has_work_for(const Worker &worker) const {
+                if (blocking_size_.load(std::memory_order_acquire) > 0) return true;
+                if (closed_.load(std::memory_order_acquire)) return true;
+                return (worker.has_cpu_permit || cpu_permits_.load(std::memory_order_acquire) > 0) && has_cpu_work();
+            }
+
+            bool CoroutineScheduler::spin_for_work(Worker &worker) {
+                const int spins = MAX_SPIN_CYCLES();
+                const int total = spins + MAX_YIELD_CYCLES();
+                if (total == 0) return false;
+                // Pairs with the fence in try_unpark(): a submitter that skipped the wake-up because it saw
+                // us spinning published its task before that, so one of the checks below sees it.
+                spinning_workers_.fetch_add(1, std::memory_order_seq_cst);
+                bool found = false;
+                for (int i = 0; i < total && !found; ++i) {
+                    if (i < spins) {
+                        cpu_relax();
+                    } else {
+                        std::this_thread::yield();
+                    }
+                    found = has_work_for(worker);
+                }
+                spinning_workers_.fetch_sub(1, std::memory_order_seq_cst);
+                return found;
+            }
+
+            bool CoroutineScheduler::should_terminate() {
+                if (!closed_.load(std::memory_order_acquire)) return false;
+                // Submissions check `closed_` under the same lock, so nothing can sneak into the
+                // global queues after we observed them empty here.
+                std::lock_guard<std::mutex> lock(global_mutex_);
+                return global_queue_.empty() && blocking_queue_.empty() &&
+                       node_queued_.load(std::memory_order_relaxed) == 0;
+            }
+
+            void CoroutineScheduler::signal_cpu_work(int count) {
+                int signalled = try_unpark(count);
+                while (signalled < count && try_create_worker(false)) ++signalled;
+            }
+
+            void CoroutineScheduler::signal_blocking_work() {
+                if (try_unpark() > 0) return;
+                try_create_worker(true);
+            }
+
+            int CoroutineScheduler::try_unpark(int count) {
+                // Pairs with the fence in park(): either the parking worker sees our task,
+                // or we see its parked_workers_ increment.
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                // A spinning worker will find a task by itself, and passes the wake-up on if more are left.
+                const int spinning = spinning_workers_.load(std::memory_order_relaxed);
+                if (spinning >= count) return count;
+                if (parked_workers_.load(std::memory_order_relaxed) == 0) return spinning;
+                int granted;
+                {
+                    std::lock_guard<std::mutex> lock(park_mutex_);
+                    const int available = parked_workers_.load(std::memory_order_relaxed) - wake_permits_;
+                    if (available <= 0) {
+                        // Every parked worker is already being woken up: they will all look for work.
+                        return parked_workers_.load(std::memory_order_relaxed) > 0 ? count : spinning;
+                    }
+                    granted = std::min(count - spinning, available);
+                    wake_permits_ += granted;
+                }
+                for (int i = 0; i < granted; ++i) park_cv_.notify_one();
+                return spinning + granted;
+            }
+
+            bool CoroutineScheduler::try_create_worker(bool for_blocking) {
+                std::lock_guard<std::mutex> lock(workers_mutex_);
+                if (joining_) return false;
+                const int alive = alive_workers_.load(std::memory_order_relaxed);
+                if (alive >= max_pool_size_) return false;
+                // Kotlin: tryCreateWorker() -- for CPU work, only grow while fewer than core_pool_size
+                // workers are available (the others are occupied by blocking tasks).
+                if (!for_blocking && alive - blocking_tasks_.load(std::memory_order_relaxed) >= core_pool_size_) {
+                    return false;
+                }
+                Worker *worker = nullptr;
+                for (auto &candidate: workers_) {
+                    if (candidate->terminated) {
+                        worker = candidate.get();
+                        break;
+                    }
+                }
+                if (worker != nullptr) {
+                    // The retired thread has left run_worker already or is about to; reap it.
+                    if (worker->thread.joinable()) worker->thread.join();
+                    worker->terminated = false;
+                } else {
+                    const int index = static_cast<int>(workers_.size());
+                    const WorkerPlacement *placement =
+                            placements_.empty() ? nullptr : &placements_[index % placements_.size()];
+                    workers_.push_back(std::unique_ptr<Worker>(
+                        new(placement != nullptr ? placement->numa_node : -1) Worker(this, index, placement)));
+                    worker = workers_.back().get();
+                    worker_slots_[index].store(worker, std::memory_order_release);
+                    created_workers_.store(index + 1, std::memory_order_release);
+                }
+                alive_workers_.fetch_add(1, std::memory_order_release);
+                worker->thread = std::thread([this, worker] { run_worker(*worker); });
+                return true;
+            }
+
+            bool CoroutineScheduler::try_retire(Worker &worker) {
+                // Kotlin: tryTerminateWorker()
+                std::lock_guard<std::mutex> lock(workers_mutex_);
+                if (closed_.load(std::memory_order_acquire)) return false;
+                if (alive_workers_.load(std::memory_order_relaxed) <= core_pool_size_) return false;
+                worker.terminated = true;
+                alive_workers_.fetch_sub(1, std::memory_order_release);
+                return true;
+            }
+
+            bool CoroutineScheduler::park(Worker &worker) {
+                if (worker.has_cpu_permit) {
+                    // Kotlin: tryReleaseCpu(WorkerState.PARKING). A parked worker must not sit on a
+                    // permit that a worker which has just finished a blocking task could use.
+                    release_cpu_permit(worker);
+                    if (has_cpu_work()) return true;
+                }
+                std::unique_lock<std::mutex> lock(park_mutex_);
+                parked_workers_.fetch_add(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (has_work_for_parked() || closed_.load(std::memory_order_acquire)) {
+                    parked_workers_.fetch_sub(1, std::memory_order_relaxed);
+                    return true;
+                }
+                const bool woken = park_cv_.wait_for(lock, idle_worker_keep_alive_, [this] {
+                    return wake_permits_ > 0 || closed_.load(std::memory_order_acquire);
+                });
+                if (wake_permits_ > 0) --wake_permits_;
+                // Decrement under the lock: a signaller either handed us a permit above or sees
+                // one parked worker less and starts a new one instead.
+                parked_workers_.fetch_sub(1, std::memory_order_relaxed);
+                lock.unlock();
+                return woken || !try_retire(worker);
+            }
+
+            void CoroutineScheduler::park_for_reserved_task(Worker &worker) {
+                // Short timed park: no lost-wakeup check needed, and no retirement on timeout.
+                std::unique_lock<std::mutex> lock(park_mutex_);
+                parked_workers_.fetch_add(1, std::memory_order_relaxed);
+                park_cv_.wait_for(lock, std::chrono::nanoseconds(worker.min_delay_until_stealable_ns), [this] {
+                    return wake_permits_ > 0 || closed_.load(std::memory_order_acquire);
+                });
+                if (wake_permits_ > 0) --wake_permits_;
+                parked_workers_.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            void CoroutineScheduler::run_worker(Worker &worker) {
+                if (worker.placement != nullptr && !worker.placement->cpus.empty()) {
+                    pin_current_thread(worker.placement->cpus);
+                }
+                current_worker_ = &worker;
+                while (true) {
+                    bool blocking = false;
+                    if (std::shared_ptr<Runnable> task = find_task(worker, blocking)) {
+                        if (worker.was_spinning) {
+                            // Submitters may have skipped their wake-ups because of us: if more work
+                            // is left than we can take, pass the wake-up on (Go: resetspinning).
+                            worker.was_spinning = false;
+                            if (has_work_for_parked()) try_unpark();
+                        }
+                        run_task(worker, std::move(task), blocking);
+                        continue;
+                    }
+                    if (should_terminate()) {
+                        std::lock_guard<std::mutex> lock(workers_mutex_);
+                        worker.terminated = true;
+                        alive_workers_.fetch_sub(1, std::memory_order_release);
+                        break;
+                    }
+                    if (worker.min_delay_until_stealable_ns > 0) {
+                        park_for_reserved_task(worker);
+                        continue;
+                    }
+                    if (spin_for_work(worker)) {
+                        worker.was_spinning = true;
+                        continue;
+                    }
+                    if (!park(worker)) break; // retired after staying idle for the keep-alive time
+                }
+                if (worker.has_cpu_permit) release_cpu_permit(worker);
+                current_worker_ = nullptr;
+            }
+        } // namespace scheduling
+    } // namespace coroutines
+} // namespace kotlinx
@@ -0,0 +1,257 @@
+#pragma once
+/**
+ * @file CoroutineScheduler.hpp
+ * @brief Work-stealing thread pool backing the multi-threaded dispatchers.
+ *
+ * Modeled after: kotlinx-coroutines-core/jvm/src/scheduling/CoroutineScheduler.kt
+ *
+ * ### Structural overview
+ *
+ * The scheduler consists of a pool of lazily created workers and two global injection queues,
+ * one for CPU tasks and one for blocking tasks. Every worker owns a local [WorkQueue]:
+ *
+ * - A CPU task submitted from one of the scheduler's own workers goes to that worker's local
+ *   queue, without touching any shared lock. Unless it is a yield, it takes the queue's LIFO
+ *   "next" slot, so a resumed coroutine runs right after the one that resumed it, on the same
+ *   (cache-hot) core. A worker runs at most [RUN_NEXT_FAIRNESS_LIMIT] tasks in a row from
+ *   that slot before it turns to its queue again, so a ping-pong pair cannot starve it.
+ * - A CPU task submitted from any other thread, and every blocking task, goes to a global queue,
+ *   which is the only lock-protected structure on the submission path.
+ * - A worker looks for work in its local queue first, then in the global queues (periodically
+ *   checking the global CPU queue first for fairness), and finally tries to steal half of the
+ *   tasks of a randomly chosen victim.
+ * - A worker that finds no work spins for a short while ([MAX_SPIN_CYCLES] `pause`s, then
+ *   [MAX_YIELD_CYCLES] yields) and only then parks. Submitters skip the wake-up while some
+ *   worker is spinning, wake a worker when some are parked, and start a new one when none is
+ *   parked and the pool is below its limits. For ping-pong workloads this saves a futex wake
+ *   and a sleep per message.
+ * - A worker parked for longer than the keep-alive time retires while there are more than
+ *   [core_pool_size] of them. Its slot is reused when the pool grows again.
+ *
+ * ### CPU permits and blocking tasks
+ *
+ * Like the Kotlin/JVM scheduler, the pool can run more threads than there are CPU permits:
+ * a worker has to hold one of [core_pool_size] permits to run CPU tasks. A worker releases its
+ * permit while it runs a blocking task (and when it parks), so blocking tasks never reduce the
+ * CPU parallelism, and the pool grows up to [max_pool_size] threads to run them.
+ *
+ * A blocking task submitted from a worker, like a task in a worker's "next" slot, is reserved
+ * for that same worker for [WORK_STEALING_TIME_RESOLUTION_NS]: other workers only take it once
+ * it is older than that.
+ * The submitter normally picks it up as soon as its current task returns, which is what makes
+ * `with_context(Dispatchers::IO)` from `Dispatchers::Default` usually stay on the same thread.
+ *
+ * ### Worker placement
+ *
+ * A scheduler created with [WorkerPlacement]s pins the worker in slot `i` to the CPUs of
+ * `placements[i % placements.size()]` and allocates it (with its local queue) on that
+ * placement's NUMA node. A worker steals from the workers of its own node first and only
+ * crosses to another node when its own node has nothing left to take. Tasks submitted with
+ * [dispatch_on_node] wait in a per-node injection queue that the node's workers poll before
+ * the global one. This is a preference, not a hard restriction: a worker of another node takes
+ * such a task once it has run out of work, rather than let it wait while a CPU is idle.
+ */
+
+#include "kotlinx/coroutines/Runnable.hpp"
+#include "kotlinx/coroutines/scheduling/Affinity.hpp"
+#include "kotlinx/coroutines/internal/SystemProps.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace kotlinx {
+namespace coroutines {
+namespace scheduling {
+
+/** Number of `pause` iterations an idle worker spins for before it starts yielding. 0 disables spinning. */
+inline int MAX_SPIN_CYCLES() {
+    static int value = internal::system_prop_int("kotlinx.coroutines.scheduler.maxSpinCycles", 128, 0);
+    return value;
+}
+
+/** Number of `std::this_thread::yield()` iterations that follow the spinning phase before parking. */
+inline int MAX_YIELD_CYCLES() {
+    static int value = internal::system_prop_int("kotlinx.coroutines.scheduler.maxYieldCycles", 8, 0);
+    return value;
+}
+
+/**
+ * Work-stealing scheduler with per-worker lock-free queues.
+ *
+ * Kotlin: internal class CoroutineScheduler(corePoolSize, maxPoolSize, idleWorkerKeepAliveNs, schedulerName)
+ */
+class CoroutineScheduler {
+public:
+    /** Kotlin: IDLE_WORKER_KEEP_ALIVE_NS (60 seconds) */
+    static constexpr long long IDLE_WORKER_KEEP_ALIVE_MS = 60'000;
+
+    /**
+     * A scheduler that only runs CPU tasks, on at most [core_pool_size] threads.
+     *
+     * @param core_pool_size the number of CPU permits (and worker threads), must be positive
+     * @param scheduler_name the name of this scheduler (used in to_string())
+     */
+    CoroutineScheduler(int core_pool_size, std::string scheduler_name);
+
+    /**
+     * @param core_pool_size the number of CPU permits, must be positive
+     * @param max_pool_size the maximum number of worker threads, at least [core_pool_size]
+     * @param scheduler_name the name of this scheduler (used in to_string())
+     * @param idle_worker_keep_alive_ms how long a worker above [core_pool_size] stays parked before it retires
+     * @param placements where to run the workers, assigned round-robin by slot; empty leaves them unpinned
+     */
+    CoroutineScheduler(int core_pool_size, int max_pool_size, std::string scheduler_name,
+                       long long idle_worker_keep_alive_ms = IDLE_WORKER_KEEP_ALIVE_MS,
+                       std::vector<WorkerPlacement> placements = {});
+
+    /**
+     * Closes the scheduler and joins all worker threads (except the calling one,
+     * if the scheduler is destroyed from its own worker).
+     */
+    ~CoroutineScheduler();
+
+    CoroutineScheduler(const CoroutineScheduler&) = delete;
+    CoroutineScheduler& operator=(const CoroutineScheduler&) = delete;
+
+    /**
+     * Schedules [block] for execution. Tasks submitted after [close] are silently dropped.
+     *
+     * A CPU task submitted from one of this scheduler's workers goes to that worker's "next" slot
+     * and runs right after the current task, unless [fair] is set, in which case it is queued
+     * behind the already submitted tasks.
+     *
+     * @param blocking whether [block] may block its thread; blocking tasks do not hold a CPU permit
+     * @param fair whether [block] has to wait for its turn (Kotlin: `fair`, used by `dispatch_yield`)
+     */
+    void dispatch(std::shared_ptr<Runnable> block, bool blocking = false, bool fair = false);
+
+    /**
+     * Schedules several CPU tasks at once: the global queue is locked at most once for the whole
+     * batch, and at most `min(blocks.size(), idle workers)` workers are woken up. None of the tasks
+     * takes a worker's "next" slot. The blocks are moved from.
+     */
+    void dispatch_batch(std::vector<std::shared_ptr<Runnable>>& blocks);
+
+    /**
+     * Schedules a CPU task for the workers of NUMA [node]: from one of those workers it behaves like
+     * [dispatch], from anywhere else it goes to the node's injection queue. Falls back to [dispatch]
+     * if no placement of this scheduler is on [node].
+     */
+    void dispatch_on_node(std::shared_ptr<Runnable> block, int node, bool fair = false);
+
+    /** Whether some worker placement of this scheduler is on NUMA [node]. */
+    bool has_numa_node(int node) const;
+
+    /**
+     * Stops accepting new tasks. Already submitted tasks are still executed before
+     * the workers terminate.
+     */
+    void close();
+
+    bool is_closed() const { return closed_.load(std::memory_order_acquire); }
+
+    int core_pool_size() const { return core_pool_size_; }
+
+    int max_pool_size() const { return max_pool_size_; }
+
+    /** Number of worker threads currently alive (running, parked or about to start). */
+    int alive_workers() const { return alive_workers_.load(std::memory_order_acquire); }
+
+    std::string to_string() const;
+
+private:
+    class Worker;
+
+    /** Kotlin: with probability 1/GLOBAL_QUEUE_CHECK_INTERVAL a worker polls the global queue first. */
+    static constexpr unsigned GLOBAL_QUEUE_CHECK_INTERVAL = 61;
+
+    /** Tasks a worker may take in a row from its "next" slot before it goes back to its FIFO queue. */
+    static constexpr int RUN_NEXT_FAIRNESS_LIMIT = 32;
+
+    /** Kotlin: WORK_STEALING_TIME_RESOLUTION_NS -- how long a blocking task stays reserved for its submitter. */
+    static constexpr long long WORK_STEALING_TIME_RESOLUTION_NS = 100'000;
+
+    struct BlockingTask {
+        std::shared_ptr<Runnable> task;
+        Worker* submitter; // nullptr when submitted from outside of the pool
+        long long submission_time_ns;
+    };
+
+    void add_to_global_queue(std::shared_ptr<Runnable> task);
+    void add_to_local_queue(Worker& worker, std::shared_ptr<Runnable> task);
+    void dispatch_local(Worker& worker, std::shared_ptr<Runnable> block, bool fair);
+    std::shared_ptr<Runnable> poll_local_queue(Worker& worker);
+    std::shared_ptr<Runnable> poll_global_queue(Worker& worker);
+    std::shared_ptr<Runnable> poll_node_queue(Worker& worker, int node);
+    std::shared_ptr<Runnable> steal_from(Worker& worker, Worker& victim, long long& now, long long resolution_ns);
+    std::shared_ptr<Runnable> poll_blocking_queue(Worker& worker);
+    std::shared_ptr<Runnable> find_task(Worker& worker, bool& blocking);
+    std::shared_ptr<Runnable> try_steal(Worker& worker);
+    void run_task(Worker& worker, std::shared_ptr<Runnable> task, bool blocking);
+    bool try_acquire_cpu_permit(Worker& worker);
+    void release_cpu_permit(Worker& worker);
+    bool has_cpu_work() const;
+    bool has_work_for_parked() const;
+    bool has_work_for(const Worker& worker) const;
+    bool spin_for_work(Worker& worker);
+    bool should_terminate();
+    void signal_cpu_work(int count = 1);
+    void signal_blocking_work();
+    int try_unpark(int count = 1);
+    bool try_create_worker(bool for_blocking);
+    bool try_retire(Worker& worker);
+    bool park(Worker& worker);
+    void park_for_reserved_task(Worker& worker);
+    void run_worker(Worker& worker);
+
+    static thread_local Worker* current_worker_;
+
+    const int core_pool_size_;
+    const int max_pool_size_;
+    const std::chrono::milliseconds idle_worker_keep_alive_;
+    const std::string scheduler_name_;
+    const std::vector<WorkerPlacement> placements_;
+    std::atomic<bool> closed_{false};
+
+    // Workers are created lazily into fixed slots; a retired worker's slot is reused, so a
+    // Worker object lives as long as the scheduler and stealers can scan the slots lock-free.
+    std::vector<std::atomic<Worker*>> worker_slots_;
+    std::atomic<int> created_workers_{0};
+    std::atomic<int> alive_workers_{0};
+    std::mutex workers_mutex_;
+    std::vector<std::unique_ptr<Worker>> workers_; // guarded by workers_mutex_
+    bool joining_ = false;                         // guarded by workers_mutex_
+
+    // Kotlin: CPU permits are part of controlState; blocking tasks are counted alongside.
+    std::atomic<int> cpu_permits_;
+    std::atomic<int> blocking_tasks_{0};
+
+    // Global injection queues for tasks submitted from outside of the pool and for blocking tasks.
+    std::mutex global_mutex_;
+    std::deque<std::shared_ptr<Runnable>> global_queue_;
+    std::atomic<int> global_size_{0};
+    std::deque<BlockingTask> blocking_queue_;
+    std::atomic<int> blocking_size_{0};
+    // Per-node injection queues, indexed by NUMA node; empty without placements.
+    std::vector<std::deque<std::shared_ptr<Runnable>>> node_queues_;
+    std::vector<int> node_pool_sizes_; // CPU workers per node, for the share taken from a node queue
+    std::atomic<int> node_queued_{0};  // total size of node_queues_
+
+    // Idle workers that are still spinning; while there is one, submitters skip the wake-up.
+    std::atomic<int> spinning_workers_{0};
+
+    // Parking lot for idle workers.
+    std::mutex park_mutex_;
+    std::condition_variable park_cv_;
+    std::atomic<int> parked_workers_{0};
+    int wake_permits_ = 0;
+};
+
+} // namespace scheduling
+} // namespace coroutines
+} // namespace kotlinx
@@ -0,0 +1,125 @@
+/**
+ * @file Dispatcher.cpp
+ * @brief Dispatchers.IO as a view over the scheduler of Dispatchers.Default.
+ *
+ * Modeled after: kotlinx-coroutines-core/jvm/src/scheduling/Dispatcher.kt
+ *
+ * NOTE: The design notes live in the companion header
+ * `kotlinx/coroutines/scheduling/Dispatcher.hpp`.
+ */
+
+#include "kotlinx/coroutines/scheduling/Dispatcher.hpp"
+#include "kotlinx/coroutines/scheduling/CoroutineScheduler.hpp"
+#include "kotlinx/coroutines/internal/SystemProps.hpp"
+#include <algorithm>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+namespace kotlinx {
+    namespace coroutines {
+        namespace scheduling {
+            int default_io_parallelism() {
+                static int value = internal::system_prop_int(
+                    IO_PARALLELISM_PROPERTY_NAME,
+                    std::max(64, static_cast<int>(std::thread::hardware_concurrency())));
+                return value;
+            }
+
+            /**
+             * Runs tasks of the IO dispatcher while holding one of its blocking permits.
+             *
+             * Kotlin: private inner class LimitedDispatcher.Worker(private var currentTask: Runnable) : Runnable
+             */
+            class IoDispatcher::Worker : public Runnable {
+            public:
+                Worker(const IoDispatcher *dispatcher, std::shared_ptr<Runnable> task)
+                    : dispatcher_(dispatcher), current_task_(std::move(task)) {
+                }
+
+                void run() override {
+                    int fairness_counter = 0;
+                    while (true) {
+                        try {
+                            current_task_->run();
+                        } catch (const std::exception &e) {
+                            std::cerr << "Uncaught exception in " << dispatcher_->name_ << " task: " << e.what()
+                                    << std::endl;
+                        } catch (...) {
+                            std::cerr << "Uncaught unknown exception in " << dispatcher_->name_ << " task" << std::endl;
+                        }
+                        std::shared_ptr<Runnable> next = dispatcher_->obtain_task_or_deallocate_worker();
+                        if (!next) return;
+                        // Give other blocking work submitted to the scheduler a chance to run.
+                        if (++fairness_counter >= FAIRNESS_BATCH) {
+                            dispatcher_->scheduler_.dispatch(
+                                std::make_shared<Worker>(dispatcher_, std::move(next)), /* blocking = */ true);
+                            return;
+                        }
+                        current_task_ = std::move(next);
+                    }
+                }
+
+            private:
+                const IoDispatcher *dispatcher_;
+                std::shared_ptr<Runnable> current_task_;
+            };
+
+            IoDispatcher::IoDispatcher(CoroutineScheduler &scheduler, int parallelism, std::string name)
+                : scheduler_(scheduler), parallelism_(parallelism), name_(std::move(name)) {
+                if (parallelism < 1) {
+                    throw std::invalid_argument(
+                        "Expected positive parallelism level, but got " + std::to_string(parallelism));
+                }
+            }
+
+            void IoDispatcher::dispatch(const CoroutineContext &context, std::shared_ptr<Runnable> block) const {
+                {
+                    std::lock_guard<std::mutex> lock(lock_);
+                    if (running_workers_ >= parallelism_) {
+                        queue_.push_back(std::move(block));
+                        return;
+                    }
+                    ++running_workers_;
+                }
+                scheduler_.dispatch(std::make_shared<Worker>(this, std::move(block)), /* blocking = */ true);
+            }
+
+            std::shared_ptr<Runnable> IoDispatcher::obtain_task_or_deallocate_worker() const {
+                std::lock_guard<std::mutex> lock(lock_);
+                if (queue_.empty()) {
+                    --running_workers_;
+                    return nullptr;
+                }
+                std::shared_ptr<Runnable> task = std::move(queue_.front());
+                queue_.pop_front();
+                return task;
+            }
+
+            std::string IoDispatcher::to_string() const {
+                return name_;
+            }
+
+            NumaNodeDispatcher::NumaNodeDispatcher(CoroutineScheduler &scheduler, int node, std::string name)
+                : scheduler_(scheduler), node_(node), name_(std::move(name)) {
+                if (!scheduler.has_numa_node(node)) {
+                    throw std::invalid_argument(
+                        "Scheduler " + scheduler.to_string() + " has no workers on NUMA node " + std::to_string(node));
+                }
+            }
+
+            void NumaNodeDispatcher::dispatch(const CoroutineContext &context, std::shared_ptr<Runnable> block) const {
+                scheduler_.dispatch_on_node(std::move(block), node_);
+            }
+
+            void NumaNodeDispatcher::dispatch_yield(const CoroutineContext &context,
+                                                    std::shared_ptr<Runnable> block) const {
+                scheduler_.dispatch_on_node(std::move(block), node_, /* fair = */ true);
+            }
+
+            std::string NumaNodeDispatcher::to_string() const {
+                return name_;
+            }
+        } // namespace scheduling
+    } // namespace coroutines
+} // namespace kotlinx
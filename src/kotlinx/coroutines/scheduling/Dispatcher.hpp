@@ -0,0 +1,116 @@
+#pragma once
+/**
+ * @file Dispatcher.hpp
+ * @brief Dispatchers.IO as a view over the scheduler of Dispatchers.Default.
+ *
+ * Modeled after: kotlinx-coroutines-core/jvm/src/scheduling/Dispatcher.kt
+ *
+ * Dispatchers.IO does not own any threads. It submits its tasks to the [CoroutineScheduler]
+ * of Dispatchers.Default as blocking tasks, and limits how many of them may be in flight at
+ * once with its own budget of blocking permits. The scheduler grows its pool for blocking
+ * tasks and retires the extra threads once they are idle, so an application that never
+ * blocks never pays for the IO threads.
+ *
+ * [NumaNodeDispatcher] is a view of the same kind that sends CPU tasks to the workers of one
+ * NUMA node of a pinned scheduler.
+ */
+
+#include "kotlinx/coroutines/CoroutineDispatcher.hpp"
+#include "kotlinx/coroutines/Runnable.hpp"
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace kotlinx {
+namespace coroutines {
+namespace scheduling {
+
+class CoroutineScheduler;
+
+/** Kotlin: public const val IO_PARALLELISM_PROPERTY_NAME: String = "kotlinx.coroutines.io.parallelism" */
+inline constexpr const char* IO_PARALLELISM_PROPERTY_NAME = "kotlinx.coroutines.io.parallelism";
+
+/**
+ * The default number of blocking permits of Dispatchers.IO: `max(64, number of cores)`,
+ * overridable with the [IO_PARALLELISM_PROPERTY_NAME] system property.
+ */
+int default_io_parallelism();
+
+/**
+ * Dispatcher running blocking tasks on a shared [CoroutineScheduler], at most [parallelism] at once.
+ *
+ * Kotlin: internal object DefaultIoScheduler : ExecutorCoroutineDispatcher(), Executor
+ * (which is `UnlimitedIoScheduler.limitedParallelism(IO_PARALLELISM)`)
+ */
+class IoDispatcher : public CoroutineDispatcher {
+public:
+    /**
+     * @param scheduler the scheduler to run on; must outlive this dispatcher's tasks
+     * @param parallelism the number of blocking permits, must be positive
+     * @param name the name of this dispatcher (used in to_string())
+     */
+    IoDispatcher(CoroutineScheduler& scheduler, int parallelism, std::string name);
+
+    IoDispatcher(const IoDispatcher&) = delete;
+    IoDispatcher& operator=(const IoDispatcher&) = delete;
+
+    void dispatch(const CoroutineContext& context, std::shared_ptr<Runnable> block) const override;
+
+    std::string to_string() const override;
+
+    int parallelism() const { return parallelism_; }
+
+private:
+    class Worker;
+
+    /** Kotlin: LimitedDispatcher.Worker re-dispatches itself after this many tasks for fairness. */
+    static constexpr int FAIRNESS_BATCH = 16;
+
+    // Kotlin: private fun obtainTaskOrDeallocateWorker(): Runnable?
+    std::shared_ptr<Runnable> obtain_task_or_deallocate_worker() const;
+
+    CoroutineScheduler& scheduler_;
+    const int parallelism_;
+    const std::string name_;
+
+    mutable std::mutex lock_;
+    mutable std::deque<std::shared_ptr<Runnable>> queue_; // guarded by lock_
+    mutable int running_workers_ = 0;                     // guarded by lock_
+};
+
+/**
+ * Dispatcher running CPU tasks on the workers of one NUMA node of a shared [CoroutineScheduler]
+ * created with worker placements (see CoroutineScheduler::dispatch_on_node).
+ *
+ * A `limited_parallelism` view of this dispatcher submits through it, so it inherits the node.
+ */
+class NumaNodeDispatcher : public CoroutineDispatcher {
+public:
+    /**
+     * @param scheduler the scheduler to run on; must outlive this dispatcher's tasks
+     * @param node the NUMA node, which must be one of [scheduler]'s placements
+     * @param name the name of this dispatcher (used in to_string())
+     */
+    NumaNodeDispatcher(CoroutineScheduler& scheduler, int node, std::string name);
+
+    NumaNodeDispatcher(const NumaNodeDispatcher&) = delete;
+    NumaNodeDispatcher& operator=(const NumaNodeDispatcher&) = delete;
+
+    void dispatch(const CoroutineContext& context, std::shared_ptr<Runnable> block) const override;
+
+    void dispatch_yield(const CoroutineContext& context, std::shared_ptr<Runnable> block) const override;
+
+    std::string to_string() const override;
+
+    int node() const { return node_; }
+
+private:
+    CoroutineScheduler& scheduler_;
+    const int node_;
+    const std::string name_;
+};
+
+} // namespace scheduling
+} // namespace coroutines
+} // namespace kotlinx
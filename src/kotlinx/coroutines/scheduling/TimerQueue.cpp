@@ -0,0 +1,227 @@
+/**
+ * @file TimerQueue.cpp
+ * @brief Shared timer thread serving delay() and with_timeout() for the default Delay.
+ *
+ * NOTE: The design notes live in the companion header
+ * `kotlinx/coroutines/scheduling/TimerQueue.hpp`.
+ */
+
+#include "kotlinx/coroutines/scheduling/TimerQueue.hpp"
+#include <iostream>
+#include <utility>
+
+namespace kotlinx {
+    namespace coroutines {
+        namespace scheduling {
+            /**
+             * A scheduled timer and, at the same time, the handle returned to the caller.
+             *
+             * Kotlin: internal abstract class DelayedTask : Runnable, Comparable<DelayedTask>, DisposableHandle
+             */
+            class TimerQueue::Timer : public DisposableHandle {
+            public:
+                static constexpr int SCHEDULED = 0;
+                static constexpr int FIRED = 1;
+                static constexpr int CANCELLED = 2;
+
+                Timer(TimerQueue *queue, Clock::time_point deadline, uint64_t sequence,
+                      std::shared_ptr<Runnable> task)
+                    : queue(queue), deadline(deadline), sequence(sequence), task(std::move(task)) {
+                }
+
+                void dispose() override {
+                    int expected = SCHEDULED;
+                    if (!state.compare_exchange_strong(expected, CANCELLED, std::memory_order_acq_rel)) return;
+                    // We own the task now: neither fire() nor the timer thread will touch it.
+                    task.reset();
+                    queue->cancelled_.fetch_add(1, std::memory_order_relaxed);
+                }
+
+                /** Claims the timer for execution; returns false if it was cancelled first. */
+                bool try_fire() {
+                    int expected = SCHEDULED;
+                    return state.compare_exchange_strong(expected, FIRED, std::memory_order_acq_rel);
+                }
+
+                bool is_cancelled() const { return state.load(std::memory_order_acquire) == CANCELLED; }
+
+                bool before(const Timer &other) const {
+                    if (deadline != other.deadline) return deadline < other.deadline;
+                    return sequence < other.sequence;
+                }
+
+                TimerQueue *const queue;
+                const Clock::time_point deadline;
+                const uint64_t sequence;
+                std::shared_ptr<Runnable> task;
+                std::atomic<int> state{SCHEDULED};
+            };
+
+            TimerQueue::TimerQueue(std::string name) : name_(std::move(name)) {
+            }
+
+            TimerQueue::~TimerQueue() {
+                shutdown();
+            }
+
+            std::shared_ptr<DisposableHandle> TimerQueue::schedule(long long time_millis,
+                                                                   std::shared_ptr<Runnable> task) {
+                const auto now = Clock::now();
+                // Clamp to avoid overflowing steady_clock for "practically infinite" delays.
+                const auto max_delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    Clock::time_point::max() - now) - std::chrono::milliseconds(1);
+                const auto delay = std::min(std::chrono::milliseconds(time_millis < 0 ? 0 : time_millis), max_delay);
+
+                std::unique_lock<std::mutex> lock(lock_);
+                auto timer = std::make_shared<Timer>(this, now + delay, next_sequence_++, std::move(task));
+                if (stopped_) {
+                    timer->try_fire(); // never runs; the handle is inert
+                    return timer;
+                }
+                if (!started_) {
+                    started_ = true;
+                    thread_ = std::thread([this] { run_timer_thread(); });
+                }
+                purge_cancelled_locked();
+                heap_push(timer);
+                // Wake the timer thread only if the new timer became the earliest one.
+                const bool earliest = heap_.front() == timer;
+                lock.unlock();
+                if (earliest) cv_.notify_one();
+                return timer;
+            }
+
+            int TimerQueue::size() const {
+                std::lock_guard<std::mutex> lock(lock_);
+                return static_cast<int>(heap_.size());
+            }
+
+            void TimerQueue::shutdown() {
+                std::vector<std::shared_ptr<Timer>> dropped;
+                {
+                    std::lock_guard<std::mutex> lock(lock_);
+                    if (stopped_) return;
+                    stopped_ = true;
+                    dropped.swap(heap_);
+                }
+                cv_.notify_all();
+                if (thread_.joinable()) {
+                    if (thread_.get_id() == std::this_thread::get_id()) {
+                        thread_.detach();
+                    } else {
+                        thread_.join();
+                    }
+                }
+                // Make outstanding handles inert so that a late dispose() does not touch this queue.
+                for (auto &timer: dropped) {
+                    if (timer->try_fire()) timer->task.reset();
+                }
+            }
+
+            void TimerQueue::run_timer_thread() {
+                std::unique_lock<std::mutex> lock(lock_);
+                while (!stopped_) {
+                    if (heap_.empty()) {
+                        cv_.wait(lock);
+                        continue;
+                    }
+                    Timer &first = *heap_.front();
+                    if (first.is_cancelled()) {
+                        heap_pop();
+                        cancelled_.fetch_sub(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    if (first.deadline > Clock::now()) {
+                        // Copy: the entry may be swept while we wait.
+                        const Clock::time_point deadline = first.deadline;
+                        cv_.wait_until(lock, deadline);
+                        continue;
+                    }
+                    std::shared_ptr<Timer> timer = heap_pop();
+                    if (!timer->try_fire()) {
+                        // Cancelled between the check above and now.
+                        cancelled_.fetch_sub(1, std::memory_order_relaxed);
+                        continue;
+                    }
+                    std::shared_ptr<Runnable> task = std::move(timer->task);
+                    lock.unlock();
+                    try {
+                        task->run();
+                    } catch (const std::exception &e) {
+                        std::cerr << "Exception in " << name_ << " timer task: " << e.what() << std::endl;
+                    } catch (...) {
+                        std::cerr << "Unknown exception in " << name_ << " timer task" << std::endl;
+                    }
+                    task.reset();
+                    lock.lock();
+                }
+            }
+
+            //
+            // 4-ary heap, guarded by lock_
+            //
+
+            void TimerQueue::heap_push(std::shared_ptr<Timer> timer) {
+                heap_.push_back(std::move(timer));
+                sift_up(heap_.size() - 1);
+            }
+
+            std::shared_ptr<TimerQueue::Timer> TimerQueue::heap_pop() {
+                std::shared_ptr<Timer> first = std::move(heap_.front());
+                heap_.front() = std::move(heap_.back());
+                heap_.pop_back();
+                if (!heap_.empty()) sift_down(0);
+                return first;
+            }
+
+            void TimerQueue::sift_up(std::size_t index) {
+                std::shared_ptr<Timer> timer = std::move(heap_[index]);
+                while (index > 0) {
+                    const std::size_t parent = (index - 1) / 4;
+                    if (!timer->before(*heap_[parent])) break;
+                    heap_[index] = std::move(heap_[parent]);
+                    index = parent;
+                }
+                heap_[index] = std::move(timer);
+            }
+
+            void TimerQueue::sift_down(std::size_t index) {
+                const std::size_t size = heap_.size();
+                std::shared_ptr<Timer> timer = std::move(heap_[index]);
+                while (true) {
+                    const std::size_t first_child = index * 4 + 1;
+                    if (first_child >= size) break;
+                    const std::size_t last_child = std::min(first_child + 4, size);
+                    std::size_t min_child = first_child;
+                    for (std::size_t child = first_child + 1; child < last_child; ++child) {
+                        if (heap_[child]->before(*heap_[min_child])) min_child = child;
+                    }
+                    if (!heap_[min_child]->before(*timer)) break;
+                    heap_[index] = std::move(heap_[min_child]);
+                    index = min_child;
+                }
+                heap_[index] = std::move(timer);
+            }
+
+            void TimerQueue::purge_cancelled_locked() {
+                const int64_t cancelled = cancelled_.load(std::memory_order_relaxed);
+                if (heap_.size() < MIN_PURGE_SIZE || cancelled * 2 < static_cast<int64_t>(heap_.size())) return;
+                int64_t removed = 0;
+                std::size_t kept = 0;
+                for (auto &timer: heap_) {
+                    if (timer->is_cancelled()) {
+                        ++removed;
+                    } else {
+                        heap_[kept++] = std::move(timer);
+                    }
+                }
+                heap_.resize(kept);
+                // Floyd's heapify: O(n), amortized against the cancellations that triggered it.
+                for (std::size_t i = kept / 4 + 1; i-- > 0;) {
+                    if (i < kept) sift_down(i);
+                }
+                cancelled_.fetch_sub(removed, std::memory_order_relaxed);
+            }
+        } // namespace scheduling
+    } // namespace coroutines
+} // namespace kotlinx
@@ -0,0 +1,96 @@
+#pragma once
+/**
+ * @file TimerQueue.hpp
+ * @brief Shared timer thread serving delay() and with_timeout() for the default Delay.
+ *
+ * Modeled after the delayed-task queue of `EventLoopImplBase` in
+ * kotlinx-coroutines-core/common/src/EventLoop.common.kt, run on one dedicated thread
+ * the way the JVM `DefaultExecutor` does.
+ *
+ * Pending timers are kept in a 4-ary min-heap ordered by deadline (ties broken by
+ * scheduling order). A 4-ary heap is shallower than a binary one and its children share
+ * a cache line, which keeps sift-down cheap at tens of thousands of pending timeouts.
+ *
+ * Cancellation through the returned DisposableHandle is O(1) and lock-free: it only flips
+ * the timer's state and releases its task. Cancelled entries are dropped lazily when they
+ * reach the top of the heap, or swept in bulk once they make up more than half of it.
+ */
+
+#include "kotlinx/coroutines/DisposableHandle.hpp"
+#include "kotlinx/coroutines/Runnable.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace kotlinx {
+namespace coroutines {
+namespace scheduling {
+
+/**
+ * A single-threaded timer service.
+ *
+ * Expired tasks are run on the timer thread, so they must be short and non-blocking:
+ * typically they resume a continuation, which hands it back to its own dispatcher,
+ * or forward the actual work to a dispatcher themselves.
+ */
+class TimerQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    explicit TimerQueue(std::string name);
+
+    /** Stops the timer thread. Pending timers are dropped without running. */
+    ~TimerQueue();
+
+    TimerQueue(const TimerQueue&) = delete;
+    TimerQueue& operator=(const TimerQueue&) = delete;
+
+    /**
+     * Runs [task] on the timer thread after [time_millis] milliseconds.
+     * The timer thread is started lazily on the first call.
+     *
+     * @return a handle that cancels the timer if it has not fired yet
+     */
+    std::shared_ptr<DisposableHandle> schedule(long long time_millis, std::shared_ptr<Runnable> task);
+
+    /** Number of entries in the heap, including cancelled ones that have not been swept yet. */
+    int size() const;
+
+    /** Stops the timer thread and drops all pending timers. Irreversible. */
+    void shutdown();
+
+private:
+    class Timer;
+
+    /** Sweeping cancelled timers is only worth it past this heap size. */
+    static constexpr std::size_t MIN_PURGE_SIZE = 64;
+
+    void run_timer_thread();
+    void heap_push(std::shared_ptr<Timer> timer);
+    std::shared_ptr<Timer> heap_pop();
+    void sift_up(std::size_t index);
+    void sift_down(std::size_t index);
+    void purge_cancelled_locked();
+
+    const std::string name_;
+    mutable std::mutex lock_;
+    std::condition_variable cv_;
+    std::vector<std::shared_ptr<Timer>> heap_;
+    // Signed: a dispose() may flip the state before bumping the counter, so a sweep can
+    // transiently observe more cancelled timers than counted.
+    std::atomic<int64_t> cancelled_{0};
+    uint64_t next_sequence_ = 0;
+    bool started_ = false;
+    bool stopped_ = false;
+    std::thread thread_;
+};
+
+} // namespace scheduling
+} // namespace coroutines
+} // namespace kotlinx
@@ -0,0 +1,194 @@
+#pragma once
+/**
+ * @file WorkQueue.hpp
+ * @brief Per-worker local task queue of the work-stealing CoroutineScheduler.
+ *
+ * Modeled after: kotlinx-coroutines-core/jvm/src/scheduling/WorkQueue.kt
+ *
+ * The Kotlin version is a ring of `AtomicReferenceArray<Task?>` slots that relies on the GC
+ * to make speculative reads of task references safe. Here tasks are `std::shared_ptr<Runnable>`,
+ * which cannot be read concurrently with a write, so every slot carries a sequence word
+ * (Vyukov-style bounded queue) that hands exclusive access to the slot's payload to exactly
+ * one thread at a time: the owning worker when it fills the slot, and the single consumer
+ * that claimed it by CAS on `head_` when it is drained.
+ *
+ * Next to the ring sits a one-task LIFO slot (Kotlin: `lastScheduledTask`, Go: `runnext`)
+ * that holds the task most recently scheduled by the owner. It is guarded by a three-state
+ * word (EMPTY / FULL / BUSY) instead of a sequence, because the owner overwrites it in place.
+ */
+
+#include "kotlinx/coroutines/Runnable.hpp"
+#include "kotlinx/coroutines/internal/CacheLine.hpp"
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace kotlinx {
+namespace coroutines {
+namespace scheduling {
+
+/*
+ * Capacity of a worker's local queue.
+ * Kotlin: internal const val BUFFER_CAPACITY_BASE = 7, BUFFER_CAPACITY = 1 shl BUFFER_CAPACITY_BASE
+ */
+static constexpr int BUFFER_CAPACITY_BASE = 7;
+static constexpr int BUFFER_CAPACITY = 1 << BUFFER_CAPACITY_BASE;
+static constexpr int MASK = BUFFER_CAPACITY - 1;
+
+/**
+ * Bounded, lock-free FIFO of tasks owned by a single worker.
+ *
+ * Only the owning worker may call [add], [add_next] and [poll_next]; any thread (the owner or
+ * a stealer) may call [poll] and [steal_next]. When the queue is full, [add] fails and the
+ * caller is expected to offload the task to the scheduler's global queue.
+ *
+ * The queue is not linearizable with respect to [size]: it is only a hint used by stealers
+ * to pick a victim and by idle workers to decide whether it is safe to park.
+ */
+class WorkQueue {
+public:
+    WorkQueue() {
+        for (int i = 0; i < BUFFER_CAPACITY; ++i) {
+            slots_[i].sequence.store(static_cast<uint64_t>(i), std::memory_order_relaxed);
+        }
+    }
+
+    WorkQueue(const WorkQueue&) = delete;
+    WorkQueue& operator=(const WorkQueue&) = delete;
+
+    /**
+     * Appends [task] to the tail of this queue. Must be called only by the owning worker.
+     * On success the task is moved from; on failure (the queue is full) it is left untouched.
+     */
+    bool add(std::shared_ptr<Runnable>& task) {
+        const uint64_t tail = tail_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[tail & MASK];
+        // The slot is free only once the consumer of the previous lap released it.
+        if (slot.sequence.load(std::memory_order_acquire) != tail) return false;
+        slot.task = std::move(task);
+        slot.sequence.store(tail + 1, std::memory_order_release);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Removes the task at the head of this queue, or returns `nullptr` if the queue is empty.
+     * Safe to call concurrently from any number of threads.
+     */
+    std::shared_ptr<Runnable> poll() {
+        uint64_t head = head_.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = slots_[head & MASK];
+            const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(head + 1);
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(head, head + 1, std::memory_order_relaxed)) {
+                    std::shared_ptr<Runnable> task = std::move(slot.task);
+                    slot.sequence.store(head + BUFFER_CAPACITY, std::memory_order_release);
+                    return task;
+                }
+                // CAS failure reloaded `head`, retry with the new value.
+            } else if (diff < 0) {
+                return nullptr; // slot not yet published: the queue is empty
+            } else {
+                head = head_.load(std::memory_order_relaxed); // another consumer got ahead of us
+            }
+        }
+    }
+
+    /**
+     * Puts [task] into the "next" slot, so that the owner runs it before anything in the ring.
+     * Must be called only by the owning worker.
+     *
+     * @param now_ns submission time, compared against by [steal_next]
+     * @return the task previously held by the slot (for the caller to [add] to the ring), or `nullptr`
+     */
+    std::shared_ptr<Runnable> add_next(std::shared_ptr<Runnable> task, long long now_ns) {
+        const int state = acquire_next_slot(/* owner = */ true);
+        std::shared_ptr<Runnable> previous;
+        if (state == NEXT_FULL) previous = std::move(next_task_);
+        next_task_ = std::move(task);
+        next_submission_time_ns_ = now_ns;
+        next_state_.store(NEXT_FULL, std::memory_order_release);
+        return previous;
+    }
+
+    /** Takes the task from the "next" slot. Must be called only by the owning worker. */
+    std::shared_ptr<Runnable> poll_next() {
+        if (acquire_next_slot(/* owner = */ false) != NEXT_FULL) return nullptr;
+        std::shared_ptr<Runnable> task = std::move(next_task_);
+        next_state_.store(NEXT_EMPTY, std::memory_order_release);
+        return task;
+    }
+
+    /**
+     * Takes the task from the "next" slot on behalf of another worker, but only once it has waited
+     * there for at least [resolution_ns]: until then it is reserved for the owner, which is
+     * expected to pick it up as soon as its current task returns.
+     *
+     * @param delay_ns set to the remaining reservation time when the slot holds a task that is too young
+     */
+    std::shared_ptr<Runnable> steal_next(long long now_ns, long long resolution_ns, long long& delay_ns) {
+        if (acquire_next_slot(/* owner = */ false) != NEXT_FULL) return nullptr;
+        const long long age = now_ns - next_submission_time_ns_;
+        if (age < resolution_ns) {
+            next_state_.store(NEXT_FULL, std::memory_order_release);
+            delay_ns = resolution_ns - age;
+            return nullptr;
+        }
+        std::shared_ptr<Runnable> task = std::move(next_task_);
+        next_state_.store(NEXT_EMPTY, std::memory_order_release);
+        return task;
+    }
+
+    bool has_next() const { return next_state_.load(std::memory_order_acquire) != NEXT_EMPTY; }
+
+    /** Approximate number of tasks in the ring, not counting the "next" slot. */
+    int size() const {
+        const uint64_t tail = tail_.load(std::memory_order_acquire);
+        const uint64_t head = head_.load(std::memory_order_acquire);
+        return tail > head ? static_cast<int>(tail - head) : 0;
+    }
+
+    bool is_empty() const { return size() == 0 && !has_next(); }
+
+private:
+    static constexpr int NEXT_EMPTY = 0;
+    static constexpr int NEXT_FULL = 1;
+    static constexpr int NEXT_BUSY = 2; // someone is moving the task in or out
+
+    /**
+     * Moves the "next" slot to BUSY and returns the state it was in. Non-owners give up on an
+     * empty slot; the owner claims it either way, since it is about to fill it.
+     */
+    int acquire_next_slot(bool owner) {
+        int state = next_state_.load(std::memory_order_acquire);
+        while (true) {
+            if (state == NEXT_EMPTY && !owner) return NEXT_EMPTY;
+            if (state == NEXT_BUSY) {
+                state = next_state_.load(std::memory_order_acquire);
+                continue;
+            }
+            if (next_state_.compare_exchange_weak(state, NEXT_BUSY, std::memory_order_acquire)) return state;
+        }
+    }
+
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};
+        std::shared_ptr<Runnable> task;
+    };
+
+    // Consumers (owner + stealers) contend on head_, only the owner writes tail_.
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<uint64_t> head_{0};
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<uint64_t> tail_{0};
+    alignas(internal::CACHE_LINE_SIZE) Slot slots_[BUFFER_CAPACITY];
+
+    // Kotlin: lastScheduledTask. Payload fields are only touched by whoever moved the state to BUSY.
+    alignas(internal::CACHE_LINE_SIZE) std::atomic<int> next_state_{NEXT_EMPTY};
+    long long next_submission_time_ns_ = 0;
+    std::shared_ptr<Runnable> next_task_;
+};
+
+} // namespace scheduling
+} // namespace coroutines
+} // namespace kotlinx
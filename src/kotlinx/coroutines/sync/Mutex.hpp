@@ -9,9 +9,15 @@
  */
 
 #include "kotlinx/coroutines/selects/Select.hpp"
+#include "kotlinx/coroutines/intrinsics/Intrinsics.hpp"
+#include "kotlinx/coroutines/CancellableContinuationImpl.hpp"
+#include "kotlinx/coroutines/dsl/CancellableReusable.hpp"
+#include <algorithm>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <atomic>
+#include <mutex>
 #include <thread>
 #include <cassert>
 #include <string>
@@ -72,6 +78,19 @@ public:
      */
     virtual void lock(void* owner = nullptr) = 0;
 
+    /**
+     * Suspending form of lock(): returns nullptr if the lock was acquired at once, otherwise
+     * COROUTINE_SUSPENDED, and [continuation] is resumed once it holds the lock (or with
+     * CancellationException if cancelled while waiting).
+     *
+     * The default implementation blocks in lock().
+     */
+    virtual void* lock(void* owner, Continuation<void*>* continuation) {
+        (void)continuation;
+        lock(owner);
+        return nullptr;
+    }
+
     /**
      * Line 77-82: Checks whether this mutex is locked by the specified owner.
      *
@@ -208,12 +227,42 @@ public:
         return holds_lock_impl(owner) == detail::HOLDS_LOCK_YES;
     }
 
+    using Mutex::lock;
+
     // Line 166-169: lock with tryLock fast-path
     void lock(void* owner = nullptr) override {
         if (try_lock(owner)) return;
         lock_suspend(owner);
     }
 
+    // Line 166-174: suspending lock; unlock() hands the lock to the first waiter
+    void* lock(void* owner, Continuation<void*>* continuation) override {
+        if (try_lock(owner)) return nullptr;
+        // Kotlin: suspendCancellableCoroutineReusable, so a state machine that locks in a loop
+        // parks on the same continuation every time
+        return dsl::suspend_cancellable_coroutine_reusable<void>(continuation,
+            [this, owner](CancellableContinuationImpl<void>* cont) {
+                bool queued = false;
+                {
+                    std::lock_guard<std::mutex> guard(waiters_lock_);
+                    // Re-check under the lock: an unlock() that found no waiter has released the permit
+                    if (!try_lock(owner)) {
+                        waiters_.push_back(Waiter{cont->shared_from_this(), owner});
+                        queued = true;
+                    }
+                }
+                if (!queued) {
+                    cont->resume(nullptr);
+                    return;
+                }
+                // Kotlin cleans the cell of a cancelled waiter from its cancellation handler; a
+                // reused continuation left queued would also be resumed for whatever its state
+                // machine waits on next. This runs outside the lock, as the handler is called
+                // right away if already cancelled.
+                cont->invoke_on_cancellation([this, cont](std::exception_ptr) { remove_waiter(cont); });
+            });
+    }
+
     // Line 176-181: tryLock
     bool try_lock(void* owner = nullptr) override {
         int result = try_lock_impl(owner);
@@ -254,9 +303,25 @@ public:
                 continue; // retry
             }
 
-            // Release the semaphore permit at the end
-            available_permits_.fetch_add(1, std::memory_order_release);
-            return;
+            // Hand the lock over to the first waiter that is not cancelled, or release the permit
+            while (true) {
+                Waiter waiter;
+                {
+                    std::lock_guard<std::mutex> guard(waiters_lock_);
+                    if (waiters_.empty()) {
+                        available_permits_.fetch_add(1, std::memory_order_release);
+                        return;
+                    }
+                    waiter = std::move(waiters_.front());
+                    waiters_.pop_front();
+                }
+                // Fails if the waiter was cancelled after it was queued
+                void* token = waiter.continuation->try_resume();
+                if (token == nullptr) continue;
+                owner_.store(waiter.owner, std::memory_order_release);
+                waiter.continuation->complete_resume(token);
+                return;
+            }
         }
     }
 
@@ -282,6 +347,25 @@ private:
     // Line 137: Owner tracking for debugging
     std::atomic<void*> owner_;
 
+    // Suspended lock(owner, continuation) calls, in arrival order. A cancelled waiter takes itself
+    // out; unlock() skips one that is cancelled after unlock() took it.
+    struct Waiter {
+        std::shared_ptr<CancellableContinuationImpl<void>> continuation;
+        void* owner = nullptr;
+    };
+    std::mutex waiters_lock_;
+    std::deque<Waiter> waiters_;
+
+    void remove_waiter(CancellableContinuation<void>* cancelled) {
+        Waiter removed; // released after the lock
+        std::lock_guard<std::mutex> guard(waiters_lock_);
+        auto it = std::find_if(waiters_.begin(), waiters_.end(),
+                               [cancelled](const Waiter& w) { return w.continuation.get() == cancelled; });
+        if (it == waiters_.end()) return;
+        removed = std::move(*it);
+        waiters_.erase(it);
+    }
+
     /**
      * Line 154-164: holdsLockImpl
      *
@@ -364,7 +364,7 @@ private:
 
         // Wrapper function.
         os << retTy << " " << fnName << "(" << params << ") {\n";
-        os << "    auto __coro = std::make_shared<" << coroName << ">(completion";
+        os << "    auto __coro = kotlinx::coroutines::internal::make_frame<" << coroName << ">(completion";
         if (!callArgs.empty()) os << ", " << callArgs;
         os << ");\n";
         os << "    return __coro->invoke_suspend(Result<void*>::success(nullptr));\n";
@@ -509,7 +509,7 @@ private:
 
         // Wrapper function.
         os << retTy << " " << fnName << "(" << params << ") {\n";
-        os << "    auto __coro = std::make_shared<" << coroName << ">(completion";
+        os << "    auto __coro = kotlinx::coroutines::internal::make_frame<" << coroName << ">(completion";
         if (!callArgs.empty()) os << ", " << callArgs;
         os << ");\n";
         os << "    return __coro->invoke_suspend(Result<void*>::success(nullptr));\n";
@@ -0,0 +1,63 @@
+#pragma once
+/**
+ * @file AllocationCounter.hpp
+ * @brief Counts heap allocations by replacing the global operator new and delete.
+ *
+ * Include it from exactly one translation unit of a test or benchmark: the replacements are
+ * definitions, and a program may have only one of each. Over-aligned allocations go through the
+ * aligned overloads and are counted with the others.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace allocation_counter {
+
+/** Allocations made so far. */
+inline std::atomic<long> allocations{0};
+
+/** Allocations not freed yet. */
+inline std::atomic<long> live{0};
+
+/** The highest `live` since the last reset_peak(). */
+inline std::atomic<long> peak{0};
+
+inline void reset_peak() { peak.store(live.load()); }
+
+inline void count_allocation() {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    const long now = live.fetch_add(1, std::memory_order_relaxed) + 1;
+    long seen = peak.load(std::memory_order_relaxed);
+    while (now > seen && !peak.compare_exchange_weak(seen, now, std::memory_order_relaxed)) {}
+}
+
+} // namespace allocation_counter
+
+void* operator new(std::size_t size) {
+    allocation_counter::count_allocation();
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    if (p != nullptr) allocation_counter::live.fetch_sub(1, std::memory_order_relaxed);
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept { operator delete(p); }
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    allocation_counter::count_allocation();
+    const auto align = static_cast<std::size_t>(alignment);
+    const std::size_t rounded = (size + align - 1) / align * align;
+    if (void* p = std::aligned_alloc(align, rounded == 0 ? align : rounded)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p, std::align_val_t) noexcept { operator delete(p); }
+
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept {
+    operator delete(p, alignment);
+}
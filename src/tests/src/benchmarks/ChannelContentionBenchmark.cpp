@@ -0,0 +1,183 @@
+/**
+ * @file ChannelContentionBenchmark.cpp
+ * @brief BufferedChannel throughput and cache misses with many senders or many receivers.
+ *
+ * Runs fan-in (N sender threads, one receiver), fan-out (one sender, N receivers) and N-to-N
+ * through a BufferedChannel<int64_t>, every thread spinning on try_send or try_receive, for N
+ * doubling up to the number of hardware threads. Prints the time per element and, where the
+ * kernel allows perf events, the cache misses and cache references per element counted over
+ * all threads of the process; the counter columns read `-` otherwise. Run it on a many-core
+ * machine before and after a change to the layout of the channel or its segments.
+ *
+ * The benchmark itself shares nothing hot between threads: the last sender closes the channel,
+ * and each receiver counts in a padded slot of its own until it sees the close.
+ *
+ * Usage: ChannelContentionBenchmark [elements] [capacity]
+ */
+
+#include "kotlinx/coroutines/channels/BufferedChannel.hpp"
+#include "kotlinx/coroutines/internal/CacheLine.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace kotlinx::coroutines::channels;
+using kotlinx::coroutines::internal::CACHE_LINE_SIZE;
+
+namespace {
+
+enum class CacheEvent { MISSES, REFERENCES };
+
+// A hardware counter of this process and the threads it starts while the counter is open
+class PerfCounter {
+public:
+    explicit PerfCounter(CacheEvent event) {
+#ifdef __linux__
+        perf_event_attr attr{};
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof(attr);
+        attr.config = event == CacheEvent::MISSES ? PERF_COUNT_HW_CACHE_MISSES : PERF_COUNT_HW_CACHE_REFERENCES;
+        attr.disabled = 1;
+        attr.inherit = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fd_ = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+#else
+        (void) event;
+#endif
+    }
+
+    PerfCounter(const PerfCounter&) = delete;
+    PerfCounter& operator=(const PerfCounter&) = delete;
+
+    ~PerfCounter() {
+#ifdef __linux__
+        if (fd_ >= 0) close(fd_);
+#endif
+    }
+
+    bool available() const { return fd_ >= 0; }
+
+    void start() {
+#ifdef __linux__
+        if (fd_ < 0) return;
+        ioctl(fd_, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd_, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+
+    // The count since start(), summed over the inherited threads that have exited
+    uint64_t stop() {
+        uint64_t count = 0;
+#ifdef __linux__
+        if (fd_ < 0) return 0;
+        ioctl(fd_, PERF_EVENT_IOC_DISABLE, 0);
+        if (read(fd_, &count, sizeof(count)) != static_cast<ssize_t>(sizeof(count))) count = 0;
+#endif
+        return count;
+    }
+
+private:
+    int fd_ = -1;
+};
+
+struct Sample {
+    double ns_per_element;
+    double misses_per_element;
+    double references_per_element;
+};
+
+// A receiver's count, on a line of its own
+struct alignas(CACHE_LINE_SIZE) ReceivedCount {
+    long value = 0;
+};
+
+Sample run(int senders, int receivers, long elements, int capacity) {
+    BufferedChannel<int64_t> channel(capacity);
+    const long per_sender = elements / senders;
+    const long total = per_sender * senders;
+    std::atomic<int> senders_left{senders};
+    std::vector<ReceivedCount> received(receivers);
+
+    PerfCounter misses(CacheEvent::MISSES);
+    PerfCounter references(CacheEvent::REFERENCES);
+    misses.start();
+    references.start();
+    const auto begin = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (int s = 0; s < senders; ++s) {
+        threads.emplace_back([&channel, &senders_left, per_sender] {
+            for (long i = 0; i < per_sender; ++i) {
+                while (!channel.try_send(i).is_success()) std::this_thread::yield();
+            }
+            if (senders_left.fetch_sub(1, std::memory_order_acq_rel) == 1) channel.close();
+        });
+    }
+    for (int r = 0; r < receivers; ++r) {
+        threads.emplace_back([&channel, &count = received[r].value] {
+            while (true) {
+                auto result = channel.try_receive();
+                if (result.is_success()) {
+                    ++count;
+                } else if (result.is_closed()) {
+                    break;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    const uint64_t miss_count = misses.stop();
+    const uint64_t reference_count = references.stop();
+    long received_total = 0;
+    for (const auto& count : received) received_total += count.value;
+    if (received_total != total) {
+        std::fprintf(stderr, "received %ld of %ld elements\n", received_total, total);
+        std::exit(1);
+    }
+    return {std::chrono::duration<double, std::nano>(elapsed).count() / total,
+            misses.available() ? static_cast<double>(miss_count) / total : -1,
+            references.available() ? static_cast<double>(reference_count) / total : -1};
+}
+
+void report(const char* shape, int senders, int receivers, long elements, int capacity) {
+    const Sample sample = run(senders, receivers, elements, capacity);
+    std::printf("%8s %8d %10d %12.1f", shape, senders, receivers, sample.ns_per_element);
+    if (sample.misses_per_element < 0) {
+        std::printf(" %12s %12s\n", "-", "-");
+    } else {
+        std::printf(" %12.3f %12.3f\n", sample.misses_per_element, sample.references_per_element);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long elements = argc > 1 ? std::atol(argv[1]) : 2'000'000;
+    const int capacity = argc > 2 ? std::atoi(argv[2]) : 64;
+    const int max_threads = std::max(2u, std::thread::hardware_concurrency());
+
+    std::printf("%8s %8s %10s %12s %12s %12s\n", "shape", "senders", "receivers", "ns/elem",
+                "miss/elem", "ref/elem");
+    for (int n = 1; n < max_threads; n *= 2) report("fan-in", n, 1, elements, capacity);
+    for (int n = 1; n < max_threads; n *= 2) report("fan-out", 1, n, elements, capacity);
+    for (int n = 1; 2 * n <= max_threads; n *= 2) report("n-to-n", n, n, elements, capacity);
+    return 0;
+}
@@ -0,0 +1,121 @@
+/**
+ * @file ChannelElementBenchmark.cpp
+ * @brief Buffered channel throughput with elements stored inline in the segment cells or boxed.
+ *
+ * Sends and receives `int64_t` and a 16-byte message through a BufferedChannel, once stored
+ * inline (the inline_channel_element default for these types) and once wrapped in a type for
+ * which inline_channel_element is specialized to false, which boxes every element in a `new E`
+ * as before. Each type runs single-threaded in batches of the capacity, then with one producer
+ * and one consumer thread. Prints the average time and heap allocations per element; the
+ * allocations are counted by replacing the global operator new.
+ *
+ * Usage: ChannelElementBenchmark [elements] [capacity]
+ */
+
+#include "kotlinx/coroutines/channels/BufferedChannel.hpp"
+
+#include "../AllocationCounter.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <type_traits>
+
+using namespace kotlinx::coroutines::channels;
+using allocation_counter::allocations;
+
+namespace {
+
+struct Message {
+    int32_t id;
+    int32_t kind;
+    double value;
+};
+
+// The same element, stored the way every element was before inline storage
+template <typename T>
+struct Boxed {
+    T value;
+};
+
+} // namespace
+
+template <typename T>
+struct kotlinx::coroutines::channels::inline_channel_element<Boxed<T>> : std::false_type {};
+
+namespace {
+
+struct Sample {
+    double ns_per_element;
+    double allocations_per_element;
+};
+
+template <typename E>
+E make_element(long i) {
+    if constexpr (std::is_same_v<E, int64_t>) {
+        return i;
+    } else if constexpr (std::is_same_v<E, Message>) {
+        return Message{static_cast<int32_t>(i), 1, static_cast<double>(i)};
+    } else {
+        return E{make_element<decltype(E::value)>(i)};
+    }
+}
+
+template <typename E>
+Sample single_thread(long elements, int capacity) {
+    BufferedChannel<E> channel(capacity);
+    const long before = allocations.load();
+    const auto begin = std::chrono::steady_clock::now();
+    for (long sent = 0; sent < elements; sent += capacity) {
+        for (int i = 0; i < capacity; ++i) channel.try_send(make_element<E>(sent + i));
+        for (int i = 0; i < capacity; ++i) channel.try_receive();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    const long count = (elements + capacity - 1) / capacity * capacity;
+    return {std::chrono::duration<double, std::nano>(elapsed).count() / count,
+            static_cast<double>(allocations.load() - before) / count};
+}
+
+template <typename E>
+Sample producer_consumer(long elements, int capacity) {
+    BufferedChannel<E> channel(capacity);
+    const long before = allocations.load();
+    const auto begin = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        for (long i = 0; i < elements; ++i) {
+            while (!channel.try_send(make_element<E>(i)).is_success()) std::this_thread::yield();
+        }
+    });
+    for (long i = 0; i < elements; ++i) {
+        while (!channel.try_receive().is_success()) std::this_thread::yield();
+    }
+    producer.join();
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    return {std::chrono::duration<double, std::nano>(elapsed).count() / elements,
+            static_cast<double>(allocations.load() - before) / elements};
+}
+
+template <typename E>
+void report(const char* element, const char* storage, long elements, int capacity) {
+    const Sample single = single_thread<E>(elements, capacity);
+    const Sample pair = producer_consumer<E>(elements, capacity);
+    std::printf("%10s %8s %12.1f %12.3f %12.1f %12.3f\n", element, storage,
+                single.ns_per_element, single.allocations_per_element,
+                pair.ns_per_element, pair.allocations_per_element);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long elements = argc > 1 ? std::atol(argv[1]) : 2'000'000;
+    const int capacity = argc > 2 ? std::atoi(argv[2]) : 64;
+
+    std::printf("%10s %8s %12s %12s %12s %12s\n", "element", "storage",
+                "1t ns/elem", "1t alloc/el", "2t ns/elem", "2t alloc/el");
+    report<int64_t>("int64_t", "inline", elements, capacity);
+    report<Boxed<int64_t>>("int64_t", "boxed", elements, capacity);
+    report<Message>("Message", "inline", elements, capacity);
+    report<Boxed<Message>>("Message", "boxed", elements, capacity);
+    return 0;
+}
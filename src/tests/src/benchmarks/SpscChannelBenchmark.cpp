@@ -0,0 +1,104 @@
+/**
+ * @file SpscChannelBenchmark.cpp
+ * @brief One producer and one consumer through a BufferedChannel and a SpscChannel.
+ *
+ * For a rendezvous, a small and a large capacity, a producer task sends `int64_t` elements
+ * with co::send and a consumer task takes them with co::receive. Each task is started on its
+ * own thread and suspends whenever the other side falls behind, going on in the thread that
+ * resumes it. For the buffered capacities a producer and a consumer thread also spin on
+ * try_send and try_receive. Prints the average time per element for each channel.
+ *
+ * Usage: SpscChannelBenchmark [elements]
+ */
+
+#include "kotlinx/coroutines/Task.hpp"
+#include "kotlinx/coroutines/CoroutineScope.hpp"
+#include "kotlinx/coroutines/channels/BufferedChannel.hpp"
+#include "kotlinx/coroutines/channels/SpscChannel.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+using namespace kotlinx::coroutines;
+using namespace kotlinx::coroutines::channels;
+
+namespace {
+
+template <typename C>
+Task<void> produce_into(std::shared_ptr<C> channel, long elements) {
+    for (long i = 0; i < elements; ++i) co_await co::send(*channel, static_cast<int64_t>(i));
+}
+
+template <typename C>
+Task<void> consume_from(std::shared_ptr<C> channel, long elements) {
+    for (long i = 0; i < elements; ++i) co_await co::receive(*channel);
+}
+
+template <typename C>
+double tasks(long elements, int capacity) {
+    auto channel = std::make_shared<C>(capacity);
+    const auto begin = std::chrono::steady_clock::now();
+    std::shared_ptr<Job> consumer;
+    std::shared_ptr<Job> producer;
+    std::thread consumer_thread([&] {
+        consumer = launch_task(GlobalScope::instance(), nullptr, consume_from(channel, elements));
+    });
+    std::thread producer_thread([&] {
+        producer = launch_task(GlobalScope::instance(), nullptr, produce_into(channel, elements));
+    });
+    consumer_thread.join();
+    producer_thread.join();
+    producer->join_blocking();
+    consumer->join_blocking();
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / elements;
+}
+
+template <typename C>
+double threads(long elements, int capacity) {
+    C channel(capacity);
+    const auto begin = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        for (long i = 0; i < elements; ++i) {
+            while (!channel.try_send(static_cast<int64_t>(i)).is_success()) std::this_thread::yield();
+        }
+    });
+    for (long i = 0; i < elements; ++i) {
+        while (!channel.try_receive().is_success()) std::this_thread::yield();
+    }
+    producer.join();
+    const auto elapsed = std::chrono::steady_clock::now() - begin;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / elements;
+}
+
+void report(const char* name, long elements, int capacity) {
+    // A rendezvous channel only hands elements to a waiting receiver, which a spinning
+    // try_receive never is
+    const long rendezvous_elements = capacity == 0 ? elements / 10 : elements;
+    const double buffered_tasks = tasks<BufferedChannel<int64_t>>(rendezvous_elements, capacity);
+    const double spsc_tasks = tasks<SpscChannel<int64_t>>(rendezvous_elements, capacity);
+    if (capacity == 0) {
+        std::printf("%12s %14.1f %14.1f %14s %14s\n", name, buffered_tasks, spsc_tasks, "-", "-");
+        return;
+    }
+    std::printf("%12s %14.1f %14.1f %14.1f %14.1f\n", name, buffered_tasks, spsc_tasks,
+                threads<BufferedChannel<int64_t>>(elements, capacity),
+                threads<SpscChannel<int64_t>>(elements, capacity));
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const long elements = argc > 1 ? std::atol(argv[1]) : 2'000'000;
+
+    std::printf("%12s %14s %14s %14s %14s\n", "capacity",
+                "tasks buffered", "tasks spsc", "2t buffered", "2t spsc");
+    report("rendezvous", elements, 0);
+    report("8", elements, 8);
+    report("1024", elements, 1024);
+    return 0;
+}
@@ -0,0 +1,108 @@
+/**
+ * @file test_cancellation_fast_path.cpp
+ * @brief Tests for cancellation with the shared CancellationException instances.
+ *
+ * Covers a job cancelled without a cause, the children of a cancelled parent, a cancellable
+ * continuation cancelled without a cause, and the non-throwing checks in Result and
+ * is_cancellation_exception().
+ */
+
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "kotlinx/coroutines/CancellableContinuationImpl.hpp"
+#include "kotlinx/coroutines/CompletableJob.hpp"
+#include "kotlinx/coroutines/Exceptions.hpp"
+#include "kotlinx/coroutines/Job.hpp"
+#include "kotlinx/coroutines/Result.hpp"
+#include "kotlinx/coroutines/context_impl.hpp"
+
+using namespace kotlinx::coroutines;
+
+namespace {
+
+class NoopContinuation : public Continuation<int> {
+public:
+    std::shared_ptr<CoroutineContext> get_context() const override { return EmptyCoroutineContext::instance(); }
+    void resume_with(Result<int>) override {}
+};
+
+} // namespace
+
+// cancel() without a cause uses the shared instance
+void test_job_cancel_without_cause() {
+    std::cout << "test_job_cancel_without_cause... ";
+
+    auto job = make_job();
+    job->cancel();
+    assert(job->is_cancelled());
+    assert(job->get_cancellation_exception() == job_cancelled_exception());
+
+    std::cout << "PASSED\n";
+}
+
+// Every child of a cancelled parent shares one exception
+void test_children_share_parent_cancelled() {
+    std::cout << "test_children_share_parent_cancelled... ";
+
+    auto parent = make_job();
+    std::vector<std::shared_ptr<CompletableJob>> children;
+    for (int i = 0; i < 1000; ++i) children.push_back(make_job(parent));
+
+    parent->cancel();
+    for (const auto& child : children) {
+        assert(child->is_cancelled());
+        assert(child->get_cancellation_exception() == parent_cancelled_exception());
+    }
+    assert(parent->is_cancelled());
+    assert(parent->get_cancellation_exception() == job_cancelled_exception());
+
+    std::cout << "PASSED\n";
+}
+
+// A continuation cancelled without a cause fails with the shared instance
+void test_continuation_cancel_without_cause() {
+    std::cout << "test_continuation_cancel_without_cause... ";
+
+    auto cont = std::make_shared<CancellableContinuationImpl<int>>(std::make_shared<NoopContinuation>(), MODE_CANCELLABLE);
+    assert(cont->cancel());
+    Result<int> result = cont->take_state();
+    assert(result.is_cancellation());
+    assert(result.exception_or_null() == job_cancelled_exception());
+
+    std::cout << "PASSED\n";
+}
+
+// Result and is_cancellation_exception() tell cancellation from other failures
+void test_cancellation_checks() {
+    std::cout << "test_cancellation_checks... ";
+
+    assert(Result<int>::cancelled().is_cancellation());
+    assert(Result<void>::cancelled().is_cancellation());
+    assert(!Result<int>::success(1).is_cancellation());
+    assert(!Result<void>::success().is_cancellation());
+    assert(!Result<int>::failure(std::make_exception_ptr(std::runtime_error("boom"))).is_cancellation());
+    assert(Result<int>::failure(std::make_exception_ptr(CancellationException("own"))).is_cancellation());
+
+    assert(is_cancellation_exception(parent_cancelled_exception()));
+    assert(!is_cancellation_exception(nullptr));
+    assert(to_cancellation_exception(nullptr) == job_cancelled_exception());
+    assert(to_cancellation_exception(parent_cancelled_exception()) == parent_cancelled_exception());
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Cancellation Fast Path Tests ===\n";
+
+    test_job_cancel_without_cause();
+    test_children_share_parent_cancelled();
+    test_continuation_cancel_without_cause();
+    test_cancellation_checks();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,327 @@
+/**
+ * @file test_channel_batch.cpp
+ * @brief Tests for the batch operations of channels.
+ *
+ * Covers try_send_batch, try_receive_many and drain_to on buffered, unlimited, rendezvous,
+ * closed and conflated channels, batches racing between threads, the suspending send_all and
+ * receive_many called with a plain continuation, and co::send_all and co::receive_many of tasks.
+ */
+
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <thread>
+#include <vector>
+
+#include "kotlinx/coroutines/Task.hpp"
+#include "kotlinx/coroutines/CoroutineScope.hpp"
+#include "kotlinx/coroutines/channels/BufferedChannel.hpp"
+#include "kotlinx/coroutines/channels/ConflatedBufferedChannel.hpp"
+
+using namespace kotlinx::coroutines;
+using namespace kotlinx::coroutines::channels;
+
+namespace {
+
+std::vector<int> range(int from, int to) {
+    std::vector<int> values(to - from);
+    std::iota(values.begin(), values.end(), from);
+    return values;
+}
+
+// A caller of send_all or receive_many: records whether and how it was resumed
+class Caller : public Continuation<void*> {
+public:
+    std::shared_ptr<CoroutineContext> get_context() const override { return EmptyCoroutineContext::instance(); }
+
+    void resume_with(Result<void*> result) override {
+        assert(!resumed);
+        resumed = true;
+        failure = result.exception_or_null();
+    }
+
+    bool resumed = false;
+    std::exception_ptr failure;
+};
+
+} // namespace
+
+// A batch fills the buffer; received batches keep the order
+void test_buffered() {
+    std::cout << "test_buffered... ";
+
+    BufferedChannel<int> channel(10);
+    std::vector<int> elements = range(0, 25);
+    assert(channel.try_send_batch(elements) == 10);
+    assert(channel.try_send_batch(elements) == 0);
+
+    std::vector<int> out;
+    assert(channel.try_receive_many(4, out) == 4);
+    assert(out == range(0, 4));
+    assert(channel.drain_to(out) == 6);
+    assert(out == range(0, 10));
+    assert(channel.try_receive_many(4, out) == 0);
+
+    // Receiving made room again
+    assert(channel.try_send_batch(std::span<const int>(elements).subspan(10)) == 10);
+    out.clear();
+    assert(channel.drain_to(out) == 10);
+    assert(out == range(10, 20));
+
+    std::cout << "PASSED\n";
+}
+
+// Batches across many segments of an unlimited channel
+void test_unlimited() {
+    std::cout << "test_unlimited... ";
+
+    BufferedChannel<int> channel(CHANNEL_UNLIMITED);
+    std::vector<int> elements = range(0, 1000);
+    assert(channel.try_send_batch(elements) == 1000);
+    assert(channel.try_send(1000).is_success());
+
+    std::vector<int> out;
+    assert(channel.try_receive_many(333, out) == 333);
+    assert(channel.drain_to(out) == 668);
+    assert(out == range(0, 1001));
+
+    std::cout << "PASSED\n";
+}
+
+// A rendezvous channel takes a batch only for the receivers waiting
+void test_rendezvous() {
+    std::cout << "test_rendezvous... ";
+
+    BufferedChannel<int> channel(0);
+    std::vector<int> elements = range(0, 5);
+    assert(channel.try_send_batch(elements) == 0);
+    std::vector<int> out;
+    assert(channel.try_receive_many(5, out) == 0);
+    assert(out.empty());
+
+    std::cout << "PASSED\n";
+}
+
+// A closed channel takes nothing and still hands out what it buffered
+void test_closed() {
+    std::cout << "test_closed... ";
+
+    BufferedChannel<int> channel(8);
+    std::vector<int> elements = range(0, 5);
+    assert(channel.try_send_batch(elements) == 5);
+    channel.close();
+    assert(channel.try_send_batch(elements) == 0);
+
+    std::vector<int> out;
+    assert(channel.drain_to(out) == 5);
+    assert(out == elements);
+    assert(channel.drain_to(out) == 0);
+    assert(channel.is_closed_for_receive());
+
+    std::cout << "PASSED\n";
+}
+
+// A conflated channel conflates a batch element by element
+void test_conflated() {
+    std::cout << "test_conflated... ";
+
+    ConflatedBufferedChannel<int> oldest(2, BufferOverflow::DROP_OLDEST);
+    std::vector<int> elements = range(0, 5);
+    assert(oldest.try_send_batch(elements) == 5);
+    std::vector<int> out;
+    assert(oldest.drain_to(out) == 2);
+    assert(out == range(3, 5));
+
+    ConflatedBufferedChannel<int> latest(2, BufferOverflow::DROP_LATEST);
+    assert(latest.try_send_batch(elements) == 5);
+    out.clear();
+    assert(latest.drain_to(out) == 2);
+    assert(out == range(0, 2));
+
+    std::cout << "PASSED\n";
+}
+
+// Batches racing on both sides lose and duplicate nothing
+void test_concurrent_batches() {
+    std::cout << "test_concurrent_batches... ";
+
+    constexpr int producers = 4;
+    constexpr int consumers = 4;
+    constexpr int per_producer = 200'000;
+    BufferedChannel<int64_t> channel(64);
+    std::atomic<long> received{0};
+    std::atomic<int64_t> sum{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&] {
+            std::vector<int64_t> elements(per_producer);
+            std::iota(elements.begin(), elements.end(), 0);
+            std::span<const int64_t> rest(elements);
+            while (!rest.empty()) {
+                std::size_t sent = channel.try_send_batch(rest.first(std::min<std::size_t>(rest.size(), 48)));
+                if (sent == 0) std::this_thread::yield();
+                rest = rest.subspan(sent);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            std::vector<int64_t> out;
+            while (received.load() < long(producers) * per_producer) {
+                out.clear();
+                std::size_t count = channel.try_receive_many(32, out);
+                if (count == 0) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                assert(out.size() == count);
+                sum.fetch_add(std::accumulate(out.begin(), out.end(), int64_t{0}));
+                received.fetch_add(static_cast<long>(count));
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+
+    assert(received.load() == long(producers) * per_producer);
+    assert(sum.load() == int64_t{producers} * per_producer * (per_producer - 1) / 2);
+
+    std::cout << "PASSED\n";
+}
+
+// send_all suspends only for what does not fit; receive_many drains without suspending then
+void test_send_all_receive_many() {
+    std::cout << "test_send_all_receive_many... ";
+
+    BufferedChannel<int> channel(4);
+    std::vector<int> elements = range(0, 10);
+    Caller sender;
+    assert(intrinsics::is_coroutine_suspended(channel.send_all(elements, &sender)));
+    assert(!sender.resumed);
+
+    // Each batch taken lets the suspended sender go on
+    std::vector<int> out;
+    while (out.size() < elements.size()) {
+        Caller receiver;
+        const std::size_t before = out.size();
+        assert(channel.receive_many(3, out, &receiver) == nullptr);
+        assert(!receiver.resumed);
+        assert(out.size() > before && out.size() - before <= 3);
+    }
+    assert(out == elements);
+    assert(sender.resumed && !sender.failure);
+
+    // What fits goes in one batch, without suspending
+    Caller fits;
+    assert(channel.send_all(std::span<const int>(elements).first(4), &fits) == nullptr);
+    assert(!fits.resumed);
+    out.clear();
+    Caller receiver;
+    assert(channel.receive_many(0, out, &receiver) == nullptr && out.empty());
+    assert(channel.receive_many(10, out, &receiver) == nullptr);
+    assert((out == range(0, 4)));
+
+    std::cout << "PASSED\n";
+}
+
+// receive_many on an empty channel waits for one element and takes what arrived with it
+void test_receive_many_waits() {
+    std::cout << "test_receive_many_waits... ";
+
+    BufferedChannel<int> channel(8);
+    std::vector<int> out;
+    Caller receiver;
+    assert(intrinsics::is_coroutine_suspended(channel.receive_many(4, out, &receiver)));
+    assert(!receiver.resumed && out.empty());
+
+    // The receiver is resumed inside the batch and may take cells claimed but not written yet,
+    // which the batch then gives up; the elements for them are left to send again
+    std::vector<int> elements = range(0, 6);
+    std::span<const int> rest(elements);
+    rest = rest.subspan(channel.try_send_batch(rest));
+    assert(receiver.resumed && !receiver.failure);
+    assert(!out.empty() && out.size() <= 4);
+    while (!rest.empty()) rest = rest.subspan(channel.try_send_batch(rest));
+    channel.drain_to(out);
+    assert(out == elements);
+
+    std::cout << "PASSED\n";
+}
+
+// Closing the channel resumes suspended callers with the failure, and fails new ones at once
+void test_send_all_receive_many_closed() {
+    std::cout << "test_send_all_receive_many_closed... ";
+
+    BufferedChannel<int> empty(2);
+    std::vector<int> out;
+    Caller receiver;
+    assert(intrinsics::is_coroutine_suspended(empty.receive_many(4, out, &receiver)));
+    empty.close();
+    assert(receiver.resumed && receiver.failure && out.empty());
+    bool threw = false;
+    try {
+        Caller late;
+        empty.receive_many(4, out, &late);
+    } catch (const ClosedReceiveChannelException&) {
+        threw = true;
+    }
+    assert(threw);
+
+    BufferedChannel<int> full(2);
+    std::vector<int> elements = range(0, 5);
+    Caller sender;
+    assert(intrinsics::is_coroutine_suspended(full.send_all(elements, &sender)));
+    full.cancel();
+    assert(sender.resumed && sender.failure);
+
+    std::cout << "PASSED\n";
+}
+
+// co::receive_many suspends only while the channel is empty; co::send_all only while it is full
+void test_suspending() {
+    std::cout << "test_suspending... ";
+
+    auto channel = std::make_shared<BufferedChannel<int>>(4);
+    std::vector<int> out;
+    std::size_t first = 0;
+    auto consumer = launch_task(GlobalScope::instance(), nullptr,
+        [](std::shared_ptr<BufferedChannel<int>> channel, std::vector<int>& out, std::size_t& first) -> Task<void> {
+            first = co_await co::receive_many(*channel, 8, out);
+            while (out.size() < 20) co_await co::receive_many(*channel, 8, out);
+        }(channel, out, first));
+    assert(!consumer->is_completed());
+
+    std::vector<int> elements = range(0, 20);
+    auto producer = launch_task(GlobalScope::instance(), nullptr,
+        [](std::shared_ptr<BufferedChannel<int>> channel, std::span<const int> elements) -> Task<void> {
+            co_await co::send_all(*channel, elements);
+        }(channel, elements));
+
+    producer->join_blocking();
+    consumer->join_blocking();
+    assert(first >= 1);
+    assert(out == elements);
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Channel Batch Tests ===\n";
+
+    test_buffered();
+    test_unlimited();
+    test_rendezvous();
+    test_closed();
+    test_conflated();
+    test_concurrent_batches();
+    test_send_all_receive_many();
+    test_receive_many_waits();
+    test_send_all_receive_many_closed();
+    test_suspending();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,277 @@
+/**
+ * @file test_channel_segment_reclamation.cpp
+ * @brief Tests for the reclamation and reuse of BufferedChannel segments.
+ *
+ * Counts the live heap allocations by replacing the global operator new and delete, and checks
+ * that a long run through a buffered channel keeps a bounded number of segments alive, that an
+ * unlimited channel gives its segments back once drained, and that a destroyed channel frees all
+ * of them. `int64_t` elements are stored inline, so segments are the only allocations. Also
+ * cancels suspended senders and receivers while their segments are being reclaimed, and after
+ * their channel is destroyed.
+ *
+ * Usage: test_channel_segment_reclamation [messages], 100000 by default. ctest also runs it with
+ * 100000000 as test_channel_segment_reclamation_long, labelled `long`; `ctest -LE long` skips it.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "kotlinx/coroutines/CompletableJob.hpp"
+#include "kotlinx/coroutines/channels/BufferedChannel.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
+
+#include "../AllocationCounter.hpp"
+
+using namespace kotlinx::coroutines;
+using namespace kotlinx::coroutines::channels;
+
+using allocation_counter::allocations;
+using allocation_counter::live;
+using allocation_counter::peak;
+using allocation_counter::reset_peak;
+
+namespace {
+
+// Segments the channel may keep: the pool, the retired ones and the span of the references
+constexpr long MAX_LIVE_SEGMENTS = 64;
+
+// The caller of a suspended send or receive, cancelled through its own job
+class Waiting : public Continuation<void*> {
+public:
+    Waiting() : job_(make_job()) {}
+
+    std::shared_ptr<CoroutineContext> get_context() const override {
+        return std::static_pointer_cast<CoroutineContext>(job_);
+    }
+
+    void resume_with(Result<void*> result) override {
+        // A received element comes boxed; a send resumes with null
+        if (result.is_success()) delete static_cast<int64_t*>(result.get_or_throw());
+        cancelled_ = result.is_failure();
+        resumed_ = true;
+    }
+
+    void cancel() { job_->cancel(); }
+
+    bool resumed() const { return resumed_; }
+    bool cancelled() const { return cancelled_; }
+
+private:
+    std::shared_ptr<CompletableJob> job_;
+    bool resumed_ = false;
+    bool cancelled_ = false;
+};
+
+} // namespace
+
+// A long run in batches of the capacity allocates a bounded number of segments
+void test_bounded_single_thread(long messages) {
+    std::cout << "test_bounded_single_thread(" << messages << ")... ";
+
+    constexpr int capacity = 64;
+    const long before = live.load();
+    {
+        BufferedChannel<int64_t> channel(capacity);
+        reset_peak();
+        const long allocations_before = allocations.load();
+        int64_t expected = 0;
+        for (long sent = 0; sent < messages; sent += capacity) {
+            for (int i = 0; i < capacity; ++i) assert(channel.try_send(sent + i).is_success());
+            for (int i = 0; i < capacity; ++i) {
+                auto result = channel.try_receive();
+                assert(result.is_success() && result.get_or_throw() == expected++);
+                (void)result;
+            }
+        }
+        assert(peak.load() - before <= MAX_LIVE_SEGMENTS);
+        assert(allocations.load() - allocations_before <= MAX_LIVE_SEGMENTS);
+    }
+    assert(live.load() == before);
+
+    std::cout << "PASSED\n";
+}
+
+// A producer and a consumer thread keep a bounded number of segments alive
+void test_bounded_producer_consumer(long messages) {
+    std::cout << "test_bounded_producer_consumer(" << messages << ")... ";
+
+    const long before = live.load();
+    {
+        BufferedChannel<int64_t> channel(64);
+        reset_peak();
+        std::thread producer([&] {
+            for (long i = 0; i < messages; ++i) {
+                while (!channel.try_send(i).is_success()) std::this_thread::yield();
+            }
+        });
+        for (long i = 0; i < messages; ++i) {
+            ChannelResult<int64_t> result = channel.try_receive();
+            while (!result.is_success()) {
+                std::this_thread::yield();
+                result = channel.try_receive();
+            }
+            assert(result.get_or_throw() == i);
+        }
+        producer.join();
+        assert(peak.load() - before <= MAX_LIVE_SEGMENTS);
+    }
+    assert(live.load() == before);
+
+    std::cout << "PASSED\n";
+}
+
+// The segments of a drained unlimited channel are freed or pooled
+void test_unlimited_drain() {
+    std::cout << "test_unlimited_drain... ";
+
+    constexpr long messages = 1'000'000;
+    const long before = live.load();
+    {
+        BufferedChannel<int64_t> channel(CHANNEL_UNLIMITED);
+        for (long i = 0; i < messages; ++i) assert(channel.try_send(i).is_success());
+        assert(live.load() - before >= messages / SEGMENT_SIZE);
+        for (long i = 0; i < messages; ++i) assert(channel.try_receive().is_success());
+        // Segments are reclaimed when new ones are created
+        for (int i = 0; i < 4 * SEGMENT_SIZE; ++i) {
+            assert(channel.try_send(i).is_success());
+            assert(channel.try_receive().is_success());
+        }
+        assert(live.load() - before <= MAX_LIVE_SEGMENTS);
+    }
+    assert(live.load() == before);
+
+    std::cout << "PASSED\n";
+}
+
+// Closing or cancelling a channel that still holds elements frees every segment
+void test_destroy_frees_segments() {
+    std::cout << "test_destroy_frees_segments... ";
+
+    const long before = live.load();
+    {
+        BufferedChannel<int64_t> channel(CHANNEL_UNLIMITED);
+        for (long i = 0; i < 10'000; ++i) channel.try_send(i);
+        channel.close();
+    }
+    {
+        BufferedChannel<int64_t> channel(CHANNEL_UNLIMITED);
+        for (long i = 0; i < 10'000; ++i) channel.try_send(i);
+        channel.cancel();
+    }
+    {
+        BufferedChannel<int64_t> channel(0);
+        for (long i = 0; i < 10'000; ++i) channel.try_send(i);
+    }
+    assert(live.load() == before);
+
+    std::cout << "PASSED\n";
+}
+
+// Waiters are cancelled on another thread while the channel moves past their segments and
+// reclaims them; run it under AddressSanitizer to catch a handler reaching a freed segment
+void test_cancel_waiters_during_reclamation(long rounds) {
+    std::cout << "test_cancel_waiters_during_reclamation(" << rounds << ")... ";
+
+    constexpr int waiters = 8;
+    internal::FrameAllocator::trim();
+    const long before = live.load();
+    {
+        BufferedChannel<int64_t> buffered(16);
+        BufferedChannel<int64_t> rendezvous(0);
+        for (long round = 0; round < rounds; ++round) {
+            std::vector<std::unique_ptr<Waiting>> receivers;
+            std::vector<std::unique_ptr<Waiting>> senders;
+            for (int i = 0; i < waiters; ++i) {
+                receivers.push_back(std::make_unique<Waiting>());
+                assert(intrinsics::is_coroutine_suspended(buffered.receive(receivers.back().get())));
+                senders.push_back(std::make_unique<Waiting>());
+                assert(intrinsics::is_coroutine_suspended(rendezvous.send(i, senders.back().get())));
+            }
+            std::thread canceller([&] {
+                for (int i = 0; i < waiters; ++i) {
+                    receivers[i]->cancel();
+                    senders[i]->cancel();
+                }
+            });
+            // Each waiter either gets an element or is skipped as cancelled
+            for (int i = 0; i < 2 * SEGMENT_SIZE; ++i) {
+                buffered.try_send(i);
+                buffered.try_receive();
+                rendezvous.try_receive();
+                rendezvous.try_send(i);
+            }
+            canceller.join();
+        }
+    }
+    // The waiters' jobs freed the handler nodes and states their cancellation made. The frames of
+    // the continuations the canceller freed wait in this thread's frame cache until trimmed.
+    internal::FrameAllocator::trim();
+    assert(live.load() == before);
+
+    std::cout << "PASSED\n";
+}
+
+// Waiters still suspended when their channel is destroyed can be cancelled afterwards
+void test_cancel_after_destroy() {
+    std::cout << "test_cancel_after_destroy... ";
+
+    internal::FrameAllocator::trim();
+    const long before = live.load();
+    {
+        std::vector<std::unique_ptr<Waiting>> senders;
+        {
+            BufferedChannel<int64_t> channel(0);
+            for (int i = 0; i < 4 * SEGMENT_SIZE; ++i) {
+                senders.push_back(std::make_unique<Waiting>());
+                assert(intrinsics::is_coroutine_suspended(channel.send(i, senders.back().get())));
+            }
+        }
+        // Closing the channel left the senders suspended in their segments, which they keep alive
+        for (auto& sender : senders) assert(!sender->resumed());
+        for (auto& sender : senders) {
+            sender->cancel();
+            assert(sender->resumed() && sender->cancelled());
+        }
+    }
+    // The last cancellation freed the segments; the senders' jobs freed the rest
+    internal::FrameAllocator::trim();
+    assert(live.load() == before);
+
+    std::cout << "PASSED\n";
+}
+
+int main(int argc, char** argv) {
+    std::cout << "=== Channel Segment Reclamation Tests ===\n";
+
+    const long messages = argc > 1 ? std::atol(argv[1]) : 100'000;
+
+    // Allocations made once: the first channel operation of a thread registers it for epoch
+    // reclamation, the first suspension sets up the thread's frame cache, and the first
+    // cancellations set up statics. The producer thread reuses the registration of a thread that
+    // has exited.
+    BufferedChannel<int64_t>(1).cancel();
+    std::thread([] { BufferedChannel<int64_t>(1).try_send(0); }).join();
+    {
+        BufferedChannel<int64_t> channel(0);
+        Waiting resumed;
+        Waiting cancelled;
+        assert(intrinsics::is_coroutine_suspended(channel.receive(&resumed)));
+        assert(intrinsics::is_coroutine_suspended(channel.receive(&cancelled)));
+        assert(channel.try_send(0).is_success());
+        cancelled.cancel();
+    }
+
+    test_bounded_single_thread(messages);
+    test_bounded_producer_consumer(messages / 10);
+    test_unlimited_drain();
+    test_destroy_frees_segments();
+    test_cancel_waiters_during_reclamation(messages / 1'000);
+    test_cancel_after_destroy();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
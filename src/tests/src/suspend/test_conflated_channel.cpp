@@ -0,0 +1,73 @@
+/**
+ * @file test_conflated_channel.cpp
+ * @brief Tests for the buffer overflow strategies of ConflatedBufferedChannel.
+ *
+ * Follows testDropOldest and testDropLatest of ChannelBufferOverflowTest.kt with the
+ * non-suspending operations, and checks the CONFLATED channel of the factory.
+ */
+
+#include <iostream>
+#include <cassert>
+
+#include "kotlinx/coroutines/channels/Channels.hpp"
+
+using namespace kotlinx::coroutines::channels;
+
+// A full buffer drops its oldest element to take the new one
+void test_drop_oldest() {
+    std::cout << "test_drop_oldest... ";
+
+    ConflatedBufferedChannel<int> channel(2, BufferOverflow::DROP_OLDEST);
+    assert(channel.try_send(1).is_success());
+    assert(channel.try_send(2).is_success());
+    assert(channel.try_send(3).is_success()); // overflows, keeps 2, 3
+    assert(channel.try_receive().get_or_throw() == 2);
+    assert(channel.try_send(4).is_success());
+    assert(channel.try_send(5).is_success()); // overflows, keeps 4, 5
+    assert(channel.try_receive().get_or_throw() == 4);
+    assert(channel.try_receive().get_or_throw() == 5);
+    assert(channel.try_receive().is_failure());
+
+    std::cout << "PASSED\n";
+}
+
+// A full buffer drops the new element
+void test_drop_latest() {
+    std::cout << "test_drop_latest... ";
+
+    ConflatedBufferedChannel<int> channel(2, BufferOverflow::DROP_LATEST);
+    assert(channel.try_send(1).is_success());
+    assert(channel.try_send(2).is_success());
+    assert(channel.try_send(3).is_success()); // overflows, keeps 1, 2
+    assert(channel.try_receive().get_or_throw() == 1);
+    assert(channel.try_send(4).is_success());
+    assert(channel.try_send(5).is_success()); // overflows, keeps 2, 4
+    assert(channel.try_receive().get_or_throw() == 2);
+    assert(channel.try_receive().get_or_throw() == 4);
+    assert(channel.try_receive().is_failure());
+
+    std::cout << "PASSED\n";
+}
+
+// A CONFLATED channel keeps the latest element
+void test_conflated() {
+    std::cout << "test_conflated... ";
+
+    auto channel = create_channel<int>(Channel<int>::CONFLATED);
+    for (int i = 0; i < 10; ++i) assert(channel->try_send(i).is_success());
+    assert(channel->try_receive().get_or_throw() == 9);
+    assert(channel->try_receive().is_failure());
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Conflated Channel Tests ===\n";
+
+    test_drop_oldest();
+    test_drop_latest();
+    test_conflated();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
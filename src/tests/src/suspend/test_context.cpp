@@ -0,0 +1,119 @@
+/**
+ * @file test_context.cpp
+ * @brief Tests for composing coroutine contexts.
+ *
+ * Covers the flat context built by `operator+` (replacement of elements with the same key,
+ * lookups of well-known and other keys, minus_key), the memoized sum of a context with the same
+ * right-hand side, and the Job/interceptor accessors.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+#include "kotlinx/coroutines/CompletableJob.hpp"
+#include "kotlinx/coroutines/CoroutineContext.hpp"
+#include "kotlinx/coroutines/CoroutineExceptionHandler.hpp"
+#include "kotlinx/coroutines/CoroutineName.hpp"
+#include "kotlinx/coroutines/Job.hpp"
+#include "kotlinx/coroutines/context_impl.hpp"
+
+using namespace kotlinx::coroutines;
+
+namespace {
+
+class TagElement : public AbstractCoroutineContextElement {
+public:
+    inline static CoroutineContext::KeyTyped<TagElement> key_instance{"Tag"};
+    static constexpr CoroutineContext::Key* type_key = &key_instance;
+
+    explicit TagElement(int value) : AbstractCoroutineContextElement(type_key), value(value) {}
+
+    int value;
+};
+
+std::size_t count_elements(const CoroutineContext& context) {
+    std::size_t count = 0;
+    context.for_each([&count](std::shared_ptr<CoroutineContext::Element>) { ++count; });
+    return count;
+}
+
+} // namespace
+
+// Elements of the right-hand side replace those with the same key; all keys are found
+void test_plus_replaces_and_finds_elements() {
+    std::cout << "test_plus_replaces_and_finds_elements... ";
+
+    std::shared_ptr<CoroutineContext> job = make_job();
+    auto first_name = std::make_shared<CoroutineName>("first");
+    auto second_name = std::make_shared<CoroutineName>("second");
+    auto tag = std::make_shared<TagElement>(7);
+
+    auto context = *(*(*job + first_name) + tag) + second_name;
+    assert(dynamic_cast<FlatCoroutineContext*>(context.get()) != nullptr);
+    assert(count_elements(*context) == 3);
+    assert(context->get(CoroutineName::type_key) == second_name);
+    assert(context->get(TagElement::type_key) == tag);
+    assert(context->get(Job::type_key) == job);
+    assert(context->job_ptr() == dynamic_cast<Job*>(job.get()));
+    assert(context->interceptor_ptr() == nullptr);
+    assert(context->delay_ptr() == nullptr);
+
+    std::cout << "PASSED\n";
+}
+
+// minus_key keeps the other elements and collapses to a single element or to nullptr
+void test_minus_key() {
+    std::cout << "test_minus_key... ";
+
+    std::shared_ptr<CoroutineContext> job = make_job();
+    auto name = std::make_shared<CoroutineName>("name");
+    auto tag = std::make_shared<TagElement>(1);
+    auto context = *(*job + name) + tag;
+
+    assert(context->minus_key(CoroutineExceptionHandler::type_key) == context);
+    auto without_name = context->minus_key(CoroutineName::type_key);
+    assert(count_elements(*without_name) == 2);
+    assert(without_name->get(CoroutineName::type_key) == nullptr);
+    assert(without_name->job_ptr() == context->job_ptr());
+
+    auto only_tag = without_name->minus_key(Job::type_key);
+    assert(only_tag == tag);
+    assert(only_tag->minus_key(TagElement::type_key) == nullptr);
+
+    std::cout << "PASSED\n";
+}
+
+// Adding the same context twice reuses the first sum while it is alive
+void test_plus_is_memoized() {
+    std::cout << "test_plus_is_memoized... ";
+
+    std::shared_ptr<CoroutineContext> job = make_job();
+    auto base = *job + std::make_shared<CoroutineName>("base");
+    auto tag = std::make_shared<TagElement>(3);
+
+    auto first = *base + tag;
+    auto second = *base + tag;
+    assert(first == second);
+
+    auto other = *base + std::make_shared<TagElement>(3);
+    assert(other != first);
+    assert(std::dynamic_pointer_cast<TagElement>(other->get(TagElement::type_key))->value == 3);
+
+    // Nothing to add: the left-hand side is returned as is
+    assert(*base + EmptyCoroutineContext::instance() == base);
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Coroutine Context Tests ===\n";
+
+    test_plus_replaces_and_finds_elements();
+    test_minus_key();
+    test_plus_is_memoized();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,232 @@
+/**
+ * @file test_dispatch_batch.cpp
+ * @brief Tests for DispatchBatchScope and the dispatch_batch of limited_parallelism views.
+ *
+ * Covers safe_dispatch inside a scope deferring every task and the flush handing each one over
+ * exactly once, in order per dispatcher; nested scopes flushing only at the outermost one; and
+ * a limited_parallelism view starting no more workers than its parallelism for a batch, whether
+ * the batch comes straight to dispatch_batch or from a scope.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "kotlinx/coroutines/CoroutineDispatcher.hpp"
+#include "kotlinx/coroutines/internal/DispatchBatch.hpp"
+#include "kotlinx/coroutines/internal/DispatchedContinuation.hpp"
+
+using namespace kotlinx::coroutines;
+using namespace kotlinx::coroutines::internal;
+
+namespace {
+
+struct FunctionRunnable : Runnable {
+    std::function<void()> block;
+    explicit FunctionRunnable(std::function<void()> b) : block(std::move(b)) {}
+    void run() override { block(); }
+};
+
+std::shared_ptr<Runnable> task(std::function<void()> block) {
+    return std::make_shared<FunctionRunnable>(std::move(block));
+}
+
+// Keeps what it is given, to be run by the test, and counts the calls
+class RecordingDispatcher : public CoroutineDispatcher {
+public:
+    void dispatch(const CoroutineContext&, std::shared_ptr<Runnable> block) const override {
+        std::lock_guard<std::mutex> guard(lock_);
+        ++dispatches_;
+        pending_.push_back(std::move(block));
+    }
+
+    void dispatch_batch(std::vector<DispatchRequest>& requests) const override {
+        std::lock_guard<std::mutex> guard(lock_);
+        batch_sizes_.push_back(static_cast<int>(requests.size()));
+        for (auto& request : requests) pending_.push_back(std::move(request.block));
+    }
+
+    std::string to_string() const override { return "RecordingDispatcher"; }
+
+    std::vector<std::shared_ptr<Runnable>> take_pending() {
+        std::lock_guard<std::mutex> guard(lock_);
+        return std::move(pending_);
+    }
+
+    int dispatches() const {
+        std::lock_guard<std::mutex> guard(lock_);
+        return dispatches_;
+    }
+
+    std::vector<int> batch_sizes() const {
+        std::lock_guard<std::mutex> guard(lock_);
+        return batch_sizes_;
+    }
+
+    // Runs what was handed over, each in order, until nothing is left
+    void run_all() {
+        for (auto pending = take_pending(); !pending.empty(); pending = take_pending()) {
+            for (auto& block : pending) block->run();
+        }
+    }
+
+    // Runs what was handed over, each on its own thread, until nothing is left
+    void run_all_in_parallel() {
+        for (auto pending = take_pending(); !pending.empty(); pending = take_pending()) {
+            std::vector<std::thread> threads;
+            for (auto& block : pending) threads.emplace_back([block] { block->run(); });
+            for (auto& thread : threads) thread.join();
+        }
+    }
+
+private:
+    mutable std::mutex lock_;
+    mutable std::vector<std::shared_ptr<Runnable>> pending_;
+    mutable int dispatches_ = 0;
+    mutable std::vector<int> batch_sizes_;
+};
+
+// Tracks how many tasks run at once
+struct Concurrency {
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    std::atomic<int> executed{0};
+
+    std::shared_ptr<Runnable> task() {
+        return ::task([this] {
+            const int now = running.fetch_add(1) + 1;
+            int seen = max_running.load();
+            while (now > seen && !max_running.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            running.fetch_sub(1);
+            executed.fetch_add(1);
+        });
+    }
+};
+
+} // namespace
+
+// Dispatches inside a scope wait for the flush, which hands each over once, in order
+void test_scope_defers_and_flushes() {
+    std::cout << "test_scope_defers_and_flushes... ";
+
+    auto first = std::make_shared<RecordingDispatcher>();
+    auto second = std::make_shared<RecordingDispatcher>();
+    std::vector<int> ran_first;
+    std::vector<int> ran_second;
+    {
+        DispatchBatchScope batch;
+        for (int i = 0; i < 10; ++i) {
+            safe_dispatch(*first, *first, task([&ran_first, i] { ran_first.push_back(i); }));
+            safe_dispatch(*second, *second, task([&ran_second, i] { ran_second.push_back(i); }));
+        }
+        assert(first->take_pending().empty() && second->take_pending().empty());
+        batch.flush();
+        assert((first->batch_sizes() == std::vector<int>{10}));
+        assert((second->batch_sizes() == std::vector<int>{10}));
+        assert(first->dispatches() == 0 && second->dispatches() == 0);
+
+        // The scope is still active after a flush
+        safe_dispatch(*first, *first, task([&ran_first] { ran_first.push_back(10); }));
+    }
+    // A single deferred task goes through dispatch()
+    assert(first->dispatches() == 1);
+
+    first->run_all();
+    second->run_all();
+    assert((ran_first == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10}));
+    assert((ran_second == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+
+    // Without a scope, safe_dispatch dispatches right away
+    safe_dispatch(*first, *first, task([] {}));
+    assert(first->dispatches() == 2);
+    first->run_all();
+
+    std::cout << "PASSED\n";
+}
+
+// An inner scope joins the outer one: only the outermost flushes
+void test_nested_scopes() {
+    std::cout << "test_nested_scopes... ";
+
+    auto dispatcher = std::make_shared<RecordingDispatcher>();
+    std::vector<int> ran;
+    {
+        DispatchBatchScope outer;
+        safe_dispatch(*dispatcher, *dispatcher, task([&ran] { ran.push_back(0); }));
+        {
+            DispatchBatchScope inner;
+            safe_dispatch(*dispatcher, *dispatcher, task([&ran] { ran.push_back(1); }));
+            inner.flush();
+            assert(dispatcher->take_pending().empty());
+        }
+        assert(dispatcher->take_pending().empty());
+        safe_dispatch(*dispatcher, *dispatcher, task([&ran] { ran.push_back(2); }));
+    }
+    assert((dispatcher->batch_sizes() == std::vector<int>{3}));
+    assert(dispatcher->dispatches() == 0);
+
+    dispatcher->run_all();
+    assert((ran == std::vector<int>{0, 1, 2}));
+
+    std::cout << "PASSED\n";
+}
+
+// A batch starts at most `parallelism` workers of the underlying dispatcher
+void test_limited_dispatcher_batch() {
+    std::cout << "test_limited_dispatcher_batch... ";
+
+    constexpr int parallelism = 2;
+    constexpr int tasks = 40;
+    auto underlying = std::make_shared<RecordingDispatcher>();
+    auto limited = underlying->limited_parallelism(parallelism);
+    Concurrency concurrency;
+
+    std::vector<DispatchRequest> requests;
+    for (int i = 0; i < tasks; ++i) requests.push_back({limited.get(), concurrency.task()});
+    limited->dispatch_batch(requests);
+    assert((underlying->batch_sizes() == std::vector<int>{parallelism}));
+
+    // While both workers are started, more tasks start none
+    std::vector<DispatchRequest> more;
+    for (int i = 0; i < tasks; ++i) more.push_back({limited.get(), concurrency.task()});
+    limited->dispatch_batch(more);
+    assert((underlying->batch_sizes() == std::vector<int>{parallelism}));
+    assert(underlying->dispatches() == 0);
+
+    // Workers that yield for fairness are dispatched again, one by one
+    underlying->run_all_in_parallel();
+    assert(concurrency.executed.load() == 2 * tasks);
+    assert(concurrency.max_running.load() <= parallelism);
+
+    // The same holds for a batch collected by a scope
+    {
+        DispatchBatchScope batch;
+        for (int i = 0; i < tasks; ++i) safe_dispatch(*limited, *limited, concurrency.task());
+        assert(underlying->take_pending().empty());
+    }
+    assert((underlying->batch_sizes() == std::vector<int>{parallelism, parallelism}));
+    underlying->run_all_in_parallel();
+    assert(concurrency.executed.load() == 3 * tasks);
+    assert(concurrency.max_running.load() <= parallelism);
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Dispatch Batch Tests ===\n";
+
+    test_scope_defers_and_flushes();
+    test_nested_scopes();
+    test_limited_dispatcher_batch();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
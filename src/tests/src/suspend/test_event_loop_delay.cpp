@@ -0,0 +1,237 @@
+/**
+ * @file test_event_loop_delay.cpp
+ * @brief Tests for the delayed tasks of BlockingEventLoop, the loop under run_blocking.
+ *
+ * Covers delay() on the loop resuming in deadline order, the loop parking until the earliest
+ * deadline instead of spinning and waking early for a new earlier one, a delay from another
+ * thread waking a loop that has nothing to wait for, a cancelled delay leaving the queue, and
+ * shutdown handing the delays still pending to DefaultExecutor. The loop runs on
+ * the test thread, as run_blocking runs it, and the last resumed sleeper shuts it down.
+ */
+
+#include <iostream>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <ctime>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "kotlinx/coroutines/CompletableJob.hpp"
+#include "kotlinx/coroutines/Delay.hpp"
+#include "kotlinx/coroutines/EventLoop.hpp"
+#include "kotlinx/coroutines/intrinsics/Intrinsics.hpp"
+
+using namespace kotlinx::coroutines;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+long long millis_since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+}
+
+// CPU time of the calling thread, to tell parking from spinning
+long long thread_cpu_millis() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ts.tv_sec * 1000LL + ts.tv_nsec / 1'000'000;
+}
+
+// A caller of delay(): records when and how it was resumed, then runs [on_resume]
+class Sleeper : public Continuation<void*> {
+public:
+    explicit Sleeper(std::shared_ptr<CoroutineContext> context, std::function<void()> on_resume = {})
+        : context_(std::move(context)), on_resume_(std::move(on_resume)) {}
+
+    std::shared_ptr<CoroutineContext> get_context() const override { return context_; }
+
+    void resume_with(Result<void*> result) override {
+        cancelled_ = result.is_failure();
+        resumed_at_ = Clock::now();
+        resumed_.store(true);
+        if (on_resume_) on_resume_();
+    }
+
+    void sleep(long long time_millis) {
+        assert(intrinsics::is_coroutine_suspended(delay(time_millis, this)));
+    }
+
+    bool resumed() const { return resumed_.load(); }
+    bool cancelled() const { return cancelled_; }
+    Clock::time_point resumed_at() const { return resumed_at_; }
+
+private:
+    std::shared_ptr<CoroutineContext> context_;
+    std::function<void()> on_resume_;
+    std::atomic<bool> resumed_{false};
+    bool cancelled_ = false;
+    Clock::time_point resumed_at_;
+};
+
+std::shared_ptr<CoroutineContext> context_of(const std::shared_ptr<BlockingEventLoop>& loop) {
+    return std::static_pointer_cast<CoroutineContext>(loop);
+}
+
+} // namespace
+
+// Delays resume in the order of their deadlines, not the order they were started in
+void test_delay_order() {
+    std::cout << "test_delay_order... ";
+
+    auto loop = std::make_shared<BlockingEventLoop>(nullptr);
+    std::vector<int> order;
+    const auto start = Clock::now();
+    std::vector<std::unique_ptr<Sleeper>> sleepers;
+    for (int millis : {60, 20, 40, 80}) {
+        sleepers.push_back(std::make_unique<Sleeper>(context_of(loop), [&order, &loop, millis] {
+            order.push_back(millis);
+            if (millis == 80) loop->shutdown();
+        }));
+        sleepers.back()->sleep(millis);
+    }
+    loop->run();
+
+    assert((order == std::vector<int>{20, 40, 60, 80}));
+    const std::vector<int> expected{60, 20, 40, 80};
+    for (std::size_t i = 0; i < sleepers.size(); ++i) {
+        assert(!sleepers[i]->cancelled());
+        assert(sleepers[i]->resumed_at() - start >= std::chrono::milliseconds(expected[i]));
+    }
+    assert(loop->is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+// While the only work is a delay, the loop waits for its deadline without burning CPU, and a
+// new earlier delay from another thread wakes it to serve that one first
+void test_parks_until_earliest_deadline() {
+    std::cout << "test_parks_until_earliest_deadline... ";
+
+    auto loop = std::make_shared<BlockingEventLoop>(nullptr);
+    Sleeper late(context_of(loop), [&loop] { loop->shutdown(); });
+    Sleeper early(context_of(loop));
+    late.sleep(300);
+    std::thread scheduler([&] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        early.sleep(50);
+    });
+
+    const auto start = Clock::now();
+    const long long cpu_before = thread_cpu_millis();
+    loop->run();
+    const long long cpu = thread_cpu_millis() - cpu_before;
+    scheduler.join();
+
+    assert(millis_since(start) >= 300);
+    assert(cpu < 100);
+    (void)cpu;
+    assert(early.resumed() && !early.cancelled());
+    assert(early.resumed_at() - start >= std::chrono::milliseconds(100));
+    assert(early.resumed_at() - start < std::chrono::milliseconds(300));
+    assert(early.resumed_at() < late.resumed_at());
+
+    std::cout << "PASSED\n";
+}
+
+// A delay scheduled from another thread while the loop goes idle with no delayed task wakes it,
+// however the schedule() interleaves with the loop deciding to wait forever. A watchdog shuts a
+// loop down that missed the wakeup.
+void test_delay_wakes_idle_loop() {
+    std::cout << "test_delay_wakes_idle_loop... ";
+
+    for (int round = 0; round < 200; ++round) {
+        auto loop = std::make_shared<BlockingEventLoop>(nullptr);
+        Sleeper sleeper(context_of(loop), [&loop] { loop->shutdown(); });
+        std::thread scheduler([&sleeper] { sleeper.sleep(1); });
+        std::atomic<bool> timed_out{false};
+        std::thread watchdog([&] {
+            const auto start = Clock::now();
+            while (!sleeper.resumed() && millis_since(start) < 2'000) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            if (!sleeper.resumed()) {
+                timed_out.store(true);
+                loop->shutdown();
+            }
+        });
+        loop->run();
+        scheduler.join();
+        watchdog.join();
+        assert(!timed_out.load());
+        assert(sleeper.resumed() && !sleeper.cancelled());
+    }
+
+    std::cout << "PASSED\n";
+}
+
+// Cancelling a delay takes its task out of the queue; the caller is resumed with the cancellation
+void test_cancelled_delay_is_disposed() {
+    std::cout << "test_cancelled_delay_is_disposed... ";
+
+    auto loop = std::make_shared<BlockingEventLoop>(nullptr);
+    auto job = make_job();
+    Sleeper cancelled(context_of(loop)->operator+(std::static_pointer_cast<CoroutineContext>(job)),
+                      [&loop] { loop->shutdown(); });
+    cancelled.sleep(10'000);
+    assert(!loop->delayed_queue.is_empty());
+
+    job->cancel();
+    assert(loop->delayed_queue.is_empty());
+
+    // The cancelled caller is resumed through the loop, which shuts it down right away
+    const auto start = Clock::now();
+    loop->run();
+    assert(millis_since(start) < 1'000);
+    assert(cancelled.resumed() && cancelled.cancelled());
+    assert(loop->is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+// Shutting the loop down hands its pending delays to DefaultExecutor for the rest of their
+// time; a delay cancelled after the handover does not complete
+void test_shutdown_moves_delays_to_default_executor() {
+    std::cout << "test_shutdown_moves_delays_to_default_executor... ";
+
+    auto loop = std::make_shared<BlockingEventLoop>(nullptr);
+    auto job = make_job();
+    Sleeper pending(context_of(loop));
+    Sleeper dropped(context_of(loop)->operator+(std::static_pointer_cast<CoroutineContext>(job)));
+    const auto start = Clock::now();
+    pending.sleep(100);
+    dropped.sleep(100);
+
+    loop->shutdown();
+    assert(loop->delayed_queue.is_empty());
+    job->cancel();
+
+    while (!pending.resumed() && millis_since(start) < 5'000) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    assert(pending.resumed() && !pending.cancelled());
+    assert(pending.resumed_at() - start >= std::chrono::milliseconds(100));
+
+    // The cancelled caller sees the cancellation, never a completed delay from the handed-over task
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    assert(dropped.resumed() && dropped.cancelled());
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Event Loop Delay Tests ===\n";
+
+    test_delay_order();
+    test_parks_until_earliest_deadline();
+    test_delay_wakes_idle_loop();
+    test_cancelled_delay_is_disposed();
+    test_shutdown_moves_delays_to_default_executor();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,203 @@
+/**
+ * @file test_finishing_exceptions.cpp
+ * @brief Tests for internal::FinishingExceptions, the exceptions of a finishing job.
+ *
+ * Covers the root cause being the first exception added, the root cause and the latest exception
+ * not being added twice, nothing being added once sealed, every exception being kept, and
+ * threads adding exceptions while another seals.
+ */
+
+#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "kotlinx/coroutines/internal/FinishingExceptions.hpp"
+
+using namespace kotlinx::coroutines::internal;
+using AddResult = FinishingExceptions::AddResult;
+
+namespace {
+
+std::exception_ptr error(const std::string& message) {
+    return std::make_exception_ptr(std::runtime_error(message));
+}
+
+} // namespace
+
+// Without exceptions the job is active, and sealing gives only the proposed exception
+void test_empty() {
+    std::cout << "test_empty... ";
+
+    FinishingExceptions exceptions;
+    assert(!exceptions.is_cancelling());
+    assert(!exceptions.is_sealed());
+    assert(exceptions.root_cause() == nullptr);
+
+    auto proposed = error("proposed");
+    bool was_cancelling = true;
+    auto sealed = exceptions.seal(proposed, was_cancelling);
+    assert(!was_cancelling);
+    assert((sealed == std::vector<std::exception_ptr>{proposed}));
+    assert(exceptions.is_sealed());
+    assert(!exceptions.is_cancelling());
+
+    FinishingExceptions completed;
+    assert(completed.seal(nullptr, was_cancelling).empty());
+    assert(!was_cancelling);
+
+    std::cout << "PASSED\n";
+}
+
+// The first exception is the root cause, whatever is added after it
+void test_root_cause() {
+    std::cout << "test_root_cause... ";
+
+    auto first = error("first");
+    auto second = error("second");
+    FinishingExceptions exceptions;
+    assert(exceptions.add(first) == AddResult::ROOT_CAUSE);
+    assert(exceptions.is_cancelling());
+    assert(exceptions.root_cause() == first);
+    assert(exceptions.add(second) == AddResult::ADDED);
+    assert(exceptions.root_cause() == first);
+
+    auto cause = error("cause");
+    FinishingExceptions cancelling(cause);
+    assert(cancelling.is_cancelling());
+    assert(cancelling.root_cause() == cause);
+    assert(cancelling.add(first) == AddResult::ADDED);
+    assert(cancelling.root_cause() == cause);
+
+    std::cout << "PASSED\n";
+}
+
+// Adding the root cause or the latest exception again, or proposing the root cause, keeps one copy
+void test_dedup() {
+    std::cout << "test_dedup... ";
+
+    auto root = error("root");
+    auto latest = error("latest");
+    FinishingExceptions exceptions;
+    assert(exceptions.add(root) == AddResult::ROOT_CAUSE);
+    assert(exceptions.add(root) == AddResult::ADDED);
+    assert(exceptions.add(latest) == AddResult::ADDED);
+    assert(exceptions.add(latest) == AddResult::ADDED);
+    assert(exceptions.add(root) == AddResult::ADDED);
+
+    bool was_cancelling = false;
+    auto sealed = exceptions.seal(root, was_cancelling);
+    assert(was_cancelling);
+    assert((sealed == std::vector<std::exception_ptr>{root, latest}));
+
+    std::cout << "PASSED\n";
+}
+
+// Once sealed nothing is added, and the exceptions stay as they were sealed
+void test_add_after_seal() {
+    std::cout << "test_add_after_seal... ";
+
+    auto root = error("root");
+    FinishingExceptions exceptions(root);
+    bool was_cancelling = false;
+    auto sealed = exceptions.seal(nullptr, was_cancelling);
+    assert(was_cancelling);
+    assert((sealed == std::vector<std::exception_ptr>{root}));
+
+    assert(exceptions.add(error("late")) == AddResult::SEALED);
+    assert(exceptions.is_sealed());
+    assert(exceptions.root_cause() == root);
+    assert(exceptions.seal(nullptr, was_cancelling) == sealed);
+
+    FinishingExceptions empty;
+    empty.seal(nullptr, was_cancelling);
+    assert(empty.add(error("late")) == AddResult::SEALED);
+    assert(!empty.is_cancelling());
+
+    std::cout << "PASSED\n";
+}
+
+// Every exception is kept, in the order it was added, with the proposed one last
+void test_keeps_all() {
+    std::cout << "test_keeps_all... ";
+
+    std::vector<std::exception_ptr> added;
+    FinishingExceptions exceptions;
+    for (int i = 0; i < 5; ++i) {
+        added.push_back(error("error " + std::to_string(i)));
+        assert(exceptions.add(added.back()) == (i == 0 ? AddResult::ROOT_CAUSE : AddResult::ADDED));
+    }
+    auto proposed = error("proposed");
+    bool was_cancelling = false;
+    auto sealed = exceptions.seal(proposed, was_cancelling);
+    added.push_back(proposed);
+    assert(sealed == added);
+
+    std::cout << "PASSED\n";
+}
+
+// Threads add while another seals: exactly the exceptions added before the seal are in it
+void test_concurrent_seal() {
+    std::cout << "test_concurrent_seal... ";
+
+    constexpr int threads = 4;
+    constexpr int per_thread = 1'000;
+    for (int round = 0; round < 50; ++round) {
+        FinishingExceptions exceptions;
+        std::vector<std::vector<std::exception_ptr>> accepted(threads);
+        std::atomic<int> root_causes{0};
+        std::atomic<bool> go{false};
+        std::vector<std::thread> adders;
+        for (int t = 0; t < threads; ++t) {
+            adders.emplace_back([&, t] {
+                while (!go.load()) {}
+                for (int i = 0; i < per_thread; ++i) {
+                    auto exception = error("error");
+                    AddResult result = exceptions.add(exception);
+                    if (result == AddResult::SEALED) break;
+                    if (result == AddResult::ROOT_CAUSE) root_causes.fetch_add(1);
+                    accepted[t].push_back(exception);
+                }
+            });
+        }
+        go.store(true);
+        bool was_cancelling = false;
+        auto sealed = exceptions.seal(nullptr, was_cancelling);
+        for (auto& adder : adders) adder.join();
+
+        std::size_t total = 0;
+        for (auto& list : accepted) total += list.size();
+        assert(sealed.size() == total);
+        assert(was_cancelling == (total > 0));
+        assert(root_causes.load() == (total > 0 ? 1 : 0));
+        if (total > 0) assert(sealed.front() == exceptions.root_cause());
+        // Each thread's exceptions appear in the order it added them
+        for (auto& list : accepted) {
+            auto at = sealed.begin();
+            for (auto& exception : list) {
+                at = std::find(at, sealed.end(), exception);
+                assert(at != sealed.end());
+            }
+        }
+    }
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Finishing Exceptions Tests ===\n";
+
+    test_empty();
+    test_root_cause();
+    test_dedup();
+    test_add_after_seal();
+    test_keeps_all();
+    test_concurrent_seal();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
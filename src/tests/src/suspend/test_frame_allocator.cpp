@@ -0,0 +1,132 @@
+/**
+ * @file test_frame_allocator.cpp
+ * @brief Tests for the pooled allocator of coroutine frames.
+ *
+ * Covers reuse of freed frames (a steady-state loop does not reach the system allocator),
+ * frames freed on another thread going back to their owner, the cache of an exited thread
+ * being adopted, and requests too large for the pool.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <memory>
+
+#include "kotlinx/coroutines/ContinuationImpl.hpp"
+#include "kotlinx/coroutines/internal/FrameAllocator.hpp"
+
+using namespace kotlinx::coroutines;
+using namespace kotlinx::coroutines::internal;
+
+namespace {
+
+class CountingFrame : public ContinuationImpl {
+public:
+    explicit CountingFrame(std::shared_ptr<Continuation<void*>> completion)
+        : ContinuationImpl(std::move(completion), nullptr) {}
+
+    void* invoke_suspend(Result<void*> result) override {
+        return nullptr;
+    }
+
+    void* label = nullptr;
+    long spilled[4] = {};
+};
+
+} // namespace
+
+// After a warm-up, allocating and freeing frames is served from the free lists
+void test_steady_state_reuses_frames() {
+    std::cout << "test_steady_state_reuses_frames... ";
+
+    {
+        auto first = make_frame<CountingFrame>(nullptr);
+        auto second = make_frame<CountingFrame>(nullptr);
+        delete new CountingFrame(nullptr);
+    }
+    const FrameAllocatorStats before = FrameAllocator::stats();
+    for (int i = 0; i < 10000; ++i) {
+        auto outer = make_frame<CountingFrame>(nullptr);
+        auto inner = make_frame<CountingFrame>(nullptr);
+        std::unique_ptr<CountingFrame> plain(new CountingFrame(nullptr));
+    }
+    const FrameAllocatorStats after = FrameAllocator::stats();
+    assert(after.allocations - before.allocations == 30000);
+    assert(after.deallocations - before.deallocations == 30000);
+    assert(after.system_allocations == before.system_allocations);
+    assert(after.system_deallocations == before.system_deallocations);
+
+    std::cout << "PASSED\n";
+}
+
+// Frames freed on another thread are returned to the allocating thread's cache
+void test_remote_free_returns_to_owner() {
+    std::cout << "test_remote_free_returns_to_owner... ";
+
+    constexpr int kFrames = 100;
+    std::vector<std::shared_ptr<CountingFrame>> frames;
+    for (int i = 0; i < kFrames; ++i) frames.push_back(make_frame<CountingFrame>(nullptr));
+    FrameAllocator::trim();
+    const FrameAllocatorStats before = FrameAllocator::stats();
+
+    std::thread releaser([&frames] { frames.clear(); });
+    releaser.join();
+    for (int i = 0; i < kFrames; ++i) frames.push_back(make_frame<CountingFrame>(nullptr));
+
+    const FrameAllocatorStats after = FrameAllocator::stats();
+    assert(after.remote_deallocations - before.remote_deallocations == kFrames);
+    assert(after.system_allocations == before.system_allocations);
+    frames.clear();
+
+    std::cout << "PASSED\n";
+}
+
+// Frames of an exited thread can still be freed, and its cache is reused by the next thread
+void test_exited_thread_cache_is_adopted() {
+    std::cout << "test_exited_thread_cache_is_adopted... ";
+
+    std::vector<std::shared_ptr<CountingFrame>> frames;
+    FrameAllocatorStats first_round;
+    for (int round = 0; round < 4; ++round) {
+        std::thread worker([&frames] {
+            for (int i = 0; i < 10; ++i) frames.push_back(make_frame<CountingFrame>(nullptr));
+            delete new CountingFrame(nullptr);
+        });
+        worker.join();
+        // Freed after their thread exited: they wait in its cache for the next thread.
+        frames.clear();
+        if (round == 0) first_round = FrameAllocator::stats();
+    }
+    const FrameAllocatorStats after = FrameAllocator::stats();
+    // Only the plain frame, which the exiting thread gave back, needs new memory in each round.
+    assert(after.system_allocations - first_round.system_allocations == 3);
+
+    std::cout << "PASSED\n";
+}
+
+// Requests above MAX_POOLED_SIZE go straight to the system allocator
+void test_large_requests_bypass_pool() {
+    std::cout << "test_large_requests_bypass_pool... ";
+
+    const FrameAllocatorStats before = FrameAllocator::stats();
+    void* block = FrameAllocator::allocate(FrameAllocator::MAX_POOLED_SIZE + 1);
+    FrameAllocator::deallocate(block);
+    const FrameAllocatorStats after = FrameAllocator::stats();
+    assert(after.system_allocations - before.system_allocations == 1);
+    assert(after.system_deallocations - before.system_deallocations == 1);
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Frame Allocator Tests ===\n";
+
+    test_steady_state_reuses_frames();
+    test_remote_free_returns_to_owner();
+    test_exited_thread_cache_is_adopted();
+    test_large_requests_bypass_pool();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,166 @@
+/**
+ * @file test_job_nodes.cpp
+ * @brief Tests for the child handle nodes and completion handler nodes of JobSupport.
+ *
+ * Covers the allocations of a fan-out of children and of invoke_on_completion with a lambda,
+ * counted by replacing the global operator new, a destroyed job freeing the nodes and states it
+ * allocated, and that the embedded child handle nodes still cancel children, wait for them and
+ * cancel the parent on failure.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+#include "kotlinx/coroutines/CompletableJob.hpp"
+#include "kotlinx/coroutines/Job.hpp"
+#include "kotlinx/coroutines/JobSupport.hpp"
+
+#include "../AllocationCounter.hpp"
+
+using namespace kotlinx::coroutines;
+using allocation_counter::allocations;
+using allocation_counter::live;
+
+// Attaching a child to its parent allocates nothing beyond the child itself
+void test_fan_out_allocations() {
+    std::cout << "test_fan_out_allocations... ";
+
+    constexpr int children = 100'000;
+    auto parent = make_job();
+    std::vector<std::shared_ptr<CompletableJob>> jobs;
+    jobs.reserve(children);
+    // The first child promotes the parent's state to a list
+    jobs.push_back(make_job(parent));
+
+    long before = allocations.load();
+    jobs.push_back(make_job());
+    long per_job = allocations.load() - before;
+
+    before = allocations.load();
+    for (int i = 2; i < children; ++i) jobs.push_back(make_job(parent));
+    long fan_out = allocations.load() - before;
+    assert(fan_out == per_job * (children - 2));
+
+    for (auto& job : jobs) job->complete();
+    parent->complete();
+    parent->join_blocking();
+    assert(parent->is_completed() && !parent->is_cancelled());
+
+    std::cout << "PASSED\n";
+}
+
+// A lambda handler is stored in its node
+void test_invoke_on_completion_inline() {
+    std::cout << "test_invoke_on_completion_inline... ";
+
+    auto job = std::dynamic_pointer_cast<JobSupport>(make_job());
+    assert(job);
+    int calls = 0;
+    std::exception_ptr seen;
+    auto failure = std::make_exception_ptr(std::runtime_error("failed"));
+
+    long before = allocations.load();
+    job->invoke_on_completion([&calls](std::exception_ptr) { ++calls; });
+    job->invoke_on_completion(true, false, [&calls, &seen](std::exception_ptr cause) {
+        ++calls;
+        seen = cause;
+    });
+    assert(allocations.load() - before <= 3); // two nodes and the promotion to a list
+
+    std::dynamic_pointer_cast<CompletableJob>(job)->complete_exceptionally(failure);
+    assert(calls == 2);
+    assert(seen == failure);
+
+    // Already complete: invoked immediately
+    job->invoke_on_completion([&calls](std::exception_ptr) { ++calls; });
+    assert(calls == 3);
+
+    std::cout << "PASSED\n";
+}
+
+// Cancelling the parent reaches every child through the embedded nodes
+// A job frees its handler nodes, lists and finishing states with itself, whether the handlers
+// ran, were disposed or were still installed
+void test_destroyed_job_frees_nodes() {
+    std::cout << "test_destroyed_job_frees_nodes... ";
+
+    auto handler = [](std::exception_ptr) {};
+    // The first cancellation sets up the shared cancellation exception
+    make_job()->cancel();
+
+    const long before = live.load();
+    for (int round = 0; round < 1'000; ++round) {
+        auto completed = make_job();
+        completed->invoke_on_completion(handler);
+        completed->invoke_on_completion(handler);
+        completed->complete();
+
+        auto disposed = make_job();
+        disposed->invoke_on_completion(handler)->dispose();
+
+        auto dropped = make_job();
+        dropped->invoke_on_completion(handler);
+
+        auto cancelled = make_job();
+        cancelled->invoke_on_completion(true, true, handler);
+        cancelled->invoke_on_completion(handler);
+        cancelled->cancel();
+    }
+    assert(live.load() == before);
+
+    std::cout << "PASSED\n";
+}
+
+void test_cancel_children() {
+    std::cout << "test_cancel_children... ";
+
+    auto parent = make_job();
+    std::vector<std::shared_ptr<CompletableJob>> jobs;
+    for (int i = 0; i < 1000; ++i) jobs.push_back(make_job(parent));
+    parent->cancel();
+    for (auto& job : jobs) assert(job->is_cancelled());
+
+    // Cancelled JobImpls do not complete by themselves yet
+    parent->complete();
+    assert(!parent->is_completed());
+    for (auto& job : jobs) job->complete();
+    parent->join_blocking();
+    assert(parent->is_cancelled());
+
+    std::cout << "PASSED\n";
+}
+
+// A completing parent waits for its children; a failed child cancels it
+void test_wait_for_children() {
+    std::cout << "test_wait_for_children... ";
+
+    auto parent = make_job();
+    auto first = make_job(parent);
+    auto second = make_job(parent);
+    parent->complete();
+    assert(!parent->is_completed());
+
+    first->complete();
+    assert(!parent->is_completed());
+    second->complete_exceptionally(std::make_exception_ptr(std::runtime_error("child failed")));
+    assert(parent->is_completed());
+    assert(parent->is_cancelled());
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Job Node Tests ===\n";
+
+    test_fan_out_allocations();
+    test_invoke_on_completion_inline();
+    test_destroyed_job_frees_nodes();
+    test_cancel_children();
+    test_wait_for_children();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,92 @@
+/**
+ * @file test_launch_lazy.cpp
+ * @brief Tests for launch with CoroutineStart::LAZY.
+ *
+ * Follows LaunchLazyTest.kt: the block does not run until the job is started, start() and
+ * join_blocking() both start it, it runs only once, and its captures are released afterwards.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <memory>
+
+#include "kotlinx/coroutines/Builders.hpp"
+#include "kotlinx/coroutines/CoroutineScope.hpp"
+
+using namespace kotlinx::coroutines;
+
+// start() runs the block once, and only then
+void test_start() {
+    std::cout << "test_start... ";
+
+    int runs = 0;
+    auto job = launch(GlobalScope::instance(), nullptr, CoroutineStart::LAZY,
+                      [&runs](CoroutineScope*) { ++runs; });
+    assert(runs == 0);
+    assert(!job->is_active());
+    assert(!job->is_completed());
+
+    assert(job->start());
+    assert(runs == 1);
+    assert(job->is_completed());
+    assert(!job->start());
+    assert(runs == 1);
+
+    std::cout << "PASSED\n";
+}
+
+// Joining a lazy job starts it
+void test_join_starts() {
+    std::cout << "test_join_starts... ";
+
+    int runs = 0;
+    auto job = launch(GlobalScope::instance(), nullptr, CoroutineStart::LAZY,
+                      [&runs](CoroutineScope*) { ++runs; });
+    job->join_blocking();
+    assert(runs == 1);
+    assert(job->is_completed());
+    assert(!job->is_cancelled());
+
+    std::cout << "PASSED\n";
+}
+
+// The coroutine does not keep the captures of its block after running it
+void test_block_released() {
+    std::cout << "test_block_released... ";
+
+    auto captured = std::make_shared<int>(42);
+    auto job = launch(GlobalScope::instance(), nullptr, CoroutineStart::LAZY,
+                      [captured](CoroutineScope*) { assert(*captured == 42); });
+    assert(captured.use_count() == 2);
+    job->start();
+    assert(captured.use_count() == 1);
+
+    std::cout << "PASSED\n";
+}
+
+// A lazy job cancelled before it starts never runs its block
+void test_cancel_before_start() {
+    std::cout << "test_cancel_before_start... ";
+
+    int runs = 0;
+    auto job = launch(GlobalScope::instance(), nullptr, CoroutineStart::LAZY,
+                      [&runs](CoroutineScope*) { ++runs; });
+    job->cancel();
+    job->join_blocking();
+    assert(job->is_cancelled());
+    assert(runs == 0);
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Lazy Launch Tests ===\n";
+
+    test_start();
+    test_join_starts();
+    test_block_released();
+    test_cancel_before_start();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
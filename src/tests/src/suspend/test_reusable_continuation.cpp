@@ -0,0 +1,279 @@
+/**
+ * @file test_reusable_continuation.cpp
+ * @brief Tests for the CancellableContinuationImpl a state machine reuses across suspensions.
+ *
+ * Covers getting the same continuation back after it was resumed and released, a claim for
+ * another result type leaving the parked continuation alone, clearing the slot when the state
+ * machine terminates, a sender and a receiver suspending on a rendezvous channel in a loop
+ * without allocating, counted by replacing the global operator new, and a state machine that
+ * waits for a Mutex over and over.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <memory>
+
+#include "kotlinx/coroutines/ContinuationImpl.hpp"
+#include "kotlinx/coroutines/dsl/CancellableReusable.hpp"
+#include "kotlinx/coroutines/channels/BufferedChannel.hpp"
+#include "kotlinx/coroutines/sync/Mutex.hpp"
+
+#include "../AllocationCounter.hpp"
+
+using namespace kotlinx::coroutines;
+using namespace kotlinx::coroutines::internal;
+using namespace kotlinx::coroutines::channels;
+using allocation_counter::allocations;
+
+namespace {
+
+class LoopFrame : public ContinuationImpl {
+public:
+    explicit LoopFrame(std::shared_ptr<Continuation<void*>> completion)
+        : ContinuationImpl(std::move(completion), nullptr) {}
+
+    void* invoke_suspend(Result<void*> result) override {
+        return nullptr;
+    }
+};
+
+// One suspension of the frame: claim a continuation, resume it, release it back.
+std::shared_ptr<CancellableContinuationImpl<int>> suspend_once(LoopFrame* frame, int value) {
+    auto cont = dsl::get_or_create_cancellable_continuation<int>(frame);
+    void* token = cont->try_resume(value);
+    assert(token != nullptr);
+    (void) token;
+    cont->release_claimed_reusable_continuation();
+    return cont;
+}
+
+// Stands in for the caller of a state machine, which only has to be there for it to run
+class IgnoringCompletion : public Continuation<void*> {
+public:
+    std::shared_ptr<CoroutineContext> get_context() const override {
+        return EmptyCoroutineContext::instance();
+    }
+
+    void resume_with(Result<void*>) override {}
+};
+
+// `while (true) channel.send(next++)`: suspends on every send while no receiver waits
+class SendLoopFrame : public ContinuationImpl {
+public:
+    SendLoopFrame(std::shared_ptr<Continuation<void*>> completion, BufferedChannel<int>* channel)
+        : ContinuationImpl(std::move(completion), nullptr), channel_(channel) {}
+
+    void* invoke_suspend(Result<void*> result) override {
+        result.get_or_throw();
+        while (true) {
+            void* outcome = channel_->send(next_++, this);
+            if (intrinsics::is_coroutine_suspended(outcome)) return outcome;
+        }
+    }
+
+    int next() const { return next_; }
+
+private:
+    BufferedChannel<int>* channel_;
+    int next_ = 0;
+};
+
+// `while (true) sum += channel.receive()`: suspends on every receive while no sender waits,
+// and takes each element in a member of the frame
+class ReceiveLoopFrame : public ContinuationImpl {
+public:
+    ReceiveLoopFrame(std::shared_ptr<Continuation<void*>> completion, BufferedChannel<int>* channel)
+        : ContinuationImpl(std::move(completion), nullptr), channel_(channel) {}
+
+    void* invoke_suspend(Result<void*> result) override {
+        void* outcome = result.get_or_throw();
+        while (true) {
+            if (outcome != nullptr) {
+                assert(outcome == &element_);
+                sum_ += element_;
+                ++received_;
+            }
+            outcome = channel_->receive_into(&element_, this);
+            if (intrinsics::is_coroutine_suspended(outcome)) return outcome;
+        }
+    }
+
+    int received() const { return received_; }
+    long sum() const { return sum_; }
+
+private:
+    BufferedChannel<int>* channel_;
+    int element_ = 0;
+    int received_ = 0;
+    long sum_ = 0;
+};
+
+// `while (true) mutex.lock()`: holding the mutex already, every lock after the first waits
+// until the mutex is unlocked on its behalf
+class LockLoopFrame : public ContinuationImpl {
+public:
+    LockLoopFrame(std::shared_ptr<Continuation<void*>> completion, sync::Mutex* mutex)
+        : ContinuationImpl(std::move(completion), nullptr), mutex_(mutex) {}
+
+    void* invoke_suspend(Result<void*> result) override {
+        result.get_or_throw();
+        // Resumed by unlock() with the lock handed over
+        if (started_) ++acquired_;
+        started_ = true;
+        while (true) {
+            void* outcome = mutex_->lock(nullptr, this);
+            if (intrinsics::is_coroutine_suspended(outcome)) return outcome;
+            ++acquired_;
+        }
+    }
+
+    int acquired() const { return acquired_; }
+
+private:
+    sync::Mutex* mutex_;
+    bool started_ = false;
+    int acquired_ = 0;
+};
+
+} // namespace
+
+// A state machine that suspends in a loop allocates its continuation once
+void test_continuation_is_reused() {
+    std::cout << "test_continuation_is_reused... ";
+
+    auto frame = make_frame<LoopFrame>(nullptr);
+    auto first = suspend_once(frame.get(), 1);
+    assert(first->resume_mode == MODE_CANCELLABLE_REUSABLE);
+    assert(first->is_reusable());
+    for (int i = 0; i < 100; ++i) {
+        auto cont = suspend_once(frame.get(), i);
+        assert(cont == first);
+    }
+
+    std::cout << "PASSED\n";
+}
+
+// A claim for another kind of continuation gets a fresh one and leaves the parked one in place
+void test_other_kind_is_not_reused() {
+    std::cout << "test_other_kind_is_not_reused... ";
+
+    auto frame = make_frame<LoopFrame>(nullptr);
+    auto parked = suspend_once(frame.get(), 1);
+
+    auto other = dsl::get_or_create_cancellable_continuation<void>(frame.get());
+    assert(other->resume_mode == MODE_CANCELLABLE);
+    assert(!other->is_reusable());
+
+    assert(suspend_once(frame.get(), 2) == parked);
+
+    std::cout << "PASSED\n";
+}
+
+// Clearing the slot drops the parked continuation; the next suspension creates a new one
+void test_clear_drops_parked_continuation() {
+    std::cout << "test_clear_drops_parked_continuation... ";
+
+    auto frame = make_frame<LoopFrame>(nullptr);
+    std::weak_ptr<CancellableContinuationImpl<int>> parked = suspend_once(frame.get(), 1);
+    assert(!parked.expired());
+
+    frame->reusable_continuation_slot().clear();
+    assert(parked.expired());
+
+    auto next = suspend_once(frame.get(), 2);
+    assert(next->is_reusable());
+
+    std::cout << "PASSED\n";
+}
+
+// Without a ContinuationImpl to hold the slot, continuations are not reusable
+void test_without_frame_is_not_reusable() {
+    std::cout << "test_without_frame_is_not_reusable... ";
+
+    auto frame = make_frame<LoopFrame>(nullptr);
+    std::shared_ptr<Continuation<void*>> completion = std::make_shared<dsl::BoxingContinuation<void*>>(frame.get());
+    auto cont = dsl::get_or_create_cancellable_continuation<int>(completion.get());
+    assert(cont->resume_mode == MODE_CANCELLABLE);
+    assert(!cont->is_reusable());
+
+    std::cout << "PASSED\n";
+}
+
+// Once warm, a sender suspending on a channel in a loop does not allocate per suspension:
+// it parks on the same continuation and the channel reuses its segments
+void test_send_loop_does_not_allocate() {
+    std::cout << "test_send_loop_does_not_allocate... ";
+
+    constexpr int suspensions = 100'000;
+    BufferedChannel<int> channel(Channel<int>::RENDEZVOUS);
+    auto frame = make_frame<SendLoopFrame>(std::make_shared<IgnoringCompletion>(), &channel);
+    // The first send suspends; each receive resumes the sender, which suspends on the next one
+    frame->resume_with(Result<void*>::success(nullptr));
+    for (int i = 0; i < 1'000; ++i) assert(channel.try_receive().get_or_throw() == i);
+
+    const long before = allocations.load();
+    for (int i = 1'000; i < suspensions; ++i) assert(channel.try_receive().get_or_throw() == i);
+    const long allocated = allocations.load() - before;
+    assert(frame->next() == suspensions + 1);
+    assert(allocated == 0);
+    (void)allocated;
+
+    channel.cancel();
+    std::cout << "PASSED\n";
+}
+
+// The same holds for a receiver: receive_into() puts each element in the frame instead of
+// boxing it into the `void*` result
+void test_receive_loop_does_not_allocate() {
+    std::cout << "test_receive_loop_does_not_allocate... ";
+
+    constexpr int suspensions = 100'000;
+    BufferedChannel<int> channel(Channel<int>::RENDEZVOUS);
+    auto frame = make_frame<ReceiveLoopFrame>(std::make_shared<IgnoringCompletion>(), &channel);
+    // The first receive suspends; each send resumes the receiver, which suspends on the next one
+    frame->resume_with(Result<void*>::success(nullptr));
+    for (int i = 0; i < 1'000; ++i) assert(channel.try_send(i).is_success());
+
+    const long before = allocations.load();
+    for (int i = 1'000; i < suspensions; ++i) assert(channel.try_send(i).is_success());
+    const long allocated = allocations.load() - before;
+    assert(frame->received() == suspensions);
+    assert(frame->sum() == static_cast<long>(suspensions) * (suspensions - 1) / 2);
+    assert(allocated == 0);
+    (void)allocated;
+
+    channel.cancel();
+    std::cout << "PASSED\n";
+}
+
+// A state machine waiting for a Mutex in a loop is handed the lock every time
+void test_lock_loop() {
+    std::cout << "test_lock_loop... ";
+
+    auto mutex = sync::make_mutex(true);
+    auto frame = make_frame<LockLoopFrame>(std::make_shared<IgnoringCompletion>(), mutex.get());
+    frame->resume_with(Result<void*>::success(nullptr));
+    assert(frame->acquired() == 0);
+    for (int i = 1; i <= 1'000; ++i) {
+        mutex->unlock();
+        assert(frame->acquired() == i);
+        assert(mutex->is_locked());
+    }
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Reusable Continuation Tests ===\n";
+
+    test_continuation_is_reused();
+    test_other_kind_is_not_reused();
+    test_clear_drops_parked_continuation();
+    test_without_frame_is_not_reusable();
+    test_send_loop_does_not_allocate();
+    test_receive_loop_does_not_allocate();
+    test_lock_loop();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,503 @@
+/**
+ * @file test_scheduler.cpp
+ * @brief Tests for the work-stealing CoroutineScheduler, its WorkQueue and the TimerQueue.
+ *
+ * Covers the local queue protocol (single owner, concurrent stealers, the LIFO
+ * "next" slot), the scheduler paths (external submissions through the global
+ * queue, fan-out from a worker into its local queue with stealing, run-next
+ * handoff and its fairness cap, draining on close, spinning before parking,
+ * batch submission, NUMA placements),
+ * the elastic pool (lazy start, growth for blocking tasks, idle retirement, the
+ * IO view's blocking permits), and timer ordering and cancellation.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+
+#include "kotlinx/coroutines/context_impl.hpp"
+#include "kotlinx/coroutines/scheduling/Affinity.hpp"
+#include "kotlinx/coroutines/scheduling/CoroutineScheduler.hpp"
+#include "kotlinx/coroutines/scheduling/Dispatcher.hpp"
+#include "kotlinx/coroutines/scheduling/TimerQueue.hpp"
+#include "kotlinx/coroutines/scheduling/WorkQueue.hpp"
+
+using namespace kotlinx::coroutines;
+using namespace kotlinx::coroutines::scheduling;
+
+namespace {
+
+struct FunctionRunnable : Runnable {
+    std::function<void()> block;
+    explicit FunctionRunnable(std::function<void()> b) : block(std::move(b)) {}
+    void run() override { block(); }
+};
+
+std::shared_ptr<Runnable> task(std::function<void()> block) {
+    return std::make_shared<FunctionRunnable>(std::move(block));
+}
+
+void wait_for(const std::atomic<int>& counter, int expected) {
+    while (counter.load() < expected) std::this_thread::yield();
+}
+
+} // namespace
+
+// Owner-only add/poll keeps FIFO order and reports fullness
+void test_work_queue_fifo() {
+    std::cout << "test_work_queue_fifo... ";
+
+    WorkQueue queue;
+    std::vector<int> order;
+    for (int i = 0; i < BUFFER_CAPACITY; ++i) {
+        auto t = task([&order, i] { order.push_back(i); });
+        assert(queue.add(t));
+        assert(!t);
+    }
+    auto overflow = task([] {});
+    assert(!queue.add(overflow));
+    assert(overflow);
+    assert(queue.size() == BUFFER_CAPACITY);
+
+    while (auto t = queue.poll()) t->run();
+    assert(queue.is_empty());
+    for (int i = 0; i < BUFFER_CAPACITY; ++i) assert(order[i] == i);
+
+    std::cout << "PASSED\n";
+}
+
+// Every task added by the owner is polled exactly once across concurrent stealers
+void test_work_queue_concurrent_steal() {
+    std::cout << "test_work_queue_concurrent_steal... ";
+
+    constexpr int kTasks = 100000;
+    constexpr int kStealers = 3;
+    WorkQueue queue;
+    std::atomic<int> executed{0};
+    std::atomic<bool> done{false};
+
+    std::vector<std::thread> stealers;
+    for (int i = 0; i < kStealers; ++i) {
+        stealers.emplace_back([&] {
+            while (!done.load() || !queue.is_empty()) {
+                if (auto t = queue.poll()) t->run();
+            }
+        });
+    }
+    for (int i = 0; i < kTasks; ++i) {
+        auto t = task([&executed] { executed.fetch_add(1); });
+        while (!queue.add(t)) {
+            if (auto mine = queue.poll()) mine->run();
+        }
+    }
+    done.store(true);
+    for (auto& s : stealers) s.join();
+    while (auto t = queue.poll()) t->run();
+    assert(executed.load() == kTasks);
+
+    std::cout << "PASSED\n";
+}
+
+// The "next" slot is LIFO, hands the displaced task back, and is reserved for its owner for a while
+void test_work_queue_next_slot() {
+    std::cout << "test_work_queue_next_slot... ";
+
+    WorkQueue queue;
+    auto first = task([] {});
+    auto second = task([] {});
+    Runnable* first_raw = first.get();
+    Runnable* second_raw = second.get();
+    assert(!queue.add_next(std::move(first), 0));
+    auto displaced = queue.add_next(std::move(second), 0);
+    assert(displaced.get() == first_raw);
+    assert(!queue.is_empty());
+    assert(queue.size() == 0);
+
+    long long delay = 0;
+    assert(!queue.steal_next(50, 100, delay));
+    assert(delay == 50);
+    auto stolen = queue.steal_next(100, 100, delay);
+    assert(stolen.get() == second_raw);
+    assert(queue.is_empty());
+
+    assert(!queue.add_next(task([] {}), 0));
+    assert(queue.poll_next());
+    assert(!queue.poll_next());
+
+    std::cout << "PASSED\n";
+}
+
+// Tasks submitted from outside of the pool all run
+void test_scheduler_external_dispatch() {
+    std::cout << "test_scheduler_external_dispatch... ";
+
+    constexpr int kTasks = 10000;
+    CoroutineScheduler scheduler(4, "test");
+    std::atomic<int> executed{0};
+    for (int i = 0; i < kTasks; ++i) {
+        scheduler.dispatch(task([&executed] { executed.fetch_add(1); }));
+    }
+    wait_for(executed, kTasks);
+
+    std::cout << "PASSED\n";
+}
+
+// A fan-out from a worker lands in its local queue and is spread by stealing
+void test_scheduler_fan_out_from_worker() {
+    std::cout << "test_scheduler_fan_out_from_worker... ";
+
+    constexpr int kTasks = 10000;
+    CoroutineScheduler scheduler(4, "test");
+    std::atomic<int> executed{0};
+    std::mutex threads_lock;
+    std::vector<std::thread::id> threads;
+    scheduler.dispatch(task([&] {
+        for (int i = 0; i < kTasks; ++i) {
+            scheduler.dispatch(task([&] {
+                {
+                    std::lock_guard<std::mutex> lock(threads_lock);
+                    threads.push_back(std::this_thread::get_id());
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(10));
+                executed.fetch_add(1);
+            }));
+        }
+    }));
+    wait_for(executed, kTasks);
+    std::sort(threads.begin(), threads.end());
+    auto distinct = std::unique(threads.begin(), threads.end()) - threads.begin();
+    assert(distinct > 1);
+
+    std::cout << "PASSED\n";
+}
+
+// Closing does not drop already submitted tasks (MultithreadedDispatcherStressTest)
+void test_scheduler_close_drains() {
+    std::cout << "test_scheduler_close_drains... ";
+
+    for (int n_threads = 1; n_threads <= 7; ++n_threads) {
+        std::atomic<int> executed{0};
+        {
+            CoroutineScheduler scheduler(n_threads, "test");
+            for (int i = 0; i < 1000; ++i) {
+                scheduler.dispatch(task([&executed] { executed.fetch_add(1); }));
+            }
+            scheduler.close();
+            scheduler.dispatch(task([&executed] { executed.fetch_add(1000); }));
+        }
+        assert(executed.load() == 1000);
+    }
+
+    std::cout << "PASSED\n";
+}
+
+// A task dispatched from a worker runs right after the current one, but cannot starve the queue
+void test_scheduler_run_next() {
+    std::cout << "test_scheduler_run_next... ";
+
+    CoroutineScheduler scheduler(1, "test");
+    std::mutex order_lock;
+    std::vector<int> order;
+    std::atomic<int> done{0};
+    auto record = [&](int value) {
+        std::lock_guard<std::mutex> lock(order_lock);
+        order.push_back(value);
+    };
+    scheduler.dispatch(task([&] {
+        scheduler.dispatch(task([&] { record(1); done.fetch_add(1); }));
+        scheduler.dispatch(task([&] { record(2); done.fetch_add(1); }));
+    }));
+    wait_for(done, 2);
+    assert((order == std::vector<int>{2, 1}));
+
+    // A task that keeps re-dispatching itself hands over to the queued task after a bounded streak.
+    constexpr int kHops = 1000;
+    std::atomic<int> hops{0};
+    std::atomic<int> queued_ran_at{-1};
+    std::function<void()> hop = [&] {
+        if (hops.fetch_add(1) + 1 < kHops) scheduler.dispatch(task(hop));
+    };
+    scheduler.dispatch(task([&] {
+        scheduler.dispatch(task([&] { queued_ran_at.store(hops.load()); }), false, /* fair = */ true);
+        scheduler.dispatch(task(hop));
+    }));
+    wait_for(hops, kHops);
+    assert(queued_ran_at.load() >= 0);
+    assert(queued_ran_at.load() < kHops);
+
+    std::cout << "PASSED\n";
+}
+
+// A message bounced between the pool and an external thread is never lost to a skipped wake-up
+void test_scheduler_ping_pong() {
+    std::cout << "test_scheduler_ping_pong... ";
+
+    constexpr int kRounds = 20000;
+    CoroutineScheduler scheduler(2, "test");
+    std::atomic<int> pongs{0};
+    for (int i = 0; i < kRounds; ++i) {
+        // Alternate between submissions that find a spinning worker and ones that find it parked.
+        if (i % 1000 == 999) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        scheduler.dispatch(task([&pongs] { pongs.fetch_add(1); }));
+        wait_for(pongs, i + 1);
+    }
+
+    std::cout << "PASSED\n";
+}
+
+// A batch runs every task exactly once, whether submitted from outside or from a worker
+void test_scheduler_dispatch_batch() {
+    std::cout << "test_scheduler_dispatch_batch... ";
+
+    {
+        CoroutineScheduler scheduler(1, "test");
+        std::vector<int> order;
+        std::atomic<int> done{0};
+        std::vector<std::shared_ptr<Runnable>> blocks;
+        for (int i = 0; i < 100; ++i) {
+            blocks.push_back(task([&order, &done, i] { order.push_back(i); done.fetch_add(1); }));
+        }
+        scheduler.dispatch_batch(blocks);
+        wait_for(done, 100);
+        std::sort(order.begin(), order.end());
+        for (int i = 0; i < 100; ++i) assert(order[i] == i);
+    }
+
+    constexpr int kTasks = 1000;
+    CoroutineScheduler scheduler(4, "test");
+    std::atomic<int> executed{0};
+    scheduler.dispatch(task([&] {
+        // Larger than a local queue: the overflow goes to the global queue.
+        std::vector<std::shared_ptr<Runnable>> blocks;
+        for (int i = 0; i < kTasks; ++i) {
+            blocks.push_back(task([&executed] { executed.fetch_add(1); }));
+        }
+        scheduler.dispatch_batch(blocks);
+    }));
+    wait_for(executed, kTasks);
+
+    std::cout << "PASSED\n";
+}
+
+// Node-local submissions and stealing with worker placements; node views and the CPU list parser
+void test_scheduler_numa_placement() {
+    std::cout << "test_scheduler_numa_placement... ";
+
+    assert((parse_cpu_list("0-3,8,10-11") == CpuSet{0, 1, 2, 3, 8, 10, 11}));
+    assert(parse_cpu_list("").empty());
+    assert(numa_node_count() >= 1);
+
+    // Two synthetic nodes with unpinned workers: only the stealing order and the node queues differ.
+    std::vector<WorkerPlacement> placements{{{}, 0}, {{}, 1}};
+    constexpr int kTasks = 2000;
+    CoroutineScheduler scheduler(4, 4, "test", CoroutineScheduler::IDLE_WORKER_KEEP_ALIVE_MS, placements);
+    assert(scheduler.has_numa_node(0) && scheduler.has_numa_node(1) && !scheduler.has_numa_node(2));
+    std::atomic<int> executed{0};
+    for (int i = 0; i < kTasks; ++i) {
+        scheduler.dispatch_on_node(task([&executed] { executed.fetch_add(1); }), i % 2);
+    }
+    scheduler.dispatch_on_node(task([&] {
+        for (int i = 0; i < kTasks; ++i) {
+            scheduler.dispatch_on_node(task([&executed] { executed.fetch_add(1); }), 1);
+        }
+    }), 0);
+    wait_for(executed, 2 * kTasks);
+
+    NumaNodeDispatcher view(scheduler, 1, "test.node1");
+    std::atomic<int> viewed{0};
+    for (int i = 0; i < 100; ++i) {
+        view.dispatch(*EmptyCoroutineContext::instance(), task([&viewed] { viewed.fetch_add(1); }));
+    }
+    wait_for(viewed, 100);
+    bool rejected = false;
+    try {
+        NumaNodeDispatcher missing(scheduler, 2, "test.node2");
+    } catch (const std::invalid_argument&) {
+        rejected = true;
+    }
+    assert(rejected);
+
+    std::cout << "PASSED\n";
+}
+
+// Workers are only started when there is work, and never more than the CPU permits for CPU tasks
+void test_scheduler_lazy_workers() {
+    std::cout << "test_scheduler_lazy_workers... ";
+
+    CoroutineScheduler scheduler(4, 16, "test");
+    assert(scheduler.alive_workers() == 0);
+    std::atomic<int> executed{0};
+    for (int i = 0; i < 1000; ++i) {
+        scheduler.dispatch(task([&executed] { executed.fetch_add(1); }));
+    }
+    wait_for(executed, 1000);
+    assert(scheduler.alive_workers() >= 1);
+    assert(scheduler.alive_workers() <= 4);
+
+    std::cout << "PASSED\n";
+}
+
+// Blocking tasks get threads of their own and do not take CPU permits away; extra threads retire
+void test_scheduler_blocking_growth_and_retirement() {
+    std::cout << "test_scheduler_blocking_growth_and_retirement... ";
+
+    constexpr int kBlocking = 8;
+    CoroutineScheduler scheduler(2, 2 + kBlocking, "test", /* idle_worker_keep_alive_ms = */ 50);
+    std::atomic<int> started{0};
+    std::atomic<bool> release{false};
+    for (int i = 0; i < kBlocking; ++i) {
+        scheduler.dispatch(task([&] {
+            started.fetch_add(1);
+            while (!release.load()) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }), /* blocking = */ true);
+    }
+    // All blocking tasks run at once, on more threads than there are CPU permits...
+    wait_for(started, kBlocking);
+    // ...and CPU tasks still make progress while they block.
+    std::atomic<int> executed{0};
+    for (int i = 0; i < 100; ++i) {
+        scheduler.dispatch(task([&executed] { executed.fetch_add(1); }));
+    }
+    wait_for(executed, 100);
+    assert(scheduler.alive_workers() > 2);
+
+    release.store(true);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (scheduler.alive_workers() > 2 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    assert(scheduler.alive_workers() == 2);
+
+    // Retired slots are reused when the pool grows again.
+    started.store(0);
+    scheduler.dispatch(task([&started] { started.fetch_add(1); }), /* blocking = */ true);
+    wait_for(started, 1);
+
+    std::cout << "PASSED\n";
+}
+
+// A blocking task submitted from a worker usually continues on that worker's thread
+void test_scheduler_blocking_stays_on_worker() {
+    std::cout << "test_scheduler_blocking_stays_on_worker... ";
+
+    constexpr int kRounds = 20;
+    CoroutineScheduler scheduler(1, 8, "test");
+    std::atomic<int> done{0};
+    std::atomic<int> same_thread{0};
+    for (int i = 0; i < kRounds; ++i) {
+        scheduler.dispatch(task([&] {
+            const auto dispatcher_thread = std::this_thread::get_id();
+            scheduler.dispatch(task([&, dispatcher_thread] {
+                if (std::this_thread::get_id() == dispatcher_thread) same_thread.fetch_add(1);
+                done.fetch_add(1);
+            }), /* blocking = */ true);
+        }));
+        wait_for(done, i + 1);
+    }
+    assert(same_thread.load() * 2 >= kRounds);
+
+    std::cout << "PASSED\n";
+}
+
+// The IO view never runs more tasks at once than it has blocking permits
+void test_io_dispatcher_parallelism() {
+    std::cout << "test_io_dispatcher_parallelism... ";
+
+    constexpr int kParallelism = 3;
+    constexpr int kTasks = 50;
+    CoroutineScheduler scheduler(2, 2 + kParallelism, "test");
+    IoDispatcher io(scheduler, kParallelism, "test-io");
+    std::atomic<int> running{0};
+    std::atomic<int> max_running{0};
+    std::atomic<int> executed{0};
+    auto& context = *EmptyCoroutineContext::instance();
+    for (int i = 0; i < kTasks; ++i) {
+        io.dispatch(context, task([&] {
+            int now = running.fetch_add(1) + 1;
+            int seen = max_running.load();
+            while (now > seen && !max_running.compare_exchange_weak(seen, now)) {}
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            running.fetch_sub(1);
+            executed.fetch_add(1);
+        }));
+    }
+    wait_for(executed, kTasks);
+    assert(max_running.load() <= kParallelism);
+    assert(max_running.load() > 1);
+
+    std::cout << "PASSED\n";
+}
+
+// Timers fire in deadline order on one thread, regardless of scheduling order
+void test_timer_ordering() {
+    std::cout << "test_timer_ordering... ";
+
+    TimerQueue timers("test");
+    std::mutex order_lock;
+    std::vector<int> order;
+    std::atomic<int> fired{0};
+    for (int delay : {30, 10, 20, 10}) {
+        timers.schedule(delay, task([&, delay] {
+            std::lock_guard<std::mutex> lock(order_lock);
+            order.push_back(delay);
+            fired.fetch_add(1);
+        }));
+    }
+    wait_for(fired, 4);
+    assert((order == std::vector<int>{10, 10, 20, 30}));
+
+    std::cout << "PASSED\n";
+}
+
+// Disposed timers never fire and are swept from the heap
+void test_timer_cancellation() {
+    std::cout << "test_timer_cancellation... ";
+
+    constexpr int kTimers = 10000;
+    TimerQueue timers("test");
+    std::atomic<int> fired{0};
+    std::vector<std::shared_ptr<DisposableHandle>> handles;
+    for (int i = 0; i < kTimers; ++i) {
+        handles.push_back(timers.schedule(60'000, task([&fired] { fired.fetch_add(1); })));
+    }
+    for (auto& handle : handles) handle->dispose();
+    // The next schedule sweeps the cancelled entries.
+    timers.schedule(1, task([&fired] { fired.fetch_add(1); }));
+    assert(timers.size() <= 1);
+    wait_for(fired, 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    assert(fired.load() == 1);
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Scheduler Tests ===\n";
+
+    test_work_queue_fifo();
+    test_work_queue_concurrent_steal();
+    test_work_queue_next_slot();
+    test_scheduler_external_dispatch();
+    test_scheduler_fan_out_from_worker();
+    test_scheduler_close_drains();
+    test_scheduler_run_next();
+    test_scheduler_ping_pong();
+    test_scheduler_dispatch_batch();
+    test_scheduler_numa_placement();
+    test_scheduler_lazy_workers();
+    test_scheduler_blocking_growth_and_retirement();
+    test_scheduler_blocking_stays_on_worker();
+    test_io_dispatcher_parallelism();
+    test_timer_ordering();
+    test_timer_cancellation();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,333 @@
+/**
+ * @file test_spsc_channel.cpp
+ * @brief Tests for SpscChannel and create_channel(ChannelMode::SPSC, ...).
+ *
+ * Covers the non-suspending operations, close and cancel, the channel the factory picks for
+ * each capacity, and suspending producer and consumer tasks on rendezvous, small and larger
+ * rings, including a receiver cancelled while it waits, a sender cancelled while it waits
+ * taking itself out of the waiter slot, and a send whose parking throws giving the slot back.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "kotlinx/coroutines/Task.hpp"
+#include "kotlinx/coroutines/CoroutineScope.hpp"
+#include "kotlinx/coroutines/channels/Channels.hpp"
+
+using namespace kotlinx::coroutines;
+using namespace kotlinx::coroutines::channels;
+
+// The ring takes up to the capacity; receiving makes room again
+void test_buffered_try() {
+    std::cout << "test_buffered_try... ";
+
+    SpscChannel<int> channel(4);
+    assert(channel.is_empty());
+    for (int i = 0; i < 4; ++i) assert(channel.try_send(i).is_success());
+    assert(channel.try_send(4).is_failure());
+    assert(!channel.is_empty());
+
+    assert(channel.try_receive().get_or_throw() == 0);
+    assert(channel.try_send(4).is_success());
+    for (int i = 1; i <= 4; ++i) assert(channel.try_receive().get_or_throw() == i);
+    assert(channel.try_receive().is_failure());
+    assert(channel.is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+// Without a waiting receiver a rendezvous channel takes nothing
+void test_rendezvous_try() {
+    std::cout << "test_rendezvous_try... ";
+
+    SpscChannel<int> channel(0);
+    assert(channel.try_send(1).is_failure());
+    assert(channel.try_receive().is_failure());
+    assert(channel.is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+// A closed channel hands out what it buffered, then reports the close
+void test_close() {
+    std::cout << "test_close... ";
+
+    SpscChannel<int> channel(8);
+    bool handler_called = false;
+    channel.invoke_on_close([&](std::exception_ptr cause) {
+        assert(cause == nullptr);
+        handler_called = true;
+    });
+    for (int i = 0; i < 3; ++i) assert(channel.try_send(i).is_success());
+    assert(channel.close());
+    assert(!channel.close());
+    assert(handler_called);
+
+    assert(channel.is_closed_for_send());
+    assert(channel.try_send(3).is_closed());
+    assert(!channel.is_closed_for_receive());
+    for (int i = 0; i < 3; ++i) assert(channel.try_receive().get_or_throw() == i);
+    assert(channel.try_receive().is_closed());
+    assert(channel.is_closed_for_receive());
+
+    std::cout << "PASSED\n";
+}
+
+// A cancelled channel drops its elements
+void test_cancel() {
+    std::cout << "test_cancel... ";
+
+    std::vector<int> undelivered;
+    SpscChannel<int> channel(8, [&](int element) { undelivered.push_back(element); });
+    for (int i = 0; i < 3; ++i) assert(channel.try_send(i).is_success());
+    channel.cancel();
+
+    assert(channel.is_closed_for_receive());
+    assert(channel.try_send(3).is_closed());
+    assert(channel.try_receive().is_closed());
+    assert((undelivered == std::vector<int>{0, 1, 2}));
+
+    std::cout << "PASSED\n";
+}
+
+// The SPSC hint applies to suspending channels of a finite capacity
+void test_factory() {
+    std::cout << "test_factory... ";
+
+    auto spsc = [](std::shared_ptr<Channel<int>> channel) {
+        return std::dynamic_pointer_cast<SpscChannel<int>>(channel);
+    };
+    assert(spsc(create_channel<int>(ChannelMode::SPSC))->capacity() == 0);
+    assert(spsc(create_channel<int>(ChannelMode::SPSC, 16))->capacity() == 16);
+    assert(spsc(create_channel<int>(ChannelMode::SPSC, Channel<int>::BUFFERED))->capacity() ==
+           Channel<int>::channel_default_capacity());
+
+    assert(!spsc(create_channel<int>(ChannelMode::SPSC, Channel<int>::UNLIMITED)));
+    assert(!spsc(create_channel<int>(ChannelMode::SPSC, Channel<int>::CONFLATED)));
+    assert(!spsc(create_channel<int>(ChannelMode::SPSC, 16, BufferOverflow::DROP_OLDEST)));
+    assert(!spsc(create_channel<int>(ChannelMode::MPMC, 16)));
+
+    std::cout << "PASSED\n";
+}
+
+// A producer and a consumer task that suspend on each other deliver every element in order
+void test_tasks(int capacity, int elements) {
+    std::cout << "test_tasks(" << capacity << ")... ";
+
+    auto channel = std::make_shared<SpscChannel<int>>(capacity);
+    std::shared_ptr<Deferred<long>> consumer;
+    std::shared_ptr<Job> producer;
+    // Each task starts on its own thread, and goes on there or on the thread of the side resuming it
+    std::thread consumer_thread([&] {
+        consumer = async_task<long>(GlobalScope::instance(), nullptr,
+            [](std::shared_ptr<SpscChannel<int>> channel, int elements) -> Task<long> {
+                long sum = 0;
+                for (int i = 0; i < elements; ++i) {
+                    int element = co_await co::receive(*channel);
+                    assert(element == i);
+                    sum += element;
+                }
+                auto last = co_await co::suspend<ChannelResult<int>>(
+                    [&](Continuation<void*>* c) { return channel->receive_catching(c); });
+                assert(last.is_closed());
+                co_return sum;
+            }(channel, elements));
+    });
+    std::thread producer_thread([&] {
+        producer = launch_task(GlobalScope::instance(), nullptr,
+            [](std::shared_ptr<SpscChannel<int>> channel, int elements) -> Task<void> {
+                for (int i = 0; i < elements; ++i) co_await co::send(*channel, i);
+                channel->close();
+            }(channel, elements));
+    });
+    consumer_thread.join();
+    producer_thread.join();
+
+    producer->join_blocking();
+    assert(consumer->await_blocking() == static_cast<long>(elements) * (elements - 1) / 2);
+    assert(channel->is_closed_for_receive());
+
+    std::cout << "PASSED\n";
+}
+
+// The iterator suspends until an element or the close
+void test_iterator() {
+    std::cout << "test_iterator... ";
+
+    auto channel = std::make_shared<SpscChannel<int>>(2);
+    auto consumer = async_task<int>(GlobalScope::instance(), nullptr,
+        [](std::shared_ptr<SpscChannel<int>> channel) -> Task<int> {
+            auto iterator = channel->iterator();
+            int count = 0;
+            while (co_await co::suspend<bool>([&](Continuation<void*>* c) { return iterator->has_next(c); })) {
+                assert(iterator->next() == count);
+                ++count;
+            }
+            co_return count;
+        }(channel));
+    auto producer = launch_task(GlobalScope::instance(), nullptr,
+        [](std::shared_ptr<SpscChannel<int>> channel) -> Task<void> {
+            for (int i = 0; i < 1000; ++i) co_await co::send(*channel, i);
+            channel->close();
+        }(channel));
+
+    producer->join_blocking();
+    assert(consumer->await_blocking() == 1000);
+
+    std::cout << "PASSED\n";
+}
+
+// A receiver cancelled while it waits leaves the channel usable
+void test_cancelled_receiver() {
+    std::cout << "test_cancelled_receiver... ";
+
+    for (int capacity : {0, 4}) {
+        auto channel = std::make_shared<SpscChannel<int>>(capacity);
+        auto consumer = launch_task(GlobalScope::instance(), nullptr,
+            [](std::shared_ptr<SpscChannel<int>> channel) -> Task<void> {
+                co_await co::receive(*channel);
+                assert(false && "nothing was sent");
+            }(channel));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        consumer->cancel();
+        consumer->join_blocking();
+        assert(consumer->is_cancelled());
+
+        if (capacity > 0) {
+            assert(channel->try_send(7).is_success());
+            assert(channel->try_receive().get_or_throw() == 7);
+        } else {
+            assert(channel->try_send(7).is_failure());
+        }
+    }
+
+    std::cout << "PASSED\n";
+}
+
+// A sender cancelled while it waits leaves the slot without the receiver touching the channel
+void test_cancelled_sender() {
+    std::cout << "test_cancelled_sender... ";
+
+    std::vector<int> undelivered;
+    auto channel = std::make_shared<SpscChannel<int>>(0, [&](int element) { undelivered.push_back(element); });
+    auto producer = launch_task(GlobalScope::instance(), nullptr,
+        [](std::shared_ptr<SpscChannel<int>> channel) -> Task<void> {
+            co_await co::send(*channel, 5);
+            assert(false && "nothing was received");
+        }(channel));
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    assert(!channel->is_empty());
+    producer->cancel();
+    producer->join_blocking();
+    assert(producer->is_cancelled());
+
+    assert(channel->is_empty());
+    assert((undelivered == std::vector<int>{5}));
+    assert(channel->try_receive().is_failure());
+
+    std::cout << "PASSED\n";
+}
+
+// Copies freely; a move throws while `throwing` is set
+struct ThrowingMove {
+    static inline bool throwing = false;
+
+    int value;
+
+    explicit ThrowingMove(int v) : value(v) {}
+    ThrowingMove(const ThrowingMove&) = default;
+    ThrowingMove(ThrowingMove&& other) : value(other.value) {
+        if (throwing) throw std::runtime_error("move failed");
+    }
+    ThrowingMove& operator=(const ThrowingMove&) = default;
+    ThrowingMove& operator=(ThrowingMove&&) = default;
+};
+
+// Stands in for the caller of a send that never completes
+class IgnoringCompletion : public Continuation<void*> {
+public:
+    std::shared_ptr<CoroutineContext> get_context() const override {
+        return EmptyCoroutineContext::instance();
+    }
+
+    void resume_with(Result<void*>) override {}
+};
+
+// A send that throws while it parks gives the reserved slot back
+void test_throwing_park() {
+    std::cout << "test_throwing_park... ";
+
+    SpscChannel<ThrowingMove> channel(0);
+    IgnoringCompletion completion;
+    const ThrowingMove element(1);
+    ThrowingMove::throwing = true;
+    bool thrown = false;
+    try {
+        channel.send(element, &completion);
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    ThrowingMove::throwing = false;
+    assert(thrown);
+
+    // Would spin on the claimed slot forever
+    assert(channel.try_receive().is_failure());
+    assert(channel.try_send(element).is_failure());
+    assert(channel.is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+// Threads spinning on try_send and try_receive keep the order
+void test_threads_try(int capacity) {
+    std::cout << "test_threads_try(" << capacity << ")... ";
+
+    constexpr int64_t elements = 1'000'000;
+    SpscChannel<int64_t> channel(capacity);
+    std::thread producer([&] {
+        for (int64_t i = 0; i < elements; ++i) {
+            while (!channel.try_send(i).is_success()) std::this_thread::yield();
+        }
+    });
+    for (int64_t i = 0; i < elements; ++i) {
+        ChannelResult<int64_t> result = channel.try_receive();
+        while (!result.is_success()) {
+            std::this_thread::yield();
+            result = channel.try_receive();
+        }
+        assert(result.get_or_throw() == i);
+    }
+    producer.join();
+    assert(channel.is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== SPSC Channel Tests ===\n";
+
+    test_buffered_try();
+    test_rendezvous_try();
+    test_close();
+    test_cancel();
+    test_factory();
+    test_tasks(0, 20'000);
+    test_tasks(1, 50'000);
+    test_tasks(16, 200'000);
+    test_iterator();
+    test_cancelled_receiver();
+    test_cancelled_sender();
+    test_throwing_park();
+    test_threads_try(1);
+    test_threads_try(64);
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -0,0 +1,230 @@
+/**
+ * @file test_task.cpp
+ * @brief Tests for Task<T>, C++20 coroutines on the coroutine runtime.
+ *
+ * Covers results of nested tasks, a deep chain of nested tasks, exceptions, the value kept by a
+ * completed Deferred, async_task with `co_await` on the Deferred, co::lock waiting for an
+ * unlock or cancelled while it waits, and co::delay.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "kotlinx/coroutines/Task.hpp"
+#include "kotlinx/coroutines/CoroutineScope.hpp"
+#include "kotlinx/coroutines/sync/Mutex.hpp"
+
+using namespace kotlinx::coroutines;
+
+namespace {
+
+Task<int> leaf(int value) {
+    co_return value;
+}
+
+Task<int> add(int a, int b) {
+    int x = co_await leaf(a);
+    int y = co_await leaf(b);
+    co_return x + y;
+}
+
+Task<int> depth(int levels) {
+    if (levels == 0) co_return 0;
+    int below = co_await depth(levels - 1);
+    co_return below + 1;
+}
+
+Task<int> fail() {
+    throw std::runtime_error("boom");
+    co_return 0;
+}
+
+Task<std::string> catch_failure() {
+    try {
+        co_await fail();
+    } catch (const std::runtime_error& e) {
+        co_return std::string(e.what());
+    }
+    co_return std::string("not thrown");
+}
+
+} // namespace
+
+// A value comes back through nested tasks
+void test_nested_value() {
+    std::cout << "test_nested_value... ";
+
+    int result = 0;
+    auto job = launch_task(GlobalScope::instance(), nullptr, [](int& out) -> Task<void> {
+        out = co_await add(2, 3);
+    }(result));
+    job->join_blocking();
+    assert(result == 5);
+
+    std::cout << "PASSED\n";
+}
+
+// Symmetric transfer keeps a deep chain off the stack (built with -O2, see CMakeLists.txt)
+void test_deep_chain() {
+    std::cout << "test_deep_chain... ";
+
+    auto deferred = async_task<int>(GlobalScope::instance(), nullptr, depth(100000));
+    assert(deferred->is_completed());
+    assert(deferred->get_completed() == 100000);
+
+    std::cout << "PASSED\n";
+}
+
+// An exception escaping a task is rethrown by co_await, or fails its Deferred
+void test_exceptions() {
+    std::cout << "test_exceptions... ";
+
+    auto caught = async_task<std::string>(GlobalScope::instance(), nullptr, catch_failure());
+    assert(caught->get_completed() == "boom");
+
+    auto failed = async_task<int>(GlobalScope::instance(), nullptr, fail());
+    assert(failed->is_completed());
+    assert(failed->get_completion_exception_or_null() != nullptr);
+
+    std::cout << "PASSED\n";
+}
+
+// A completed Deferred keeps its value for every reader
+void test_completed_value_kept() {
+    std::cout << "test_completed_value_kept... ";
+
+    const std::string value(64, 'x'); // past the small-string buffer, so a move empties it
+    auto deferred = async_task<std::string>(GlobalScope::instance(), nullptr,
+        [](std::string v) -> Task<std::string> { co_return v; }(value));
+    assert(deferred->is_completed());
+    assert(deferred->get_completed() == value);
+    assert(deferred->get_completed() == value);
+    assert(deferred->await_blocking() == value);
+
+    std::cout << "PASSED\n";
+}
+
+// co_await on a Deferred suspends until it completes
+void test_await_deferred() {
+    std::cout << "test_await_deferred... ";
+
+    auto mutex = sync::make_mutex(true);
+    auto first = async_task<int>(GlobalScope::instance(), nullptr, [](sync::Mutex& m) -> Task<int> {
+        co_await co::lock(m);
+        m.unlock();
+        co_return 20;
+    }(*mutex));
+    auto second = async_task<int>(GlobalScope::instance(), nullptr, [](Deferred<int>& d) -> Task<int> {
+        int value = co_await d;
+        co_return value + 1;
+    }(*first));
+    assert(!second->is_completed());
+
+    mutex->unlock();
+    second->join_blocking();
+    assert(second->get_completed() == 21);
+
+    std::cout << "PASSED\n";
+}
+
+// co::lock suspends while the mutex is held and resumes owning it
+void test_lock() {
+    std::cout << "test_lock... ";
+
+    auto mutex = sync::make_mutex();
+    int token = 0;
+    bool held = false;
+    mutex->lock();
+    auto job = launch_task(GlobalScope::instance(), nullptr, [](sync::Mutex& m, int* owner, bool& h) -> Task<void> {
+        co_await co::lock(m, owner);
+        h = m.holds_lock(owner);
+        m.unlock(owner);
+    }(*mutex, &token, held));
+    assert(!job->is_completed());
+
+    mutex->unlock();
+    job->join_blocking();
+    assert(held);
+    assert(!mutex->is_locked());
+
+    std::cout << "PASSED\n";
+}
+
+// A task cancelled while it waits for the lock leaves the queue; unlock() skips it
+void test_lock_cancelled() {
+    std::cout << "test_lock_cancelled... ";
+
+    auto mutex = sync::make_mutex(true);
+    bool reached = false;
+    auto cancelled = launch_task(GlobalScope::instance(), nullptr, [](sync::Mutex& m, bool& r) -> Task<void> {
+        co_await co::lock(m);
+        r = true;
+    }(*mutex, reached));
+    bool held = false;
+    auto next = launch_task(GlobalScope::instance(), nullptr, [](sync::Mutex& m, bool& h) -> Task<void> {
+        co_await co::lock(m);
+        h = true;
+        m.unlock();
+    }(*mutex, held));
+
+    cancelled->cancel();
+    cancelled->join_blocking();
+    assert(cancelled->is_cancelled());
+    assert(mutex->is_locked());
+
+    mutex->unlock();
+    next->join_blocking();
+    assert(held);
+    assert(!reached);
+    assert(!mutex->is_locked());
+
+    // With the only waiter cancelled, unlock() releases the mutex
+    assert(mutex->try_lock());
+    auto lone = launch_task(GlobalScope::instance(), nullptr, [](sync::Mutex& m) -> Task<void> {
+        co_await co::lock(m);
+    }(*mutex));
+    lone->cancel();
+    lone->join_blocking();
+    mutex->unlock();
+    assert(!mutex->is_locked());
+    assert(mutex->try_lock());
+    mutex->unlock();
+
+    std::cout << "PASSED\n";
+}
+
+// co::delay resumes the task from the delay thread
+void test_delay() {
+    std::cout << "test_delay... ";
+
+    int steps = 0;
+    auto job = launch_task(GlobalScope::instance(), nullptr, [](int& s) -> Task<void> {
+        co_await co::delay(0);
+        ++s;
+        co_await co::delay(5);
+        ++s;
+    }(steps));
+    job->join_blocking();
+    assert(steps == 2);
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Task Tests ===\n";
+
+    test_nested_value();
+    test_deep_chain();
+    test_exceptions();
+    test_completed_value_kept();
+    test_await_deferred();
+    test_lock();
+    test_lock_cancelled();
+    test_delay();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
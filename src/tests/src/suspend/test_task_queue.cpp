@@ -0,0 +1,286 @@
+/**
+ * @file test_task_queue.cpp
+ * @brief Tests for the internal task queues behind LimitedDispatcher and the event loops.
+ *
+ * Covers the intrusive MPSC queue (FIFO order, ownership of queued tasks, re-queuing a
+ * task after it was removed, rejecting a task that is still queued, concurrent producers
+ * against a single consumer) and the
+ * LockFreeTaskQueue (growth by freezing, closing, the single-consumer path with several
+ * producers, and several consumers taking every element exactly once), plus a
+ * BlockingEventLoop running the tasks that several threads dispatch to it.
+ */
+
+#include <iostream>
+#include <cassert>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+
+#include "kotlinx/coroutines/EventLoop.hpp"
+#include "kotlinx/coroutines/internal/IntrusiveTaskQueue.hpp"
+#include "kotlinx/coroutines/internal/LockFreeTaskQueue.hpp"
+
+using namespace kotlinx::coroutines;
+using namespace kotlinx::coroutines::internal;
+
+namespace {
+
+struct NumberedRunnable : Runnable {
+    int producer;
+    int number;
+    NumberedRunnable(int producer, int number) : producer(producer), number(number) {}
+    void run() override {}
+};
+
+struct CountingRunnable : Runnable {
+    std::atomic<int>& count;
+    explicit CountingRunnable(std::atomic<int>& count) : count(count) {}
+    void run() override { count.fetch_add(1); }
+};
+
+} // namespace
+
+// Single-threaded FIFO order, size accounting and ownership while queued
+void test_intrusive_queue_fifo() {
+    std::cout << "test_intrusive_queue_fifo... ";
+
+    IntrusiveTaskQueue queue;
+    assert(queue.is_empty());
+    assert(queue.remove_first_or_null() == nullptr);
+    std::weak_ptr<Runnable> first;
+    {
+        auto task = std::make_shared<NumberedRunnable>(0, 0);
+        first = task;
+        queue.add_last(std::move(task));
+    }
+    assert(!first.expired()); // the queue keeps it alive
+    for (int i = 1; i < 100; ++i) queue.add_last(std::make_shared<NumberedRunnable>(0, i));
+    assert(queue.size() == 100);
+    for (int i = 0; i < 100; ++i) {
+        auto task = std::static_pointer_cast<NumberedRunnable>(queue.remove_first_or_null());
+        assert(task && task->number == i);
+        // A removed task can be queued again right away.
+        if (i == 50) queue.add_last(task);
+    }
+    auto again = std::static_pointer_cast<NumberedRunnable>(queue.remove_first_or_null());
+    assert(again && again->number == 50);
+    assert(queue.remove_first_or_null() == nullptr);
+    assert(queue.is_empty());
+    assert(first.expired());
+
+    std::cout << "PASSED\n";
+}
+
+// Queuing a task that is already queued, in the same queue or another, throws and leaves both
+// queues intact; once removed, the task can be queued again
+void test_queued_task_is_rejected() {
+    std::cout << "test_queued_task_is_rejected... ";
+
+    IntrusiveTaskQueue queue;
+    IntrusiveTaskQueue other;
+    auto task = std::make_shared<NumberedRunnable>(0, 0);
+    queue.add_last(task);
+    queue.add_last(std::make_shared<NumberedRunnable>(0, 1));
+
+    auto rejects = [&task](auto&& enqueue) {
+        try {
+            enqueue();
+        } catch (const std::logic_error&) {
+            return true;
+        }
+        return false;
+    };
+    assert(rejects([&] { queue.add_last(task); }));
+    assert(rejects([&] { other.add_last(task); }));
+    assert(rejects([&] { retain_queued(task); }));
+    assert(queue.size() == 2);
+    assert(other.is_empty());
+
+    assert(queue.remove_first_or_null() == task);
+    assert(std::static_pointer_cast<NumberedRunnable>(queue.remove_first_or_null())->number == 1);
+    assert(queue.remove_first_or_null() == nullptr);
+
+    // Out of the queue, it goes through retain_queued and back into a queue
+    Runnable* raw = retain_queued(task);
+    assert(rejects([&] { other.add_last(task); }));
+    assert(release_queued(raw) == task);
+    other.add_last(task);
+    assert(other.remove_first_or_null() == task);
+
+    std::cout << "PASSED\n";
+}
+
+// Concurrent producers: nothing is lost or duplicated, and each producer's order is kept
+void test_intrusive_queue_mpsc() {
+    std::cout << "test_intrusive_queue_mpsc... ";
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 50000;
+    IntrusiveTaskQueue queue;
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < kPerProducer; ++i) queue.add_last(std::make_shared<NumberedRunnable>(p, i));
+        });
+    }
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    while (received < kProducers * kPerProducer) {
+        auto task = std::static_pointer_cast<NumberedRunnable>(queue.remove_first_or_null());
+        if (!task) {
+            assert(queue.size() >= 0);
+            std::this_thread::yield();
+            continue;
+        }
+        assert(task->number == next[task->producer]);
+        ++next[task->producer];
+        ++received;
+    }
+    for (auto& producer : producers) producer.join();
+    assert(queue.is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+// Growth past the initial capacity keeps FIFO order; closing keeps the elements already added
+void test_lock_free_queue_growth_and_close() {
+    std::cout << "test_lock_free_queue_growth_and_close... ";
+
+    for (bool single_consumer : {true, false}) {
+        LockFreeTaskQueue<int> queue(single_consumer);
+        std::vector<int> values(1000);
+        for (int i = 0; i < 1000; ++i) {
+            values[i] = i;
+            assert(queue.add_last(&values[i]));
+        }
+        assert(queue.size() == 1000);
+        auto mapped = queue.map<int>([](int* value) { return *value; });
+        assert(static_cast<int>(mapped.size()) == 1000 && mapped[999] == 999);
+        for (int i = 0; i < 500; ++i) assert(*queue.remove_first_or_null() == i);
+        queue.close();
+        assert(queue.is_closed());
+        int rejected = -1;
+        assert(!queue.add_last(&rejected));
+        for (int i = 500; i < 1000; ++i) assert(*queue.remove_first_or_null() == i);
+        assert(queue.remove_first_or_null() == nullptr);
+        assert(queue.is_empty());
+    }
+
+    std::cout << "PASSED\n";
+}
+
+// Several producers, one consumer on the CAS-free path: per-producer order and no losses
+void test_lock_free_queue_single_consumer() {
+    std::cout << "test_lock_free_queue_single_consumer... ";
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 50000;
+    LockFreeTaskQueue<NumberedRunnable> queue(true);
+    std::vector<std::vector<NumberedRunnable>> elements(kProducers);
+    for (int p = 0; p < kProducers; ++p) {
+        for (int i = 0; i < kPerProducer; ++i) elements[p].emplace_back(p, i);
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, &elements, p] {
+            for (auto& element : elements[p]) assert(queue.add_last(&element));
+        });
+    }
+    std::vector<int> next(kProducers, 0);
+    int received = 0;
+    while (received < kProducers * kPerProducer) {
+        NumberedRunnable* element = queue.remove_first_or_null();
+        if (element == nullptr) {
+            std::this_thread::yield();
+            continue;
+        }
+        assert(element->number == next[element->producer]);
+        ++next[element->producer];
+        ++received;
+    }
+    for (auto& producer : producers) producer.join();
+    assert(queue.is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+// Several producers and consumers: every element is taken exactly once
+void test_lock_free_queue_multi_consumer() {
+    std::cout << "test_lock_free_queue_multi_consumer... ";
+
+    constexpr int kThreads = 4;
+    constexpr int kPerProducer = 50000;
+    constexpr int kTotal = kThreads * kPerProducer;
+    LockFreeTaskQueue<NumberedRunnable> queue(false);
+    std::vector<NumberedRunnable> elements;
+    elements.reserve(kTotal);
+    for (int i = 0; i < kTotal; ++i) elements.emplace_back(i / kPerProducer, i);
+    std::vector<std::atomic<int>> taken(kTotal);
+    std::atomic<int> received{0};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < kPerProducer; ++i) assert(queue.add_last(&elements[t * kPerProducer + i]));
+        });
+        threads.emplace_back([&] {
+            while (received.load() < kTotal) {
+                if (NumberedRunnable* element = queue.remove_first_or_null()) {
+                    taken[element->number].fetch_add(1);
+                    received.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (auto& count : taken) assert(count.load() == 1);
+    assert(queue.is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+// Tasks dispatched from several threads while the loop parks and wakes all run once
+void test_event_loop_dispatch() {
+    std::cout << "test_event_loop_dispatch... ";
+
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 20000;
+    auto loop = std::make_shared<BlockingEventLoop>(nullptr);
+    std::atomic<int> ran{0};
+    std::thread runner([&] { loop->run(); });
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&] {
+            for (int i = 0; i < kPerProducer; ++i) {
+                loop->dispatch(*EmptyCoroutineContext::instance(), std::make_shared<CountingRunnable>(ran));
+                if (i % 1000 == 0) std::this_thread::yield(); // let the loop run dry and park
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    while (ran.load() < kProducers * kPerProducer) std::this_thread::yield();
+    loop->shutdown();
+    runner.join();
+    assert(loop->is_empty());
+
+    std::cout << "PASSED\n";
+}
+
+int main() {
+    std::cout << "=== Task Queue Tests ===\n";
+
+    test_intrusive_queue_fifo();
+    test_queued_task_is_rejected();
+    test_intrusive_queue_mpsc();
+    test_lock_free_queue_growth_and_close();
+    test_lock_free_queue_single_consumer();
+    test_lock_free_queue_multi_consumer();
+    test_event_loop_dispatch();
+
+    std::cout << "\nAll tests passed!\n";
+    return 0;
+}
@@ -163,7 +163,7 @@ void test_simple_yield() {
     execution_log.clear();
 
     auto completion = std::make_shared<TestCompletion>();
-    auto coro = std::make_shared<SimpleYieldCoroutine>(completion);
+    auto coro = internal::make_frame<SimpleYieldCoroutine>(completion);
 
     // First call - runs until first yield
     void* r1 = coro->invoke_suspend(Result<void*>::success(nullptr));
@@ -195,7 +195,7 @@ void test_conditional_suspend() {
     // Test with suspension
     {
         auto completion = std::make_shared<TestCompletion>();
-        auto coro = std::make_shared<ConditionalSuspendCoroutine>(true, completion);
+        auto coro = internal::make_frame<ConditionalSuspendCoroutine>(true, completion);
 
         void* r1 = coro->invoke_suspend(Result<void*>::success(nullptr));
         assert(is_coroutine_suspended(r1));
@@ -209,7 +209,7 @@ void test_conditional_suspend() {
     // Test without suspension
     {
         auto completion = std::make_shared<TestCompletion>();
-        auto coro = std::make_shared<ConditionalSuspendCoroutine>(false, completion);
+        auto coro = internal::make_frame<ConditionalSuspendCoroutine>(false, completion);
 
         void* r1 = coro->invoke_suspend(Result<void*>::success(nullptr));
         assert(!is_coroutine_suspended(r1));
@@ -223,7 +223,7 @@ void test_loop_suspend() {
     std::cout << "test_loop_suspend... ";
 
     auto completion = std::make_shared<TestCompletion>();
-    auto coro = std::make_shared<LoopCoroutine>(completion);
+    auto coro = internal::make_frame<LoopCoroutine>(completion);
 
     // iteration 0: sum = 0, iteration = 1
     void* r = coro->invoke_suspend(Result<void*>::success(nullptr));
@@ -257,7 +257,7 @@ void test_yield_value_resume_result() {
     void* expected = static_cast<void*>(&k_marker);
 
     auto completion = std::make_shared<TestCompletion>();
-    auto coro = std::make_shared<YieldValueCoroutine>(completion);
+    auto coro = internal::make_frame<YieldValueCoroutine>(completion);
 
     void* r1 = coro->invoke_suspend(Result<void*>::success(nullptr));
     assert(is_coroutine_suspended(r1));
@@ -275,7 +275,7 @@ void test_resume_with_value() {
 
     // Test that BaseContinuationImpl::resume_with drives the state machine
     auto completion = std::make_shared<TestCompletion>();
-    auto coro = std::make_shared<SimpleYieldCoroutine>(completion);
+    auto coro = internal::make_frame<SimpleYieldCoroutine>(completion);
 
     // Start via resume_with - this drives the loop in BaseContinuationImpl
     coro->resume_with(Result<void*>::success(nullptr));
@@ -292,7 +292,7 @@ void test_start_with_exception_throws() {
     execution_log.clear();
 
     auto completion = std::make_shared<TestCompletion>();
-    auto coro = std::make_shared<SimpleYieldCoroutine>(completion);
+    auto coro = internal::make_frame<SimpleYieldCoroutine>(completion);
 
     bool threw = false;
     try {